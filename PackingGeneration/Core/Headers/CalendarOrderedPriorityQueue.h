@@ -0,0 +1,377 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Core_Headers_CalendarOrderedPriorityQueue_h
+#define Core_Headers_CalendarOrderedPriorityQueue_h
+
+#include <vector>
+#include <algorithm>
+#include "IOrderedPriorityQueue.h"
+#include "Constants.h"
+#include "Types.h"
+#include "Macros.h"
+
+namespace Core
+{
+    // See Brown (1988) Calendar queues: a fast O(1) priority queue implementation for the simulation event set problem
+    // and Tan, Thng (2000) SNOOPY calendar queue.
+    // The values are distributed over a "year" of bucketsCount "days" of width bucketWidth by their priorities; each bucket is a sorted doubly-linked list of value indexes.
+    // For event-driven molecular dynamics the events are dense near the current time, so the top value is usually found in one of the first visited buckets,
+    // and both GetTopIndex and HandleUpdate are O(1) on average instead of O(log(N)) for the heap.
+    // TCompare should expose "FLOAT_TYPE GetPriority(const TValue& value)", which should be consistent with TCompare::operator().
+    // Values with priority MAX_FLOAT_VALUE (e.g., invalid events) are stored in a separate overflow list.
+    // Values with equal priorities are ordered by their indexes.
+    template<class TContainer, class TCompare>
+    class CalendarOrderedPriorityQueue : public virtual IOrderedPriorityQueue<TContainer, TCompare>
+    {
+    private:
+        typedef unsigned long long DayIndex;
+
+        static const int NoIndex = -1;
+
+        // The queue is checked for efficiency not more often than once in minCheckPeriod updates
+        static const int minCheckPeriod = 256;
+
+        // If the queue visits more buckets per search or more list nodes per insertion on average, bucket width is re-estimated.
+        // See Tan, Thng (2000).
+        static const int maxAverageSkippedBuckets = 16;
+        static const int maxAverageWalkLength = 8;
+
+        // Number of the first values used to estimate the average separation of priorities. See Brown (1988).
+        static const int estimationSampleSize = 32;
+
+        TContainer* values;
+        TCompare compare;
+        int valuesCount;
+
+        // Intrusive bucket lists
+        std::vector<int> nextIndexes;
+        std::vector<int> previousIndexes;
+        std::vector<int> bucketIndexes;
+        std::vector<int> bucketHeads; // the last bucket is the overflow list
+
+        // Priorities are cached, as values can be changed by clients before HandleUpdate is called
+        std::vector<FLOAT_TYPE> priorities;
+        std::vector<DayIndex> days;
+        std::vector<FLOAT_TYPE> prioritiesSample;
+
+        int bucketsCount;
+        int overflowBucketIndex;
+        DayIndex bucketsMask;
+        DayIndex maxDay;
+        FLOAT_TYPE origin;
+        FLOAT_TYPE bucketWidth;
+        int finiteValuesCount;
+
+        // Search state and statistics. The search state does not influence the order of values.
+        mutable DayIndex currentDay;
+        mutable long long skippedBucketsCount;
+        long long walkLength;
+        int updatesCount;
+        int checkPeriod;
+
+    public:
+        CalendarOrderedPriorityQueue()
+        {
+            values = NULL;
+            valuesCount = 0;
+            bucketsCount = 0;
+            finiteValuesCount = 0;
+            bucketWidth = 1.0;
+            origin = 0.0;
+        }
+
+        OVERRIDE void Initialize(TContainer* values, TCompare compare)
+        {
+            this->values = values;
+            this->compare = compare;
+            valuesCount = values->size();
+
+            bucketsCount = 2;
+            while (bucketsCount < valuesCount)
+            {
+                bucketsCount *= 2;
+            }
+            bucketsMask = bucketsCount - 1;
+            overflowBucketIndex = bucketsCount;
+            maxDay = static_cast<DayIndex>(1) << 52;
+
+            nextIndexes.resize(valuesCount);
+            previousIndexes.resize(valuesCount);
+            bucketIndexes.resize(valuesCount);
+            priorities.resize(valuesCount);
+            days.resize(valuesCount);
+            bucketHeads.resize(bucketsCount + 1);
+
+            for (int i = 0; i < valuesCount; ++i)
+            {
+                priorities[i] = this->compare.GetPriority((*values)[i]);
+            }
+
+            bucketWidth = 1.0;
+            checkPeriod = minCheckPeriod;
+            Rebuild(EstimateBucketWidth());
+        }
+
+        OVERRIDE int GetTopIndex() const
+        {
+            if (finiteValuesCount == 0)
+            {
+                return GetOverflowTopIndex();
+            }
+
+            for (int i = 0; i < bucketsCount; ++i)
+            {
+                DayIndex day = currentDay + i;
+                int headIndex = bucketHeads[day & bucketsMask];
+
+                // No finite value has day less than currentDay, and lists are sorted, so the head has the minimal day in the bucket
+                if (headIndex != NoIndex && days[headIndex] == day)
+                {
+                    currentDay = day;
+                    skippedBucketsCount += i;
+                    return headIndex;
+                }
+            }
+
+            // A whole year is empty, search directly among the heads
+            skippedBucketsCount += bucketsCount;
+            int topIndex = NoIndex;
+            for (int bucketIndex = 0; bucketIndex < bucketsCount; ++bucketIndex)
+            {
+                int headIndex = bucketHeads[bucketIndex];
+                if (headIndex != NoIndex && (topIndex == NoIndex || IsEarlier(headIndex, priorities[topIndex], topIndex)))
+                {
+                    topIndex = headIndex;
+                }
+            }
+
+            currentDay = days[topIndex];
+            return topIndex;
+        }
+
+        OVERRIDE void HandleUpdate(int valueIndex)
+        {
+            Remove(valueIndex);
+            priorities[valueIndex] = compare.GetPriority((*values)[valueIndex]);
+            Insert(valueIndex);
+
+            updatesCount++;
+            if (updatesCount >= checkPeriod)
+            {
+                CheckEfficiency();
+            }
+        }
+
+        ~CalendarOrderedPriorityQueue()
+        {
+        }
+
+    private:
+        bool IsEarlier(int valueIndex, FLOAT_TYPE priority, int otherValueIndex) const
+        {
+            FLOAT_TYPE valuePriority = priorities[valueIndex];
+            return valuePriority < priority || (valuePriority == priority && valueIndex < otherValueIndex);
+        }
+
+        bool IsFinite(FLOAT_TYPE priority) const
+        {
+            return priority < MAX_FLOAT_VALUE && (priority - origin) / bucketWidth < maxDay;
+        }
+
+        DayIndex GetDay(FLOAT_TYPE priority) const
+        {
+            if (priority <= origin)
+            {
+                return 0;
+            }
+            return static_cast<DayIndex>((priority - origin) / bucketWidth);
+        }
+
+        int GetOverflowTopIndex() const
+        {
+            int topIndex = NoIndex;
+            for (int valueIndex = bucketHeads[overflowBucketIndex]; valueIndex != NoIndex; valueIndex = nextIndexes[valueIndex])
+            {
+                if (topIndex == NoIndex || IsEarlier(valueIndex, priorities[topIndex], topIndex))
+                {
+                    topIndex = valueIndex;
+                }
+            }
+            return topIndex;
+        }
+
+        void Insert(int valueIndex)
+        {
+            FLOAT_TYPE priority = priorities[valueIndex];
+            if (!IsFinite(priority))
+            {
+                // The overflow list is not sorted
+                Link(valueIndex, overflowBucketIndex, NoIndex, bucketHeads[overflowBucketIndex]);
+                return;
+            }
+
+            DayIndex day = GetDay(priority);
+            days[valueIndex] = day;
+            int bucketIndex = static_cast<int>(day & bucketsMask);
+
+            int previousIndex = NoIndex;
+            int currentIndex = bucketHeads[bucketIndex];
+            while (currentIndex != NoIndex && IsEarlier(currentIndex, priority, valueIndex))
+            {
+                previousIndex = currentIndex;
+                currentIndex = nextIndexes[currentIndex];
+                walkLength++;
+            }
+
+            Link(valueIndex, bucketIndex, previousIndex, currentIndex);
+            finiteValuesCount++;
+            if (day < currentDay)
+            {
+                currentDay = day;
+            }
+        }
+
+        void Link(int valueIndex, int bucketIndex, int previousIndex, int nextIndex)
+        {
+            bucketIndexes[valueIndex] = bucketIndex;
+            previousIndexes[valueIndex] = previousIndex;
+            nextIndexes[valueIndex] = nextIndex;
+
+            if (previousIndex == NoIndex)
+            {
+                bucketHeads[bucketIndex] = valueIndex;
+            }
+            else
+            {
+                nextIndexes[previousIndex] = valueIndex;
+            }
+
+            if (nextIndex != NoIndex)
+            {
+                previousIndexes[nextIndex] = valueIndex;
+            }
+        }
+
+        void Remove(int valueIndex)
+        {
+            int bucketIndex = bucketIndexes[valueIndex];
+            int previousIndex = previousIndexes[valueIndex];
+            int nextIndex = nextIndexes[valueIndex];
+
+            if (previousIndex == NoIndex)
+            {
+                bucketHeads[bucketIndex] = nextIndex;
+            }
+            else
+            {
+                nextIndexes[previousIndex] = nextIndex;
+            }
+
+            if (nextIndex != NoIndex)
+            {
+                previousIndexes[nextIndex] = previousIndex;
+            }
+
+            if (bucketIndex != overflowBucketIndex)
+            {
+                finiteValuesCount--;
+            }
+        }
+
+        void CheckEfficiency()
+        {
+            FLOAT_TYPE averageSkippedBuckets = static_cast<FLOAT_TYPE>(skippedBucketsCount) / updatesCount;
+            FLOAT_TYPE averageWalkLength = static_cast<FLOAT_TYPE>(walkLength) / updatesCount;
+            ResetStatistics();
+
+            if (averageSkippedBuckets <= maxAverageSkippedBuckets && averageWalkLength <= maxAverageWalkLength)
+            {
+                return;
+            }
+
+            FLOAT_TYPE estimatedBucketWidth = EstimateBucketWidth();
+            if (estimatedBucketWidth > 2.0 * bucketWidth || estimatedBucketWidth < 0.5 * bucketWidth)
+            {
+                checkPeriod = minCheckPeriod;
+                Rebuild(estimatedBucketWidth);
+            }
+            else
+            {
+                // The priorities are just clustered, rebuilding will not help; check less frequently not to waste time on estimation
+                checkPeriod *= 2;
+            }
+        }
+
+        // Bucket width is three average separations of the first priorities, see Brown (1988).
+        FLOAT_TYPE EstimateBucketWidth()
+        {
+            prioritiesSample.clear();
+            for (int i = 0; i < valuesCount; ++i)
+            {
+                if (priorities[i] < MAX_FLOAT_VALUE)
+                {
+                    prioritiesSample.push_back(priorities[i]);
+                }
+            }
+
+            int sampleSize = prioritiesSample.size();
+            if (sampleSize < 2)
+            {
+                return bucketWidth;
+            }
+
+            int lastSampleIndex = std::min(sampleSize - 1, static_cast<int>(estimationSampleSize));
+            std::nth_element(prioritiesSample.begin(), prioritiesSample.begin() + lastSampleIndex, prioritiesSample.end());
+            FLOAT_TYPE minPriority = *std::min_element(prioritiesSample.begin(), prioritiesSample.begin() + lastSampleIndex + 1);
+            FLOAT_TYPE separation = (prioritiesSample[lastSampleIndex] - minPriority) / lastSampleIndex;
+
+            if (separation <= 0)
+            {
+                // The first priorities coincide, use the separation over the whole range
+                FLOAT_TYPE maxPriority = *std::max_element(prioritiesSample.begin(), prioritiesSample.end());
+                separation = (maxPriority - minPriority) / (sampleSize - 1);
+            }
+
+            return (separation > 0) ? 3.0 * separation : bucketWidth;
+        }
+
+        void Rebuild(FLOAT_TYPE newBucketWidth)
+        {
+            bucketWidth = newBucketWidth;
+
+            origin = MAX_FLOAT_VALUE;
+            for (int i = 0; i < valuesCount; ++i)
+            {
+                origin = std::min(origin, priorities[i]);
+            }
+            if (origin == MAX_FLOAT_VALUE)
+            {
+                origin = 0.0;
+            }
+
+            std::fill(bucketHeads.begin(), bucketHeads.end(), static_cast<int>(NoIndex));
+            finiteValuesCount = 0;
+            currentDay = 0;
+
+            for (int i = 0; i < valuesCount; ++i)
+            {
+                Insert(i);
+            }
+
+            ResetStatistics();
+        }
+
+        void ResetStatistics()
+        {
+            updatesCount = 0;
+            walkLength = 0;
+            skippedBucketsCount = 0;
+        }
+
+        DISALLOW_COPY_AND_ASSIGN(CalendarOrderedPriorityQueue);
+    };
+}
+
+#endif /* Core_Headers_CalendarOrderedPriorityQueue_h */
@@ -0,0 +1,47 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Core_Headers_CounterBasedRandom_h
+#define Core_Headers_CounterBasedRandom_h
+
+#include <stdint.h>
+#include "Types.h"
+
+namespace Core
+{
+    // Implements the counter-based Philox4x32-10 random number generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", SC 2011).
+    // A random block is a pure function of the key (seed) and the counter, so there is no state to share or advance:
+    // several threads may draw the values of any stream (e.g. of a sample index) independently, and the values do not depend on the order of drawing.
+    class CounterBasedRandom
+    {
+    public:
+        static const int WORDS_PER_BLOCK = 4;
+        static const int VALUES_PER_BLOCK = 2;
+
+    private:
+        uint32_t key[2];
+
+        static const uint32_t MULTIPLIER_0 = 0xD2511F53;
+        static const uint32_t MULTIPLIER_1 = 0xCD9E8D57;
+        static const uint32_t KEY_INCREMENT_0 = 0x9E3779B9; // golden ratio
+        static const uint32_t KEY_INCREMENT_1 = 0xBB67AE85; // sqrt(3) - 1
+        static const int ROUNDS_COUNT = 10;
+
+    public:
+        explicit CounterBasedRandom(int seed);
+
+        void SetSeed(int seed);
+
+        // Sets the full 64-bit key (SetSeed sets the first word only).
+        void SetKey(uint32_t firstKeyWord, uint32_t secondKeyWord);
+
+        // Fills four random 32-bit words for the counter. Is thread-safe.
+        void FillRandomWords(const uint32_t* counter, uint32_t* words) const;
+
+        // Fills VALUES_PER_BLOCK random values, uniformly distributed in [0, 1) with 53 random bits each, of the block blockIndex of the stream streamIndex. Is thread-safe.
+        void FillRandoms(uint64_t streamIndex, uint32_t blockIndex, FLOAT_TYPE* values) const;
+    };
+}
+
+#endif /* Core_Headers_CounterBasedRandom_h */
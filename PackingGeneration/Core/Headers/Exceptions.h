@@ -35,6 +35,15 @@ namespace Core
         explicit InvalidOperationException(std::string message);
         virtual ~InvalidOperationException();
     };
+
+    // Is thrown, when a task is interrupted, as the time budget of the program run has expired (see TimeBudget).
+    class TimeBudgetExpiredException :
+        public Exception
+    {
+    public:
+        explicit TimeBudgetExpiredException(std::string message);
+        virtual ~TimeBudgetExpiredException();
+    };
 }
 
 #endif /* Core_Headers_Exceptions_h */
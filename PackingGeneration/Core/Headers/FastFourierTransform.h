@@ -0,0 +1,56 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Core_Headers_FastFourierTransform_h
+#define Core_Headers_FastFourierTransform_h
+
+#include <vector>
+#include <complex>
+#include "Types.h"
+#include "Macros.h"
+
+namespace Core
+{
+    // Implements a mixed-radix (Cooley-Tukey) discrete Fourier transform of complex values of any size.
+    // Sizes with small prime factors (see GetNextFastSize) are the fastest, a large prime factor p costs O(p) operations per value.
+    // The transform is not normalized: output[k] = sum_j input[j] * exp(-+2 pi i j k / size), with minus for the forward transform.
+    class FastFourierTransform
+    {
+    private:
+        int size;
+        std::vector<int> factors; // pairs of a radix and the size of the remaining transform: p1, size / p1, p2, size / (p1 * p2), ..., pn, 1
+        std::vector<std::complex<FLOAT_TYPE> > forwardTwiddles;
+        std::vector<std::complex<FLOAT_TYPE> > inverseTwiddles;
+        int maxRadix;
+
+    public:
+        explicit FastFourierTransform(int size);
+
+        int GetSize() const;
+
+        // Transforms size values, read from input with the given stride. Output is contiguous and must not overlap the input. Is thread-safe.
+        void Transform(const std::complex<FLOAT_TYPE>* input, int inputStride, std::complex<FLOAT_TYPE>* output, bool inverse) const;
+
+        // Transforms a DIMENSIONS-dimensional array in place. The first index changes the fastest: values[x + sizes[0] * (y + sizes[1] * z)].
+        static void TransformMultidimensional(const DiscreteSpatialVector& sizes, std::vector<std::complex<FLOAT_TYPE> >* values, bool inverse);
+
+        // Returns the smallest size not less than minSize, which has no prime factors other than 2, 3 and 5.
+        static int GetNextFastSize(int minSize);
+
+        ~FastFourierTransform();
+
+    private:
+        void TransformRecursively(std::complex<FLOAT_TYPE>* output, const std::complex<FLOAT_TYPE>* input, int inputStride, int factorIndex,
+                const std::vector<std::complex<FLOAT_TYPE> >& twiddles, std::complex<FLOAT_TYPE>* scratch) const;
+
+        void ApplyRadix2Butterflies(std::complex<FLOAT_TYPE>* output, int twiddleStride, int subtransformSize, const std::vector<std::complex<FLOAT_TYPE> >& twiddles) const;
+
+        void ApplyGenericButterflies(std::complex<FLOAT_TYPE>* output, int twiddleStride, int subtransformSize, int radix,
+                const std::vector<std::complex<FLOAT_TYPE> >& twiddles, std::complex<FLOAT_TYPE>* scratch) const;
+
+        DISALLOW_COPY_AND_ASSIGN(FastFourierTransform);
+    };
+}
+
+#endif /* Core_Headers_FastFourierTransform_h */
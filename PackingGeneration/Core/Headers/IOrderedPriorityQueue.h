@@ -0,0 +1,26 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Core_Headers_IOrderedPriorityQueue_h
+#define Core_Headers_IOrderedPriorityQueue_h
+
+namespace Core
+{
+    // A priority queue over an external container of values. The queue does not own the values: clients update the values in place
+    // and notify the queue through HandleUpdate. GetTopIndex returns the index of the minimal (with respect to TCompare) value.
+    template<class TContainer, class TCompare>
+    class IOrderedPriorityQueue
+    {
+    public:
+        virtual void Initialize(TContainer* values, TCompare compare) = 0;
+
+        virtual int GetTopIndex() const = 0;
+
+        virtual void HandleUpdate(int valueIndex) = 0;
+
+        virtual ~IOrderedPriorityQueue(){ };
+    };
+}
+
+#endif /* Core_Headers_IOrderedPriorityQueue_h */
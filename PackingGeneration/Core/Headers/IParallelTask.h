@@ -0,0 +1,21 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Core_Headers_IParallelTask_h
+#define Core_Headers_IParallelTask_h
+
+namespace Core
+{
+    // A piece of work, which is split into several independent parts. ThreadPool executes the parts concurrently.
+    class IParallelTask
+    {
+    public:
+        // Is called concurrently for different part indexes, so the implementations should not modify the state shared by different parts.
+        virtual void Execute(int partIndex) = 0;
+
+        virtual ~IParallelTask(){ };
+    };
+}
+
+#endif /* Core_Headers_IParallelTask_h */
@@ -0,0 +1,159 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Core_Headers_KeyOrderedPriorityQueue_h
+#define Core_Headers_KeyOrderedPriorityQueue_h
+
+#include <vector>
+#include <algorithm>
+#include "IOrderedPriorityQueue.h"
+#include "Types.h"
+#include "Macros.h"
+
+namespace Core
+{
+    // A 4-ary heap, which stores compact (priority, value index) keys instead of value indexes.
+    // OrderedPriorityQueue compares values indirectly, so each comparison reads two (possibly large and distant in memory) values.
+    // Here comparisons touch only the heap itself, and the four children of a node are adjacent in memory, so the heap is also twice shallower than the binary one.
+    // TCompare should expose "FLOAT_TYPE GetPriority(const TValue& value)", which should be consistent with TCompare::operator().
+    // Values with equal priorities are ordered by their indexes.
+    template<class TContainer, class TCompare>
+    class KeyOrderedPriorityQueue : public virtual IOrderedPriorityQueue<TContainer, TCompare>
+    {
+    private:
+        struct Key
+        {
+            FLOAT_TYPE priority;
+            int valueIndex;
+        };
+
+        static const int arity = 4;
+
+        TContainer* values;
+        TCompare compare;
+        std::vector<Key> heap;
+        std::vector<int> heapPositions;
+
+    public:
+        KeyOrderedPriorityQueue()
+        {
+            values = NULL;
+        }
+
+        OVERRIDE void Initialize(TContainer* values, TCompare compare)
+        {
+            this->values = values;
+            this->compare = compare;
+
+            int valuesCount = values->size();
+            heap.resize(valuesCount);
+            heapPositions.resize(valuesCount);
+            for (int i = 0; i < valuesCount; ++i)
+            {
+                heap[i].priority = this->compare.GetPriority((*values)[i]);
+                heap[i].valueIndex = i;
+                heapPositions[i] = i;
+            }
+
+            // Floyd's heap construction, O(N)
+            for (int position = (valuesCount - 2) / arity; position >= 0; --position)
+            {
+                SiftDown(position);
+            }
+        }
+
+        OVERRIDE int GetTopIndex() const
+        {
+            return heap[0].valueIndex;
+        }
+
+        OVERRIDE void HandleUpdate(int valueIndex)
+        {
+            int position = heapPositions[valueIndex];
+            Key& key = heap[position];
+            FLOAT_TYPE oldPriority = key.priority;
+            key.priority = compare.GetPriority((*values)[valueIndex]);
+
+            if (key.priority < oldPriority)
+            {
+                SiftUp(position);
+            }
+            else
+            {
+                SiftDown(position);
+            }
+        }
+
+        ~KeyOrderedPriorityQueue()
+        {
+        }
+
+    private:
+        static bool IsEarlier(const Key& first, const Key& second)
+        {
+            return first.priority < second.priority || (first.priority == second.priority && first.valueIndex < second.valueIndex);
+        }
+
+        // Keys are moved into the hole instead of being swapped
+        void SiftUp(int position)
+        {
+            Key key = heap[position];
+            while (position > 0)
+            {
+                int parentPosition = (position - 1) / arity;
+                if (!IsEarlier(key, heap[parentPosition]))
+                {
+                    break;
+                }
+
+                Place(heap[parentPosition], position);
+                position = parentPosition;
+            }
+            Place(key, position);
+        }
+
+        void SiftDown(int position)
+        {
+            int heapSize = heap.size();
+            Key key = heap[position];
+            while (true)
+            {
+                int firstChildPosition = arity * position + 1;
+                if (firstChildPosition >= heapSize)
+                {
+                    break;
+                }
+
+                int lastChildPosition = std::min(firstChildPosition + arity, heapSize);
+                int minChildPosition = firstChildPosition;
+                for (int childPosition = firstChildPosition + 1; childPosition < lastChildPosition; ++childPosition)
+                {
+                    if (IsEarlier(heap[childPosition], heap[minChildPosition]))
+                    {
+                        minChildPosition = childPosition;
+                    }
+                }
+
+                if (!IsEarlier(heap[minChildPosition], key))
+                {
+                    break;
+                }
+
+                Place(heap[minChildPosition], position);
+                position = minChildPosition;
+            }
+            Place(key, position);
+        }
+
+        void Place(const Key& key, int position)
+        {
+            heap[position] = key;
+            heapPositions[key.valueIndex] = position;
+        }
+
+        DISALLOW_COPY_AND_ASSIGN(KeyOrderedPriorityQueue);
+    };
+}
+
+#endif /* Core_Headers_KeyOrderedPriorityQueue_h */
@@ -15,16 +15,35 @@
 #undef GetMessage
 #else
 #include <unistd.h>
+#include <stdlib.h>
 #endif
 
 namespace Core
 {
+    // The state of the random number generator of Math, so that a random sequence can be continued after a restart.
+    struct RandomState
+    {
+        unsigned short seed[3];
+        bool spareReady;
+        FLOAT_TYPE spare;
+    };
+
     // Implements math utility methods.
     class Math
     {
     private:
-        static FLOAT_TYPE spare;
-        static bool spareReady;
+        // The random number generator state is per thread, so that the tasks executed concurrently by different threads
+        // get the same random sequences as in sequential execution. rand() on Windows already keeps its state per thread.
+        static thread_local FLOAT_TYPE spare;
+        static thread_local bool spareReady;
+#ifndef WINDOWS
+        static thread_local unsigned short randomSeed[3];
+
+        // The state of the integer sequence of GetNextRandomInteger, which replaces the process-wide rand()
+        static thread_local bool integerRandomReady;
+        static thread_local random_data integerRandomData;
+        static thread_local char integerRandomState[128];
+#endif
 
     public:
         //Determines, whether x is a number (i.e. not a NaN or infinity)
@@ -36,10 +55,20 @@ namespace Core
         //Rounds the input.
         static int Round(FLOAT_TYPE x);
 
+        // Affects only the random sequence of the calling thread.
         static void SetSeed(int seed);
 
         static FLOAT_TYPE GetNextRandom();
 
+        // Returns the next value of rand() in [0, RAND_MAX], independent of the sequence of GetNextRandom, so that it does not shift the latter.
+        // Unlike rand(), the sequence is per thread and SetSeed restarts it from the initial state of rand() without srand (on Windows it is rand() itself).
+        static int GetNextRandomInteger();
+
+        // On Windows the state of rand() is not accessible, so only the spare Gaussian value is saved and restored.
+        static void FillRandomState(RandomState* state);
+
+        static void SetRandomState(const RandomState& state);
+
         static void CalculateStepSize(FLOAT_TYPE minBinLeftEdge, FLOAT_TYPE maxBinRightEdge, FLOAT_TYPE expectedStep, FLOAT_TYPE* actualStep, int* binsCount);
 
         static void DistributeValuesToBins(const std::vector<FLOAT_TYPE>& values, FLOAT_TYPE step,
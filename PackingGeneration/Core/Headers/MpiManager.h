@@ -18,6 +18,9 @@ typedef int MPI_Datatype;
 #define MPI_INT            ((MPI_Datatype)6)
 #define MPI_BYTE           ((MPI_Datatype)3)
 
+#define MPI_ANY_SOURCE     (-2)
+#define MPI_ANY_TAG        (-1)
+
 typedef struct MPI_Status {
     int count;
     int cancelled;
@@ -96,6 +99,8 @@ namespace Core
         // A wrapper over IProbe
         int ProbeNonBlocking(int source, int tag, bool* flag, MPI_Status* status);
 
+        int Broadcast(void* buffer, int count, MPI_Datatype dataType, int root);
+
         int Barrier();
 
     private:
@@ -6,11 +6,12 @@
 #define Core_Headers_OrderedPriorityQueue_h
 
 #include "BaseOrderedPriorityQueue.h"
+#include "IOrderedPriorityQueue.h"
 
 namespace Core
 {
     template<class TContainer, class TCompare>
-    class OrderedPriorityQueue
+    class OrderedPriorityQueue : public virtual IOrderedPriorityQueue<TContainer, TCompare>
     {
     private:
         BaseOrderedPriorityQueue<typename TContainer::iterator, TCompare> queue;
@@ -23,17 +24,17 @@ namespace Core
         // Have a separate Initialize method to allow
         // a. interface extraction
         // b. creating (if stored by value) or passing the queue (by value or reference) in client constructors, initializing it later
-        void Initialize(TContainer* values, TCompare compare)
+        OVERRIDE void Initialize(TContainer* values, TCompare compare)
         {
             queue.Initialize(values->begin(), values->end(), compare);
         }
 
-        int GetTopIndex() const
+        OVERRIDE int GetTopIndex() const
         {
             return queue.GetTopIndex();
         }
 
-        void HandleUpdate(int valueIndex)
+        OVERRIDE void HandleUpdate(int valueIndex)
         {
             queue.HandleUpdate(valueIndex);
         }
@@ -28,6 +28,12 @@ namespace Core
 
         static void FillFolderNames(std::string basePath, std::vector<std::string>* folderNames);
 
+        // Lists the folder once, without calling stat for each entry, if the file system reports the entry types (faster on network file systems).
+        static void FillFileAndFolderNames(std::string basePath, std::vector<std::string>* fileNames, std::vector<std::string>* folderNames);
+
+        // Returns the last modification time in nanoseconds (in seconds precision, if the platform has no finer one). Returns false if the path does not exist.
+        static bool TryGetModificationTime(std::string path, long long* modificationTime);
+
         static bool Exists(std::string path);
 
         static bool CreateFolder(std::string path);
@@ -0,0 +1,63 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Core_Headers_SphericalHarmonicsKernel_h
+#define Core_Headers_SphericalHarmonicsKernel_h
+
+#include <vector>
+#include <complex>
+#include "Types.h"
+#include "Macros.h"
+
+namespace Core
+{
+    // Computes the spherical harmonics Y_lm (with the Condon-Shortley phase) of all l <= maxL for a unit vector at once, without trigonometric functions.
+    // Y_lm = Q_lm(z) * (x + i y)^m, where Q_lm = P_lm / sin(theta)^m are the normalized associated Legendre functions without the sin(theta)^m factor.
+    // Q_lm are computed by the standard three-term recurrence in l, the powers of (x + i y) by multiplication.
+    // Only m >= 0 are stored, as Y_l(-m) = (-1)^m conj(Y_lm) for real directions (so the same holds for any sums of harmonics).
+    class SphericalHarmonicsKernel
+    {
+    private:
+        int maxL;
+        std::vector<FLOAT_TYPE> diagonalFactors; // Q_mm = diagonalFactors[m] * Q_(m-1)(m-1)
+        std::vector<FLOAT_TYPE> firstRecurrenceFactors; // Q_lm = firstRecurrenceFactors[lm] * (z * Q_(l-1)m - secondRecurrenceFactors[lm] * Q_(l-2)m)
+        std::vector<FLOAT_TYPE> secondRecurrenceFactors;
+        std::vector<std::vector<FLOAT_TYPE> > wignerSymbols; // wignerSymbols[l][(m1 + l) * (2 l + 1) + m2 + l] = (l l l; m1 m2 -m1-m2)
+
+    public:
+        explicit SphericalHarmonicsKernel(int maxL);
+
+        int GetMaxL() const;
+
+        // Returns the number of the stored harmonics, (maxL + 1) * (maxL + 2) / 2.
+        int GetValuesCount() const;
+
+        // Returns the index of Y_lm, m >= 0, in the arrays of values.
+        static int GetValueIndex(int l, int m);
+
+        // Adds Y_lm(direction) for all 0 <= m <= l <= maxL to the values. The direction should be normalized. Is thread-safe.
+        void AddSphericalHarmonicValues(const SpatialVector& direction, std::complex<FLOAT_TYPE>* values) const;
+
+        // Returns the rotationally invariant sum over m = -l, ..., l of |values_lm|^2.
+        static FLOAT_TYPE GetSquaresSum(const std::complex<FLOAT_TYPE>* values, int l);
+
+        // Returns the Steinhardt order q_l = sqrt(4 pi / (2 l + 1) * sum_m |values_lm / count|^2) of the sums of count harmonics.
+        static FLOAT_TYPE GetOrder(const std::complex<FLOAT_TYPE>* values, int l, int count);
+
+        // Returns the normalized third-order invariant w_l = sum_(m1 + m2 + m3 = 0) (l l l; m1 m2 m3) values_lm1 values_lm2 values_lm3 / (sum_m |values_lm|^2)^(3/2).
+        FLOAT_TYPE GetWignerOrder(const std::complex<FLOAT_TYPE>* values, int l) const;
+
+        // Returns the Wigner 3j symbol (l l l; m1 m2 -m1-m2) by the Racah formula.
+        static FLOAT_TYPE GetWignerSymbol(int l, int m1, int m2);
+
+        ~SphericalHarmonicsKernel();
+
+    private:
+        static std::complex<FLOAT_TYPE> GetValue(const std::complex<FLOAT_TYPE>* values, int l, int m);
+
+        DISALLOW_COPY_AND_ASSIGN(SphericalHarmonicsKernel);
+    };
+}
+
+#endif /* Core_Headers_SphericalHarmonicsKernel_h */
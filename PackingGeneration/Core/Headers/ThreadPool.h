@@ -0,0 +1,63 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Core_Headers_ThreadPool_h
+#define Core_Headers_ThreadPool_h
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include "Macros.h"
+namespace Core { class IParallelTask; }
+
+namespace Core
+{
+    // A fixed set of threads, which execute the parts of IParallelTask instances.
+    // The threads are created once, so the repeated short parallel sections (e.g. the force parts of EnergyService, which keeps its pool between the calls)
+    // do not pay for thread creation. The other users (e.g. OrderService, InsertionRadiiSampler) create a pool per call.
+    // Is independent of MPI: MPI distributes packings between processes, while threads of a single process work on a single packing
+    // or, with the -tasks option, on several packings at once (see Parallelism::TaskManager).
+    class ThreadPool
+    {
+    private:
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable taskStarted;
+        std::condition_variable taskFinished;
+
+        // Working variables, guarded by the mutex
+        IParallelTask* task;
+        int partsCount;
+        int nextPartIndex;
+        int unfinishedPartsCount;
+        int taskNumber;
+        bool shouldStop;
+        std::exception_ptr error;
+
+    public:
+        // The calling thread also executes the parts, so threadsCount - 1 threads are created. If threadsCount is not positive, the number of hardware threads is used.
+        explicit ThreadPool(int threadsCount);
+
+        ~ThreadPool();
+
+        int GetThreadsCount() const;
+
+        // Calls task->Execute(partIndex) for each partIndex from 0 to partsCount - 1 and returns when all the calls are finished.
+        // If any of the calls throws, the first exception is rethrown in the calling thread.
+        void Execute(IParallelTask* task, int partsCount);
+
+        static int GetHardwareThreadsCount();
+
+    private:
+        void RunWorker();
+
+        void ExecuteParts(std::unique_lock<std::mutex>* lock);
+
+        DISALLOW_COPY_AND_ASSIGN(ThreadPool);
+    };
+}
+
+#endif /* Core_Headers_ThreadPool_h */
@@ -0,0 +1,47 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Core_Headers_TimeBudget_h
+#define Core_Headers_TimeBudget_h
+
+#include <chrono>
+#include "Types.h"
+#include "Macros.h"
+#include "Exceptions.h"
+
+namespace Core
+{
+    // Represents the wall-clock time budget of the program run (e.g. the allocation of a batch job), shared by all the tasks and threads.
+    // Long loops with resumable state check the budget and, when it has expired, save the state and throw TimeBudgetExpiredException.
+    // The work that can not be resumed (e.g. sampling of insertion radii) does not check the budget, so that it is completed once started.
+    // The budget is unlimited, until it is started.
+    class TimeBudget
+    {
+    private:
+        static TimeBudget* instance;
+        bool isLimited;
+        std::chrono::steady_clock::time_point deadline;
+
+    public:
+        // Singleton pattern.
+        static TimeBudget* GetInstance();
+
+        // Starts the budget of budgetSeconds from now. Shall be called before the tasks start. If budgetSeconds is not positive, the budget is unlimited.
+        void Start(FLOAT_TYPE budgetSeconds);
+
+        bool IsLimited() const;
+
+        bool IsExpired() const;
+
+        // Throws TimeBudgetExpiredException, if the budget has expired.
+        void ThrowIfExpired() const;
+
+    private:
+        TimeBudget();
+
+        DISALLOW_COPY_AND_ASSIGN(TimeBudget);
+    };
+}
+
+#endif /* Core_Headers_TimeBudget_h */
@@ -6,6 +6,7 @@
 #define Core_Headers_Utilities_h
 
 #include <sstream>
+#include "Types.h"
 
 namespace Core
 {
@@ -34,6 +35,9 @@ namespace Core
 
         static int ParseInt(const std::string& input, int base = 0);
 
+        // Throws InvalidOperationException, if the input is not a finite number or is out of range (unlike atof, which returns zero).
+        static FLOAT_TYPE ParseFloat(const std::string& input);
+
         // TODO: Use boost/lexical_cast
         template<typename T>
         static std::string ConvertToString(T value)
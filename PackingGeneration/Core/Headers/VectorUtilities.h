@@ -288,11 +288,7 @@ namespace Core
             const std::size_t size = vectortRef.size();
             for (std::size_t i = 0; i < size; ++i)
             {
-#ifdef WINDOWS
-                vectortRef[i] = TItemType(rand()) / RAND_MAX;
-#else
-                vectortRef[i] = TItemType(drand48());
-#endif
+                vectortRef[i] = TItemType(Math::GetNextRandom());
             }
         }
 
@@ -0,0 +1,73 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/CounterBasedRandom.h"
+
+namespace Core
+{
+    CounterBasedRandom::CounterBasedRandom(int seed)
+    {
+        SetSeed(seed);
+    }
+
+    void CounterBasedRandom::SetSeed(int seed)
+    {
+        SetKey(static_cast<uint32_t>(seed), 0);
+    }
+
+    void CounterBasedRandom::SetKey(uint32_t firstKeyWord, uint32_t secondKeyWord)
+    {
+        key[0] = firstKeyWord;
+        key[1] = secondKeyWord;
+    }
+
+    void CounterBasedRandom::FillRandomWords(const uint32_t* counter, uint32_t* words) const
+    {
+        uint32_t x0 = counter[0];
+        uint32_t x1 = counter[1];
+        uint32_t x2 = counter[2];
+        uint32_t x3 = counter[3];
+        uint32_t k0 = key[0];
+        uint32_t k1 = key[1];
+
+        for (int round = 0; round < ROUNDS_COUNT; ++round)
+        {
+            uint64_t product0 = static_cast<uint64_t>(MULTIPLIER_0) * x0;
+            uint64_t product1 = static_cast<uint64_t>(MULTIPLIER_1) * x2;
+            uint32_t high0 = static_cast<uint32_t>(product0 >> 32);
+            uint32_t low0 = static_cast<uint32_t>(product0);
+            uint32_t high1 = static_cast<uint32_t>(product1 >> 32);
+            uint32_t low1 = static_cast<uint32_t>(product1);
+
+            x0 = high1 ^ x1 ^ k0;
+            x1 = low1;
+            x2 = high0 ^ x3 ^ k1;
+            x3 = low0;
+
+            k0 += KEY_INCREMENT_0;
+            k1 += KEY_INCREMENT_1;
+        }
+
+        words[0] = x0;
+        words[1] = x1;
+        words[2] = x2;
+        words[3] = x3;
+    }
+
+    void CounterBasedRandom::FillRandoms(uint64_t streamIndex, uint32_t blockIndex, FLOAT_TYPE* values) const
+    {
+        uint32_t counter[WORDS_PER_BLOCK] = {blockIndex, 0, static_cast<uint32_t>(streamIndex), static_cast<uint32_t>(streamIndex >> 32)};
+        uint32_t words[WORDS_PER_BLOCK];
+        FillRandomWords(counter, words);
+
+        // 53 random bits per value: 27 from the first word and 26 from the second one, as in the MT19937 genrand_res53
+        const FLOAT_TYPE scale = 1.0 / 9007199254740992.0; // 2^-53
+        for (int i = 0; i < VALUES_PER_BLOCK; ++i)
+        {
+            uint64_t high = words[2 * i] >> 5;
+            uint64_t low = words[2 * i + 1] >> 6;
+            values[i] = static_cast<FLOAT_TYPE>((high << 26) | low) * scale;
+        }
+    }
+}
@@ -37,4 +37,14 @@ namespace Core
     {
 
     }
+
+    TimeBudgetExpiredException::TimeBudgetExpiredException(std::string message) : Exception(message)
+    {
+
+    }
+
+    TimeBudgetExpiredException::~TimeBudgetExpiredException()
+    {
+
+    }
 }
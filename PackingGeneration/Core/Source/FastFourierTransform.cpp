@@ -0,0 +1,198 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/FastFourierTransform.h"
+
+#include <cmath>
+#include <algorithm>
+#include "../Headers/Constants.h"
+#include "../Headers/Exceptions.h"
+
+using namespace std;
+
+namespace Core
+{
+    FastFourierTransform::FastFourierTransform(int size)
+    {
+        if (size < 1)
+        {
+            throw InvalidOperationException("Fourier transform size should be positive.");
+        }
+
+        this->size = size;
+
+        // Factorize the size, radix 2 butterflies are the cheapest
+        int remainingSize = size;
+        int radix = 2;
+        maxRadix = 1;
+        while (remainingSize > 1)
+        {
+            while (remainingSize % radix != 0)
+            {
+                radix = (radix * radix > remainingSize) ? remainingSize : radix + 1;
+            }
+            remainingSize /= radix;
+            factors.push_back(radix);
+            factors.push_back(remainingSize);
+            maxRadix = std::max(maxRadix, radix);
+        }
+        if (size == 1)
+        {
+            factors.push_back(1);
+            factors.push_back(1);
+        }
+
+        forwardTwiddles.resize(size);
+        inverseTwiddles.resize(size);
+        for (int i = 0; i < size; ++i)
+        {
+            FLOAT_TYPE phase = 2.0 * PI * i / size;
+            forwardTwiddles[i] = complex<FLOAT_TYPE>(cos(phase), -sin(phase));
+            inverseTwiddles[i] = complex<FLOAT_TYPE>(cos(phase), sin(phase));
+        }
+    }
+
+    FastFourierTransform::~FastFourierTransform()
+    {
+    }
+
+    int FastFourierTransform::GetSize() const
+    {
+        return size;
+    }
+
+    void FastFourierTransform::Transform(const complex<FLOAT_TYPE>* input, int inputStride, complex<FLOAT_TYPE>* output, bool inverse) const
+    {
+        vector<complex<FLOAT_TYPE> > scratch(maxRadix);
+        const vector<complex<FLOAT_TYPE> >& twiddles = inverse ? inverseTwiddles : forwardTwiddles;
+        TransformRecursively(output, input, inputStride, 0, twiddles, &scratch[0]);
+    }
+
+    // Decimation in time: the transform of size p * m is assembled from p transforms of size m of the values with indexes congruent modulo p.
+    // inputStride is the distance between the inputs of the current subtransform, the same as the twiddle stride times the original stride.
+    void FastFourierTransform::TransformRecursively(complex<FLOAT_TYPE>* output, const complex<FLOAT_TYPE>* input, int inputStride, int factorIndex,
+            const vector<complex<FLOAT_TYPE> >& twiddles, complex<FLOAT_TYPE>* scratch) const
+    {
+        int radix = factors[factorIndex];
+        int subtransformSize = factors[factorIndex + 1];
+        int twiddleStride = size / (radix * subtransformSize);
+
+        if (subtransformSize == 1)
+        {
+            for (int i = 0; i < radix; ++i)
+            {
+                output[i] = input[i * inputStride];
+            }
+        }
+        else
+        {
+            for (int i = 0; i < radix; ++i)
+            {
+                TransformRecursively(output + i * subtransformSize, input + i * inputStride, inputStride * radix, factorIndex + 2, twiddles, scratch);
+            }
+        }
+
+        if (radix == 2)
+        {
+            ApplyRadix2Butterflies(output, twiddleStride, subtransformSize, twiddles);
+        }
+        else if (radix > 2)
+        {
+            ApplyGenericButterflies(output, twiddleStride, subtransformSize, radix, twiddles, scratch);
+        }
+    }
+
+    void FastFourierTransform::ApplyRadix2Butterflies(complex<FLOAT_TYPE>* output, int twiddleStride, int subtransformSize, const vector<complex<FLOAT_TYPE> >& twiddles) const
+    {
+        complex<FLOAT_TYPE>* secondOutput = output + subtransformSize;
+        for (int i = 0; i < subtransformSize; ++i)
+        {
+            complex<FLOAT_TYPE> rotatedValue = secondOutput[i] * twiddles[i * twiddleStride];
+            secondOutput[i] = output[i] - rotatedValue;
+            output[i] += rotatedValue;
+        }
+    }
+
+    void FastFourierTransform::ApplyGenericButterflies(complex<FLOAT_TYPE>* output, int twiddleStride, int subtransformSize, int radix,
+            const vector<complex<FLOAT_TYPE> >& twiddles, complex<FLOAT_TYPE>* scratch) const
+    {
+        for (int i = 0; i < subtransformSize; ++i)
+        {
+            for (int j = 0; j < radix; ++j)
+            {
+                scratch[j] = output[i + j * subtransformSize];
+            }
+
+            for (int j = 0; j < radix; ++j)
+            {
+                int outputIndex = i + j * subtransformSize;
+                int twiddleStep = twiddleStride * outputIndex; // less than size
+                int twiddleIndex = 0;
+                complex<FLOAT_TYPE> value = scratch[0];
+                for (int k = 1; k < radix; ++k)
+                {
+                    twiddleIndex += twiddleStep;
+                    if (twiddleIndex >= size)
+                    {
+                        twiddleIndex -= size;
+                    }
+                    value += scratch[k] * twiddles[twiddleIndex];
+                }
+                output[outputIndex] = value;
+            }
+        }
+    }
+
+    void FastFourierTransform::TransformMultidimensional(const DiscreteSpatialVector& sizes, vector<complex<FLOAT_TYPE> >* values, bool inverse)
+    {
+        vector<complex<FLOAT_TYPE> >& valuesRef = *values;
+        int totalSize = static_cast<int>(valuesRef.size());
+
+        int stride = 1;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            int lineSize = sizes[i];
+            FastFourierTransform transform(lineSize);
+            vector<complex<FLOAT_TYPE> > line(lineSize);
+
+            int linesCount = totalSize / lineSize;
+            for (int lineIndex = 0; lineIndex < linesCount; ++lineIndex)
+            {
+                int lowerIndex = lineIndex % stride;
+                int upperIndex = lineIndex / stride;
+                int lineStart = lowerIndex + upperIndex * stride * lineSize;
+
+                transform.Transform(&valuesRef[lineStart], stride, &line[0], inverse);
+                for (int j = 0; j < lineSize; ++j)
+                {
+                    valuesRef[lineStart + j * stride] = line[j];
+                }
+            }
+
+            stride *= lineSize;
+        }
+    }
+
+    int FastFourierTransform::GetNextFastSize(int minSize)
+    {
+        int fastSize = std::max(1, minSize);
+        while (true)
+        {
+            int remainder = fastSize;
+            const int smallPrimes[] = {2, 3, 5};
+            for (int i = 0; i < 3; ++i)
+            {
+                while (remainder % smallPrimes[i] == 0)
+                {
+                    remainder /= smallPrimes[i];
+                }
+            }
+            if (remainder == 1)
+            {
+                return fastSize;
+            }
+            fastSize++;
+        }
+    }
+}
@@ -3,6 +3,9 @@
 // See the accompanying file License.txt or http://opensource.org/licenses/MIT
 
 #include "../Headers/Math.h"
+
+#include <stdlib.h>
+#include <algorithm>
 #include "../Headers/VectorUtilities.h"
 #include "../Headers/StlUtilities.h"
 #include "../Headers/Constants.h"
@@ -11,8 +14,15 @@ using namespace std;
 
 namespace Core
 {
-    bool Math::spareReady = false;
-    FLOAT_TYPE Math::spare = 0;
+    thread_local bool Math::spareReady = false;
+    thread_local FLOAT_TYPE Math::spare = 0;
+#ifndef WINDOWS
+    // The same initial state as the one of drand48 without a seed
+    thread_local unsigned short Math::randomSeed[3] = {0, 0, 0};
+    thread_local bool Math::integerRandomReady = false;
+    thread_local random_data Math::integerRandomData;
+    thread_local char Math::integerRandomState[128];
+#endif
 
     bool Math::IsNumber(FLOAT_TYPE x)
     {
@@ -43,8 +53,14 @@ namespace Core
 #ifdef WINDOWS
         srand(seed);
 #else
-        srand48(seed);
+        // erand48 on this state produces the same sequence as drand48 after srand48(seed)
+        randomSeed[0] = 0x330E;
+        randomSeed[1] = static_cast<unsigned short>(seed & 0xFFFF);
+        randomSeed[2] = static_cast<unsigned short>((static_cast<unsigned int>(seed) >> 16) & 0xFFFF);
+        integerRandomReady = false;
 #endif
+        // Otherwise the first Gaussian value would be left from the previous sequence
+        spareReady = false;
     }
 
     FLOAT_TYPE Math::GetNextRandom()
@@ -52,8 +68,47 @@ namespace Core
 #ifdef WINDOWS
         return rand() / static_cast<FLOAT_TYPE>(RAND_MAX);
 #else
-        return drand48();
+        return erand48(randomSeed);
+#endif
+    }
+
+    int Math::GetNextRandomInteger()
+    {
+#ifdef WINDOWS
+        return rand();
+#else
+        if (!integerRandomReady)
+        {
+            // rand() uses the 128-byte state of random() seeded with 1 until srand is called
+            integerRandomData.state = NULL;
+            initstate_r(1, integerRandomState, sizeof(integerRandomState), &integerRandomData);
+            integerRandomReady = true;
+        }
+
+        int32_t value;
+        random_r(&integerRandomData, &value);
+        return value;
+#endif
+    }
+
+    void Math::FillRandomState(RandomState* state)
+    {
+#ifdef WINDOWS
+        state->seed[0] = state->seed[1] = state->seed[2] = 0;
+#else
+        std::copy(randomSeed, randomSeed + 3, state->seed);
+#endif
+        state->spareReady = spareReady;
+        state->spare = spare;
+    }
+
+    void Math::SetRandomState(const RandomState& state)
+    {
+#ifndef WINDOWS
+        std::copy(state.seed, state.seed + 3, randomSeed);
 #endif
+        spareReady = state.spareReady;
+        spare = state.spare;
     }
 
     // See http://en.wikipedia.org/wiki/Marsaglia_polar_method
@@ -149,6 +149,12 @@ namespace Core
         return result;
     }
 
+    int MpiManager::Broadcast(void* buffer, int count, MPI_Datatype dataType, int root)
+    {
+        CheckInitialization();
+        return MPI_Bcast(buffer, count, dataType, root, communicator);
+    }
+
     void MpiManager::CheckInitialization() const
     {
         if (!initialized)
@@ -256,6 +262,11 @@ namespace Core
         return 0;
     }
 
+    int MpiManager::Broadcast(void* buffer, int count, MPI_Datatype dataType, int root)
+    {
+        return 0;
+    }
+
     int MpiManager::Barrier()
     {
         return 0;
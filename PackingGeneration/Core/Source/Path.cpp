@@ -7,6 +7,7 @@
 #include <fcntl.h>   // open
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <algorithm>
 #include "Core/Headers/Macros.h"
 #include "Core/Headers/Constants.h"
 #include "Core/Headers/ScopedFile.h"
@@ -257,6 +258,71 @@ namespace Core
         closedir(directoryPointer);
     }
 
+    void Path::FillFileAndFolderNames(string basePath, vector<string>* fileNames, vector<string>* folderNames)
+    {
+        fileNames->clear();
+        folderNames->clear();
+
+        DIR* directoryPointer = opendir(basePath.c_str());
+        if (directoryPointer == NULL)
+        {
+            return;
+        }
+
+        struct dirent* entry;
+        struct stat status;
+        while ((entry = readdir(directoryPointer)) != NULL)
+        {
+            string entryName(entry->d_name);
+            if (entryName == "." || entryName == "..")
+            {
+                continue;
+            }
+
+            // Symbolic links and unknown types are resolved with stat, as in FillFileOrFolderNames
+            bool isFolder = (entry->d_type == DT_DIR);
+            bool isFile = (entry->d_type == DT_REG);
+            if (!isFolder && !isFile)
+            {
+                if (stat(Path::Append(basePath, entryName).c_str(), &status) == -1)
+                {
+                    continue;
+                }
+                isFolder = S_ISDIR(status.st_mode);
+            }
+
+            if (isFolder)
+            {
+                folderNames->push_back(entryName);
+            }
+            else
+            {
+                fileNames->push_back(entryName);
+            }
+        }
+
+        closedir(directoryPointer);
+    }
+
+    bool Path::TryGetModificationTime(string path, long long* modificationTime)
+    {
+        struct stat status;
+        if (stat(path.c_str(), &status) != 0)
+        {
+            return false;
+        }
+
+        const long long nanosecondsPerSecond = 1000000000LL;
+#if defined(WINDOWS)
+        *modificationTime = static_cast<long long>(status.st_mtime) * nanosecondsPerSecond;
+#elif defined(__APPLE__)
+        *modificationTime = static_cast<long long>(status.st_mtimespec.tv_sec) * nanosecondsPerSecond + status.st_mtimespec.tv_nsec;
+#else
+        *modificationTime = static_cast<long long>(status.st_mtim.tv_sec) * nanosecondsPerSecond + status.st_mtim.tv_nsec;
+#endif
+        return true;
+    }
+
     void Path::FillFoldersRecursively(string basePath, string fileNameToCheck, vector<string>* folderPaths)
     {
         folderPaths->clear();
@@ -266,7 +332,8 @@ namespace Core
     void Path::AddFoldersRecursively(string basePath, string fileNameToCheck, vector<string>* folderPaths)
     {
         vector<string> currentFolderFiles;
-        Path::FillFileNames(basePath, &currentFolderFiles);
+        vector<string> subfolders;
+        Path::FillFileAndFolderNames(basePath, &currentFolderFiles, &subfolders);
         for (vector<string>::iterator it = currentFolderFiles.begin(); it < currentFolderFiles.end(); ++it)
         {
             string fileName = *it;
@@ -277,8 +344,8 @@ namespace Core
             }
         }
 
-        vector<string> subfolders;
-        Path::FillFolderNames(basePath, &subfolders);
+        // The order of directory entries depends on the file system, while the task ids depend on the order of the folders
+        std::sort(subfolders.begin(), subfolders.end());
         for (vector<string>::iterator it = subfolders.begin(); it < subfolders.end(); ++it)
         {
             string subfolderName = *it;
@@ -0,0 +1,197 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/SphericalHarmonicsKernel.h"
+
+#include <cmath>
+#include <algorithm>
+#include "../Headers/Constants.h"
+#include "../Headers/Exceptions.h"
+
+using namespace std;
+
+namespace Core
+{
+    SphericalHarmonicsKernel::SphericalHarmonicsKernel(int maxL)
+    {
+        if (maxL < 0)
+        {
+            throw InvalidOperationException("maxL should not be negative");
+        }
+
+        this->maxL = maxL;
+        int valuesCount = GetValuesCount();
+
+        // See e.g. Limpanuparb, Milthorpe (2014) Associated Legendre polynomials and spherical harmonics computation for chemistry applications
+        diagonalFactors.resize(maxL + 1);
+        diagonalFactors[0] = sqrt(1.0 / (4.0 * PI));
+        for (int m = 1; m <= maxL; ++m)
+        {
+            diagonalFactors[m] = -sqrt((2.0 * m + 1.0) / (2.0 * m));
+        }
+
+        firstRecurrenceFactors.assign(valuesCount, 0.0);
+        secondRecurrenceFactors.assign(valuesCount, 0.0);
+        for (int l = 1; l <= maxL; ++l)
+        {
+            for (int m = 0; m < l; ++m)
+            {
+                int index = GetValueIndex(l, m);
+                firstRecurrenceFactors[index] = sqrt((4.0 * l * l - 1.0) / (static_cast<FLOAT_TYPE>(l) * l - static_cast<FLOAT_TYPE>(m) * m));
+                secondRecurrenceFactors[index] = sqrt((static_cast<FLOAT_TYPE>(l - 1) * (l - 1) - static_cast<FLOAT_TYPE>(m) * m) / (4.0 * (l - 1) * (l - 1) - 1.0));
+            }
+        }
+
+        wignerSymbols.resize(maxL + 1);
+        for (int l = 0; l <= maxL; ++l)
+        {
+            int mCount = 2 * l + 1;
+            wignerSymbols[l].assign(mCount * mCount, 0.0);
+            for (int m1 = -l; m1 <= l; ++m1)
+            {
+                for (int m2 = -l; m2 <= l; ++m2)
+                {
+                    if (std::abs(m1 + m2) <= l)
+                    {
+                        wignerSymbols[l][(m1 + l) * mCount + m2 + l] = GetWignerSymbol(l, m1, m2);
+                    }
+                }
+            }
+        }
+    }
+
+    SphericalHarmonicsKernel::~SphericalHarmonicsKernel()
+    {
+    }
+
+    int SphericalHarmonicsKernel::GetMaxL() const
+    {
+        return maxL;
+    }
+
+    int SphericalHarmonicsKernel::GetValuesCount() const
+    {
+        return (maxL + 1) * (maxL + 2) / 2;
+    }
+
+    int SphericalHarmonicsKernel::GetValueIndex(int l, int m)
+    {
+        return l * (l + 1) / 2 + m;
+    }
+
+    void SphericalHarmonicsKernel::AddSphericalHarmonicValues(const SpatialVector& direction, complex<FLOAT_TYPE>* values) const
+    {
+        FLOAT_TYPE z = direction[2];
+        complex<FLOAT_TYPE> xy(direction[0], direction[1]);
+        complex<FLOAT_TYPE> xyPower(1.0, 0.0); // (x + i y)^m = sin(theta)^m (cos(m phi) + i sin(m phi))
+
+        FLOAT_TYPE diagonalValue = 1.0;
+        for (int m = 0; m <= maxL; ++m)
+        {
+            diagonalValue *= diagonalFactors[m];
+
+            // Q_mm, Q_(m+1)m, and then the recurrence in l
+            FLOAT_TYPE previousValue = 0.0;
+            FLOAT_TYPE value = diagonalValue;
+            values[GetValueIndex(m, m)] += value * xyPower;
+            for (int l = m + 1; l <= maxL; ++l)
+            {
+                int index = GetValueIndex(l, m);
+                FLOAT_TYPE nextValue = firstRecurrenceFactors[index] * (z * value - secondRecurrenceFactors[index] * previousValue);
+                previousValue = value;
+                value = nextValue;
+                values[index] += value * xyPower;
+            }
+
+            xyPower *= xy;
+        }
+    }
+
+    FLOAT_TYPE SphericalHarmonicsKernel::GetSquaresSum(const complex<FLOAT_TYPE>* values, int l)
+    {
+        const complex<FLOAT_TYPE>* lValues = &values[GetValueIndex(l, 0)];
+        FLOAT_TYPE squaresSum = 0.0;
+        for (int m = 1; m <= l; ++m)
+        {
+            squaresSum += norm(lValues[m]);
+        }
+        return norm(lValues[0]) + 2.0 * squaresSum;
+    }
+
+    FLOAT_TYPE SphericalHarmonicsKernel::GetOrder(const complex<FLOAT_TYPE>* values, int l, int count)
+    {
+        FLOAT_TYPE squaresSum = GetSquaresSum(values, l) / (static_cast<FLOAT_TYPE>(count) * count);
+        return sqrt(4.0 * PI / (2.0 * l + 1.0) * squaresSum);
+    }
+
+    FLOAT_TYPE SphericalHarmonicsKernel::GetWignerOrder(const complex<FLOAT_TYPE>* values, int l) const
+    {
+        FLOAT_TYPE squaresSum = GetSquaresSum(values, l);
+        if (squaresSum == 0.0)
+        {
+            return 0.0;
+        }
+
+        const vector<FLOAT_TYPE>& lWignerSymbols = wignerSymbols[l];
+        int mCount = 2 * l + 1;
+        FLOAT_TYPE invariant = 0.0;
+        for (int m1 = -l; m1 <= l; ++m1)
+        {
+            complex<FLOAT_TYPE> firstValue = GetValue(values, l, m1);
+            for (int m2 = std::max(-l, -l - m1); m2 <= std::min(l, l - m1); ++m2)
+            {
+                int m3 = -m1 - m2;
+                complex<FLOAT_TYPE> product = firstValue * GetValue(values, l, m2) * GetValue(values, l, m3);
+                // The invariant is real, the imaginary parts cancel out
+                invariant += lWignerSymbols[(m1 + l) * mCount + m2 + l] * product.real();
+            }
+        }
+
+        return invariant / pow(squaresSum, 1.5);
+    }
+
+    complex<FLOAT_TYPE> SphericalHarmonicsKernel::GetValue(const complex<FLOAT_TYPE>* values, int l, int m)
+    {
+        if (m >= 0)
+        {
+            return values[GetValueIndex(l, m)];
+        }
+
+        complex<FLOAT_TYPE> value = conj(values[GetValueIndex(l, -m)]);
+        return (m % 2 == 0) ? value : -value;
+    }
+
+    FLOAT_TYPE SphericalHarmonicsKernel::GetWignerSymbol(int l, int m1, int m2)
+    {
+        int m3 = -m1 - m2;
+        if (std::abs(m1) > l || std::abs(m2) > l || std::abs(m3) > l)
+        {
+            return 0.0;
+        }
+
+        // Factorials are exact in double precision up to 22!, and are accurate to the machine precision up to 170!, i.e. l up to 56
+        vector<FLOAT_TYPE> factorials(3 * l + 2);
+        factorials[0] = 1.0;
+        for (size_t i = 1; i < factorials.size(); ++i)
+        {
+            factorials[i] = factorials[i - 1] * i;
+        }
+
+        // Racah formula for j1 = j2 = j3 = l
+        FLOAT_TYPE triangleFactor = factorials[l] * factorials[l] * factorials[l] / factorials[3 * l + 1];
+        FLOAT_TYPE projectionsFactor = factorials[l + m1] * factorials[l - m1] * factorials[l + m2] * factorials[l - m2] * factorials[l + m3] * factorials[l - m3];
+
+        int minK = std::max(0, std::max(-m1, m2));
+        int maxK = std::min(l, std::min(l - m1, l + m2));
+        FLOAT_TYPE sum = 0.0;
+        for (int k = minK; k <= maxK; ++k)
+        {
+            FLOAT_TYPE denominator = factorials[k] * factorials[k + m1] * factorials[k - m2] * factorials[l - k] * factorials[l - k - m1] * factorials[l - k + m2];
+            sum += ((k % 2 == 0) ? 1.0 : -1.0) / denominator;
+        }
+
+        FLOAT_TYPE sign = (m3 % 2 == 0) ? 1.0 : -1.0; // (-1)^(j1 - j2 - m3)
+        return sign * sqrt(triangleFactor * projectionsFactor) * sum;
+    }
+}
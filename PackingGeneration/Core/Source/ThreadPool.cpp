@@ -0,0 +1,142 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/ThreadPool.h"
+#include "../Headers/IParallelTask.h"
+
+using namespace std;
+
+namespace Core
+{
+    ThreadPool::ThreadPool(int threadsCount)
+    {
+        task = NULL;
+        partsCount = 0;
+        nextPartIndex = 0;
+        unfinishedPartsCount = 0;
+        taskNumber = 0;
+        shouldStop = false;
+
+        if (threadsCount <= 0)
+        {
+            threadsCount = GetHardwareThreadsCount();
+        }
+
+        for (int i = 0; i < threadsCount - 1; ++i)
+        {
+            threads.push_back(thread(&ThreadPool::RunWorker, this));
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            unique_lock<std::mutex> lock(mutex);
+            shouldStop = true;
+        }
+        taskStarted.notify_all();
+
+        for (size_t i = 0; i < threads.size(); ++i)
+        {
+            threads[i].join();
+        }
+    }
+
+    int ThreadPool::GetThreadsCount() const
+    {
+        return threads.size() + 1;
+    }
+
+    int ThreadPool::GetHardwareThreadsCount()
+    {
+        int hardwareThreadsCount = thread::hardware_concurrency();
+        return (hardwareThreadsCount > 0) ? hardwareThreadsCount : 1;
+    }
+
+    void ThreadPool::Execute(IParallelTask* task, int partsCount)
+    {
+        if (partsCount <= 0)
+        {
+            return;
+        }
+
+        unique_lock<std::mutex> lock(mutex);
+        this->task = task;
+        this->partsCount = partsCount;
+        nextPartIndex = 0;
+        unfinishedPartsCount = partsCount;
+        error = exception_ptr();
+        taskNumber++;
+        taskStarted.notify_all();
+
+        ExecuteParts(&lock);
+        while (unfinishedPartsCount > 0)
+        {
+            taskFinished.wait(lock);
+        }
+
+        this->task = NULL;
+        exception_ptr taskError = error;
+        error = exception_ptr();
+        lock.unlock();
+
+        if (taskError)
+        {
+            rethrow_exception(taskError);
+        }
+    }
+
+    void ThreadPool::RunWorker()
+    {
+        int lastTaskNumber = 0;
+        unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            while (!shouldStop && taskNumber == lastTaskNumber)
+            {
+                taskStarted.wait(lock);
+            }
+            if (shouldStop)
+            {
+                return;
+            }
+
+            lastTaskNumber = taskNumber;
+            ExecuteParts(&lock);
+        }
+    }
+
+    void ThreadPool::ExecuteParts(unique_lock<std::mutex>* lock)
+    {
+        // Parts are coarse (e.g. the force parts of EnergyService, the particle ranges of OrderService or the sample ranges of InsertionRadiiSampler), so they are simply taken one by one under the lock
+        while (nextPartIndex < partsCount)
+        {
+            int partIndex = nextPartIndex;
+            nextPartIndex++;
+
+            lock->unlock();
+            exception_ptr partError;
+            try
+            {
+                task->Execute(partIndex);
+            }
+            catch (...)
+            {
+                partError = current_exception();
+            }
+            lock->lock();
+
+            if (partError && !error)
+            {
+                error = partError;
+            }
+
+            unfinishedPartsCount--;
+            if (unfinishedPartsCount == 0)
+            {
+                taskFinished.notify_all();
+            }
+        }
+    }
+}
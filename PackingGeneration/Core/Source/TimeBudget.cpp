@@ -0,0 +1,50 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/TimeBudget.h"
+
+using namespace std;
+
+namespace Core
+{
+    TimeBudget* TimeBudget::instance = new TimeBudget();
+
+    TimeBudget::TimeBudget()
+    {
+        isLimited = false;
+    }
+
+    TimeBudget* TimeBudget::GetInstance()
+    {
+        return instance;
+    }
+
+    void TimeBudget::Start(FLOAT_TYPE budgetSeconds)
+    {
+        isLimited = budgetSeconds > 0;
+        if (isLimited)
+        {
+            chrono::steady_clock::duration budget = chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<FLOAT_TYPE>(budgetSeconds));
+            deadline = chrono::steady_clock::now() + budget;
+        }
+    }
+
+    bool TimeBudget::IsLimited() const
+    {
+        return isLimited;
+    }
+
+    bool TimeBudget::IsExpired() const
+    {
+        return isLimited && chrono::steady_clock::now() >= deadline;
+    }
+
+    void TimeBudget::ThrowIfExpired() const
+    {
+        if (IsExpired())
+        {
+            throw TimeBudgetExpiredException("The time budget has expired.");
+        }
+    }
+}
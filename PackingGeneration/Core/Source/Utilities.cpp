@@ -6,6 +6,7 @@
 #include "../Headers/Exceptions.h"
 #include <errno.h>
 #include <climits>
+#include <cfloat>
 #include <cstdlib>
 
 #ifndef WINDOWS
@@ -58,5 +59,22 @@ namespace Core
         }
         return result;
     }
+
+    FLOAT_TYPE Utilities::ParseFloat(const string& input)
+    {
+        char* end;
+        double result;
+        errno = 0;
+        result = strtod(input.c_str(), &end);
+        if (errno == ERANGE)
+        {
+            throw InvalidOperationException("Out of range");
+        }
+        if (input.size() == 0 || *end != '\0' || result != result || result > DBL_MAX || result < -DBL_MAX)
+        {
+            throw InvalidOperationException("Inconvertible");
+        }
+        return result;
+    }
 }
 
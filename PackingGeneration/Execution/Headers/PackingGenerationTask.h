@@ -9,6 +9,7 @@
 #include "Core/Headers/StlUtilities.h"
 #include "Parallelism/Headers/ITask.h"
 #include "Generation/Model/Headers/Config.h"
+#include "Generation/PackingGenerators/LubachevsckyStillinger/Headers/Types.h"
 namespace Generation { class GenerationManager; }
 namespace PackingGenerators { class IPackingStep; }
 namespace PackingServices { class GeometryService; }
@@ -31,6 +32,19 @@ namespace Execution
     public:
         Model::ExecutionConfig userConfig;
 
+        // The number of threads used by the services of the task. If not positive, the number of hardware threads is used (the default).
+        // Shall be reduced when several tasks are executed concurrently.
+        int threadsCount;
+
+        // The events queue of the Lubachevsky-Stillinger steps of generation and equilibration. The key heap by default.
+        PackingGenerators::EventsQueueType::Type eventsQueueType;
+
+        // If true (by default), the Verlet skin of the Lubachevsky-Stillinger generation is tuned (see LubachevsckyStillingerStep::tuneVerletSkin).
+        bool tuneVerletSkin;
+
+        // The estimated execution time in seconds (see TaskCostEstimator). One by default.
+        Core::FLOAT_TYPE weight;
+
     public:
         explicit PackingGenerationTask(std::string baseFolder, int id);
 
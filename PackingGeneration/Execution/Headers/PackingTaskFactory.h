@@ -8,6 +8,7 @@
 #include <string>
 #include "Parallelism/Headers/ITaskFactory.h"
 #include "Generation/Model/Headers/Config.h"
+#include "Generation/PackingGenerators/LubachevsckyStillinger/Headers/Types.h"
 
 namespace Execution
 {
@@ -19,6 +20,13 @@ namespace Execution
         std::vector<std::string> consoleArguments;
 
         Model::ExecutionConfig userConfig;
+        int concurrentTasksCount;
+        Core::FLOAT_TYPE timeBudget;
+        // If true (the -index option), the folders are found with WorkingFolderIndex instead of a directory walk by each process
+        bool useFolderIndex;
+        PackingGenerators::EventsQueueType::Type eventsQueueType;
+        // If false (the -fixedskin option), the Verlet skin of the Lubachevsky-Stillinger generation is not tuned
+        bool tuneVerletSkin;
 
     public:
         PackingTaskFactory(std::string baseFolder, int argc, char **argv);
@@ -27,9 +35,18 @@ namespace Execution
 
         OVERRIDE void FillTasks(std::vector<boost::shared_ptr<Parallelism::ITask> >* tasks);
 
+        // Returns the number of tasks to be executed concurrently by threads of a single process (the -tasks option). One by default; if not positive, the number of hardware threads.
+        int GetConcurrentTasksCount() const;
+
+        // Returns the wall-clock time budget of the run in seconds (the -budget option). Zero (unlimited) by default.
+        Core::FLOAT_TYPE GetTimeBudget() const;
+
     private:
         void ParseConsoleArguments(int argc, char **argv);
 
+        // Parses the name of the events queue of the Lubachevsky-Stillinger algorithms (the -queue option).
+        static PackingGenerators::EventsQueueType::Type ParseEventsQueueType(const std::string& name);
+
         void FillGenerationConfig();
 
         void ParseGenerationArguments(Model::GenerationConfig* generationConfig);
@@ -38,6 +55,9 @@ namespace Execution
 
         void FillConfigFolders(std::vector<std::string>* configFolders) const;
 
+        // The hardware threads are split between the tasks executed concurrently.
+        int GetTaskThreadsCount(int tasksCount) const;
+
         DISALLOW_COPY_AND_ASSIGN(PackingTaskFactory);
     };
 }
@@ -0,0 +1,62 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Execution_Headers_TaskCostEstimator_h
+#define Execution_Headers_TaskCostEstimator_h
+
+#include <string>
+#include <vector>
+#include "Core/Headers/Macros.h"
+#include "Core/Headers/Types.h"
+#include "Generation/Model/Headers/Config.h"
+
+namespace Execution
+{
+    // Estimates execution times of packing tasks, so that the longest tasks can be started first.
+    // The model cost grows as N log(N) with the particles count N (as for the neighbor search), with a factor per algorithm and execution mode.
+    // The execution time of each finished task is recorded in its folder; a recorded time for the same execution mode (and algorithm) replaces the model cost
+    // and is used to calibrate the model costs of the other tasks.
+    class TaskCostEstimator
+    {
+    private:
+        struct ExecutionTimeRecord
+        {
+            int particlesCount;
+            Core::FLOAT_TYPE executionTime;
+        };
+
+    public:
+        TaskCostEstimator();
+
+        // Fills the estimated execution times in seconds for the folders. The generationConfig holds the execution mode and algorithm common to all the folders.
+        void FillCosts(const Model::GenerationConfig& generationConfig, const std::vector<std::string>& folders, std::vector<Core::FLOAT_TYPE>* costs) const;
+
+        // Returns the model cost in seconds, without calibration. The absolute values are crude estimates.
+        Core::FLOAT_TYPE GetModelCost(const Model::GenerationConfig& generationConfig, int particlesCount) const;
+
+        // Returns true if the task in generationConfig.baseFolder does nothing, as the packing is already generated.
+        bool IsTaskFinished(const Model::GenerationConfig& generationConfig) const;
+
+        // Appends the execution time of the task in generationConfig.baseFolder to the execution times file. Write errors are only logged.
+        void RecordExecutionTime(const Model::GenerationConfig& generationConfig, Core::FLOAT_TYPE executionTime) const;
+
+        ~TaskCostEstimator();
+
+    private:
+        // Returns -1 if the config file is missing.
+        int ReadParticlesCount(const std::string& folder) const;
+
+        // Reads the latest record for the same execution mode (and algorithm, for packing generation).
+        bool TryReadExecutionTime(const Model::GenerationConfig& generationConfig, const std::string& folder, ExecutionTimeRecord* record) const;
+
+        // Returns the recorded time, rescaled with the model, if the particles count has changed since the record.
+        Core::FLOAT_TYPE GetRecordedCost(const Model::GenerationConfig& generationConfig, const ExecutionTimeRecord& record, int particlesCount) const;
+
+        Core::FLOAT_TYPE GetAlgorithmFactor(Model::PackingGenerationAlgorithm::Type generationAlgorithm) const;
+
+        DISALLOW_COPY_AND_ASSIGN(TaskCostEstimator);
+    };
+}
+
+#endif /* Execution_Headers_TaskCostEstimator_h */
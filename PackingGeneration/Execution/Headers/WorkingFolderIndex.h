@@ -0,0 +1,115 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Execution_Headers_WorkingFolderIndex_h
+#define Execution_Headers_WorkingFolderIndex_h
+
+#include <string>
+#include <vector>
+#include <map>
+#include "Core/Headers/Macros.h"
+#include "Core/Headers/IParallelTask.h"
+
+namespace Execution
+{
+    // Discovers the packing folders under the base folder and keeps them in a binary index file with their completion state (whether the packing info exists).
+    // Only one process lists the folders (with several threads, level by level), and broadcasts the index to the other MPI processes.
+    // On the next launch a folder is not listed again, if its modification time has not changed (creating or deleting a file, e.g. the packing info, changes it).
+    // The folders modified shortly before the previous scan are listed again, as the modification time may be too coarse to notice a change.
+    // The folders are ordered as in Path::FillFoldersRecursively.
+    class WorkingFolderIndex : public virtual Core::IParallelTask
+    {
+    private:
+        struct FolderState
+        {
+            long long modificationTime;
+            bool hasConfig;
+            bool hasInfo;
+            std::vector<std::string> subfolderNames;
+        };
+
+        struct FolderScan
+        {
+            std::string relativePath;
+            bool exists;
+            bool isReused;
+            FolderState state;
+            std::vector<int> subfolderScanIndexes;
+        };
+
+    public:
+        // The number of threads listing the folders. Listing mostly waits for the file server, so more threads than cores may be useful. By default, the number of hardware threads.
+        int threadsCount;
+
+    private:
+        std::string baseFolder;
+
+        // Folders in the order of the depth-first search, with paths relative to the base folder (the base folder itself is an empty path)
+        std::vector<std::string> relativePaths;
+        std::map<std::string, FolderState> folderStates;
+        long long scanStartTime;
+
+        // Working variables of the scan
+        std::map<std::string, FolderState> previousFolderStates;
+        long long previousScanStartTime;
+        std::vector<FolderScan> scans;
+        int firstLevelScanIndex;
+
+        static const int FORMAT_VERSION = 1;
+        // In nanoseconds. Is larger than the modification time precision of the common file systems.
+        static const long long MODIFICATION_TIME_PRECISION = 2000000000LL;
+
+    public:
+        explicit WorkingFolderIndex(std::string baseFolder);
+
+        // Updates the index file in a single-process environment or on the master, and broadcasts the index to the other processes. Shall be called by all the processes.
+        void Update();
+
+        // Fills the folders that contain the config file.
+        void FillConfigFolders(std::vector<std::string>* folderPaths) const;
+
+        // Fills the folders that contain the packing info, i.e. with generated packings.
+        void FillFinishedFolders(std::vector<std::string>* folderPaths) const;
+
+        // Lists a single folder of the current scan level.
+        OVERRIDE void Execute(int partIndex);
+
+        virtual ~WorkingFolderIndex();
+
+    private:
+        void Scan();
+
+        void AddScannedFolders(int scanIndex);
+
+        // Returns the modification time of a temporary file, so that the scan start is measured by the clock of the file system.
+        long long GetFileSystemTime(std::string temporaryFilePath) const;
+
+        void FillFolders(bool requireInfo, std::vector<std::string>* folderPaths) const;
+
+        void Serialize(std::vector<char>* buffer) const;
+
+        // Returns false if the buffer is not a valid index.
+        bool Deserialize(const std::vector<char>& buffer);
+
+        // Keeps the previous index for the scan. A missing or invalid index file is ignored.
+        void ReadPreviousIndex();
+
+        // Write errors are only logged, as the index only speeds up the next launch.
+        void WriteIndex(const std::vector<char>& buffer) const;
+
+        // Sends the serialized index from the master to the other processes, which deserialize it.
+        void Broadcast(std::vector<char>* buffer);
+
+        static void AppendBytes(const void* value, size_t size, std::vector<char>* buffer);
+
+        // Returns false if the buffer ends before size bytes are read.
+        static bool ReadBytes(const std::vector<char>& buffer, size_t* offset, void* value, size_t size);
+
+        std::string GetIndexFilePath() const;
+
+        DISALLOW_COPY_AND_ASSIGN(WorkingFolderIndex);
+    };
+}
+
+#endif /* Execution_Headers_WorkingFolderIndex_h */
@@ -4,6 +4,9 @@
 
 #include "../Headers/PackingGenerationTask.h"
 
+#include <chrono>
+#include "../Headers/TaskCostEstimator.h"
+
 #include "Generation/GenerationManager.h"
 #include "Core/Headers/EndiannessProvider.h"
 
@@ -12,7 +15,7 @@
 #include "Generation/PackingServices/Headers/GeometryService.h"
 #include "Generation/PackingServices/Headers/ImmobileParticlesService.h"
 #include "Generation/PackingServices/DistanceServices/Headers/VerletListNeighborProvider.h"
-#include "Generation/PackingServices/DistanceServices/Headers/CellListNeighborProvider.h"
+#include "Generation/PackingServices/DistanceServices/Headers/HierarchicalCellListNeighborProvider.h"
 #include "Generation/PackingServices/DistanceServices/Headers/ClosestPairProvider.h"
 #include "Generation/PackingServices/DistanceServices/Headers/NaiveNeighborProvider.h"
 #include "Generation/PackingServices/DistanceServices/Headers/DistanceService.h"
@@ -22,7 +25,10 @@
 #include "Generation/PackingServices/PostProcessing/Headers/MolecularDynamicsService.h"
 #include "Generation/PackingServices/PostProcessing/Headers/PressureService.h"
 #include "Generation/PackingServices/PostProcessing/Headers/InsertionRadiiGenerator.h"
+#include "Generation/PackingServices/PostProcessing/Headers/InsertionRadiiSampler.h"
 #include "Generation/PackingServices/PostProcessing/Headers/HessianService.h"
+#include "Generation/PackingServices/PostProcessing/Headers/PairCorrelationService.h"
+#include "Generation/PackingServices/PostProcessing/Headers/GriddedStructureFactorService.h"
 #include "Generation/PackingGenerators/Headers/PackingGenerator.h"
 
 // Energy  minimization steps
@@ -57,6 +63,10 @@ namespace Execution
     {
         userConfig.generationConfig.baseFolder = baseFolder;
         this->id = id;
+        threadsCount = 0;
+        eventsQueueType = EventsQueueType::KeyHeap;
+        tuneVerletSkin = true;
+        weight = 1.0;
     }
 
     PackingGenerationTask::~PackingGenerationTask()
@@ -65,7 +75,7 @@ namespace Execution
 
     FLOAT_TYPE PackingGenerationTask::GetWeight() const
     {
-        return 1.0;
+        return weight;
     }
 
     int PackingGenerationTask::GetId() const
@@ -84,22 +94,30 @@ namespace Execution
         MathService mathService;
         GeometryCollisionService geometryCollisionService;
         GeometryService geometryService(&mathService);
-        CellListNeighborProvider baseNeighborProvider(&geometryService, &geometryCollisionService);
+        // Reduces to a usual cell list for monodisperse packings, but scans much fewer irrelevant neighbors for polydisperse ones
+        HierarchicalCellListNeighborProvider baseNeighborProvider(&geometryService, &geometryCollisionService);
         VerletListNeighborProvider neighborProvider(&geometryService, &mathService, &baseNeighborProvider, &geometryCollisionService);
 //        NaiveNeighborProvider neighborProvider;
 
         ClosestPairProvider closestPairProvider(&mathService, &neighborProvider); // performance leak
         DistanceService distanceService(&mathService, &geometryService, &neighborProvider);
+        distanceService.threadsCount = threadsCount;
         EnergyService generationEnergyService(&mathService, &neighborProvider);
+        generationEnergyService.threadsCount = threadsCount;
 //        EnergyService contractionEnergyService(&mathService, &neighborProvider);
         RattlerRemovalService rattlerRemovalServiceForEnergy(&mathService, &neighborProvider);
         NoRattlersEnergyService contractionEnergyService(&mathService, &neighborProvider, &rattlerRemovalServiceForEnergy);
         LubachevsckyStillingerStep lubachevsckyStillingerStep(&geometryService, &neighborProvider, &distanceService, &mathService, &packingSerializer, &contractionEnergyService);
+        lubachevsckyStillingerStep.eventsQueueType = eventsQueueType;
 
         // Post-processing services
         OrderService orderService(&mathService, &neighborProvider);
+        orderService.threadsCount = threadsCount;
         PressureService pressureService(&mathService, &neighborProvider);
-        InsertionRadiiGenerator insertionRadiiGenerator(&distanceService, &geometryService);
+        InsertionRadiiSampler insertionRadiiSampler(&mathService, threadsCount);
+        InsertionRadiiGenerator insertionRadiiGenerator(&distanceService, &geometryService, &insertionRadiiSampler);
+        PairCorrelationService pairCorrelationService(&mathService, &geometryService, threadsCount);
+        GriddedStructureFactorService griddedStructureFactorService;
         MolecularDynamicsService molecularDynamicsService(&mathService, &geometryService, &lubachevsckyStillingerStep, &packingSerializer);
         RattlerRemovalService rattlerRemovalService(&mathService, &neighborProvider);
         HessianService hessianService(&mathService, &neighborProvider, &rattlerRemovalService);
@@ -126,12 +144,17 @@ namespace Execution
                 &harmonicPotential,
                 &packingSerializer);
 
-        PackingGenerator generator(&packingSerializer, &geometryService, &mathService, packingStep.get());
+        PackingGenerator generator(&packingSerializer, &geometryService, &mathService, packingStep.get(), threadsCount);
+        // The step with the tuned skin rebuilds the Verlet lists itself before the expected outer diameter ratio is exceeded
+        boost::shared_ptr<LubachevsckyStillingerStep> lubachevsckyStillingerGenerationStep = boost::dynamic_pointer_cast<LubachevsckyStillingerStep>(packingStep);
+        generator.checkOuterDiameterRatio = lubachevsckyStillingerGenerationStep == NULL || !lubachevsckyStillingerGenerationStep->tuneVerletSkin;
 
         GenerationManager generationManager(&packingSerializer,
                 &generator,
                 &insertionRadiiGenerator,
                 &distanceService,
+                &pairCorrelationService,
+                &griddedStructureFactorService,
                 &orderService,
                 &contractionEnergyService,
                 &hessianService,
@@ -140,7 +163,18 @@ namespace Execution
                 &rattlerRemovalService,
                 &immobileParticlesService);
 
+        // The wall time is recorded, as concurrent tasks share the processor time of the process
+        TaskCostEstimator costEstimator;
+        bool taskFinished = costEstimator.IsTaskFinished(userConfig.generationConfig);
+        chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+
         CallCorrectMethod(&generationManager);
+
+        if (!taskFinished)
+        {
+            chrono::duration<FLOAT_TYPE> executionTime = chrono::steady_clock::now() - startTime;
+            costEstimator.RecordExecutionTime(userConfig.generationConfig, executionTime.count());
+        }
     }
 
     boost::shared_ptr<IPackingStep> PackingGenerationTask::CreatePackingStep(GeometryService* geometryService,
@@ -164,7 +198,13 @@ namespace Execution
                 generationConfig.generationAlgorithm == PackingGenerationAlgorithm::LubachevskyStillingerConstantPower ||
                 generationConfig.generationAlgorithm == PackingGenerationAlgorithm::LubachevskyStillingerBiazzo)
         {
-            packingStep.reset(new LubachevsckyStillingerStep(geometryService, neighborProvider, distanceService, mathService, packingSerializer, contractionEnergyService));
+            boost::shared_ptr<LubachevsckyStillingerStep> lubachevsckyStillingerStep(new LubachevsckyStillingerStep(geometryService, neighborProvider, distanceService, mathService, packingSerializer, contractionEnergyService));
+            // The skin optimal for dilute packings is too large near jamming, and the fixed expected outer diameter ratio is exceeded for dense packings
+            lubachevsckyStillingerStep->tuneVerletSkin = tuneVerletSkin;
+            lubachevsckyStillingerStep->writeCheckpoints = true;
+            lubachevsckyStillingerStep->threadsCount = threadsCount;
+            lubachevsckyStillingerStep->eventsQueueType = eventsQueueType;
+            packingStep = lubachevsckyStillingerStep;
         }
         else if (generationConfig.generationAlgorithm == PackingGenerationAlgorithm::ForceBiasedAlgorithm)
         {
@@ -5,9 +5,15 @@
 #include "../Headers/PackingTaskFactory.h"
 
 #include <cstring>
+#include <algorithm>
 #include "Core/Headers/Path.h"
 #include "Core/Headers/Utilities.h"
+#include "Core/Headers/Exceptions.h"
+#include "Core/Headers/MpiManager.h"
+#include "Core/Headers/ThreadPool.h"
 #include "../Headers/PackingGenerationTask.h"
+#include "../Headers/TaskCostEstimator.h"
+#include "../Headers/WorkingFolderIndex.h"
 #include "Generation/Constants.h"
 
 using namespace std;
@@ -15,12 +21,18 @@ using namespace Parallelism;
 using namespace Model;
 using namespace Core;
 using namespace Generation;
+using namespace PackingGenerators;
 
 namespace Execution
 {
     PackingTaskFactory::PackingTaskFactory(string baseFolder, int argc, char **argv)
     {
         this->baseFolder = baseFolder;
+        concurrentTasksCount = 1;
+        timeBudget = 0.0;
+        useFolderIndex = false;
+        eventsQueueType = EventsQueueType::KeyHeap;
+        tuneVerletSkin = true;
         ParseConsoleArguments(argc, argv);
     }
 
@@ -34,10 +46,69 @@ namespace Execution
         consoleArguments.reserve(argc - 1);
         for (int i = 1; i < argc; ++i)
         {
-            consoleArguments.push_back(argv[i]);
+            string argument = argv[i];
+            // The options may be combined with any execution mode, so they are removed from the positional arguments
+            if (argument == "-tasks" && i + 1 < argc)
+            {
+                concurrentTasksCount = Utilities::ParseInt(argv[i + 1]);
+                i++;
+            }
+            else if (argument == "-budget" && i + 1 < argc)
+            {
+                timeBudget = Utilities::ParseFloat(argv[i + 1]);
+                if (timeBudget <= 0.0)
+                {
+                    throw InvalidOperationException("The time budget shall be a positive number of seconds.");
+                }
+                i++;
+            }
+            else if (argument == "-queue" && i + 1 < argc)
+            {
+                eventsQueueType = ParseEventsQueueType(argv[i + 1]);
+                i++;
+            }
+            else if (argument == "-index")
+            {
+                useFolderIndex = true;
+            }
+            else if (argument == "-fixedskin")
+            {
+                tuneVerletSkin = false;
+            }
+            else
+            {
+                consoleArguments.push_back(argument);
+            }
         }
     }
 
+    EventsQueueType::Type PackingTaskFactory::ParseEventsQueueType(const string& name)
+    {
+        if (name == "heap")
+        {
+            return EventsQueueType::BinaryHeap;
+        }
+        if (name == "calendar")
+        {
+            return EventsQueueType::Calendar;
+        }
+        if (name == "keyheap")
+        {
+            return EventsQueueType::KeyHeap;
+        }
+        throw InvalidOperationException("Unknown events queue. Use heap, calendar or keyheap.");
+    }
+
+    int PackingTaskFactory::GetConcurrentTasksCount() const
+    {
+        return concurrentTasksCount;
+    }
+
+    FLOAT_TYPE PackingTaskFactory::GetTimeBudget() const
+    {
+        return timeBudget;
+    }
+
     PackingTaskFactory::~PackingTaskFactory()
     {
     }
@@ -51,6 +122,16 @@ namespace Execution
         FillConfigFolders(&configFolders);
 
         tasks->reserve(configFolders.size());
+        int taskThreadsCount = GetTaskThreadsCount(configFolders.size());
+
+        // Only the master orders the tasks, so the workers do not read the folders
+        vector<FLOAT_TYPE> costs(configFolders.size(), 1.0);
+        MpiManager* mpiManager = MpiManager::GetInstance();
+        if (!mpiManager->IsParallel() || mpiManager->IsMaster())
+        {
+            TaskCostEstimator costEstimator;
+            costEstimator.FillCosts(userConfig.generationConfig, configFolders, &costs);
+        }
 
         // For each config create a task
         int id = 0;
@@ -65,6 +146,10 @@ namespace Execution
             boost::shared_ptr<ITask> task(new PackingGenerationTask(currentFolder, id));
             boost::shared_ptr<PackingGenerationTask> packingGenerationTask = boost::dynamic_pointer_cast<PackingGenerationTask, ITask>(task);
             packingGenerationTask->userConfig.MergeWith(userConfig);
+            packingGenerationTask->threadsCount = taskThreadsCount;
+            packingGenerationTask->eventsQueueType = eventsQueueType;
+            packingGenerationTask->tuneVerletSkin = tuneVerletSkin;
+            packingGenerationTask->weight = costs[id];
             tasks->push_back(task);
             id++;
         }
@@ -72,10 +157,41 @@ namespace Execution
 
     void PackingTaskFactory::FillConfigFolders(std::vector<std::string>* configFolders) const
     {
-        string fileToCheck = (userConfig.generationConfig.executionMode == ExecutionMode::PackingGeneration) ? CONFIG_FILE_NAME : PACKING_FILE_NAME_NFO;
+        bool isGeneration = userConfig.generationConfig.executionMode == ExecutionMode::PackingGeneration;
+        if (useFolderIndex)
+        {
+            // Only the master lists the folders, the other processes receive the index
+            WorkingFolderIndex folderIndex(baseFolder);
+            folderIndex.Update();
+            if (isGeneration)
+            {
+                folderIndex.FillConfigFolders(configFolders);
+            }
+            else
+            {
+                folderIndex.FillFinishedFolders(configFolders);
+            }
+            return;
+        }
+
+        string fileToCheck = isGeneration ? CONFIG_FILE_NAME : PACKING_FILE_NAME_NFO;
         Path::FillFoldersRecursively(baseFolder, fileToCheck, configFolders);
     }
 
+    int PackingTaskFactory::GetTaskThreadsCount(int tasksCount) const
+    {
+        // MPI processes execute a single task each
+        if (concurrentTasksCount == 1 || MpiManager::GetInstance()->IsParallel())
+        {
+            return 0;
+        }
+
+        int hardwareThreadsCount = ThreadPool::GetHardwareThreadsCount();
+        int actualConcurrentTasksCount = (concurrentTasksCount > 0) ? concurrentTasksCount : hardwareThreadsCount;
+        actualConcurrentTasksCount = std::max(1, std::min(actualConcurrentTasksCount, tasksCount));
+        return std::max(1, hardwareThreadsCount / actualConcurrentTasksCount);
+    }
+
     void PackingTaskFactory::FillGenerationConfig()
     {
         // Best program parameters
@@ -177,6 +293,10 @@ namespace Execution
         else if (consoleArguments[0] == "-sf")
         {
             generationConfig->executionMode = ExecutionMode::StructureFactorCalculation;
+            if (consoleArguments.size() > 1)
+            {
+                generationConfig->maxWaveVectorLength = atof(consoleArguments[1].c_str());
+            }
         }
         // LocalOrientationalDisorder
         else if (consoleArguments[0] == "-lod")
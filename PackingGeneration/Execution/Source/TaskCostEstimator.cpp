@@ -0,0 +1,210 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/TaskCostEstimator.h"
+
+#include <stdio.h>
+#include <cmath>
+#include <algorithm>
+#include "Core/Headers/Path.h"
+#include "Core/Headers/ScopedFile.h"
+#include "Generation/Constants.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Generation;
+
+namespace Execution
+{
+    TaskCostEstimator::TaskCostEstimator()
+    {
+    }
+
+    TaskCostEstimator::~TaskCostEstimator()
+    {
+    }
+
+    void TaskCostEstimator::FillCosts(const GenerationConfig& generationConfig, const vector<string>& folders, vector<FLOAT_TYPE>* costs) const
+    {
+        vector<FLOAT_TYPE>& costsRef = *costs;
+        costsRef.assign(folders.size(), 0.0);
+
+        vector<bool> recordedCostsMask(folders.size(), false);
+        vector<FLOAT_TYPE> modelCosts(folders.size(), 0.0);
+        vector<FLOAT_TYPE> calibrationFactors;
+
+        GenerationConfig folderConfig;
+        folderConfig.MergeWith(generationConfig);
+        for (size_t i = 0; i < folders.size(); ++i)
+        {
+            folderConfig.baseFolder = folders[i];
+            if (IsTaskFinished(folderConfig))
+            {
+                continue;
+            }
+
+            int particlesCount = ReadParticlesCount(folders[i]);
+            modelCosts[i] = GetModelCost(folderConfig, particlesCount);
+
+            ExecutionTimeRecord record;
+            if (TryReadExecutionTime(folderConfig, folders[i], &record))
+            {
+                costsRef[i] = GetRecordedCost(folderConfig, record, particlesCount);
+                recordedCostsMask[i] = true;
+                if (costsRef[i] > 0.0)
+                {
+                    calibrationFactors.push_back(costsRef[i] / modelCosts[i]);
+                }
+            }
+        }
+
+        // The median is not affected by a few extremely long runs (e.g. the packings that are hard to jam)
+        FLOAT_TYPE calibrationFactor = 1.0;
+        if (!calibrationFactors.empty())
+        {
+            vector<FLOAT_TYPE>::iterator median = calibrationFactors.begin() + calibrationFactors.size() / 2;
+            std::nth_element(calibrationFactors.begin(), median, calibrationFactors.end());
+            calibrationFactor = *median;
+        }
+
+        for (size_t i = 0; i < folders.size(); ++i)
+        {
+            if (!recordedCostsMask[i])
+            {
+                costsRef[i] = modelCosts[i] * calibrationFactor;
+            }
+        }
+    }
+
+    FLOAT_TYPE TaskCostEstimator::GetModelCost(const GenerationConfig& generationConfig, int particlesCount) const
+    {
+        // Unknown particles count is considered small
+        FLOAT_TYPE count = std::max(particlesCount, 2);
+        FLOAT_TYPE logCount = log(count);
+        FLOAT_TYPE neighborSearchCost = count * logCount;
+
+        switch (generationConfig.executionMode)
+        {
+        case ExecutionMode::PackingGeneration:
+            return GetAlgorithmFactor(generationConfig.generationAlgorithm) * neighborSearchCost;
+
+        case ExecutionMode::InsertionRadiiGeneration:
+        case ExecutionMode::EntropyCalculation:
+        case ExecutionMode::DistancesToClosestSurfacesCalculation:
+            // Each insertion radius or distance is a search in the neighbor list
+            return 1e-6 * std::max(generationConfig.insertionRadiiCount, 0) * logCount + 1e-6 * neighborSearchCost;
+
+        case ExecutionMode::MolecularDynamicsCalculation:
+        case ExecutionMode::ImmediateMolecularDynamicsCalculation:
+            return GetAlgorithmFactor(PackingGenerationAlgorithm::LubachevskyStillingerSimple) * neighborSearchCost;
+
+        case ExecutionMode::ContractionEnergyCalculation:
+        case ExecutionMode::PressureCalculation:
+            return 1e-5 * neighborSearchCost;
+
+        case ExecutionMode::HessianEigenvaluesCalculation:
+            // The eigenvalues of a dense matrix
+            return 1e-9 * count * count * count;
+
+        default:
+            return 1e-6 * neighborSearchCost;
+        }
+    }
+
+    FLOAT_TYPE TaskCostEstimator::GetAlgorithmFactor(PackingGenerationAlgorithm::Type generationAlgorithm) const
+    {
+        switch (generationAlgorithm)
+        {
+        case PackingGenerationAlgorithm::LubachevskyStillingerSimple:
+        case PackingGenerationAlgorithm::LubachevskyStillingerGradualDensification:
+        case PackingGenerationAlgorithm::LubachevskyStillingerEquilibrationBetweenCompressions:
+        case PackingGenerationAlgorithm::LubachevskyStillingerConstantPower:
+        case PackingGenerationAlgorithm::LubachevskyStillingerBiazzo:
+        case PackingGenerationAlgorithm::ClosestJammingSearch:
+            return 1e-4;
+
+        case PackingGenerationAlgorithm::MonteCarlo:
+        case PackingGenerationAlgorithm::ConjugateGradient:
+            return 5e-5;
+
+        case PackingGenerationAlgorithm::OriginalJodreyTory:
+        case PackingGenerationAlgorithm::KhirevichJodreyTory:
+            return 2e-5;
+
+        default:
+            return 1e-5;
+        }
+    }
+
+    bool TaskCostEstimator::IsTaskFinished(const GenerationConfig& generationConfig) const
+    {
+        // GenerationManager skips the generation if the packing info exists
+        return generationConfig.executionMode == ExecutionMode::PackingGeneration &&
+                Path::Exists(Path::Append(generationConfig.baseFolder, PACKING_FILE_NAME_NFO));
+    }
+
+    void TaskCostEstimator::RecordExecutionTime(const GenerationConfig& generationConfig, FLOAT_TYPE executionTime) const
+    {
+        int particlesCount = ReadParticlesCount(generationConfig.baseFolder);
+        ScopedFile<LogErrorHandler> file(Path::Append(generationConfig.baseFolder, EXECUTION_TIMES_FILE_NAME), FileOpenMode::Append);
+        if (file.Exists())
+        {
+            fprintf(file, "%d %d %d %.6g\n", generationConfig.executionMode, generationConfig.generationAlgorithm, particlesCount, executionTime);
+        }
+    }
+
+    int TaskCostEstimator::ReadParticlesCount(const string& folder) const
+    {
+        ScopedFile<EmptyErrorHandler> file(Path::Append(folder, CONFIG_FILE_NAME), FileOpenMode::Read);
+        int particlesCount;
+        if (!file.Exists() || fscanf(file, "Particles count: %d", &particlesCount) != 1)
+        {
+            return -1;
+        }
+        return particlesCount;
+    }
+
+    bool TaskCostEstimator::TryReadExecutionTime(const GenerationConfig& generationConfig, const string& folder, ExecutionTimeRecord* record) const
+    {
+        string executionTimesPath = Path::Append(folder, EXECUTION_TIMES_FILE_NAME);
+        if (!Path::Exists(executionTimesPath))
+        {
+            return false;
+        }
+
+        ScopedFile<EmptyErrorHandler> file(executionTimesPath, FileOpenMode::Read);
+        if (!file.Exists())
+        {
+            return false;
+        }
+
+        // Each line contains the execution mode, algorithm, particles count and execution time. The latest matching record is used.
+        bool recordFound = false;
+        int executionMode;
+        int generationAlgorithm;
+        ExecutionTimeRecord currentRecord;
+        while (fscanf(file, "%d %d %d " FLOAT_FORMAT, &executionMode, &generationAlgorithm, &currentRecord.particlesCount, &currentRecord.executionTime) == 4)
+        {
+            bool sameAlgorithm = (generationConfig.executionMode != ExecutionMode::PackingGeneration) || (generationAlgorithm == generationConfig.generationAlgorithm);
+            if (executionMode == generationConfig.executionMode && sameAlgorithm)
+            {
+                *record = currentRecord;
+                recordFound = true;
+            }
+        }
+
+        return recordFound;
+    }
+
+    FLOAT_TYPE TaskCostEstimator::GetRecordedCost(const GenerationConfig& generationConfig, const ExecutionTimeRecord& record, int particlesCount) const
+    {
+        if (record.particlesCount == particlesCount)
+        {
+            return record.executionTime;
+        }
+
+        return record.executionTime * GetModelCost(generationConfig, particlesCount) / GetModelCost(generationConfig, record.particlesCount);
+    }
+}
@@ -0,0 +1,350 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/WorkingFolderIndex.h"
+
+#include <stdio.h>
+#include <cstring>
+#include <algorithm>
+#include "Core/Headers/Path.h"
+#include "Core/Headers/ScopedFile.h"
+#include "Core/Headers/Exceptions.h"
+#include "Core/Headers/MpiManager.h"
+#include "Core/Headers/ThreadPool.h"
+#include "Generation/Constants.h"
+
+using namespace std;
+using namespace Core;
+using namespace Generation;
+
+namespace Execution
+{
+    WorkingFolderIndex::WorkingFolderIndex(string baseFolder)
+    {
+        this->baseFolder = baseFolder;
+        threadsCount = ThreadPool::GetHardwareThreadsCount();
+        scanStartTime = 0;
+        previousScanStartTime = 0;
+        firstLevelScanIndex = 0;
+    }
+
+    WorkingFolderIndex::~WorkingFolderIndex()
+    {
+    }
+
+    void WorkingFolderIndex::Update()
+    {
+        MpiManager* mpiManager = MpiManager::GetInstance();
+        vector<char> buffer;
+        if (!mpiManager->IsParallel() || mpiManager->IsMaster())
+        {
+            ReadPreviousIndex();
+            Scan();
+            Serialize(&buffer);
+            WriteIndex(buffer);
+        }
+
+        if (mpiManager->IsParallel())
+        {
+            Broadcast(&buffer);
+        }
+    }
+
+    void WorkingFolderIndex::FillConfigFolders(vector<string>* folderPaths) const
+    {
+        FillFolders(false, folderPaths);
+    }
+
+    void WorkingFolderIndex::FillFinishedFolders(vector<string>* folderPaths) const
+    {
+        FillFolders(true, folderPaths);
+    }
+
+    void WorkingFolderIndex::FillFolders(bool requireInfo, vector<string>* folderPaths) const
+    {
+        folderPaths->clear();
+        for (vector<string>::const_iterator it = relativePaths.begin(); it != relativePaths.end(); ++it)
+        {
+            const FolderState& state = folderStates.find(*it)->second;
+            bool folderMatches = requireInfo ? state.hasInfo : state.hasConfig;
+            if (folderMatches)
+            {
+                folderPaths->push_back(Path::Append(baseFolder, *it));
+            }
+        }
+    }
+
+    void WorkingFolderIndex::Scan()
+    {
+        scanStartTime = GetFileSystemTime(GetIndexFilePath() + ".tmp");
+
+        // The folders of each level are listed concurrently. The levels are usually wide, as the packing folders are at the same depth.
+        scans.clear();
+        scans.push_back(FolderScan());
+        ThreadPool threadPool(threadsCount);
+        size_t levelStart = 0;
+        while (levelStart < scans.size())
+        {
+            size_t levelEnd = scans.size();
+            firstLevelScanIndex = static_cast<int>(levelStart);
+            threadPool.Execute(this, static_cast<int>(levelEnd - levelStart));
+
+            for (size_t scanIndex = levelStart; scanIndex < levelEnd; ++scanIndex)
+            {
+                for (size_t i = 0; i < scans[scanIndex].state.subfolderNames.size(); ++i)
+                {
+                    FolderScan subfolderScan;
+                    subfolderScan.relativePath = Path::Append(scans[scanIndex].relativePath, scans[scanIndex].state.subfolderNames[i]);
+                    scans[scanIndex].subfolderScanIndexes.push_back(static_cast<int>(scans.size()));
+                    scans.push_back(subfolderScan);
+                }
+            }
+            levelStart = levelEnd;
+        }
+
+        relativePaths.clear();
+        folderStates.clear();
+        AddScannedFolders(0);
+
+        int reusedFoldersCount = 0;
+        for (vector<FolderScan>::const_iterator it = scans.begin(); it != scans.end(); ++it)
+        {
+            reusedFoldersCount += it->isReused ? 1 : 0;
+        }
+        printf("Folder index updated: %d folders, %d of them unchanged since the previous launch\n", static_cast<int>(relativePaths.size()), reusedFoldersCount);
+
+        scans.clear();
+        previousFolderStates.clear();
+    }
+
+    void WorkingFolderIndex::Execute(int partIndex)
+    {
+        FolderScan& scan = scans[firstLevelScanIndex + partIndex];
+        string folderPath = Path::Append(baseFolder, scan.relativePath);
+        scan.isReused = false;
+        scan.exists = Path::TryGetModificationTime(folderPath, &scan.state.modificationTime);
+        if (!scan.exists)
+        {
+            return;
+        }
+
+        map<string, FolderState>::const_iterator previousState = previousFolderStates.find(scan.relativePath);
+        scan.isReused = previousState != previousFolderStates.end() &&
+                previousState->second.modificationTime == scan.state.modificationTime &&
+                scan.state.modificationTime < previousScanStartTime - MODIFICATION_TIME_PRECISION;
+        if (scan.isReused)
+        {
+            scan.state = previousState->second;
+            return;
+        }
+
+        vector<string> fileNames;
+        Path::FillFileAndFolderNames(folderPath, &fileNames, &scan.state.subfolderNames);
+        std::sort(scan.state.subfolderNames.begin(), scan.state.subfolderNames.end());
+        scan.state.hasConfig = std::find(fileNames.begin(), fileNames.end(), CONFIG_FILE_NAME) != fileNames.end();
+        scan.state.hasInfo = std::find(fileNames.begin(), fileNames.end(), PACKING_FILE_NAME_NFO) != fileNames.end();
+    }
+
+    void WorkingFolderIndex::AddScannedFolders(int scanIndex)
+    {
+        const FolderScan& scan = scans[scanIndex];
+        if (!scan.exists)
+        {
+            return;
+        }
+
+        relativePaths.push_back(scan.relativePath);
+        folderStates[scan.relativePath] = scan.state;
+        for (vector<int>::const_iterator it = scan.subfolderScanIndexes.begin(); it != scan.subfolderScanIndexes.end(); ++it)
+        {
+            AddScannedFolders(*it);
+        }
+    }
+
+    long long WorkingFolderIndex::GetFileSystemTime(string temporaryFilePath) const
+    {
+        // If the file can not be written, all the folders will be listed on the next launch
+        long long fileSystemTime = 0;
+        ScopedFile<LogErrorHandler> file(temporaryFilePath, FileOpenMode::Write | FileOpenMode::Binary);
+        if (file.Exists())
+        {
+            file.Close();
+            Path::TryGetModificationTime(temporaryFilePath, &fileSystemTime);
+        }
+        return fileSystemTime;
+    }
+
+    // The format: version, scan start time, folders count, and for each folder its modification time, flags, path length and path.
+    // The folders go in the depth-first order, so the subfolders of each folder are restored from the paths.
+    void WorkingFolderIndex::Serialize(vector<char>* buffer) const
+    {
+        buffer->clear();
+        int formatVersion = FORMAT_VERSION;
+        int foldersCount = static_cast<int>(relativePaths.size());
+        AppendBytes(&formatVersion, sizeof(formatVersion), buffer);
+        AppendBytes(&scanStartTime, sizeof(scanStartTime), buffer);
+        AppendBytes(&foldersCount, sizeof(foldersCount), buffer);
+
+        for (vector<string>::const_iterator it = relativePaths.begin(); it != relativePaths.end(); ++it)
+        {
+            const FolderState& state = folderStates.find(*it)->second;
+            char flags = (state.hasConfig ? 1 : 0) | (state.hasInfo ? 2 : 0);
+            int pathLength = static_cast<int>(it->size());
+            AppendBytes(&state.modificationTime, sizeof(state.modificationTime), buffer);
+            AppendBytes(&flags, sizeof(flags), buffer);
+            AppendBytes(&pathLength, sizeof(pathLength), buffer);
+            AppendBytes(it->data(), it->size(), buffer);
+        }
+    }
+
+    bool WorkingFolderIndex::Deserialize(const vector<char>& buffer)
+    {
+        relativePaths.clear();
+        folderStates.clear();
+
+        size_t offset = 0;
+        int formatVersion;
+        int foldersCount;
+        bool success = ReadBytes(buffer, &offset, &formatVersion, sizeof(formatVersion)) && formatVersion == FORMAT_VERSION &&
+                ReadBytes(buffer, &offset, &scanStartTime, sizeof(scanStartTime)) &&
+                ReadBytes(buffer, &offset, &foldersCount, sizeof(foldersCount)) && foldersCount >= 0;
+
+        char separator = Path::GetSeparator();
+        for (int i = 0; success && i < foldersCount; ++i)
+        {
+            FolderState state;
+            char flags;
+            int pathLength;
+            success = ReadBytes(buffer, &offset, &state.modificationTime, sizeof(state.modificationTime)) &&
+                    ReadBytes(buffer, &offset, &flags, sizeof(flags)) &&
+                    ReadBytes(buffer, &offset, &pathLength, sizeof(pathLength)) &&
+                    pathLength >= 0 && static_cast<size_t>(pathLength) <= buffer.size() - offset;
+            if (!success)
+            {
+                break;
+            }
+
+            string relativePath(buffer.begin() + offset, buffer.begin() + offset + pathLength);
+            offset += pathLength;
+            state.hasConfig = (flags & 1) != 0;
+            state.hasInfo = (flags & 2) != 0;
+
+            // The base folder goes first, and each folder goes after its parent
+            if (i > 0)
+            {
+                size_t separatorIndex = relativePath.find_last_of(separator);
+                string parentPath = (separatorIndex == string::npos) ? "" : relativePath.substr(0, separatorIndex);
+                string folderName = (separatorIndex == string::npos) ? relativePath : relativePath.substr(separatorIndex + 1);
+                map<string, FolderState>::iterator parentState = folderStates.find(parentPath);
+                success = (parentState != folderStates.end()) && (folderStates.count(relativePath) == 0);
+                if (!success)
+                {
+                    break;
+                }
+                parentState->second.subfolderNames.push_back(folderName);
+            }
+            else
+            {
+                success = relativePath.empty();
+            }
+
+            relativePaths.push_back(relativePath);
+            folderStates[relativePath] = state;
+        }
+
+        success = success && offset == buffer.size();
+        if (!success)
+        {
+            relativePaths.clear();
+            folderStates.clear();
+        }
+        return success;
+    }
+
+    void WorkingFolderIndex::ReadPreviousIndex()
+    {
+        previousFolderStates.clear();
+        previousScanStartTime = 0;
+
+        string indexFilePath = GetIndexFilePath();
+        if (!Path::Exists(indexFilePath))
+        {
+            return;
+        }
+
+        vector<char> buffer(Path::GetFileSize(indexFilePath));
+        ScopedFile<LogErrorHandler> file(indexFilePath, FileOpenMode::Read | FileOpenMode::Binary);
+        bool success = file.Exists() &&
+                (buffer.empty() || fread(&buffer[0], sizeof(char), buffer.size(), file) == buffer.size()) &&
+                Deserialize(buffer);
+        if (!success)
+        {
+            printf("WARNING: the folder index is invalid. Listing all the folders\n");
+            return;
+        }
+
+        previousFolderStates.swap(folderStates);
+        previousScanStartTime = scanStartTime;
+        relativePaths.clear();
+    }
+
+    void WorkingFolderIndex::WriteIndex(const vector<char>& buffer) const
+    {
+        string indexFilePath = GetIndexFilePath();
+        string temporaryFilePath = indexFilePath + ".tmp";
+        {
+            ScopedFile<LogErrorHandler> file(temporaryFilePath, FileOpenMode::Write | FileOpenMode::Binary);
+            if (!file.Exists() || fwrite(&buffer[0], sizeof(char), buffer.size(), file) != buffer.size())
+            {
+                printf("WARNING: the folder index could not be written\n");
+                return;
+            }
+        }
+
+        if (Path::Exists(indexFilePath))
+        {
+            Path::DeleteFile(indexFilePath);
+        }
+        Path::Rename(temporaryFilePath, indexFilePath);
+    }
+
+    void WorkingFolderIndex::Broadcast(vector<char>* buffer)
+    {
+        MpiManager* mpiManager = MpiManager::GetInstance();
+        int masterRank = mpiManager->GetMasterRank();
+
+        int bufferSize = static_cast<int>(buffer->size());
+        mpiManager->Broadcast(&bufferSize, 1, MPI_INT, masterRank);
+        buffer->resize(bufferSize);
+        mpiManager->Broadcast(&buffer->at(0), bufferSize, MPI_BYTE, masterRank);
+
+        if (!mpiManager->IsMaster() && !Deserialize(*buffer))
+        {
+            throw InvalidOperationException("The folder index received from the master is invalid.");
+        }
+    }
+
+    string WorkingFolderIndex::GetIndexFilePath() const
+    {
+        return Path::Append(baseFolder, FOLDER_INDEX_FILE_NAME);
+    }
+
+    void WorkingFolderIndex::AppendBytes(const void* value, size_t size, vector<char>* buffer)
+    {
+        const char* bytes = static_cast<const char*>(value);
+        buffer->insert(buffer->end(), bytes, bytes + size);
+    }
+
+    bool WorkingFolderIndex::ReadBytes(const vector<char>& buffer, size_t* offset, void* value, size_t size)
+    {
+        if (buffer.size() - *offset < size)
+        {
+            return false;
+        }
+
+        memcpy(value, &buffer[*offset], size);
+        *offset += size;
+        return true;
+    }
+}
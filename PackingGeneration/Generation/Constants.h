@@ -37,6 +37,9 @@ namespace Generation
     const std::string NEAREST_NEIGHBORS_FILE_NAME = "nearest_neighbors.txt";
     const std::string ACTIVE_GEOMETRY_FILE_NAME = "active_geometry.conf";
     const std::string IMMOBILE_PARTICLES_FILE_NAME = "immobileParticleIndexes.txt";
+    const std::string CHECKPOINT_FILE_NAME = "ls_checkpoint.bin";
+    const std::string EXECUTION_TIMES_FILE_NAME = "execution_times.txt";
+    const std::string FOLDER_INDEX_FILE_NAME = "folder_index.bin";
 }
 
 #endif /* Generation_Constants_h */
@@ -21,6 +21,8 @@
 #include "PackingServices/PostProcessing/Headers/PressureService.h"
 #include "PackingServices/PostProcessing/Headers/RattlerRemovalService.h"
 #include "PackingServices/PostProcessing/Headers/MolecularDynamicsService.h"
+#include "PackingServices/PostProcessing/Headers/PairCorrelationService.h"
+#include "PackingServices/PostProcessing/Headers/GriddedStructureFactorService.h"
 
 #include "PackingServices/EnergyServices/Headers/HarmonicPotential.h"
 #include "PackingServices/EnergyServices/Headers/IEnergyService.h"
@@ -51,6 +53,8 @@ namespace Generation
             IPackingGenerator* packingGenerator,
             InsertionRadiiGenerator* insertionRadiiGenerator,
             DistanceService* distanceService,
+            PairCorrelationService* pairCorrelationService,
+            GriddedStructureFactorService* griddedStructureFactorService,
             OrderService* orderService,
             IEnergyService* contractionEnergyService,
             HessianService* hessianService,
@@ -63,6 +67,8 @@ namespace Generation
         this->packingGenerator = packingGenerator;
         this->insertionRadiiGenerator = insertionRadiiGenerator;
         this->distanceService = distanceService;
+        this->pairCorrelationService = pairCorrelationService;
+        this->griddedStructureFactorService = griddedStructureFactorService;
         this->orderService = orderService;
         this->contractionEnergyService = contractionEnergyService;
         this->hessianService = hessianService;
@@ -195,7 +201,10 @@ namespace Generation
 
         packingGenerator->SetContext(context);
         insertionRadiiGenerator->SetContext(context);
+        insertionRadiiGenerator->SetSeed(fullConfig.generationConfig.seed);
         distanceService->SetContext(context);
+        pairCorrelationService->SetContext(context);
+        griddedStructureFactorService->SetContext(context);
         orderService->SetContext(context);
         contractionEnergyService->SetContext(context);
         hessianService->SetContext(context);
@@ -393,8 +402,13 @@ namespace Generation
     void GenerationManager::GenerateOrder(const ExecutionConfig& fullConfig, const ModellingContext& context, string targetFilePath, Packing* particles)
     {
         orderService->SetParticles(*particles);
-        OrderService::Order order = orderService->GetOrder(6); // 6 is the best order, as is maximum for FCC packings
-        packingSerializer->SerializeOrder(targetFilePath, order);
+        // 6 is the best order, as is maximum for FCC packings. It goes first, so that the first lines of the file are the same as before.
+        boost::array<int, 3> lsArray = {{6, 4, 8}};
+        vector<int> ls;
+        StlUtilities::ResizeAndCopy(lsArray, &ls);
+        OrderService::BondOrders bondOrders;
+        orderService->FillBondOrders(ls, &bondOrders);
+        packingSerializer->SerializeBondOrders(targetFilePath, bondOrders);
     }
 
     void GenerationManager::CalculateHessianEigenvalues(const ExecutionConfig& fullConfig, const ModellingContext& context, string targetFilePath, Packing* particles)
@@ -473,9 +487,8 @@ namespace Generation
     {
         printf("Calculating pair correlation function\n");
 
-        distanceService->SetParticles(*particles);
         PairCorrelationFunction pairCorrelationFunction;
-        distanceService->FillPairCorrelationFunction(&pairCorrelationFunction);
+        pairCorrelationService->FillPairCorrelationFunction(*particles, &pairCorrelationFunction);
 
         packingSerializer->SerializePairCorrelationFunction(targetFilePath, pairCorrelationFunction);
     }
@@ -484,9 +497,16 @@ namespace Generation
     {
         printf("Calculating structure factor\n");
 
-        distanceService->SetParticles(*particles);
         StructureFactor structureFactor;
-        distanceService->FillStructureFactor(&structureFactor);
+        if (fullConfig.generationConfig.maxWaveVectorLength > 0)
+        {
+            griddedStructureFactorService->FillStructureFactor(*particles, fullConfig.generationConfig.maxWaveVectorLength, &structureFactor);
+        }
+        else
+        {
+            distanceService->SetParticles(*particles);
+            distanceService->FillStructureFactor(&structureFactor);
+        }
 
         packingSerializer->SerializeStructureFactor(targetFilePath, structureFactor);
     }
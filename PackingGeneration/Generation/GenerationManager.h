@@ -18,6 +18,8 @@ namespace PackingServices { class HessianService; }
 namespace PackingServices { class InsertionRadiiGenerator; }
 namespace PackingServices { struct PackingSerializer; }
 namespace PackingServices { struct DistanceService; }
+namespace PackingServices { class PairCorrelationService; }
+namespace PackingServices { class GriddedStructureFactorService; }
 namespace PackingServices { struct OrderService; }
 namespace PackingServices { struct ImmobileParticlesService; }
 
@@ -37,6 +39,8 @@ namespace Generation
         PackingGenerators::IPackingGenerator* packingGenerator;
         PackingServices::InsertionRadiiGenerator* insertionRadiiGenerator;
         PackingServices::DistanceService* distanceService;
+        PackingServices::PairCorrelationService* pairCorrelationService;
+        PackingServices::GriddedStructureFactorService* griddedStructureFactorService;
         PackingServices::OrderService* orderService;
         PackingServices::IEnergyService* contractionEnergyService;
         PackingServices::HessianService* hessianService;
@@ -52,6 +56,8 @@ namespace Generation
                 PackingGenerators::IPackingGenerator* packingGenerator,
                 PackingServices::InsertionRadiiGenerator* insertionRadiiGenerator,
                 PackingServices::DistanceService* distanceService,
+                PackingServices::PairCorrelationService* pairCorrelationService,
+                PackingServices::GriddedStructureFactorService* griddedStructureFactorService,
                 PackingServices::OrderService* orderService,
                 PackingServices::IEnergyService* contractionEnergyService,
                 PackingServices::HessianService* hessianService,
@@ -70,6 +70,7 @@ namespace Model
 
         // Params for other algorithms
         int insertionRadiiCount;
+        Core::FLOAT_TYPE maxWaveVectorLength; // for the structure factor calculation on a mesh
 
     public:
         GenerationConfig();
@@ -71,6 +71,7 @@ namespace Model
         generationAlgorithm = PackingGenerationAlgorithm::Unknown;
 
         insertionRadiiCount = -1;
+        maxWaveVectorLength = -1;
     }
 
     void GenerationConfig::MergeWith(const GenerationConfig& config)
@@ -134,6 +135,11 @@ namespace Model
         {
             insertionRadiiCount = config.insertionRadiiCount;
         }
+
+        if (maxWaveVectorLength < 0)
+        {
+            maxWaveVectorLength = config.maxWaveVectorLength;
+        }
     }
 
     ExecutionConfig::ExecutionConfig()
@@ -53,6 +53,8 @@ namespace PackingGenerators
 
         OVERRIDE bool ShouldContinue() const;
 
+        OVERRIDE void SaveState();
+
         OVERRIDE Core::FLOAT_TYPE GetInnerDiameterRatio() const;
 
         OVERRIDE Core::FLOAT_TYPE GetOuterDiameterRatio() const;
@@ -24,6 +24,9 @@ namespace PackingGenerators
 
         virtual bool ShouldContinue() const = 0;
 
+        // Saves the inner state of the step (if any) that is not contained in the particles, so that an interrupted generation can be continued.
+        virtual void SaveState() = 0;
+
         virtual Core::FLOAT_TYPE GetInnerDiameterRatio() const = 0;
 
         virtual Core::FLOAT_TYPE GetOuterDiameterRatio() const = 0;
@@ -7,11 +7,13 @@
 
 #include <time.h>
 #include "Core/Headers/Macros.h"
+#include "Generation/PackingServices/DistanceServices/Headers/GridClosestPairService.h"
 #include "IPackingGenerator.h"
 namespace PackingGenerators { class IPackingStep; }
 namespace PackingServices { class GeometryService; }
 namespace PackingServices { struct PackingSerializer; }
 namespace PackingServices { class MathService; }
+namespace PackingServices { class AsyncPackingWriter; }
 namespace Geometries { class IGeometry; }
 namespace Model { class SystemConfig; }
 
@@ -25,6 +27,7 @@ namespace PackingGenerators
         PackingServices::GeometryService* geometryService;
         PackingServices::MathService* mathService;
         IPackingStep* packingStep;
+        PackingServices::GridClosestPairService closestPairService;
 
         // Context
         const Model::ModellingContext* context;
@@ -42,12 +45,19 @@ namespace PackingGenerators
         Model::Packing* particles;
 
         static const Core::FLOAT_TYPE EPSILON;
+        // Intermediate packings are written in the background; the generation waits only if the disk is slower than this number of snapshots
+        static const int MAX_QUEUED_SNAPSHOTS_COUNT = 2;
 
     public:
+        // If true (by default), a warning is printed when the outer diameter ratio exceeds VerletListNeighborProvider::MAX_EXPECTED_OUTER_DIAMETER_RATIO.
+        // Shall be false if the packing step keeps the expected outer diameter ratio of the Verlet lists above the actual one itself (see LubachevsckyStillingerStep::tuneVerletSkin).
+        bool checkOuterDiameterRatio;
+
         PackingGenerator(PackingServices::PackingSerializer* packingSerializer,
                 PackingServices::GeometryService* geometryService,
                 PackingServices::MathService* mathService,
-                IPackingStep* packingStep);
+                IPackingStep* packingStep,
+                int threadsCount);
 
         OVERRIDE void ArrangePacking(Model::Packing* particles);
 
@@ -66,16 +76,21 @@ namespace PackingGenerators
 
         void Initialize();
 
-        clock_t Log(unsigned long long iterationCounter) const;
+        // Queues the intermediate packing for writing and returns the time spent.
+        clock_t Log(unsigned long long iterationCounter, PackingServices::AsyncPackingWriter* packingWriter) const;
 
         void Finish(clock_t totalTime, unsigned long long iterationCounter) const;
 
+        // Writes the packing and the state of the packing step, and switches the config to continue the generation, so that the next run resumes it.
+        void SaveResumableState(unsigned long long iterationCounter, PackingServices::AsyncPackingWriter* packingWriter) const;
+
         // region Checking
         // All functions return shouldContinue
 
         void DisplayPorosity() const;
 
-        void CheckIntersectionsNaive() const;
+        // Checks that the closest pair of the packing (found without neighbor providers, see GridClosestPairService) agrees with innerDiameterRatio.
+        void CheckIntersections();
 
         // end region Checking
 
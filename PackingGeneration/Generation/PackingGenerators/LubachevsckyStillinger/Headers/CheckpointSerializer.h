@@ -0,0 +1,46 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Generation_PackingGenerators_LubachevsckyStillinger_Headers_CheckpointSerializer_h
+#define Generation_PackingGenerators_LubachevsckyStillinger_Headers_CheckpointSerializer_h
+
+#include <string>
+#include <cstdio>
+#include "Core/Headers/Macros.h"
+#include "Types.h"
+
+namespace PackingGenerators
+{
+    // Reads and writes the binary checkpoints of the Lubachevsky-Stillinger generation. Values are stored in the native byte order,
+    // as a checkpoint is only needed to restart an interrupted generation on the same machine.
+    class CheckpointSerializer
+    {
+    private:
+        static const int FORMAT_VERSION = 1;
+        static const int INTEGERS_COUNT = 13;
+        static const int FLOATS_COUNT = 7;
+        static const int FLOATS_PER_PARTICLE = 3 * DIMENSIONS + 2;
+        static const int PARTICLES_PER_IO_CHUNK = 65536;
+
+    public:
+        CheckpointSerializer();
+
+        // Writes the checkpoint to a temporary file and renames it, so that an interrupted write does not damage the previous checkpoint.
+        void WriteCheckpoint(std::string checkpointFilePath, const LubachevsckyStillingerCheckpoint& checkpoint) const;
+
+        // Returns false if the checkpoint is absent or damaged.
+        bool ReadCheckpoint(std::string checkpointFilePath, LubachevsckyStillingerCheckpoint* checkpoint) const;
+
+        ~CheckpointSerializer();
+
+    private:
+        void WriteParticles(const LubachevsckyStillingerCheckpoint& checkpoint, FILE* file) const;
+
+        bool ReadParticles(FILE* file, LubachevsckyStillingerCheckpoint* checkpoint) const;
+
+        DISALLOW_COPY_AND_ASSIGN(CheckpointSerializer);
+    };
+}
+
+#endif /* Generation_PackingGenerators_LubachevsckyStillinger_Headers_CheckpointSerializer_h */
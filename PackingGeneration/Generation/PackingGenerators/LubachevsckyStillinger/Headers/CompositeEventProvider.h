@@ -6,20 +6,20 @@
 #define Generation_PackingGenerators_LubachevsckyStillinger_Headers_CompositeEventProvider_h
 
 #include "BaseEventProvider.h"
-namespace Core { template<class TContainer, class TCompare> class OrderedPriorityQueue; }
+namespace Core { template<class TContainer, class TCompare> class IOrderedPriorityQueue; }
 
 namespace PackingGenerators
 {
     class CompositeEventProvider : public BaseEventProvider
     {
     private:
-        Core::OrderedPriorityQueue<std::vector<MovingParticle>, MovingParticleComparer>* eventsQueue;
+        Core::IOrderedPriorityQueue<std::vector<MovingParticle>, MovingParticleComparer>* eventsQueue;
 
     public:
         const std::vector<IEventProvider*>* eventProviders;
 
     public:
-        CompositeEventProvider(Core::OrderedPriorityQueue<std::vector<MovingParticle>, MovingParticleComparer>* eventsQueue,
+        CompositeEventProvider(Core::IOrderedPriorityQueue<std::vector<MovingParticle>, MovingParticleComparer>* eventsQueue,
                 const std::vector<IEventProvider*>* eventProviders);
 
         ~CompositeEventProvider() {};
@@ -5,14 +5,16 @@
 #ifndef Generation_PackingGenerators_LubachevsckyStillinger_Headers_LubachevsckyStillingerStep_h
 #define Generation_PackingGenerators_LubachevsckyStillinger_Headers_LubachevsckyStillingerStep_h
 
-#include <ctime>
+#include <chrono>
 #include <boost/shared_ptr.hpp>
-#include "Core/Headers/OrderedPriorityQueue.h"
+#include "Core/Headers/IOrderedPriorityQueue.h"
 #include "Generation/PackingServices/Headers/GeometryCollisionService.h"
+#include "Generation/PackingServices/DistanceServices/Headers/VerletSkinTuner.h"
 #include "Generation/PackingGenerators/Headers/BasePackingStep.h"
 #include "Types.h"
 #include "ParticleCollisionService.h"
 #include "VelocityService.h"
+#include "CheckpointSerializer.h"
 namespace PackingGenerators { class CompositeEventProcessor; }
 namespace PackingGenerators { class CollisionEventProcessor; }
 namespace PackingGenerators { class CompositeEventProvider; }
@@ -20,6 +22,7 @@ namespace PackingGenerators { class IEventProvider; }
 namespace PackingGenerators { class IEventProcessor; }
 namespace PackingServices { class PackingSerializer; }
 namespace PackingServices { class IEnergyService; }
+namespace PackingServices { class VerletListNeighborProvider; }
 
 namespace PackingGenerators
 {
@@ -35,6 +38,22 @@ namespace PackingGenerators
         int eventsPerParticle;
         bool lockParticles;
         bool preserveInitialDiameter;
+        EventsQueueType::Type eventsQueueType;
+
+        // If true, events are not recomputed after velocity rescaling between the event batches while particles do not grow, but their times are rescaled.
+        // It speeds up only the blocks with zero growth rate (equilibrations between compressions, LubachevskyStillingerGradualDensification after suppressing growth,
+        // constant diameters). While particles grow, all the events are recomputed, as collision times depend on the ratio of velocities and the growth rate.
+        bool updateEventsIncrementally;
+
+        // If true, the cutoff distance (skin) of VerletListNeighborProvider is tuned after each block of events to minimize the cost per event (see VerletSkinTuner),
+        // and the expected outer diameter ratio of the Verlet lists follows the actual inner diameter ratio. Requires VerletListNeighborProvider.
+        bool tuneVerletSkin;
+
+        // If true, the state of the simulation is written to the checkpoint file in the base folder every stepsToWrite blocks of events (i.e. with the packing file),
+        // and SetParticles restores it if it was written for the same particles, so that an interrupted generation continues with the same velocities and growth rate.
+        bool writeCheckpoints;
+
+        int threadsCount; // for the Voronoi tesselation of locked particles. If not positive, the number of hardware threads is used.
 
     private:
         // Original Donev code usually terminates at 1e12, but for those packings that exhibit 1e12 for Donev code our code determines pressure at 1e8.
@@ -45,6 +64,16 @@ namespace PackingGenerators
         // These are also the most probable reasons for PSD generation errors of the closed source program of Donev.
         static const Core::FLOAT_TYPE maxPressure;
 
+        // Relative costs of the elementary operations for the Verlet skin tuning (see TuneVerletSkin).
+        // Deterministic counts are used instead of the wall clock time, so that the generated packings are reproducible.
+        // The values are rough estimates of the floating point operations and memory accesses, not measurements; only their ratios matter.
+        // An event (20) includes the queue update, the particle displacement and the velocity update; a pair check (2) is solving a quadratic equation
+        // for the collision time; a candidate check (1) is a distance comparison; a list element (2) is a read and a write while removing and adding a particle.
+        static const Core::FLOAT_TYPE eventCost;
+        static const Core::FLOAT_TYPE pairCheckCost;
+        static const Core::FLOAT_TYPE candidateCheckCost;
+        static const Core::FLOAT_TYPE listElementCost;
+
         // Working variables
         Core::FLOAT_TYPE initialInnerDiameterRatio;
         Core::FLOAT_TYPE currentTime;
@@ -53,16 +82,19 @@ namespace PackingGenerators
         bool shouldContinue;
         int growthRateUpdatesCount;
         int equilibrationsCount;
-        clock_t startTime;
+        int processedEventsCount;
+        int blocksCount;
+        std::chrono::steady_clock::time_point startTime; // wall-clock time, as the CPU time of the process includes the other tasks and threads
 
         // Services
         // These ones are too internal for the LS Step, so i do not pass them in constructor as pointers.
-        Core::OrderedPriorityQueue<std::vector<MovingParticle>, MovingParticleComparer> eventsQueue;
+        boost::shared_ptr<Core::IOrderedPriorityQueue<std::vector<MovingParticle>, MovingParticleComparer> > eventsQueue;
         ParticleCollisionService particleCollisionService;
         VelocityService velocityService;
         PackingServices::GeometryCollisionService geometryCollisionService;
         PackingServices::PackingSerializer* packingSerializer;
         PackingServices::IEnergyService* contractionEnergyService;
+        CheckpointSerializer checkpointSerializer;
 
         // Event providers and processors. Most of these fields are needed for memory management.
         // I'm initializing the providers and processors inside this class, as it knows better which providers and processors it needs.
@@ -74,6 +106,8 @@ namespace PackingGenerators
         boost::shared_ptr<CompositeEventProvider> eventProvider;
         boost::shared_ptr<CompositeEventProcessor> eventProcessor;
         boost::shared_ptr<CollisionEventProcessor> collisionEventProcessor;
+        PackingServices::VerletListNeighborProvider* verletListNeighborProvider;
+        PackingServices::VerletSkinTuner verletSkinTuner;
         std::vector<VoronoiPolytope> voronoiTesselation;
 
     public:
@@ -92,6 +126,12 @@ namespace PackingGenerators
 
         OVERRIDE bool ShouldContinue() const;
 
+        // Writes the checkpoint, if checkpoints are enabled. Shall be called between calls to DisplaceParticles.
+        OVERRIDE void SaveState();
+
+        // Returns the moving particles with their next events, synchronized with the zero time between the calls to DisplaceParticles.
+        const std::vector<MovingParticle>& GetMovingParticles() const;
+
         ~LubachevsckyStillingerStep();
 
     private:
@@ -105,18 +145,33 @@ namespace PackingGenerators
 
         void SwitchCompressionRateWithZero(Core::FLOAT_TYPE previousPressue);
 
+        void CreateEventsQueue();
+
         void CreateEventProviders();
 
         void CreateEventProcessors();
 
         void InitializeEvents();
 
+        void UpdateEventsAfterRescaling(Core::FLOAT_TYPE velocityRescaleFactor);
+
         void ResetTime();
 
         void DisplaceRealParticles();
 
         void CalculateStatistics();
 
+        void InitializeVerletSkin();
+
+        void TuneVerletSkin(Core::FLOAT_TYPE blockDuration);
+
+        void UpdateVerletLists(Core::FLOAT_TYPE cutoffDistance, Core::FLOAT_TYPE expectedOuterDiameterRatio);
+
+        // Returns false if there is no checkpoint for the current particles and generation algorithm.
+        bool RestoreCheckpoint();
+
+        void WriteCheckpoint() const;
+
         DISALLOW_COPY_AND_ASSIGN(LubachevsckyStillingerStep);
     };
 }
@@ -7,6 +7,8 @@
 
 #include "Generation/Model/Headers/Types.h"
 #include "Core/Headers/VectorUtilities.h"
+#include "Core/Headers/Constants.h"
+#include "Core/Headers/Math.h"
 
 namespace PackingGenerators
 {
@@ -81,6 +83,32 @@ namespace PackingGenerators
             // Invalid events (with event time < global time) will never appear in the events queue, so we do not check global time.
             return first.nextAvailableEvent.time < second.nextAvailableEvent.time;
         };
+
+        // Is used by the queues that bucket values by priorities (e.g., Core::CalendarOrderedPriorityQueue). Is consistent with operator().
+        Core::FLOAT_TYPE GetPriority(const MovingParticle& particle) const
+        {
+            if (particle.nextAvailableEvent.type == EventType::InvalidEvent)
+            {
+                return Core::MAX_FLOAT_VALUE;
+            }
+
+            return particle.nextAvailableEvent.time;
+        };
+    };
+
+    struct EventsQueueType
+    {
+        enum Type
+        {
+            // Binary heap (Core::OrderedPriorityQueue), O(log(N)) per event
+            BinaryHeap = 0,
+
+            // Calendar queue (Core::CalendarOrderedPriorityQueue), O(1) per event on average
+            Calendar = 1,
+
+            // 4-ary heap of (time, particle index) keys (Core::KeyOrderedPriorityQueue), O(log(N)) per event, but does not read particles while sifting
+            KeyHeap = 2
+        };
     };
 
     struct VoronoiPlane : Model::Plane
@@ -159,6 +187,27 @@ namespace PackingGenerators
             return particleIndex < other.particleIndex;
         };
     };
+
+    // The state of the Lubachevsky-Stillinger generation between two blocks of events, when the current time is reset to zero.
+    // Events are not stored, as they are recomputed from the moving particles when the state is restored.
+    struct LubachevsckyStillingerCheckpoint
+    {
+        Model::PackingGenerationAlgorithm::Type generationAlgorithm;
+        bool lockParticles;
+        Core::FLOAT_TYPE initialInnerDiameterRatio;
+        Core::FLOAT_TYPE ratioGrowthRate;
+        int growthRateUpdatesCount;
+        int equilibrationsCount;
+        bool shouldContinue;
+        Model::MolecularDynamicsStatistics statistics;
+        Core::RandomState randomState;
+
+        // The particles synchronized with the current time, as they are written to the packing file
+        Model::Packing particles;
+
+        // The particles at their last events
+        std::vector<MovingParticle> movingParticles;
+    };
 }
 
 #endif /* Generation_PackingGenerators_LubachevsckyStillinger_Headers_Types_h */
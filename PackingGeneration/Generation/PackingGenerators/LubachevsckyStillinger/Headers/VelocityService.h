@@ -28,7 +28,8 @@ namespace PackingGenerators
 
         Core::FLOAT_TYPE GetExpectedKineticEnergy(const std::vector<MovingParticle>& particles) const;
 
-        void RescaleVelocities(Core::FLOAT_TYPE currentTime, Core::FLOAT_TYPE actualKineticEnergy, std::vector<MovingParticle>* particles) const;
+        // Returns the rescale factor
+        Core::FLOAT_TYPE RescaleVelocities(Core::FLOAT_TYPE currentTime, Core::FLOAT_TYPE actualKineticEnergy, std::vector<MovingParticle>* particles) const;
 
         void SynchronizeParticleWithCurrentTime(Core::FLOAT_TYPE currentTime, MovingParticle* particle) const;
 
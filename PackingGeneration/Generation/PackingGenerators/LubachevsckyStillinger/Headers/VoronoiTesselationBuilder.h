@@ -0,0 +1,113 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Generation_PackingGenerators_LubachevsckyStillinger_Headers_VoronoiTesselationBuilder_h
+#define Generation_PackingGenerators_LubachevsckyStillinger_Headers_VoronoiTesselationBuilder_h
+
+#include <vector>
+#include "Core/Headers/Macros.h"
+#include "Core/Headers/IParallelTask.h"
+#include "Generation/PackingServices/DistanceServices/Headers/CellGrid.h"
+#include "Types.h"
+namespace PackingServices { class MathService; }
+namespace Model { class SystemConfig; }
+
+namespace PackingGenerators
+{
+    // Builds the Voronoi tesselation of a packing in-process, so that the Voronoi planes do not have to be prepared by qhull.
+    // Each cell is a box around the particle clipped by the bisector planes of the neighbors in the order of increasing distance,
+    // until the remaining neighbors are farther than twice the farthest cell vertex. The neighbors are taken from a temporary cell grid;
+    // if the cell is too large for the grid (e.g. in a dilute packing), all the particles and their periodic images are checked.
+    // The planes of a cell, which crosses the box boundary, are also added for the periodic images of the cell, which intersect the box
+    // (as in the tesselation of the periodically extended packing), because the particles are moved to the periodic images when they cross the boundary.
+    class VoronoiTesselationBuilder : public virtual Core::IParallelTask
+    {
+    private:
+        struct CellFace
+        {
+            // The face plane is normal * x = distance in coordinates relative to the particle center
+            Core::SpatialVector normal;
+            Core::FLOAT_TYPE distance;
+            Model::ParticleIndex neighborIndex; // -1 for the faces of the initial box
+            std::vector<Core::SpatialVector> vertices; // relative to the particle center, in the order of traversal
+        };
+
+        struct CellNeighbor
+        {
+            Model::ParticleIndex index;
+            Core::SpatialVector offset; // from the particle center to the neighbor (or its periodic image)
+            Core::FLOAT_TYPE distanceSquare;
+
+            bool operator<(const CellNeighbor& other) const
+            {
+                return distanceSquare < other.distanceSquare;
+            }
+        };
+
+        // Services
+        PackingServices::MathService* mathService;
+
+        // Context
+        int threadsCount;
+        const Model::SystemConfig* config;
+        const Model::Packing* particles;
+
+        // Working variables
+        PackingServices::CellGrid cellGrid;
+        bool periodicAxes[DIMENSIONS];
+        Core::FLOAT_TYPE gridCoverageRadius;
+        Core::FLOAT_TYPE vertexEpsilon;
+        int partsCount;
+        std::vector<std::vector<VoronoiPlane> >* voronoiPlanesPerParticle;
+
+        static const int PARTS_PER_THREAD = 4;
+        // The grid cells are not smaller than this number of mean interparticle distances, so that almost all the Voronoi cells are built from the neighboring grid cells
+        static const Core::FLOAT_TYPE GRID_CELL_SIZE_FACTOR;
+
+    public:
+        // If threadsCount is not positive, the number of hardware threads is used.
+        VoronoiTesselationBuilder(PackingServices::MathService* mathService, int threadsCount);
+
+        // Fills the planes of the Voronoi cells. The axes are periodic, if the mathService considers them periodic; the other axes are bounded by the box walls.
+        void FillVoronoiPlanes(const Model::SystemConfig& config, const Model::Packing& particles, std::vector<std::vector<VoronoiPlane> >* voronoiPlanesPerParticle);
+
+        // Builds the cells of a range of particles.
+        OVERRIDE void Execute(int partIndex);
+
+        virtual ~VoronoiTesselationBuilder();
+
+    private:
+        void FillCellPlanes(Model::ParticleIndex particleIndex, std::vector<CellNeighbor>* neighbors, std::vector<CellFace>* faces, std::vector<VoronoiPlane>* planes) const;
+
+        // Fills the closest periodic images of the particles from the neighboring grid cells.
+        void FillGridNeighbors(Model::ParticleIndex particleIndex, std::vector<CellNeighbor>* neighbors) const;
+
+        // Fills all the particles and their periodic images from the neighboring periodic boxes (including the images of the particle itself).
+        void FillAllNeighbors(Model::ParticleIndex particleIndex, std::vector<CellNeighbor>* neighbors) const;
+
+        // Returns true if the cell is exact, i.e. all the particles closer than twice the farthest cell vertex are among the neighbors.
+        bool BuildCell(Model::ParticleIndex particleIndex, const std::vector<CellNeighbor>& neighbors, Core::FLOAT_TYPE coverageRadius, std::vector<CellFace>* faces) const;
+
+        void InitializeCell(const Core::SpatialVector& center, std::vector<CellFace>* faces) const;
+
+        // Cuts off the part of the cell beyond the plane normal * x = distance.
+        void CutCell(const Core::SpatialVector& normal, Core::FLOAT_TYPE distance, Model::ParticleIndex neighborIndex, std::vector<CellFace>* faces) const;
+
+        // Orders the vertices of a new face by the angle around the face center and removes the duplicates.
+        void OrderFaceVertices(CellFace* face) const;
+
+        bool AreVerticesEqual(const Core::SpatialVector& vertex, const Core::SpatialVector& otherVertex) const;
+
+        void AddPlanes(Model::ParticleIndex particleIndex, const std::vector<CellFace>& faces, const Core::SpatialVector& shift, std::vector<VoronoiPlane>* planes) const;
+
+        // Adds the planes of the periodic images of the cell, which intersect the box.
+        void AddPeriodicImagePlanes(Model::ParticleIndex particleIndex, const std::vector<CellFace>& faces, std::vector<VoronoiPlane>* planes) const;
+
+        static Core::FLOAT_TYPE GetMaxVertexDistanceSquare(const std::vector<CellFace>& faces);
+
+        DISALLOW_COPY_AND_ASSIGN(VoronoiTesselationBuilder);
+    };
+}
+
+#endif /* Generation_PackingGenerators_LubachevsckyStillinger_Headers_VoronoiTesselationBuilder_h */
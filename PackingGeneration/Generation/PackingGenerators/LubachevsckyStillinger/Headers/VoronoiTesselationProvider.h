@@ -9,6 +9,7 @@
 #include "Types.h"
 namespace PackingServices { class MathService; }
 namespace PackingServices { class GeometryCollisionService; }
+namespace Model { class SystemConfig; }
 
 namespace PackingGenerators
 {
@@ -20,20 +21,36 @@ namespace PackingGenerators
 
         std::string baseFolder;
         const Model::Packing* particles;
+        const Model::SystemConfig* config;
         Model::ParticleIndex particlesCount;
+        int threadsCount;
+
+        static const int CACHE_FORMAT_VERSION = 1;
 
     public:
         VoronoiTesselationProvider(PackingServices::GeometryCollisionService* geometryCollisionService,
                 PackingServices::MathService* mathService,
                 std::string baseFolder,
                 const Model::Packing* particles,
-                Model::ParticleIndex particlesCount);
+                const Model::SystemConfig& config,
+                int threadsCount);
 
+        // Reads the tesselation prepared by qhull from Cache/mainVoronoi.txt and Cache/mainPeriodicIndexesMap.txt, if present.
+        // Otherwise reads the binary cache Cache/voronoiTesselation.bin, if it was built for the same particle centers,
+        // or builds the tesselation by VoronoiTesselationBuilder and writes the cache.
         void FillVoronoiTesselation(std::vector<VoronoiPolytope>* voronoiTesselation) const;
 
         ~VoronoiTesselationProvider() {};
 
     private:
+        void BuildVoronoiPlanes(std::vector<std::vector<VoronoiPlane> >* voronoiPlanesPerParticle) const;
+
+        // Returns false if the cache is absent, damaged or was built for other particles.
+        bool ReadCachedTesselation(std::string path, std::vector<VoronoiPolytope>* voronoiTesselation) const;
+
+        // Stores the particle centers and the planes of each cell as raw floats.
+        void WriteCachedTesselation(std::string path, const std::vector<VoronoiPolytope>& voronoiTesselation) const;
+
         void ReadPeriodicIndexesMap(std::string path, std::vector<Model::ParticleIndex>* periodicIndexesMap) const;
 
         void ReadVoronoiPlanes(std::string path, const std::vector<Model::ParticleIndex>& periodicIndexesMap, std::vector<VoronoiPlane>* voronoiPlanes) const;
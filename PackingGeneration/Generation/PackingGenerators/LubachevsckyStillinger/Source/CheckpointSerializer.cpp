@@ -0,0 +1,173 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/CheckpointSerializer.h"
+
+#include <algorithm>
+#include <vector>
+#include "Core/Headers/Exceptions.h"
+#include "Core/Headers/ScopedFile.h"
+#include "Core/Headers/Path.h"
+
+using namespace Core;
+using namespace Model;
+using namespace std;
+
+namespace PackingGenerators
+{
+    CheckpointSerializer::CheckpointSerializer()
+    {
+    }
+
+    CheckpointSerializer::~CheckpointSerializer()
+    {
+    }
+
+    void CheckpointSerializer::WriteCheckpoint(string checkpointFilePath, const LubachevsckyStillingerCheckpoint& checkpoint) const
+    {
+        string temporaryFilePath = checkpointFilePath + ".tmp";
+        ScopedFile<ExceptionErrorHandler> file(temporaryFilePath, FileOpenMode::Write | FileOpenMode::Binary);
+
+        const MolecularDynamicsStatistics& statistics = checkpoint.statistics;
+        const RandomState& randomState = checkpoint.randomState;
+        int integers[INTEGERS_COUNT] = {FORMAT_VERSION, static_cast<int>(checkpoint.particles.size()),
+                checkpoint.generationAlgorithm, checkpoint.lockParticles, checkpoint.growthRateUpdatesCount, checkpoint.equilibrationsCount, checkpoint.shouldContinue,
+                statistics.eventsCount, statistics.collisionErrorsExisted,
+                randomState.seed[0], randomState.seed[1], randomState.seed[2], randomState.spareReady};
+        FLOAT_TYPE floats[FLOATS_COUNT] = {checkpoint.initialInnerDiameterRatio, checkpoint.ratioGrowthRate,
+                statistics.reducedPressure, statistics.exchangedMomentum, statistics.kineticEnergy, statistics.timePeriod,
+                randomState.spare};
+
+        bool success = fwrite(integers, sizeof(int), INTEGERS_COUNT, file) == INTEGERS_COUNT &&
+                fwrite(floats, sizeof(FLOAT_TYPE), FLOATS_COUNT, file) == FLOATS_COUNT;
+        if (!success)
+        {
+            throw InvalidOperationException("Could not write the checkpoint.");
+        }
+
+        WriteParticles(checkpoint, file);
+        file.Close();
+
+        if (Path::Exists(checkpointFilePath))
+        {
+            Path::DeleteFile(checkpointFilePath);
+        }
+        Path::Rename(temporaryFilePath, checkpointFilePath);
+    }
+
+    void CheckpointSerializer::WriteParticles(const LubachevsckyStillingerCheckpoint& checkpoint, FILE* file) const
+    {
+        int particlesCount = checkpoint.particles.size();
+        const int particlesPerChunk = PARTICLES_PER_IO_CHUNK;
+        vector<FLOAT_TYPE> buffer(std::min(particlesCount, particlesPerChunk) * FLOATS_PER_PARTICLE);
+        for (int chunkStart = 0; chunkStart < particlesCount; chunkStart += particlesPerChunk)
+        {
+            int chunkParticlesCount = std::min(particlesPerChunk, particlesCount - chunkStart);
+            FLOAT_TYPE* values = &buffer[0];
+            for (ParticleIndex i = chunkStart; i < chunkStart + chunkParticlesCount; ++i)
+            {
+                const DomainParticle& particle = checkpoint.particles[i];
+                const MovingParticle& movingParticle = checkpoint.movingParticles[i];
+                values = std::copy(particle.coordinates.begin(), particle.coordinates.end(), values);
+                *values++ = particle.diameter;
+                values = std::copy(movingParticle.coordinates.begin(), movingParticle.coordinates.end(), values);
+                values = std::copy(movingParticle.velocity.begin(), movingParticle.velocity.end(), values);
+                *values++ = movingParticle.lastEventTime;
+            }
+
+            size_t valuesCount = chunkParticlesCount * FLOATS_PER_PARTICLE;
+            if (fwrite(&buffer[0], sizeof(FLOAT_TYPE), valuesCount, file) != valuesCount)
+            {
+                throw InvalidOperationException("Could not write the checkpoint.");
+            }
+        }
+    }
+
+    bool CheckpointSerializer::ReadCheckpoint(string checkpointFilePath, LubachevsckyStillingerCheckpoint* checkpoint) const
+    {
+        if (!Path::Exists(checkpointFilePath))
+        {
+            return false;
+        }
+
+        ScopedFile<LogErrorHandler> file(checkpointFilePath, FileOpenMode::Read | FileOpenMode::Binary);
+        int integers[INTEGERS_COUNT];
+        FLOAT_TYPE floats[FLOATS_COUNT];
+        bool success = file.Exists() &&
+                fread(integers, sizeof(int), INTEGERS_COUNT, file) == INTEGERS_COUNT &&
+                integers[0] == FORMAT_VERSION && integers[1] >= 0 &&
+                fread(floats, sizeof(FLOAT_TYPE), FLOATS_COUNT, file) == FLOATS_COUNT;
+        if (!success)
+        {
+            return false;
+        }
+
+        checkpoint->generationAlgorithm = static_cast<PackingGenerationAlgorithm::Type>(integers[2]);
+        checkpoint->lockParticles = integers[3] != 0;
+        checkpoint->growthRateUpdatesCount = integers[4];
+        checkpoint->equilibrationsCount = integers[5];
+        checkpoint->shouldContinue = integers[6] != 0;
+
+        MolecularDynamicsStatistics& statistics = checkpoint->statistics;
+        statistics.eventsCount = integers[7];
+        statistics.collisionErrorsExisted = integers[8] != 0;
+        statistics.equilibrationEventsCount = 0;
+
+        RandomState& randomState = checkpoint->randomState;
+        for (int i = 0; i < 3; ++i)
+        {
+            randomState.seed[i] = static_cast<unsigned short>(integers[9 + i]);
+        }
+        randomState.spareReady = integers[12] != 0;
+
+        checkpoint->initialInnerDiameterRatio = floats[0];
+        checkpoint->ratioGrowthRate = floats[1];
+        statistics.reducedPressure = floats[2];
+        statistics.exchangedMomentum = floats[3];
+        statistics.kineticEnergy = floats[4];
+        statistics.timePeriod = floats[5];
+        randomState.spare = floats[6];
+
+        checkpoint->particles.resize(integers[1]);
+        checkpoint->movingParticles.resize(integers[1]);
+        return ReadParticles(file, checkpoint);
+    }
+
+    bool CheckpointSerializer::ReadParticles(FILE* file, LubachevsckyStillingerCheckpoint* checkpoint) const
+    {
+        int particlesCount = checkpoint->particles.size();
+        const int particlesPerChunk = PARTICLES_PER_IO_CHUNK;
+        vector<FLOAT_TYPE> buffer(std::min(particlesCount, particlesPerChunk) * FLOATS_PER_PARTICLE);
+        for (int chunkStart = 0; chunkStart < particlesCount; chunkStart += particlesPerChunk)
+        {
+            int chunkParticlesCount = std::min(particlesPerChunk, particlesCount - chunkStart);
+            size_t valuesCount = chunkParticlesCount * FLOATS_PER_PARTICLE;
+            if (fread(&buffer[0], sizeof(FLOAT_TYPE), valuesCount, file) != valuesCount)
+            {
+                return false;
+            }
+
+            const FLOAT_TYPE* values = &buffer[0];
+            for (ParticleIndex i = chunkStart; i < chunkStart + chunkParticlesCount; ++i)
+            {
+                DomainParticle& particle = checkpoint->particles[i];
+                MovingParticle& movingParticle = checkpoint->movingParticles[i];
+                particle.index = i;
+                std::copy(values, values + DIMENSIONS, particle.coordinates.begin());
+                values += DIMENSIONS;
+                particle.diameter = *values++;
+
+                movingParticle.index = i;
+                movingParticle.diameter = particle.diameter;
+                std::copy(values, values + DIMENSIONS, movingParticle.coordinates.begin());
+                values += DIMENSIONS;
+                std::copy(values, values + DIMENSIONS, movingParticle.velocity.begin());
+                values += DIMENSIONS;
+                movingParticle.lastEventTime = *values++;
+            }
+        }
+
+        return true;
+    }
+}
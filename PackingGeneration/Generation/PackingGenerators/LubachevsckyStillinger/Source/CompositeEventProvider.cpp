@@ -4,7 +4,7 @@
 
 #include "../Headers/CompositeEventProvider.h"
 
-#include "Core/Headers/OrderedPriorityQueue.h"
+#include "Core/Headers/IOrderedPriorityQueue.h"
 #include "Core/Headers/StlUtilities.h"
 #include "../Headers/VoronoiTransferEventProvider.h"
 #include "../Headers/NeighborTransferEventProvider.h"
@@ -16,7 +16,7 @@ using namespace std;
 
 namespace PackingGenerators
 {
-    CompositeEventProvider::CompositeEventProvider(OrderedPriorityQueue<std::vector<MovingParticle>, MovingParticleComparer>* eventsQueue,
+    CompositeEventProvider::CompositeEventProvider(IOrderedPriorityQueue<std::vector<MovingParticle>, MovingParticleComparer>* eventsQueue,
             const vector<IEventProvider*>* eventProviders) : BaseEventProvider()
     {
         this->eventsQueue = eventsQueue;
@@ -22,7 +22,12 @@
 #include "../Headers/CompositeEventProcessor.h"
 #include "../Headers/MoveEventProcessor.h"
 
+#include "Core/Headers/OrderedPriorityQueue.h"
+#include "Core/Headers/CalendarOrderedPriorityQueue.h"
+#include "Core/Headers/KeyOrderedPriorityQueue.h"
 #include "Core/Headers/StlUtilities.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/Constants.h"
 #include "Core/Headers/MemoryUtility.h"
 #include "Core/Headers/Exceptions.h"
 #include "Core/Headers/ScopedFile.h"
@@ -31,6 +36,7 @@
 #include "Generation/Model/Headers/Config.h"
 #include "Generation/PackingServices/DistanceServices/Headers/IClosestPairProvider.h"
 #include "Generation/PackingServices/DistanceServices/Headers/INeighborProvider.h"
+#include "Generation/PackingServices/DistanceServices/Headers/VerletListNeighborProvider.h"
 #include "Generation/PackingServices/Headers/PackingSerializer.h"
 #include "Generation/PackingServices/Headers/GeometryService.h"
 #include "Generation/Constants.h"
@@ -41,12 +47,18 @@
 using namespace PackingServices;
 using namespace Core;
 using namespace Model;
+using namespace Generation;
 using namespace std;
 
 namespace PackingGenerators
 {
     const FLOAT_TYPE LubachevsckyStillingerStep::maxPressure = 1e12;
 
+    const FLOAT_TYPE LubachevsckyStillingerStep::eventCost = 20.0;
+    const FLOAT_TYPE LubachevsckyStillingerStep::pairCheckCost = 2.0;
+    const FLOAT_TYPE LubachevsckyStillingerStep::candidateCheckCost = 1.0;
+    const FLOAT_TYPE LubachevsckyStillingerStep::listElementCost = 2.0;
+
     LubachevsckyStillingerStep::LubachevsckyStillingerStep(GeometryService* geometryService,
             INeighborProvider* neighborProvider,
             IClosestPairProvider* distanceService,
@@ -64,6 +76,12 @@ namespace PackingGenerators
 
         lockParticles = false;
         preserveInitialDiameter = false;
+        eventsQueueType = EventsQueueType::KeyHeap;
+        updateEventsIncrementally = true;
+        tuneVerletSkin = false;
+        writeCheckpoints = false;
+        threadsCount = 0;
+        verletListNeighborProvider = NULL;
     }
 
     LubachevsckyStillingerStep::~LubachevsckyStillingerStep()
@@ -76,11 +94,21 @@ namespace PackingGenerators
         ratioGrowthRate = generationConfig->contractionRate;
         growthRateUpdatesCount = 0;
         equilibrationsCount = 0;
-        startTime = clock();
+        blocksCount = 0;
+        startTime = std::chrono::steady_clock::now();
 
+        CreateEventsQueue();
         CreateEventProviders();
         CreateEventProcessors();
 
+        if (writeCheckpoints && RestoreCheckpoint())
+        {
+            // Events are derived from the restored particles, as in UpdateEventsAfterRescaling
+            InitializeVerletSkin();
+            InitializeEvents();
+            return;
+        }
+
         ParticlePair closestPair = closestPairProvider->FindClosestPair();
         innerDiameterRatio = sqrt(closestPair.normalizedDistanceSquare);
         if (preserveInitialDiameter)
@@ -113,10 +141,27 @@ decreasing the diameters will lead to unexpected consequences (e.g., incorrect d
 
         velocityService.FillVelocities(&movingParticles);
 
+        InitializeVerletSkin();
         InitializeEvents();
         shouldContinue = true;
     }
 
+    void LubachevsckyStillingerStep::CreateEventsQueue()
+    {
+        if (eventsQueueType == EventsQueueType::Calendar)
+        {
+            eventsQueue.reset(new CalendarOrderedPriorityQueue<vector<MovingParticle>, MovingParticleComparer>());
+        }
+        else if (eventsQueueType == EventsQueueType::KeyHeap)
+        {
+            eventsQueue.reset(new KeyOrderedPriorityQueue<vector<MovingParticle>, MovingParticleComparer>());
+        }
+        else
+        {
+            eventsQueue.reset(new OrderedPriorityQueue<vector<MovingParticle>, MovingParticleComparer>());
+        }
+    }
+
     void LubachevsckyStillingerStep::CreateEventProviders()
     {
         eventProviders.clear();
@@ -132,8 +177,8 @@ decreasing the diameters will lead to unexpected consequences (e.g., incorrect d
 
         if (lockParticles)
         {
-            VoronoiTesselationProvider tesselationProvider(&geometryCollisionService, mathService, generationConfig->baseFolder, particles, config->particlesCount);
-//            VoronoiTesselationProvider tesselationProvider(&geometryCollisionService, mathService, "", particles, config->particlesCount);
+            VoronoiTesselationProvider tesselationProvider(&geometryCollisionService, mathService, generationConfig->baseFolder, particles, *config, threadsCount);
+//            VoronoiTesselationProvider tesselationProvider(&geometryCollisionService, mathService, "", particles, *config, threadsCount);
             tesselationProvider.FillVoronoiTesselation(&voronoiTesselation);
 
             boost::shared_ptr<IEventProvider> voronoiTransferEventProvider(new VoronoiTransferEventProvider(&geometryCollisionService, &velocityService, mathService, &voronoiTesselation));
@@ -144,7 +189,7 @@ decreasing the diameters will lead to unexpected consequences (e.g., incorrect d
         MemoryUtility::RemoveOwnership(eventProviders, &eventProvidersNotOwned);
 
         CompositeEventProvider::OptimizeEventProviders(&eventProvidersNotOwned);
-        eventProvider.reset(new CompositeEventProvider(&eventsQueue, &eventProvidersNotOwned));
+        eventProvider.reset(new CompositeEventProvider(eventsQueue.get(), &eventProvidersNotOwned));
     }
 
     void LubachevsckyStillingerStep::CreateEventProcessors()
@@ -186,7 +231,7 @@ decreasing the diameters will lead to unexpected consequences (e.g., incorrect d
         }
 
         MovingParticleComparer comparer;
-        eventsQueue.Initialize(&movingParticles, comparer);
+        eventsQueue->Initialize(&movingParticles, comparer);
 
         vector<ParticleIndex> updatedParticleIndexes;
         for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
@@ -196,21 +241,49 @@ decreasing the diameters will lead to unexpected consequences (e.g., incorrect d
         }
     }
 
+    void LubachevsckyStillingerStep::UpdateEventsAfterRescaling(FLOAT_TYPE velocityRescaleFactor)
+    {
+        // If particles grow, we should recalculate all the events from scratch
+        // (it's incorrect simply to rescale event times proportionally assuming that all the events will occur at the same locations,
+        // as far as relative velocity-radii growth rates have also changed, so even collision locations will change).
+        bool canRescale = updateEventsIncrementally && ratioGrowthRate == 0.0 && velocityRescaleFactor > 0.0 && Math::IsFiniteNumber(velocityRescaleFactor);
+        if (!canRescale)
+        {
+            InitializeEvents();
+            return;
+        }
+
+        // If particles do not grow, all the events are ballistic: particles will pass the same trajectories and collide at the same locations, just faster or slower.
+        // All the particles are synchronized with the current time, so the times left until the events are simply divided by the factor.
+        // The order of events and the "available neighbor" relations between them are preserved.
+        // The small time shifts of the neighbor transfer events (see NeighborTransferEventProvider) are rescaled as well, which only changes them by the order of the shift.
+        // The events that never happen (e.g. of particles at rest) keep MAX_FLOAT_VALUE, as rescaling could overflow it.
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            Event& event = movingParticles[particleIndex].nextAvailableEvent;
+            if (event.type != EventType::InvalidEvent && event.time < MAX_FLOAT_VALUE)
+            {
+                event.time = (event.time - currentTime) / velocityRescaleFactor + currentTime;
+            }
+        }
+
+        MovingParticleComparer comparer;
+        eventsQueue->Initialize(&movingParticles, comparer);
+    }
+
     void LubachevsckyStillingerStep::DisplaceParticles()
     {
         FLOAT_TYPE previousPressure = statistics.reducedPressure;
         ProcessEvents(eventsPerParticle * config->particlesCount);
+        FLOAT_TYPE blockDuration = currentTime;
 
         // The order of the calls below is very crucial, they are very interdependent! TODO: refactor somehow.
-        velocityService.RescaleVelocities(currentTime, statistics.kineticEnergy, &movingParticles);
+        FLOAT_TYPE velocityRescaleFactor = velocityService.RescaleVelocities(currentTime, statistics.kineticEnergy, &movingParticles);
 
         // Double precision epsilon is 2e-16, but for making sure that no finite precision errors occur (e.g. when adding 1e-16 time lapse to global time = 1) we reset time after each generation.
         ResetTime();
 
-        // As far as all the velocities have changed, we should recalculate all the events from scratch
-        // (it's incorrect simply to rescale event times proportionally assuming that all the events will occur at the same locations,
-        // as far as relative velocity-radii growth rates have also changed, so even collision locations will change).
-        InitializeEvents();
+        UpdateEventsAfterRescaling(velocityRescaleFactor);
 
         DisplaceRealParticles();
 
@@ -234,6 +307,173 @@ decreasing the diameters will lead to unexpected consequences (e.g., incorrect d
         {
             shouldContinue = statistics.reducedPressure < maxPressure;
         }
+
+        TuneVerletSkin(blockDuration);
+
+        // The packing is written by the packing generator with the same frequency
+        if (writeCheckpoints && (blocksCount % generationConfig->stepsToWrite) == 0)
+        {
+            WriteCheckpoint();
+        }
+        blocksCount++;
+    }
+
+    void LubachevsckyStillingerStep::SaveState()
+    {
+        if (writeCheckpoints)
+        {
+            WriteCheckpoint();
+        }
+    }
+
+    const vector<MovingParticle>& LubachevsckyStillingerStep::GetMovingParticles() const
+    {
+        return movingParticles;
+    }
+
+    bool LubachevsckyStillingerStep::RestoreCheckpoint()
+    {
+        string checkpointFilePath = Path::Append(generationConfig->baseFolder, CHECKPOINT_FILE_NAME);
+        LubachevsckyStillingerCheckpoint checkpoint;
+        if (!checkpointSerializer.ReadCheckpoint(checkpointFilePath, &checkpoint))
+        {
+            return false;
+        }
+
+        // The checkpoint is valid only for the packing that was written with it
+        const Packing& particlesRef = *particles;
+        bool checkpointMatches = checkpoint.generationAlgorithm == generationConfig->generationAlgorithm &&
+                checkpoint.lockParticles == lockParticles &&
+                static_cast<int>(checkpoint.particles.size()) == config->particlesCount;
+        for (ParticleIndex particleIndex = 0; checkpointMatches && particleIndex < config->particlesCount; ++particleIndex)
+        {
+            const DomainParticle& particle = particlesRef[particleIndex];
+            const DomainParticle& checkpointParticle = checkpoint.particles[particleIndex];
+            checkpointMatches = particle.coordinates == checkpointParticle.coordinates && particle.diameter == checkpointParticle.diameter;
+        }
+
+        if (!checkpointMatches)
+        {
+            printf("WARNING: the checkpoint was written for other particles or another algorithm. Starting from the packing.\n");
+            return false;
+        }
+
+        initialInnerDiameterRatio = checkpoint.initialInnerDiameterRatio;
+        innerDiameterRatio = initialInnerDiameterRatio;
+        ratioGrowthRate = checkpoint.ratioGrowthRate;
+        growthRateUpdatesCount = checkpoint.growthRateUpdatesCount;
+        equilibrationsCount = checkpoint.equilibrationsCount;
+        shouldContinue = checkpoint.shouldContinue;
+        statistics = checkpoint.statistics;
+        currentTime = 0;
+
+        particleCollisionService.Initialize(initialInnerDiameterRatio, ratioGrowthRate);
+
+        movingParticles.resize(config->particlesCount);
+        Particle::CopyPackingTo(*particles, &movingParticles);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            MovingParticle& movingParticle = movingParticles[particleIndex];
+            const MovingParticle& checkpointParticle = checkpoint.movingParticles[particleIndex];
+            movingParticle.coordinates = checkpointParticle.coordinates;
+            movingParticle.velocity = checkpointParticle.velocity;
+            movingParticle.lastEventTime = checkpointParticle.lastEventTime;
+        }
+
+        Math::SetRandomState(checkpoint.randomState);
+
+        printf("Simulation state restored from the checkpoint. Inner diameter ratio: %1.15f, growth rate: %g\n", innerDiameterRatio, ratioGrowthRate);
+        return true;
+    }
+
+    // Shall be called between the blocks of events, when the current time is zero and the real particles are synchronized with it.
+    void LubachevsckyStillingerStep::WriteCheckpoint() const
+    {
+        LubachevsckyStillingerCheckpoint checkpoint;
+        checkpoint.generationAlgorithm = generationConfig->generationAlgorithm;
+        checkpoint.lockParticles = lockParticles;
+        checkpoint.initialInnerDiameterRatio = initialInnerDiameterRatio;
+        checkpoint.ratioGrowthRate = ratioGrowthRate;
+        checkpoint.growthRateUpdatesCount = growthRateUpdatesCount;
+        checkpoint.equilibrationsCount = equilibrationsCount;
+        checkpoint.shouldContinue = shouldContinue;
+        checkpoint.statistics = statistics;
+        Math::FillRandomState(&checkpoint.randomState);
+        checkpoint.particles = *particles;
+        checkpoint.movingParticles = movingParticles;
+
+        string checkpointFilePath = Path::Append(generationConfig->baseFolder, CHECKPOINT_FILE_NAME);
+        checkpointSerializer.WriteCheckpoint(checkpointFilePath, checkpoint);
+    }
+
+    void LubachevsckyStillingerStep::InitializeVerletSkin()
+    {
+        verletListNeighborProvider = NULL;
+        if (!tuneVerletSkin)
+        {
+            return;
+        }
+
+        verletListNeighborProvider = dynamic_cast<VerletListNeighborProvider*>(neighborProvider);
+        if (verletListNeighborProvider == NULL)
+        {
+            throw InvalidOperationException("Verlet skin tuning requires VerletListNeighborProvider.");
+        }
+
+        FLOAT_TYPE meanDiameter = geometryService->GetMeanParticleDiameter(*particles);
+        verletSkinTuner.Initialize(meanDiameter, 0.05 * meanDiameter, 2.0 * meanDiameter);
+
+        // The growth of particles in the first block is unknown, so the usual expected outer diameter ratio is used (or a larger one if particles are already large)
+        FLOAT_TYPE expectedOuterDiameterRatio = std::max(VerletListNeighborProvider::MAX_EXPECTED_OUTER_DIAMETER_RATIO,
+                innerDiameterRatio * VerletListNeighborProvider::MAX_EXPECTED_OUTER_DIAMETER_RATIO);
+        UpdateVerletLists(meanDiameter, expectedOuterDiameterRatio);
+    }
+
+    // Estimates the cost of the last block of events per useful (not NeighborTransfer) event and passes it to the skin tuner.
+    // The cost includes the events processing, the collision checks with all the Verlet neighbors of the event particle,
+    // the checks of the candidates from the base neighbor provider while updating Verlet lists,
+    // and the work of removing the particle from the neighbors' lists and adding it back (linear in list length).
+    // The Verlet lists are rebuilt if the cutoff distance changes or if particles may outgrow the expected outer diameter ratio in the next block.
+    void LubachevsckyStillingerStep::TuneVerletSkin(FLOAT_TYPE blockDuration)
+    {
+        if (verletListNeighborProvider == NULL)
+        {
+            return;
+        }
+
+        FLOAT_TYPE eventsCount = processedEventsCount;
+        FLOAT_TYPE listUpdatesCount = verletListNeighborProvider->GetListUpdatesCount();
+        FLOAT_TYPE checkedCandidatesCount = verletListNeighborProvider->GetCheckedCandidatesCount();
+        FLOAT_TYPE meanListLength = verletListNeighborProvider->GetMeanListLength();
+
+        FLOAT_TYPE cost = eventsCount * (eventCost + meanListLength * pairCheckCost) +
+                checkedCandidatesCount * candidateCheckCost +
+                listUpdatesCount * meanListLength * listElementCost;
+        FLOAT_TYPE usefulEventsCount = eventsCount - listUpdatesCount;
+        cost /= (usefulEventsCount < 1.0) ? 1.0 : usefulEventsCount;
+
+        FLOAT_TYPE cutoffDistance = verletSkinTuner.GetNextCutoffDistance(cost);
+        verletListNeighborProvider->ResetStatistics();
+
+        FLOAT_TYPE ratioGrowth = (ratioGrowthRate > 0.0) ? ratioGrowthRate * blockDuration : 0.0;
+        FLOAT_TYPE requiredOuterDiameterRatio = innerDiameterRatio + 2.0 * ratioGrowth;
+        bool cutoffDistanceChanged = cutoffDistance != verletListNeighborProvider->GetCutoffDistance();
+        bool ratioExceeded = requiredOuterDiameterRatio > verletListNeighborProvider->GetExpectedOuterDiameterRatio();
+        if (cutoffDistanceChanged || ratioExceeded)
+        {
+            // Leave some room for growth, so that the lists are not rebuilt after each block because of the ratio only
+            UpdateVerletLists(cutoffDistance, requiredOuterDiameterRatio + 2.0 * ratioGrowth);
+            InitializeEvents();
+        }
+    }
+
+    // Events should be initialized from scratch after the update. All the moving particles should be synchronized with the current time then (as it is after DisplaceRealParticles).
+    void LubachevsckyStillingerStep::UpdateVerletLists(FLOAT_TYPE cutoffDistance, FLOAT_TYPE expectedOuterDiameterRatio)
+    {
+        verletListNeighborProvider->SetCutoffDistance(cutoffDistance);
+        verletListNeighborProvider->SetExpectedOuterDiameterRatio(expectedOuterDiameterRatio);
+        verletListNeighborProvider->SetParticles(*particles);
+        verletListNeighborProvider->ResetStatistics();
     }
 
     void LubachevsckyStillingerStep::EnsureConstantPower()
@@ -355,7 +595,8 @@ decreasing the diameters will lead to unexpected consequences (e.g., incorrect d
                 {
                     // When there are many more packings than tasks, it's better to restrict computation time,
                     // as there are always several packings (~10%) with extremely long generation times.
-                    FLOAT_TYPE computationTime = (clock() - startTime) / static_cast<double>(CLOCKS_PER_SEC);
+                    // Unlike the time budget of the run, this limit finishes the packing instead of interrupting it.
+                    FLOAT_TYPE computationTime = std::chrono::duration<FLOAT_TYPE>(std::chrono::steady_clock::now() - startTime).count();
                     FLOAT_TYPE maxComputationTime = 6 * 3600; // 6 hours
                     if (computationTime > maxComputationTime)
                     {
@@ -433,11 +674,12 @@ decreasing the diameters will lead to unexpected consequences (e.g., incorrect d
 
         for (int i = 0; i < count; ++i)
         {
-            int nextEventParticleIndex = eventsQueue.GetTopIndex();
+            int nextEventParticleIndex = eventsQueue->GetTopIndex();
             Event nextEvent = movingParticles[nextEventParticleIndex].nextAvailableEvent;
             currentTime = nextEvent.time;
             eventProcessor->ProcessEvent(&movingParticles, nextEvent);
         }
+        processedEventsCount = count;
 
         CalculateStatistics();
     }
@@ -447,7 +689,7 @@ decreasing the diameters will lead to unexpected consequences (e.g., incorrect d
         // Sometimes i get negative exchanged momentum. TODO: investigate this carefully.
         statistics.exchangedMomentum = std::abs(collisionEventProcessor->exchangedMomentum);
         statistics.kineticEnergy = velocityService.GetActualKineticEnergy(movingParticles);
-        statistics.eventsCount = eventsPerParticle * config->particlesCount;
+        statistics.eventsCount = processedEventsCount;
         statistics.timePeriod = currentTime;
 
         // See Otsuki and Hayakawa (2012) Critical scaling of a jammed system after a quench of temperature, formula (3)
@@ -480,7 +722,13 @@ decreasing the diameters will lead to unexpected consequences (e.g., incorrect d
         for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
         {
             movingParticles[particleIndex].lastEventTime -= currentTime;
-            movingParticles[particleIndex].nextAvailableEvent.time -= currentTime;
+
+            // The events that never happen keep MAX_FLOAT_VALUE, so that they are recognized (e.g. not rescaled in UpdateEventsAfterRescaling)
+            Event& event = movingParticles[particleIndex].nextAvailableEvent;
+            if (event.time < MAX_FLOAT_VALUE)
+            {
+                event.time -= currentTime;
+            }
         }
 
         innerDiameterRatio = initialInnerDiameterRatio + ratioGrowthRate * currentTime;
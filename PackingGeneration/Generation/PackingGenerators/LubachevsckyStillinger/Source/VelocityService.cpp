@@ -20,7 +20,7 @@ namespace PackingGenerators
         temperature = 0.2;
     }
 
-    void VelocityService::RescaleVelocities(FLOAT_TYPE currentTime, FLOAT_TYPE actualKineticEnergy, vector<MovingParticle>* particles) const
+    FLOAT_TYPE VelocityService::RescaleVelocities(FLOAT_TYPE currentTime, FLOAT_TYPE actualKineticEnergy, vector<MovingParticle>* particles) const
     {
         // Rescale factor is chosen to reestablish the temperature of the system
         FLOAT_TYPE expectedKineticEnergy = GetExpectedKineticEnergy(*particles);
@@ -37,6 +37,8 @@ namespace PackingGenerators
             SynchronizeParticleWithCurrentTime(currentTime, particle);
             VectorUtilities::MultiplyByValue(particle->velocity, rescaleFactor, &particle->velocity);
         }
+
+        return rescaleFactor;
     }
 
     void VelocityService::SynchronizeParticleWithCurrentTime(FLOAT_TYPE currentTime, MovingParticle* particle) const
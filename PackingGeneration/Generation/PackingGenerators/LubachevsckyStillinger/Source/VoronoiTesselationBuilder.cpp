@@ -0,0 +1,484 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/VoronoiTesselationBuilder.h"
+
+#include <cmath>
+#include <algorithm>
+#include "Core/Headers/Constants.h"
+#include "Core/Headers/Exceptions.h"
+#include "Core/Headers/ThreadPool.h"
+#include "Core/Headers/VectorUtilities.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace PackingServices;
+
+namespace PackingGenerators
+{
+    const FLOAT_TYPE VoronoiTesselationBuilder::GRID_CELL_SIZE_FACTOR = 2.5;
+
+    VoronoiTesselationBuilder::VoronoiTesselationBuilder(MathService* mathService, int threadsCount)
+    {
+        this->mathService = mathService;
+        this->threadsCount = threadsCount;
+        config = NULL;
+        particles = NULL;
+        gridCoverageRadius = 0.0;
+        vertexEpsilon = 0.0;
+        partsCount = 0;
+        voronoiPlanesPerParticle = NULL;
+    }
+
+    VoronoiTesselationBuilder::~VoronoiTesselationBuilder()
+    {
+    }
+
+    void VoronoiTesselationBuilder::FillVoronoiPlanes(const SystemConfig& config, const Packing& particles, vector<vector<VoronoiPlane> >* voronoiPlanesPerParticle)
+    {
+        if (DIMENSIONS != 3)
+        {
+            throw NotImplementedException("Voronoi tesselation is implemented only in 3D.");
+        }
+
+        this->config = &config;
+        this->particles = &particles;
+        this->voronoiPlanesPerParticle = voronoiPlanesPerParticle;
+
+        voronoiPlanesPerParticle->clear();
+        voronoiPlanesPerParticle->resize(config.particlesCount);
+        if (config.particlesCount == 0)
+        {
+            return;
+        }
+
+        // Shall be consistent with MathService::FillDistance
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            periodicAxes[i] = (i == DIMENSIONS - 1) || (config.boundariesMode == BoundariesMode::Bulk);
+        }
+
+        FLOAT_TYPE boxVolume = VectorUtilities::GetProduct(config.packingSize);
+        FLOAT_TYPE meanDistance = pow(boxVolume / config.particlesCount, 1.0 / DIMENSIONS);
+        cellGrid.Fill(config, particles, GRID_CELL_SIZE_FACTOR * meanDistance);
+
+        // All the particles within the coverage radius from a particle are in the neighboring grid cells, and their closest periodic images are the only ones within this radius
+        FLOAT_TYPE minBoxSize = VectorUtilities::GetMinValue(config.packingSize);
+        gridCoverageRadius = cellGrid.AreAllCellsNeighbors() ? 0.5 * minBoxSize : std::min(cellGrid.GetMinCellSize(), 0.5 * minBoxSize);
+        vertexEpsilon = 1e-12 * VectorUtilities::GetMaxValue(config.packingSize);
+
+        ThreadPool threadPool(threadsCount);
+        partsCount = std::min(static_cast<int>(config.particlesCount), threadPool.GetThreadsCount() * PARTS_PER_THREAD);
+        threadPool.Execute(this, partsCount);
+    }
+
+    void VoronoiTesselationBuilder::Execute(int partIndex)
+    {
+        ParticleIndex startIndex = static_cast<ParticleIndex>(static_cast<long long>(config->particlesCount) * partIndex / partsCount);
+        ParticleIndex endIndex = static_cast<ParticleIndex>(static_cast<long long>(config->particlesCount) * (partIndex + 1) / partsCount);
+
+        vector<CellNeighbor> neighbors;
+        vector<CellFace> faces;
+        vector<vector<VoronoiPlane> >& voronoiPlanesPerParticleRef = *voronoiPlanesPerParticle;
+        for (ParticleIndex particleIndex = startIndex; particleIndex < endIndex; ++particleIndex)
+        {
+            FillCellPlanes(particleIndex, &neighbors, &faces, &voronoiPlanesPerParticleRef[particleIndex]);
+        }
+    }
+
+    void VoronoiTesselationBuilder::FillCellPlanes(ParticleIndex particleIndex, vector<CellNeighbor>* neighbors, vector<CellFace>* faces, vector<VoronoiPlane>* planes) const
+    {
+        FillGridNeighbors(particleIndex, neighbors);
+        bool cellIsExact = BuildCell(particleIndex, *neighbors, gridCoverageRadius, faces);
+
+        if (!cellIsExact)
+        {
+            // The periodic images from the other boxes are at least 1.5 box sizes away along some axis
+            FillAllNeighbors(particleIndex, neighbors);
+            FLOAT_TYPE minBoxSize = VectorUtilities::GetMinValue(config->packingSize);
+            cellIsExact = BuildCell(particleIndex, *neighbors, 1.5 * minBoxSize, faces);
+            if (!cellIsExact)
+            {
+                throw InvalidOperationException("Voronoi cell is larger than the box.");
+            }
+        }
+
+        planes->clear();
+        SpatialVector zeroShift;
+        VectorUtilities::InitializeWith(&zeroShift, 0.0);
+        AddPlanes(particleIndex, *faces, zeroShift, planes);
+        AddPeriodicImagePlanes(particleIndex, *faces, planes);
+    }
+
+    void VoronoiTesselationBuilder::FillGridNeighbors(ParticleIndex particleIndex, vector<CellNeighbor>* neighbors) const
+    {
+        neighbors->clear();
+        const SpatialVector& center = particles->at(particleIndex).coordinates;
+
+        int neighborCellIndexes[CellGrid::MAX_NEIGHBOR_CELLS_COUNT];
+        int neighborCellsCount = cellGrid.FillNeighborCellIndexes(cellGrid.GetCellIndex(center), neighborCellIndexes);
+        for (int neighborCellNumber = 0; neighborCellNumber < neighborCellsCount; ++neighborCellNumber)
+        {
+            int cellParticlesCount;
+            const ParticleIndex* cellParticleIndexes = cellGrid.GetCellParticleIndexes(neighborCellIndexes[neighborCellNumber], &cellParticlesCount);
+            for (int i = 0; i < cellParticlesCount; ++i)
+            {
+                CellNeighbor neighbor;
+                neighbor.index = cellParticleIndexes[i];
+                if (neighbor.index == particleIndex)
+                {
+                    continue;
+                }
+
+                mathService->FillDistance(particles->at(neighbor.index).coordinates, center, &neighbor.offset);
+                neighbor.distanceSquare = VectorUtilities::GetSelfDotProduct(neighbor.offset);
+                neighbors->push_back(neighbor);
+            }
+        }
+
+        std::sort(neighbors->begin(), neighbors->end());
+    }
+
+    void VoronoiTesselationBuilder::FillAllNeighbors(ParticleIndex particleIndex, vector<CellNeighbor>* neighbors) const
+    {
+        neighbors->clear();
+        const SpatialVector& center = particles->at(particleIndex).coordinates;
+
+        int shiftsCount = 1;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            shiftsCount *= periodicAxes[i] ? 3 : 1;
+        }
+
+        for (ParticleIndex index = 0; index < config->particlesCount; ++index)
+        {
+            SpatialVector closestOffset;
+            mathService->FillDistance(particles->at(index).coordinates, center, &closestOffset);
+
+            for (int shiftIndex = 0; shiftIndex < shiftsCount; ++shiftIndex)
+            {
+                CellNeighbor neighbor;
+                neighbor.index = index;
+                int remainder = shiftIndex;
+                for (int i = 0; i < DIMENSIONS; ++i)
+                {
+                    int shift = 0;
+                    if (periodicAxes[i])
+                    {
+                        shift = remainder % 3 - 1;
+                        remainder /= 3;
+                    }
+                    neighbor.offset[i] = closestOffset[i] + shift * config->packingSize[i];
+                }
+
+                neighbor.distanceSquare = VectorUtilities::GetSelfDotProduct(neighbor.offset);
+                if (neighbor.distanceSquare > 0.0)
+                {
+                    neighbors->push_back(neighbor);
+                }
+            }
+        }
+
+        std::sort(neighbors->begin(), neighbors->end());
+    }
+
+    bool VoronoiTesselationBuilder::BuildCell(ParticleIndex particleIndex, const vector<CellNeighbor>& neighbors, FLOAT_TYPE coverageRadius, vector<CellFace>* faces) const
+    {
+        InitializeCell(particles->at(particleIndex).coordinates, faces);
+        FLOAT_TYPE maxVertexDistanceSquare = GetMaxVertexDistanceSquare(*faces);
+
+        for (vector<CellNeighbor>::const_iterator it = neighbors.begin(); it != neighbors.end(); ++it)
+        {
+            const CellNeighbor& neighbor = *it;
+
+            // The bisector planes of this and all the farther neighbors do not reach the cell vertices
+            if (neighbor.distanceSquare >= 4.0 * maxVertexDistanceSquare)
+            {
+                return true;
+            }
+
+            FLOAT_TYPE neighborDistance = sqrt(neighbor.distanceSquare);
+            SpatialVector normal;
+            VectorUtilities::DivideByValue(neighbor.offset, neighborDistance, &normal);
+            CutCell(normal, 0.5 * neighborDistance, neighbor.index, faces);
+            maxVertexDistanceSquare = GetMaxVertexDistanceSquare(*faces);
+        }
+
+        return 4.0 * maxVertexDistanceSquare <= coverageRadius * coverageRadius;
+    }
+
+    void VoronoiTesselationBuilder::InitializeCell(const SpatialVector& center, vector<CellFace>* faces) const
+    {
+        // Along the periodic axes the initial box is larger than any exact cell; along the other axes it is bounded by the box walls
+        SpatialVector lowerBounds;
+        SpatialVector upperBounds;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            lowerBounds[i] = periodicAxes[i] ? -config->packingSize[i] : -center[i];
+            upperBounds[i] = periodicAxes[i] ? config->packingSize[i] : config->packingSize[i] - center[i];
+        }
+
+        faces->clear();
+        faces->resize(2 * DIMENSIONS);
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            int firstAxis = (i + 1) % DIMENSIONS;
+            int secondAxis = (i + 2) % DIMENSIONS;
+            for (int side = 0; side < 2; ++side)
+            {
+                CellFace& face = faces->at(2 * i + side);
+                VectorUtilities::InitializeWith(&face.normal, 0.0);
+                face.normal[i] = (side == 0) ? -1.0 : 1.0;
+                face.distance = (side == 0) ? -lowerBounds[i] : upperBounds[i];
+                face.neighborIndex = -1;
+
+                // Corners of the box face in the order of traversal
+                const int firstCornerSides[4] = {0, 1, 1, 0};
+                const int secondCornerSides[4] = {0, 0, 1, 1};
+                face.vertices.resize(4);
+                for (int k = 0; k < 4; ++k)
+                {
+                    SpatialVector& vertex = face.vertices[k];
+                    vertex[i] = (side == 0) ? lowerBounds[i] : upperBounds[i];
+                    vertex[firstAxis] = (firstCornerSides[k] == 0) ? lowerBounds[firstAxis] : upperBounds[firstAxis];
+                    vertex[secondAxis] = (secondCornerSides[k] == 0) ? lowerBounds[secondAxis] : upperBounds[secondAxis];
+                }
+            }
+        }
+    }
+
+    void VoronoiTesselationBuilder::CutCell(const SpatialVector& normal, FLOAT_TYPE distance, ParticleIndex neighborIndex, vector<CellFace>* faces) const
+    {
+        CellFace newFace;
+        newFace.normal = normal;
+        newFace.distance = distance;
+        newFace.neighborIndex = neighborIndex;
+
+        bool cellIsCut = false;
+        vector<SpatialVector> clippedVertices;
+        for (vector<CellFace>::iterator faceIterator = faces->begin(); faceIterator != faces->end(); )
+        {
+            vector<SpatialVector>& vertices = faceIterator->vertices;
+            int verticesCount = vertices.size();
+
+            // Clip the face polygon (Sutherland-Hodgman); the points on the plane form the new face
+            clippedVertices.clear();
+            for (int i = 0; i < verticesCount; ++i)
+            {
+                const SpatialVector& vertex = vertices[i];
+                const SpatialVector& nextVertex = vertices[(i + 1) % verticesCount];
+                FLOAT_TYPE vertexDistance = VectorUtilities::GetDotProduct(normal, vertex) - distance;
+                FLOAT_TYPE nextVertexDistance = VectorUtilities::GetDotProduct(normal, nextVertex) - distance;
+
+                bool vertexInside = vertexDistance <= vertexEpsilon;
+                bool nextVertexInside = nextVertexDistance <= vertexEpsilon;
+                if (vertexInside)
+                {
+                    clippedVertices.push_back(vertex);
+                    if (vertexDistance >= -vertexEpsilon)
+                    {
+                        newFace.vertices.push_back(vertex);
+                    }
+                }
+                else
+                {
+                    cellIsCut = true;
+                }
+
+                if (vertexInside != nextVertexInside && std::abs(vertexDistance) > vertexEpsilon && std::abs(nextVertexDistance) > vertexEpsilon)
+                {
+                    FLOAT_TYPE fraction = vertexDistance / (vertexDistance - nextVertexDistance);
+                    SpatialVector intersection;
+                    for (int j = 0; j < DIMENSIONS; ++j)
+                    {
+                        intersection[j] = vertex[j] + fraction * (nextVertex[j] - vertex[j]);
+                    }
+                    clippedVertices.push_back(intersection);
+                    newFace.vertices.push_back(intersection);
+                }
+            }
+
+            if (clippedVertices.size() < 3)
+            {
+                faceIterator = faces->erase(faceIterator);
+            }
+            else
+            {
+                vertices.swap(clippedVertices);
+                ++faceIterator;
+            }
+        }
+
+        if (!cellIsCut)
+        {
+            return;
+        }
+
+        OrderFaceVertices(&newFace);
+        if (newFace.vertices.size() >= 3)
+        {
+            faces->push_back(newFace);
+        }
+    }
+
+    void VoronoiTesselationBuilder::OrderFaceVertices(CellFace* face) const
+    {
+        vector<SpatialVector>& vertices = face->vertices;
+        if (vertices.size() < 3)
+        {
+            return;
+        }
+
+        SpatialVector faceCenter;
+        VectorUtilities::InitializeWith(&faceCenter, 0.0);
+        for (vector<SpatialVector>::const_iterator it = vertices.begin(); it != vertices.end(); ++it)
+        {
+            VectorUtilities::Add(faceCenter, *it, &faceCenter);
+        }
+        VectorUtilities::DivideByValue(faceCenter, static_cast<FLOAT_TYPE>(vertices.size()), &faceCenter);
+
+        // Two orthogonal axes in the face plane
+        const SpatialVector& normal = face->normal;
+        SpatialVector firstAxis;
+        int minNormalAxis = 0;
+        for (int i = 1; i < DIMENSIONS; ++i)
+        {
+            if (std::abs(normal[i]) < std::abs(normal[minNormalAxis]))
+            {
+                minNormalAxis = i;
+            }
+        }
+        VectorUtilities::MultiplyByValue(normal, -normal[minNormalAxis], &firstAxis);
+        firstAxis[minNormalAxis] += 1.0;
+        VectorUtilities::DivideByValue(firstAxis, VectorUtilities::GetLength(firstAxis), &firstAxis);
+
+        SpatialVector secondAxis;
+        secondAxis[Axis::X] = normal[Axis::Y] * firstAxis[Axis::Z] - normal[Axis::Z] * firstAxis[Axis::Y];
+        secondAxis[Axis::Y] = normal[Axis::Z] * firstAxis[Axis::X] - normal[Axis::X] * firstAxis[Axis::Z];
+        secondAxis[Axis::Z] = normal[Axis::X] * firstAxis[Axis::Y] - normal[Axis::Y] * firstAxis[Axis::X];
+
+        vector<pair<FLOAT_TYPE, int> > angles(vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++i)
+        {
+            SpatialVector difference;
+            VectorUtilities::Subtract(vertices[i], faceCenter, &difference);
+            angles[i].first = atan2(VectorUtilities::GetDotProduct(difference, secondAxis), VectorUtilities::GetDotProduct(difference, firstAxis));
+            angles[i].second = i;
+        }
+        std::sort(angles.begin(), angles.end());
+
+        // The vertices shared by neighboring clipped faces are added twice
+        vector<SpatialVector> orderedVertices;
+        for (size_t i = 0; i < angles.size(); ++i)
+        {
+            const SpatialVector& vertex = vertices[angles[i].second];
+            if (!orderedVertices.empty() && AreVerticesEqual(vertex, orderedVertices.back()))
+            {
+                continue;
+            }
+            orderedVertices.push_back(vertex);
+        }
+        while (orderedVertices.size() > 1 && AreVerticesEqual(orderedVertices.front(), orderedVertices.back()))
+        {
+            orderedVertices.pop_back();
+        }
+
+        vertices.swap(orderedVertices);
+    }
+
+    bool VoronoiTesselationBuilder::AreVerticesEqual(const SpatialVector& vertex, const SpatialVector& otherVertex) const
+    {
+        SpatialVector difference;
+        VectorUtilities::Subtract(vertex, otherVertex, &difference);
+        return VectorUtilities::GetSelfDotProduct(difference) <= 100.0 * vertexEpsilon * vertexEpsilon;
+    }
+
+    void VoronoiTesselationBuilder::AddPlanes(ParticleIndex particleIndex, const vector<CellFace>& faces, const SpatialVector& shift, vector<VoronoiPlane>* planes) const
+    {
+        const SpatialVector& center = particles->at(particleIndex).coordinates;
+        SpatialVector shiftedCenter;
+        VectorUtilities::Add(center, shift, &shiftedCenter);
+
+        for (vector<CellFace>::const_iterator it = faces.begin(); it != faces.end(); ++it)
+        {
+            const CellFace& face = *it;
+
+            // normal * (x - shiftedCenter) = distance
+            VoronoiPlane plane;
+            plane.normal = face.normal;
+            plane.displacement = - face.distance - VectorUtilities::GetDotProduct(face.normal, shiftedCenter);
+            plane.particleIndex = particleIndex;
+            plane.neighborIndex = face.neighborIndex;
+            planes->push_back(plane);
+        }
+    }
+
+    void VoronoiTesselationBuilder::AddPeriodicImagePlanes(ParticleIndex particleIndex, const vector<CellFace>& faces, vector<VoronoiPlane>* planes) const
+    {
+        const SpatialVector& center = particles->at(particleIndex).coordinates;
+
+        SpatialVector lowerBounds;
+        SpatialVector upperBounds;
+        VectorUtilities::InitializeWith(&lowerBounds, MAX_FLOAT_VALUE);
+        VectorUtilities::InitializeWith(&upperBounds, -MAX_FLOAT_VALUE);
+        for (vector<CellFace>::const_iterator faceIterator = faces.begin(); faceIterator != faces.end(); ++faceIterator)
+        {
+            for (vector<SpatialVector>::const_iterator vertexIterator = faceIterator->vertices.begin(); vertexIterator != faceIterator->vertices.end(); ++vertexIterator)
+            {
+                for (int i = 0; i < DIMENSIONS; ++i)
+                {
+                    lowerBounds[i] = std::min(lowerBounds[i], center[i] + (*vertexIterator)[i]);
+                    upperBounds[i] = std::max(upperBounds[i], center[i] + (*vertexIterator)[i]);
+                }
+            }
+        }
+
+        int shiftsCount = 1;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            shiftsCount *= periodicAxes[i] ? 3 : 1;
+        }
+
+        for (int shiftIndex = 0; shiftIndex < shiftsCount; ++shiftIndex)
+        {
+            SpatialVector shift;
+            bool imageIntersectsBox = true;
+            bool shiftIsZero = true;
+            int remainder = shiftIndex;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                int axisShift = 0;
+                if (periodicAxes[i])
+                {
+                    axisShift = remainder % 3 - 1;
+                    remainder /= 3;
+                }
+                shift[i] = axisShift * config->packingSize[i];
+                shiftIsZero = shiftIsZero && (axisShift == 0);
+                imageIntersectsBox = imageIntersectsBox && (lowerBounds[i] + shift[i] < config->packingSize[i]) && (upperBounds[i] + shift[i] > 0.0);
+            }
+
+            if (!shiftIsZero && imageIntersectsBox)
+            {
+                AddPlanes(particleIndex, faces, shift, planes);
+            }
+        }
+    }
+
+    FLOAT_TYPE VoronoiTesselationBuilder::GetMaxVertexDistanceSquare(const vector<CellFace>& faces)
+    {
+        FLOAT_TYPE maxDistanceSquare = 0.0;
+        for (vector<CellFace>::const_iterator faceIterator = faces.begin(); faceIterator != faces.end(); ++faceIterator)
+        {
+            for (vector<SpatialVector>::const_iterator vertexIterator = faceIterator->vertices.begin(); vertexIterator != faceIterator->vertices.end(); ++vertexIterator)
+            {
+                maxDistanceSquare = std::max(maxDistanceSquare, VectorUtilities::GetSelfDotProduct(*vertexIterator));
+            }
+        }
+        return maxDistanceSquare;
+    }
+}
@@ -11,6 +11,8 @@
 #include "Core/Headers/Path.h"
 #include "Generation/PackingServices/Headers/GeometryCollisionService.h"
 #include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/Model/Headers/Config.h"
+#include "../Headers/VoronoiTesselationBuilder.h"
 
 using namespace PackingServices;
 using namespace Core;
@@ -23,12 +25,16 @@ namespace PackingGenerators
             PackingServices::MathService* mathService,
             string baseFolder,
             const Packing* particles,
-            Model::ParticleIndex particlesCount)
+            const SystemConfig& config,
+            int threadsCount)
     {
         this->geometryCollisionService = geometryCollisionService;
+        this->mathService = mathService;
         this->baseFolder = baseFolder;
         this->particles = particles;
-        this->particlesCount = particlesCount;
+        this->config = &config;
+        this->particlesCount = config.particlesCount;
+        this->threadsCount = threadsCount;
     }
 
     void VoronoiTesselationProvider::FillVoronoiTesselation(std::vector<VoronoiPolytope>* voronoiTesselation) const
@@ -55,18 +61,29 @@ namespace PackingGenerators
         string cachePath = Path::Append(baseFolder, "Cache");
         string voronoiTesselationPath = Path::Append(cachePath, "mainVoronoi.txt");
         string periodicIndexesMapPath = Path::Append(cachePath, "mainPeriodicIndexesMap.txt");
+        string cachedTesselationPath = Path::Append(cachePath, "voronoiTesselation.bin");
 
         if (!Path::Exists(voronoiTesselationPath))
         {
-            throw InvalidOperationException("Voronoi tesselation not found. Please prepare it by qhull prior to running this code.");
+            if (!ReadCachedTesselation(cachedTesselationPath, voronoiTesselation))
+            {
+                vector<vector<VoronoiPlane> > voronoiPlanesPerParticle;
+                BuildVoronoiPlanes(&voronoiPlanesPerParticle);
+                FillVoronoiTesselation(voronoiPlanesPerParticle, voronoiTesselation);
+
+                Path::EnsureDirectory(cachePath);
+                WriteCachedTesselation(cachedTesselationPath, *voronoiTesselation);
+            }
+
+            SetInscribedSpheres(*particles, voronoiTesselation);
+            return;
         }
+
         if (!Path::Exists(periodicIndexesMapPath))
         {
             throw InvalidOperationException("Periodic indexes map not found. Please prepare it prior to running this code.");
         }
 
-        // TODO: implement creating periodic images of particles, saving periodicIndexesMap, particles in qhul format, running qhul. Currently it's done by MATLAB codes.
-
         vector<ParticleIndex> periodicIndexesMap;
         ReadPeriodicIndexesMap(periodicIndexesMapPath, &periodicIndexesMap);
 
@@ -80,6 +97,101 @@ namespace PackingGenerators
         SetInscribedSpheres(*particles, voronoiTesselation);
     }
 
+    void VoronoiTesselationProvider::BuildVoronoiPlanes(vector<vector<VoronoiPlane> >* voronoiPlanesPerParticle) const
+    {
+        printf("Building Voronoi tesselation...\n");
+        VoronoiTesselationBuilder tesselationBuilder(mathService, threadsCount);
+        tesselationBuilder.FillVoronoiPlanes(*config, *particles, voronoiPlanesPerParticle);
+    }
+
+    bool VoronoiTesselationProvider::ReadCachedTesselation(string path, vector<VoronoiPolytope>* voronoiTesselation) const
+    {
+        if (!Path::Exists(path))
+        {
+            return false;
+        }
+
+        ScopedFile<LogErrorHandler> file(path, FileOpenMode::Read | FileOpenMode::Binary);
+        int header[2];
+        if (fread(header, sizeof(int), 2, file) != 2 || header[0] != CACHE_FORMAT_VERSION || header[1] != particlesCount)
+        {
+            return false;
+        }
+
+        const Packing& particlesRef = *particles;
+        voronoiTesselation->clear();
+        voronoiTesselation->resize(particlesCount);
+        vector<FLOAT_TYPE> planeValues;
+        for (ParticleIndex i = 0; i < particlesCount; ++i)
+        {
+            SpatialVector center;
+            int planesCount;
+            if (fread(&center[0], sizeof(FLOAT_TYPE), DIMENSIONS, file) != DIMENSIONS || fread(&planesCount, sizeof(int), 1, file) != 1)
+            {
+                voronoiTesselation->clear();
+                return false;
+            }
+
+            // The cache of another packing is rebuilt
+            bool centersEqual = true;
+            for (int j = 0; j < DIMENSIONS; ++j)
+            {
+                centersEqual = centersEqual && (center[j] == particlesRef[i].coordinates[j]);
+            }
+
+            const size_t valuesCount = planesCount * (DIMENSIONS + 1);
+            planeValues.resize(valuesCount);
+            if (!centersEqual || planesCount < 0 || (valuesCount > 0 && fread(&planeValues[0], sizeof(FLOAT_TYPE), valuesCount, file) != valuesCount))
+            {
+                voronoiTesselation->clear();
+                return false;
+            }
+
+            vector<Plane>& planes = voronoiTesselation->at(i).planes;
+            planes.resize(planesCount);
+            for (int planeIndex = 0; planeIndex < planesCount; ++planeIndex)
+            {
+                const FLOAT_TYPE* values = &planeValues[planeIndex * (DIMENSIONS + 1)];
+                for (int j = 0; j < DIMENSIONS; ++j)
+                {
+                    planes[planeIndex].normal[j] = values[j];
+                }
+                planes[planeIndex].displacement = values[DIMENSIONS];
+            }
+        }
+
+        printf("Voronoi tesselation read from cache\n");
+        return true;
+    }
+
+    void VoronoiTesselationProvider::WriteCachedTesselation(string path, const vector<VoronoiPolytope>& voronoiTesselation) const
+    {
+        ScopedFile<LogErrorHandler> file(path, FileOpenMode::Write | FileOpenMode::Binary);
+        int header[2] = {CACHE_FORMAT_VERSION, particlesCount};
+        fwrite(header, sizeof(int), 2, file);
+
+        const Packing& particlesRef = *particles;
+        vector<FLOAT_TYPE> planeValues;
+        for (ParticleIndex i = 0; i < particlesCount; ++i)
+        {
+            const vector<Plane>& planes = voronoiTesselation[i].planes;
+            int planesCount = planes.size();
+            fwrite(&particlesRef[i].coordinates[0], sizeof(FLOAT_TYPE), DIMENSIONS, file);
+            fwrite(&planesCount, sizeof(int), 1, file);
+
+            planeValues.clear();
+            for (vector<Plane>::const_iterator it = planes.begin(); it != planes.end(); ++it)
+            {
+                planeValues.insert(planeValues.end(), it->normal.begin(), it->normal.end());
+                planeValues.push_back(it->displacement);
+            }
+            if (!planeValues.empty())
+            {
+                fwrite(&planeValues[0], sizeof(FLOAT_TYPE), planeValues.size(), file);
+            }
+        }
+    }
+
     void VoronoiTesselationProvider::SetInscribedSpheres(const Packing& particles, std::vector<VoronoiPolytope>* voronoiTesselation) const
     {
         int index = 0;
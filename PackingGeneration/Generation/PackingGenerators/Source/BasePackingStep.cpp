@@ -70,6 +70,11 @@ namespace PackingGenerators
         theoreticalPorosity = CalculateTheoreticalPorosity();
     }
 
+    void BasePackingStep::SaveState()
+    {
+        // The generation is continued from the particles only
+    }
+
     FLOAT_TYPE BasePackingStep::GetInnerDiameterRatio() const
     {
         return innerDiameterRatio;
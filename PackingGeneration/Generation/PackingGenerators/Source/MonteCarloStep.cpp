@@ -139,7 +139,7 @@ namespace PackingGenerators
         SpatialVector displacement;
         for (int i = 0; i < DIMENSIONS; ++i)
         {
-            displacement[i] = factor * rand();
+            displacement[i] = factor * Math::GetNextRandomInteger();
         }
 
         VectorUtilities::Add(particle->coordinates, displacement, &particle->coordinates);
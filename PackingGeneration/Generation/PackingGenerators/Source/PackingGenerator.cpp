@@ -8,11 +8,13 @@
 #include "Core/Headers/Path.h"
 #include "Core/Headers/StlUtilities.h"
 #include "Core/Headers/MpiManager.h"
+#include "Core/Headers/TimeBudget.h"
 #include "../Headers/IPackingStep.h"
 #include "Generation/Model/Headers/Config.h"
 #include "Generation/Geometries/Headers/IGeometry.h"
 #include "Generation/PackingServices/Headers/MathService.h"
 #include "Generation/PackingServices/Headers/PackingSerializer.h"
+#include "Generation/PackingServices/Headers/AsyncPackingWriter.h"
 #include "Generation/PackingServices/Headers/GeometryService.h"
 #include "Generation/PackingServices/DistanceServices/Headers/VerletListNeighborProvider.h"
 
@@ -30,12 +32,15 @@ namespace PackingGenerators
     PackingGenerator::PackingGenerator(PackingSerializer* packingSerializer,
             GeometryService* geometryService,
             MathService* mathService,
-            IPackingStep* packingStep)
+            IPackingStep* packingStep,
+            int threadsCount) :
+            closestPairService(mathService, geometryService, threadsCount)
     {
         this->packingSerializer = packingSerializer;
         this->geometryService = geometryService;
         this->mathService = mathService;
         this->packingStep = packingStep;
+        checkOuterDiameterRatio = true;
     }
 
     PackingGenerator::~PackingGenerator()
@@ -58,6 +63,7 @@ namespace PackingGenerators
         geometryService->SetContext(context);
         mathService->SetContext(context);
         packingStep->SetContext(context);
+        closestPairService.SetContext(context);
     }
 
     // TODO: Refactor!
@@ -77,11 +83,13 @@ namespace PackingGenerators
         if (!packingStep->ShouldContinue())
         {
             printf("Packing is correct, generation not started.\n");
-            CheckIntersectionsNaive();
+            CheckIntersections();
             Finish(0, 0);
             return;
         }
 
+        // Is destroyed before leaving the method (even on errors), so all the snapshots are written by then
+        AsyncPackingWriter packingWriter(packingSerializer, MAX_QUEUED_SNAPSHOTS_COUNT);
         while (shouldContinue)
         {
             packingStep->DisplaceParticles();
@@ -91,7 +99,7 @@ namespace PackingGenerators
 
             // TODO: make this check specific for each neighbor provider. Or even better: allow initial max outerDiameterRatio specification for neighbor providers.
             // Even better: allow dynamic max outerDiameterRatio specification for neighbor providers.
-            if (outerDiameterRatio > VerletListNeighborProvider::MAX_EXPECTED_OUTER_DIAMETER_RATIO)
+            if (checkOuterDiameterRatio && outerDiameterRatio > VerletListNeighborProvider::MAX_EXPECTED_OUTER_DIAMETER_RATIO)
             {
                 printf("WARNING: The outerDiameterRatio exceeds the one expected by VerletListNeighborProvider.\n");
                 // throw InvalidOperationException("The outerDiameterRatio exceeds the one expected with Verlet List.");
@@ -99,15 +107,22 @@ namespace PackingGenerators
 
             if ((iterationIndex % generationConfig->stepsToWrite) == 0)
             {
-                clock_t currentDelay = Log(iterationIndex);
+                clock_t currentDelay = Log(iterationIndex, &packingWriter);
                 delay = delay + currentDelay;
             }
 
             iterationIndex++;
+
+            if (shouldContinue && TimeBudget::GetInstance()->IsExpired())
+            {
+                SaveResumableState(iterationIndex, &packingWriter);
+                throw TimeBudgetExpiredException("The time budget has expired. The generation will be continued by the next run.");
+            }
         }
+        packingWriter.Flush();
 
         DisplayPorosity();
-        CheckIntersectionsNaive();
+        CheckIntersections();
 
         clock_t totalTime = clock() - startTime - delay;
         Finish(totalTime, iterationIndex);
@@ -118,17 +133,17 @@ namespace PackingGenerators
         return innerDiameterRatio;
     }
 
-    void PackingGenerator::CheckIntersectionsNaive() const
+    void PackingGenerator::CheckIntersections()
     {
-        printf("Checking min particle distance in a naive way...\n");
-        ParticlePair closestPair = geometryService->GetMinNormalizedDistanceNaive(*particles);
+        printf("Checking min particle distance with a cell grid...\n");
+        ParticlePair closestPair = closestPairService.FindClosestPair(*particles);
         FLOAT_TYPE minNormalizedDistance = sqrt(closestPair.normalizedDistanceSquare);
 
         if (std::abs(minNormalizedDistance - innerDiameterRatio) > EPSILON)
         {
-            printf("ERROR: innerDiameterRatio %g is not equal to min normalized distance from naive computation %g in the pair %d %d. Probably bugs in distance provider.\n",
+            printf("ERROR: innerDiameterRatio %g is not equal to min normalized distance from the cell grid %g in the pair %d %d. Probably bugs in distance provider.\n",
                     innerDiameterRatio, minNormalizedDistance, closestPair.firstParticleIndex, closestPair.secondParticleIndex);
-            throw InvalidOperationException("InnerDiameterRatio is not equal to min normalized distance from naive computation.");
+            throw InvalidOperationException("InnerDiameterRatio is not equal to min normalized distance from the cell grid.");
         }
     }
 
@@ -160,31 +175,37 @@ namespace PackingGenerators
         printf("Time: %g s, iterations are %llu\n", info.totalTime, iterationCounter);
     }
 
-    clock_t PackingGenerator::Log(unsigned long long iterationCounter) const
+    clock_t PackingGenerator::Log(unsigned long long iterationCounter, AsyncPackingWriter* packingWriter) const
     {
         clock_t startTime = clock();
         printf("Step %llu. Inner diameter ratio is %1.15f. Outer diameter ratio is %1.15f. Writing int. packing state...", iterationCounter, innerDiameterRatio, outerDiameterRatio);
         printf("Contraction rate: %e\n", generationConfig->contractionRate);
 
         string packingFilePath = Path::Append(generationConfig->baseFolder, PACKING_FILE_NAME);
-        // Renaming the previously saved packing. Though all IO is set up to flush the buffer immediately,
-        // packing files may be empty, when the program is terminated (at least by the MPI timeout).
-        // May be I should switch to MPI IO?
-        if (Path::Exists(packingFilePath))
-        {
-            string previousPackingFilePath = Path::Append(generationConfig->baseFolder, PREVIOUS_PACKING_FILE_NAME);
-            if (Path::Exists(packingFilePath))
-            {
-                Path::DeleteFile(previousPackingFilePath);
-            }
-            Path::Rename(packingFilePath, previousPackingFilePath);
-        }
-        packingSerializer->SerializePacking(packingFilePath, *particles);
+        string previousPackingFilePath = Path::Append(generationConfig->baseFolder, PREVIOUS_PACKING_FILE_NAME);
+        packingWriter->WritePacking(packingFilePath, previousPackingFilePath, *particles);
 
         printf("done.\n");
         return clock() - startTime;
     }
 
+    void PackingGenerator::SaveResumableState(unsigned long long iterationCounter, AsyncPackingWriter* packingWriter) const
+    {
+        Log(iterationCounter, packingWriter);
+        packingWriter->Flush();
+        packingStep->SaveState();
+
+        // The next run shall read the packing instead of creating the initial one. The config is reread, as the packing step may have updated it (e.g. the contraction rate).
+        ExecutionConfig actualExecutionConfig;
+        packingSerializer->ReadConfig(generationConfig->baseFolder, &actualExecutionConfig);
+        actualExecutionConfig.generationConfig.shouldStartGeneration.value = false;
+        actualExecutionConfig.systemConfig.MergeWith(*config);
+        actualExecutionConfig.generationConfig.MergeWith(*generationConfig);
+
+        string configPath = Path::Append(generationConfig->baseFolder, CONFIG_FILE_NAME);
+        packingSerializer->SerializeConfig(configPath, actualExecutionConfig);
+    }
+
     FLOAT_TYPE PackingGenerator::CalculateTheoreticalPorosity() const
     {
         return CalculateCurrentPorosity(1.0);
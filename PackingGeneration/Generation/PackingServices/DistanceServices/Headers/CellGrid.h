@@ -0,0 +1,67 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Generation_PackingServices_DistanceServices_Headers_CellGrid_h
+#define Generation_PackingServices_DistanceServices_Headers_CellGrid_h
+
+#include <vector>
+#include "Core/Headers/Macros.h"
+#include "Generation/Model/Headers/Types.h"
+namespace Model { class SystemConfig; }
+
+namespace PackingServices
+{
+    // A temporary cell grid over a static packing for the services, which scan all the pairs of particles closer than a cutoff exactly once
+    // (e.g. for the final closest pair check or the pair correlation function). Unlike the neighbor providers, it is not updated when particles move,
+    // but it is const after filling, so that several threads may scan different cells.
+    // The boundaries are considered periodic. For other boundaries the pairs across the box are scanned needlessly, but correctly.
+    class CellGrid
+    {
+    public:
+        static const int MAX_NEIGHBOR_CELLS_COUNT = 27;
+
+    private:
+        Core::DiscreteSpatialVector cellsCounts;
+        Core::SpatialVector cellSize;
+        std::vector<int> cellOffsets; // particles of the cell i are cellParticleIndexes[cellOffsets[i]], ..., cellParticleIndexes[cellOffsets[i + 1] - 1]
+        std::vector<Model::ParticleIndex> cellParticleIndexes;
+        std::vector<int> particleCellIndexes;
+
+    public:
+        CellGrid();
+
+        // Cells are not smaller than minCellSize, so the particles closer than minCellSize are in the neighboring cells.
+        void Fill(const Model::SystemConfig& config, const Model::Packing& particles, Core::FLOAT_TYPE minCellSize);
+
+        int GetCellsCount() const;
+
+        // If there are less than three cells in each dimension, all the cells are neighbors, and all the pairs are scanned.
+        bool AreAllCellsNeighbors() const;
+
+        // Returns the cell of the point. Points outside the box are mapped periodically.
+        int GetCellIndex(const Core::SpatialVector& point) const;
+
+        // Returns the smallest cell size among dimensions. Points in non-neighboring cells are at least that far from each other.
+        Core::FLOAT_TYPE GetMinCellSize() const;
+
+        // Returns the particles of the cell. The indexes are sorted in the ascending order.
+        const Model::ParticleIndex* GetCellParticleIndexes(int cellIndex, int* particlesCount) const;
+
+        // Fills the cells, which are neighbors of the given cell (including the cell itself), without repetitions. Returns the number of the neighbors.
+        int FillNeighborCellIndexes(int cellIndex, int* neighborCellIndexes) const;
+
+        ~CellGrid();
+
+    private:
+        int GetCellIndex(const Core::DiscreteSpatialVector& cellPoint) const;
+
+        // Fills the coordinates of the cells along the dimension, which are neighbors of the cell with the given coordinate (including the cell itself), without repetitions.
+        // Returns the number of the neighbors (not more than 3).
+        int FillNeighborCellCoordinates(int dimension, int cellCoordinate, int* neighborCellCoordinates) const;
+
+        DISALLOW_COPY_AND_ASSIGN(CellGrid);
+    };
+}
+
+#endif /* Generation_PackingServices_DistanceServices_Headers_CellGrid_h */
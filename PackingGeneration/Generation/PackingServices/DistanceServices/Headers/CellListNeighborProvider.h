@@ -5,7 +5,7 @@
 #ifndef Generation_PackingServices_DistanceServices_Headers_CellListNeighborProvider_h
 #define Generation_PackingServices_DistanceServices_Headers_CellListNeighborProvider_h
 
-#include <map>
+#include <vector>
 #include "Core/Geometry/Headers/GeometryParameters.h"
 #include "Core/Lattice/Headers/LatticeIndexingProvider.h"
 #include "Core/Lattice/Headers/GenericLattice.h"
@@ -30,16 +30,27 @@ namespace PackingServices
         // In this implementation, each cell contains particles from 27 neighboring cells from the previous implementation, each particle belongs to 27 cells.
         // It allows to avoid joining of 27 lists at every neighbor search, but makes updating cells more costly.
         // But even for moderately dense packings particles cross cell boundaries very rarely, so this overhead is negligible.
+        // Particle lists of all the cells are stored in a single flat array (see cellParticleIndexes), so moving particles does not allocate memory.
+        // The list of a cell is laid out as [own | others | own], where "own" are the particles lying in this cell (in the same order in both copies),
+        // and "others" are the particles from the neighboring cells. Thus the neighbors of the own particle at position i, excluding the particle itself,
+        // are the contiguous range [i + 1, i + particlesCount), and the neighbors of an arbitrary point are [ownParticlesCount, ownParticlesCount + particlesCount).
         struct Cell : public Model::CubicBox
         {
-            std::vector<Model::ParticleIndex> particleIndexes;
             std::vector<int> neighborCellIndexes; // for each cell index stores all its neighbors
-            std::map<Model::ParticleIndex, int> particleIndexesPermutation; // particleIndexesPermutation[i] gets the index of the particle i in the particleIndexes array
+            int ownNeighborSlot; // index of this cell in neighborCellIndexes
+            int particlesOffset; // start of the cell particles in cellParticleIndexes
+            int particlesCapacity;
+            int particlesCount; // the number of distinct particles, own and others
+            int ownParticlesCount;
 
             Cell()
             {
-                particleIndexes.reserve(50);
                 neighborCellIndexes.reserve(50);
+                ownNeighborSlot = 0;
+                particlesOffset = 0;
+                particlesCapacity = 0;
+                particlesCount = 0;
+                ownParticlesCount = 0;
             }
         };
 
@@ -58,15 +69,24 @@ namespace PackingServices
         const Model::SystemConfig* config;
 
         // Cached variables
-        mutable std::vector<Cell> domainCells; // see GetNeighborIndexes for the need for mutable
+        std::vector<Cell> domainCells;
         Core::DiscreteSpatialVector cellsCounts;
         Core::SpatialVector cellSize;
 
+        // Flat (compressed sparse row) storage of the cell particle lists. Cell i occupies [particlesOffset, particlesOffset + particlesCapacity).
+        // Each particle belongs to the neighbor cells of its own cell; a slot is the index of a cell in Cell::neighborCellIndexes of the particle own cell.
+        // cellParticleSlots[j] is the slot of the cell for the particle cellParticleIndexes[j], so that its position can be updated in O(1).
+        // particlePositions[particleIndex * maxNeighborCellsCount + slot] is the position of the particle in the corresponding cell (relative to particlesOffset);
+        // for the own particles of a cell it is the position in the first copy.
+        std::vector<Model::ParticleIndex> cellParticleIndexes;
+        std::vector<int> cellParticleSlots;
+        std::vector<int> particlePositions;
+        int maxNeighborCellsCount;
         Model::ParticleIndex movedParticleIndex;
         Core::DiscreteSpatialVector previousLatticePoint;
 
         static const int MAX_NEIGHBORS_COUNT = 200;
-        static const int NOT_PRESENT_PERMUTATION = -1;
+        static const int MIN_CELL_CAPACITY_RESERVE = 8;
 
     public:
         CellListNeighborProvider(GeometryService* geometryService, GeometryCollisionService* geometryCollisionService);
@@ -89,7 +109,7 @@ namespace PackingServices
 
     private:
 
-        Model::ParticleIndex* GetNeighborIndexes(const Core::SpatialVector& coordinates, Model::ParticleIndex* neighborsCount, int* linearCellIndex) const;
+        int GetCellIndex(const Core::SpatialVector& point) const;
 
         void FillDomainCellCoordinates(const Core::SpatialVector& point, Core::DiscreteSpatialVector* latticePoint) const;
 
@@ -99,9 +119,20 @@ namespace PackingServices
 
         void SpreadParticlesByCells();
 
-        void AddParticleToCell(Cell* cell, int cellIndex, Model::ParticleIndex index);
+        int GetOwnCellIndex(Model::ParticleIndex particleIndex) const;
 
-        void RemoveParticleFromCell(Cell* cell, int cellIndex, Model::ParticleIndex index);
+        bool CanAddParticle(int ownCellIndex) const;
+
+        void AddParticleToCells(int ownCellIndex, Model::ParticleIndex particleIndex);
+
+        void RemoveParticleFromCells(int ownCellIndex, Model::ParticleIndex particleIndex);
+
+        void SetParticlePosition(const Cell& cell, int position, Model::ParticleIndex particleIndex, int slot);
+
+        void MoveParticle(const Cell& cell, int sourcePosition, int targetPosition);
+
+        // Rewrites the second copy of the own particles of the cell after the first copy or the other particles have changed.
+        void CopyOwnParticles(const Cell& cell);
 
         DISALLOW_COPY_AND_ASSIGN(CellListNeighborProvider);
     };
@@ -28,6 +28,10 @@ namespace PackingServices
             };
         };
 
+    public:
+        // Options
+        int threadsCount; // for the structure factor and intermediate scattering function. If not positive, the number of hardware threads is used.
+
     public:
         DistanceService(MathService* mathService, GeometryService* geometryService, INeighborProvider* neighborProvider);
 
@@ -53,6 +57,7 @@ namespace PackingServices
         // whether this particle belongs to the initial list or not or may it not belong, and if the particle with the same index is excluded.
         void SetClosestNeighbor(const Core::SpatialVector& point, Model::ParticleIndex indexToExclude, Core::FLOAT_TYPE diameter, Model::ParticleIndex* neighborIndex, Core::FLOAT_TYPE* normalizedDistanceSquare) const;
 
+        // O(N^2). See PairCorrelationService for the parallel version with a cell grid.
         void FillPairCorrelationFunction(Model::PairCorrelationFunction* pairCorrelationFunction) const;
 
         void FillStructureFactor(Model::StructureFactor* structureFactor) const;
@@ -66,9 +71,14 @@ namespace PackingServices
         void FillStructureFactorForWaveVectors(const Model::SystemConfig& config, const Model::Packing& particles,
                 const std::vector<Core::SpatialVector>& waveVectors, std::vector<Core::FLOAT_TYPE>* structureFactors) const;
 
+        // Uses ScatteringSumsKernel in several threads if the wave vectors are commensurate with the box (as those from FillPeriodicWaveVectors), otherwise the naive version.
         void FillIntermediateScatteringFunctionForWaveVectors(const Model::SystemConfig& config, const Model::Packing& firstPacking, const Model::Packing& secondPacking,
                 const std::vector<Core::SpatialVector>& waveVectors, std::vector<Core::FLOAT_TYPE>* intermediateScatteringFunctionValues, std::vector<Core::FLOAT_TYPE>* selfPartValues) const;
 
+        // Computes a complex exponent for each wave vector and particle.
+        void FillIntermediateScatteringFunctionForWaveVectorsNaive(const Model::SystemConfig& config, const Model::Packing& firstPacking, const Model::Packing& secondPacking,
+                const std::vector<Core::SpatialVector>& waveVectors, std::vector<Core::FLOAT_TYPE>* intermediateScatteringFunctionValues, std::vector<Core::FLOAT_TYPE>* selfPartValues) const;
+
         void FillNeighborVectorSums(std::vector<Core::FLOAT_TYPE>* neighborVectorSumsNorms, Core::FLOAT_TYPE contractionRate) const;
 
         Core::FLOAT_TYPE GetMaxNeighborVectorSumForNonRattlers(const std::vector<bool>& rattlerMask, const std::vector<Core::FLOAT_TYPE>& neighborVectorSumsNorms) const;
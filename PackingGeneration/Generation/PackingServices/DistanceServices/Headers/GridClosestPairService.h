@@ -0,0 +1,66 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Generation_PackingServices_DistanceServices_Headers_GridClosestPairService_h
+#define Generation_PackingServices_DistanceServices_Headers_GridClosestPairService_h
+
+#include <vector>
+#include "Core/Headers/Macros.h"
+#include "Core/Headers/IParallelTask.h"
+#include "Generation/Model/Headers/Types.h"
+#include "Generation/PackingServices/Headers/IContextDependentService.h"
+#include "CellGrid.h"
+namespace PackingServices { class MathService; }
+namespace PackingServices { class GeometryService; }
+namespace Model { class SystemConfig; }
+
+namespace PackingServices
+{
+    // Finds the closest pair (by normalized distance) of a static packing, e.g. to verify the generated packing without the O(N^2) GeometryService::GetMinNormalizedDistanceNaive.
+    // Builds a temporary cell grid with the cell size not less than the max diameter and checks the pairs from the neighboring cells in several threads.
+    // The pairs from non-neighboring cells are farther than cellSize / maxDiameter in normalized distances, so if the closest pair found is closer, it is exact.
+    // Otherwise (for very dilute packings) the cell size is doubled and the search is repeated.
+    // Returns exactly the same pair as the naive search: the distances are computed in the same way, and of equally distant pairs the one with the smallest indexes is chosen.
+    class GridClosestPairService : public virtual IContextDependentService, public virtual Core::IParallelTask
+    {
+    private:
+        // Services
+        MathService* mathService;
+        GeometryService* geometryService;
+
+        // Context
+        const Model::SystemConfig* config;
+        int threadsCount;
+
+        // Working variables
+        const Model::Packing* particles;
+        CellGrid cellGrid;
+        int partsCount;
+        std::vector<Model::ParticlePair> partClosestPairs;
+
+        static const int PARTS_PER_THREAD = 4;
+        // Limits the number of cells for small particles in a large box
+        static const int MAX_CELLS_PER_PARTICLE = 8;
+
+    public:
+        // If threadsCount is not positive, the number of hardware threads is used.
+        GridClosestPairService(MathService* mathService, GeometryService* geometryService, int threadsCount);
+
+        OVERRIDE void SetContext(const Model::ModellingContext& context);
+
+        Model::ParticlePair FindClosestPair(const Model::Packing& particles);
+
+        // Finds the closest pairs for the particles of a range of cells.
+        OVERRIDE void Execute(int partIndex);
+
+        virtual ~GridClosestPairService();
+
+    private:
+        static bool IsCloser(const Model::ParticlePair& pair, const Model::ParticlePair& otherPair);
+
+        DISALLOW_COPY_AND_ASSIGN(GridClosestPairService);
+    };
+}
+
+#endif /* Generation_PackingServices_DistanceServices_Headers_GridClosestPairService_h */
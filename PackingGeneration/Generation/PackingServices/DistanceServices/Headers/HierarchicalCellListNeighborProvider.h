@@ -0,0 +1,123 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Generation_PackingServices_DistanceServices_Headers_HierarchicalCellListNeighborProvider_h
+#define Generation_PackingServices_DistanceServices_Headers_HierarchicalCellListNeighborProvider_h
+
+#include <vector>
+#include "Core/Headers/Macros.h"
+#include "Generation/Model/Headers/Types.h"
+#include "INeighborProvider.h"
+namespace PackingServices { class GeometryCollisionService; }
+namespace PackingServices { class GeometryService; }
+namespace Model { class SystemConfig; }
+
+namespace PackingServices
+{
+    // Represents a class to efficiently determine nearest neighbors of a current particle in strongly polydisperse packings.
+    // CellListNeighborProvider sizes cells from the maximum diameter, so small particles scan many irrelevant neighbors.
+    // This class uses hierarchical cell lists (see Ogarko, Luding (2012) A fast multilevel algorithm for contact detection of arbitrarily polydisperse objects):
+    // particles are split by diameters into levels (each next level has diameters approximately two times smaller), each level has its own cell list
+    // with the cell size not less than the maximum diameter of the level. Each particle belongs to exactly one cell of its own level.
+    // A particle scans in each level only the cells, which may contain the particles intersecting its own cell (expanded by the maximum possible contact distance),
+    // so that the neighbor relation is symmetric. For monodisperse packings it reduces to a usual cell list with 27 neighboring cells.
+    // Neighbor lists are gathered into a buffer of the calling thread, so GetNeighborIndexes may be called by several threads simultaneously
+    // (e.g. point queries through VerletListNeighborProvider). A returned list is valid until the next query of any such provider by the same thread.
+    class HierarchicalCellListNeighborProvider : public virtual INeighborProvider
+    {
+    private:
+        struct Cell
+        {
+            int particlesOffset; // start of the cell particles in cellParticleIndexes
+            int particlesCapacity;
+            int particlesCount;
+        };
+
+        struct Level
+        {
+            Core::FLOAT_TYPE maxDiameter;
+            Core::DiscreteSpatialVector cellsCounts;
+            Core::SpatialVector cellSize;
+            int firstCellIndex; // index of the first cell of the level in cells
+        };
+
+        // Services
+        GeometryService* geometryService;
+        GeometryCollisionService* geometryCollisionService;
+
+        // Main variables
+        const Model::Packing* particles;
+        const Model::SystemConfig* config;
+
+        // Cached variables
+        std::vector<Level> levels;
+        std::vector<Cell> cells;
+
+        // Flat storage of the cell particle lists of all the levels. Cell i occupies [particlesOffset, particlesOffset + particlesCapacity).
+        std::vector<Model::ParticleIndex> cellParticleIndexes;
+        std::vector<int> particleLevels;
+        std::vector<int> particleCellIndexes;
+        std::vector<int> particlePositions; // positions of the particles in their cells (relative to particlesOffset)
+
+        static thread_local std::vector<Model::ParticleIndex> neighborIndexes;
+        Model::ParticleIndex movedParticleIndex;
+
+        // Ratio of maximum diameters of the neighboring levels
+        static const Core::FLOAT_TYPE LEVELS_DIAMETER_RATIO;
+        static const int MAX_LEVELS_COUNT = 10;
+        // Limits the number of cells of a level with a few small particles
+        static const int MAX_CELLS_PER_PARTICLE = 8;
+        static const int MIN_CELL_CAPACITY_RESERVE = 4;
+
+    public:
+        HierarchicalCellListNeighborProvider(GeometryService* geometryService, GeometryCollisionService* geometryCollisionService);
+
+        virtual ~HierarchicalCellListNeighborProvider();
+
+        OVERRIDE void SetContext(const Model::ModellingContext& context);
+
+        OVERRIDE void SetParticles(const Model::Packing& particles);
+
+        OVERRIDE const Model::ParticleIndex* GetNeighborIndexes(Model::ParticleIndex particleIndex, Model::ParticleIndex* neighborsCount) const;
+
+        // Returns the particles from the cells, which intersect the 3x3x3 block of the largest-level cells around the point (as CellListNeighborProvider does).
+        OVERRIDE const Model::ParticleIndex* GetNeighborIndexes(const Core::SpatialVector& coordinates, Model::ParticleIndex* neighborsCount) const;
+
+        OVERRIDE Core::FLOAT_TYPE GetTimeToUpdateBoundary(Model::ParticleIndex particleIndex, const Core::SpatialVector& point, const Core::SpatialVector& velocity) const;
+
+        OVERRIDE void StartMove(Model::ParticleIndex particleIndex);
+
+        OVERRIDE void EndMove();
+
+        int GetLevelsCount() const;
+
+    private:
+        void InitializeLevels();
+
+        void InitializeLevelCells(Level* level, int levelParticlesCount);
+
+        void SpreadParticlesByCells();
+
+        void FillCellCoordinates(const Level& level, const Core::SpatialVector& point, Core::DiscreteSpatialVector* cellPoint) const;
+
+        int GetCellIndex(const Level& level, const Core::DiscreteSpatialVector& cellPoint) const;
+
+        int GetCellIndex(const Level& level, const Core::SpatialVector& point) const;
+
+        // Makes the buffer of the calling thread large enough for any neighbor list
+        void ReserveNeighborIndexes() const;
+
+        // Appends to neighborIndexes the particles of the level, which lie in the cells intersecting [minCoordinates - distance, maxCoordinates + distance]
+        void AddNeighbors(const Level& level, const Core::SpatialVector& minCoordinates, const Core::SpatialVector& maxCoordinates,
+                Core::FLOAT_TYPE distance, Model::ParticleIndex particleIndexToExclude, Model::ParticleIndex* neighborsCount) const;
+
+        void AddParticleToCell(int cellIndex, Model::ParticleIndex particleIndex);
+
+        void RemoveParticleFromCell(Model::ParticleIndex particleIndex);
+
+        DISALLOW_COPY_AND_ASSIGN(HierarchicalCellListNeighborProvider);
+    };
+}
+
+#endif /* Generation_PackingServices_DistanceServices_Headers_HierarchicalCellListNeighborProvider_h */
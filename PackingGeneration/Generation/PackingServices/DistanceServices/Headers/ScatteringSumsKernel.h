@@ -0,0 +1,71 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Generation_PackingServices_DistanceServices_Headers_ScatteringSumsKernel_h
+#define Generation_PackingServices_DistanceServices_Headers_ScatteringSumsKernel_h
+
+#include <vector>
+#include <complex>
+#include "Core/Headers/Macros.h"
+#include "Core/Headers/IParallelTask.h"
+#include "Generation/Model/Headers/Types.h"
+namespace Model { class SystemConfig; }
+
+namespace PackingServices
+{
+    // Computes the sums of exp(i k r) over particles for the structure factor and the intermediate scattering function (see DistanceService::FillIntermediateScatteringFunctionForWaveVectors)
+    // for the wave vectors, commensurate with the box: k = 2 pi (m_x / L_x, m_y / L_y, m_z / L_z) with integer m_i.
+    // Then exp(i k r) = exp(i 2 pi x / L_x)^m_x * exp(i 2 pi y / L_y)^m_y * exp(i 2 pi z / L_z)^m_z, and the powers are tabulated by recurrence
+    // for blocks of particles (struct of arrays), so each particle and wave vector cost a few multiplications instead of a complex exponent.
+    // Blocks of particles are processed in several threads, the sums of the threads are added in a fixed order, so the results are reproducible.
+    class ScatteringSumsKernel : public virtual Core::IParallelTask
+    {
+    private:
+        const Model::SystemConfig* config;
+        const Model::Packing* firstPacking;
+        const Model::Packing* secondPacking;
+        std::vector<Core::DiscreteSpatialVector> waveIndexes;
+        Core::DiscreteSpatialVector maxWaveIndexes;
+
+        // Working variables
+        int partsCount;
+        std::vector<std::complex<Core::FLOAT_TYPE> > partFirstSums; // partFirstSums[partIndex * waveVectorsCount + waveVectorIndex]
+        std::vector<std::complex<Core::FLOAT_TYPE> > partSecondSums;
+        std::vector<std::complex<Core::FLOAT_TYPE> > partSelfSums;
+
+        static const int BLOCK_SIZE = 512;
+        // The particles are split into the same parts for any number of threads, so that the summation order and hence the values do not depend on it
+        static const int MAX_PARTS_COUNT = 64;
+
+    public:
+        ScatteringSumsKernel();
+
+        // Returns false if any of the wave vectors is not commensurate with the box.
+        bool SetWaveVectors(const Model::SystemConfig& config, const std::vector<Core::SpatialVector>& waveVectors);
+
+        // Fills the values as DistanceService::FillIntermediateScatteringFunctionForWaveVectors.
+        // If threadsCount is not positive, the number of hardware threads is used.
+        void FillIntermediateScatteringFunction(const Model::Packing& firstPacking, const Model::Packing& secondPacking, int threadsCount,
+                std::vector<Core::FLOAT_TYPE>* intermediateScatteringFunctionValues, std::vector<Core::FLOAT_TYPE>* selfPartValues);
+
+        // Adds the sums for a range of particles.
+        OVERRIDE void Execute(int partIndex);
+
+        virtual ~ScatteringSumsKernel();
+
+    private:
+        // Fills powers[m * BLOCK_SIZE + j] = exp(i 2 pi x_j / L)^m for m = 0, ..., maxWaveIndex along the axis for the particles of the block (real and imaginary parts separately).
+        void FillPowers(const Model::Packing& particles, Model::ParticleIndex blockStart, int blockParticlesCount, int axis,
+                std::vector<Core::FLOAT_TYPE>* realPowers, std::vector<Core::FLOAT_TYPE>* imaginaryPowers) const;
+
+        // Fills exp(i k r_j) for the particles of the block.
+        void FillExponents(const Core::DiscreteSpatialVector& waveIndex, int blockParticlesCount,
+                const std::vector<Core::FLOAT_TYPE>* realPowers, const std::vector<Core::FLOAT_TYPE>* imaginaryPowers,
+                Core::FLOAT_TYPE* realExponents, Core::FLOAT_TYPE* imaginaryExponents) const;
+
+        DISALLOW_COPY_AND_ASSIGN(ScatteringSumsKernel);
+    };
+}
+
+#endif /* Generation_PackingServices_DistanceServices_Headers_ScatteringSumsKernel_h */
@@ -30,9 +30,18 @@ namespace PackingServices
     // Still, if the particle 2 returns to its initial position, it may intersect the new verlet sphere of particle 1, but this will not be reflected in verlet lists, and verlet lists will be incorrect.
     // 4. Therefore, we need to pass verlet list centers to base neighbor provider, not actual particle centers. That's why we need verletParticles array. Also, this allows updating the base neighbor provider much rarely.
     // 5. To make base neighbor provider not to miss neighbors, suitable for verlet lists, we need to pass particle with radii r_i + cutoffDistance / 2 to baseNeighborProvider.
+    // 6. Verlet lists are always symmetric: if j is in the list of i, i is in the list of j. Therefore each pair is stored twice, and each entry knows the position of the mirror entry,
+    // so that a particle is removed from the lists of its neighbors in O(1). Symmetry also allows checking for duplicates only in one list (see FillVerletList).
     class VerletListNeighborProvider : public virtual INeighborProvider
     {
     private:
+        struct VerletList
+        {
+            int neighborsOffset; // start of the list in listNeighborIndexes
+            int neighborsCapacity;
+            int neighborsCount;
+        };
+
         // Services
         GeometryService* geometryService;
         INeighborProvider* baseNeighborProvider;
@@ -45,15 +54,35 @@ namespace PackingServices
 
         // Can't introduce VerletParticle, a sublcass of a Model::DomainParticle, as we operate (and pass) an array Model::DomainParticle* to baseNeighborProvider, not an array of pointers.
         Model::Packing verletParticles; // Represents an array of particles with coordinates as centers of verlet spheres. It should be passed to baseNeighborProvider.
-        std::vector<std::vector<Model::ParticleIndex> > verletLists; // An array of Verlet lists for a single particle.
+        std::vector<VerletList> verletLists;
+
+        // Flat storage of all the Verlet lists (instead of a separate vector per particle). List i occupies [neighborsOffset, neighborsOffset + neighborsCapacity).
+        // Full lists are moved to the end of the storage, the storage is compacted when too much space is wasted.
+        std::vector<Model::ParticleIndex> listNeighborIndexes;
+        std::vector<int> listMirrorPositions; // for an entry j in the list of i, the position of i in the list of j
+        int wastedCapacity;
+
+        // Stamps of the particles, which are already in the Verlet list being filled (instead of searching the list for duplicates).
+        std::vector<int> particleStamps;
+        int currentStamp;
 
         Model::ParticleIndex movedParticleIndex;
         Core::FLOAT_TYPE cutoffDistance;
-        mutable bool cutoffDistanceSet;
+        bool cutoffDistanceSet;
+        Core::FLOAT_TYPE expectedOuterDiameterRatio;
+        bool expectedOuterDiameterRatioSet;
+
+        // Statistics for tuning the cutoff distance
+        int listUpdatesCount;
+        long long checkedCandidatesCount; // the number of candidates from baseNeighborProvider, checked while filling Verlet lists
 
     public:
         static const Core::FLOAT_TYPE MAX_EXPECTED_OUTER_DIAMETER_RATIO;
 
+    private:
+        static const int INITIAL_LIST_CAPACITY = 16;
+        static const int MIN_LIST_CAPACITY_RESERVE = 4;
+
     public:
         VerletListNeighborProvider(GeometryService* geometryService, MathService* mathService, INeighborProvider* baseNeighborProvider, GeometryCollisionService* geometryCollisionService);
 
@@ -63,8 +92,25 @@ namespace PackingServices
 
         OVERRIDE void SetParticles(const Model::Packing& particles);
 
+        // The cutoff distance and the expected outer diameter ratio are applied in the next call of SetParticles only.
         void SetCutoffDistance(Core::FLOAT_TYPE cutoffDistance);
 
+        Core::FLOAT_TYPE GetCutoffDistance() const;
+
+        // The Verlet lists are correct only while outer particle diameters do not exceed diameter * expectedOuterDiameterRatio. By default it is MAX_EXPECTED_OUTER_DIAMETER_RATIO.
+        void SetExpectedOuterDiameterRatio(Core::FLOAT_TYPE expectedOuterDiameterRatio);
+
+        Core::FLOAT_TYPE GetExpectedOuterDiameterRatio() const;
+
+        Core::FLOAT_TYPE GetMeanListLength() const;
+
+        // Returns the number of Verlet list updates (when particles leave their Verlet spheres) since the last call of ResetStatistics.
+        int GetListUpdatesCount() const;
+
+        long long GetCheckedCandidatesCount() const;
+
+        void ResetStatistics();
+
         OVERRIDE const Model::ParticleIndex* GetNeighborIndexes(Model::ParticleIndex particleIndex, Model::ParticleIndex* neighborsCount) const;
 
         OVERRIDE const Model::ParticleIndex* GetNeighborIndexes(const Core::SpatialVector& coordinates, Model::ParticleIndex* neighborsCount) const;
@@ -83,9 +129,18 @@ namespace PackingServices
 
         bool IsParticleInVerletSphere(Model::ParticleIndex verletListIndex, Model::ParticleIndex particleIndex) const;
 
-        void AddParticleToVerletList(Model::ParticleIndex verletListIndex, Model::ParticleIndex particleIndex);
+        // Allocates the lists with the given capacities (plus reserve) in the flat storage, keeping the current list entries.
+        void LayOutLists(int minCapacity);
+
+        void EnsureCapacity(Model::ParticleIndex verletListIndex);
+
+        void AddPair(Model::ParticleIndex firstParticleIndex, Model::ParticleIndex secondParticleIndex);
+
+        void RemoveEntry(Model::ParticleIndex verletListIndex, int position);
+
+        void ClearList(Model::ParticleIndex verletListIndex);
 
-        void RemoveParticleFromVerletList(Model::ParticleIndex verletListIndex, Model::ParticleIndex particleIndex);
+        void StartStamp();
 
         DISALLOW_COPY_AND_ASSIGN(VerletListNeighborProvider);
     };
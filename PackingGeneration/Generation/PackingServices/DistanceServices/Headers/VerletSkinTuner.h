@@ -0,0 +1,55 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Generation_PackingServices_DistanceServices_Headers_VerletSkinTuner_h
+#define Generation_PackingServices_DistanceServices_Headers_VerletSkinTuner_h
+
+#include "Core/Headers/Macros.h"
+#include "Core/Headers/Types.h"
+
+namespace PackingServices
+{
+    // Tunes the cutoff distance (skin) of VerletListNeighborProvider at runtime.
+    // Large skins lead to long Verlet lists (more collision checks per event), small skins lead to frequent list updates (more NeighborTransfer events).
+    // The optimal skin changes during densification, so the tuner performs a one-dimensional pattern search on the logarithmic scale:
+    // after each block of events it compares the cost per event with the cost of the previous block, keeps the step direction if the cost decreased
+    // and reverses it (reducing the step) otherwise. When the step becomes small, the cutoff is held for several blocks and the search restarts,
+    // as the optimum drifts while the packing is being compressed.
+    class VerletSkinTuner
+    {
+    private:
+        Core::FLOAT_TYPE cutoffDistance;
+        Core::FLOAT_TYPE minCutoffDistance;
+        Core::FLOAT_TYPE maxCutoffDistance;
+
+        Core::FLOAT_TYPE previousCost;
+        bool previousCostSet;
+        Core::FLOAT_TYPE stepFactor;
+        int direction;
+        int heldBlocksCount;
+
+        static const Core::FLOAT_TYPE INITIAL_STEP_FACTOR;
+        static const Core::FLOAT_TYPE MIN_STEP_FACTOR;
+        static const int HELD_BLOCKS_COUNT = 10;
+
+    public:
+        VerletSkinTuner();
+
+        void Initialize(Core::FLOAT_TYPE cutoffDistance, Core::FLOAT_TYPE minCutoffDistance, Core::FLOAT_TYPE maxCutoffDistance);
+
+        Core::FLOAT_TYPE GetCutoffDistance() const;
+
+        // Accepts the cost per event, measured with the current cutoff distance, and returns the cutoff distance for the next block.
+        Core::FLOAT_TYPE GetNextCutoffDistance(Core::FLOAT_TYPE cost);
+
+        ~VerletSkinTuner();
+
+    private:
+        void Restart();
+
+        DISALLOW_COPY_AND_ASSIGN(VerletSkinTuner);
+    };
+}
+
+#endif /* Generation_PackingServices_DistanceServices_Headers_VerletSkinTuner_h */
@@ -0,0 +1,172 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/CellGrid.h"
+
+#include <cmath>
+#include <algorithm>
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+
+namespace PackingServices
+{
+    CellGrid::CellGrid()
+    {
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            cellsCounts[i] = 1;
+            cellSize[i] = 1.0;
+        }
+        cellOffsets.assign(2, 0);
+    }
+
+    CellGrid::~CellGrid()
+    {
+    }
+
+    void CellGrid::Fill(const SystemConfig& config, const Packing& particles, FLOAT_TYPE minCellSize)
+    {
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            cellsCounts[i] = std::max(1, static_cast<int>(floor(config.packingSize[i] / minCellSize)));
+            cellSize[i] = config.packingSize[i] / cellsCounts[i];
+        }
+
+        // Sort the particles by cells (counting sort). The sort is stable, so the particles of each cell are sorted by indexes.
+        int cellsCount = GetCellsCount();
+        particleCellIndexes.resize(config.particlesCount);
+        cellOffsets.assign(cellsCount + 1, 0);
+        for (ParticleIndex particleIndex = 0; particleIndex < config.particlesCount; ++particleIndex)
+        {
+            particleCellIndexes[particleIndex] = GetCellIndex(particles[particleIndex].coordinates);
+            cellOffsets[particleCellIndexes[particleIndex] + 1]++;
+        }
+
+        for (int cellIndex = 0; cellIndex < cellsCount; ++cellIndex)
+        {
+            cellOffsets[cellIndex + 1] += cellOffsets[cellIndex];
+        }
+
+        vector<int> cellPositions(cellOffsets.begin(), cellOffsets.end() - 1);
+        cellParticleIndexes.resize(config.particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config.particlesCount; ++particleIndex)
+        {
+            cellParticleIndexes[cellPositions[particleCellIndexes[particleIndex]]++] = particleIndex;
+        }
+    }
+
+    int CellGrid::GetCellsCount() const
+    {
+        int cellsCount = 1;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            cellsCount *= cellsCounts[i];
+        }
+        return cellsCount;
+    }
+
+    int CellGrid::GetCellIndex(const SpatialVector& point) const
+    {
+        DiscreteSpatialVector cellPoint;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            // Particles may lie slightly outside the box
+            int cellCoordinate = static_cast<int>(floor(point[i] / cellSize[i]));
+            cellPoint[i] = ((cellCoordinate % cellsCounts[i]) + cellsCounts[i]) % cellsCounts[i];
+        }
+        return GetCellIndex(cellPoint);
+    }
+
+    FLOAT_TYPE CellGrid::GetMinCellSize() const
+    {
+        FLOAT_TYPE minCellSize = cellSize[0];
+        for (int i = 1; i < DIMENSIONS; ++i)
+        {
+            minCellSize = std::min(minCellSize, cellSize[i]);
+        }
+        return minCellSize;
+    }
+
+    bool CellGrid::AreAllCellsNeighbors() const
+    {
+        bool allCellsNeighbors = true;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            allCellsNeighbors = allCellsNeighbors && (cellsCounts[i] < 3);
+        }
+        return allCellsNeighbors;
+    }
+
+    const ParticleIndex* CellGrid::GetCellParticleIndexes(int cellIndex, int* particlesCount) const
+    {
+        *particlesCount = cellOffsets[cellIndex + 1] - cellOffsets[cellIndex];
+        return (*particlesCount > 0) ? &cellParticleIndexes[cellOffsets[cellIndex]] : NULL;
+    }
+
+    int CellGrid::FillNeighborCellIndexes(int cellIndex, int* neighborCellIndexes) const
+    {
+        // Cell coordinates, the first dimension changes the fastest (see GetCellIndex)
+        DiscreteSpatialVector cellPoint;
+        int remainder = cellIndex;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            cellPoint[i] = remainder % cellsCounts[i];
+            remainder /= cellsCounts[i];
+        }
+
+        int neighborCellCoordinates[DIMENSIONS][3];
+        int neighborCellCounts[DIMENSIONS];
+        int neighborCellsCount = 1;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            neighborCellCounts[i] = FillNeighborCellCoordinates(i, cellPoint[i], neighborCellCoordinates[i]);
+            neighborCellsCount *= neighborCellCounts[i];
+        }
+
+        for (int neighborCellNumber = 0; neighborCellNumber < neighborCellsCount; ++neighborCellNumber)
+        {
+            DiscreteSpatialVector neighborCellPoint;
+            remainder = neighborCellNumber;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                neighborCellPoint[i] = neighborCellCoordinates[i][remainder % neighborCellCounts[i]];
+                remainder /= neighborCellCounts[i];
+            }
+            neighborCellIndexes[neighborCellNumber] = GetCellIndex(neighborCellPoint);
+        }
+
+        return neighborCellsCount;
+    }
+
+    int CellGrid::FillNeighborCellCoordinates(int dimension, int cellCoordinate, int* neighborCellCoordinates) const
+    {
+        int cellsCount = cellsCounts[dimension];
+        if (cellsCount < 3)
+        {
+            for (int i = 0; i < cellsCount; ++i)
+            {
+                neighborCellCoordinates[i] = i;
+            }
+            return cellsCount;
+        }
+
+        neighborCellCoordinates[0] = (cellCoordinate + cellsCount - 1) % cellsCount;
+        neighborCellCoordinates[1] = cellCoordinate;
+        neighborCellCoordinates[2] = (cellCoordinate + 1) % cellsCount;
+        return 3;
+    }
+
+    int CellGrid::GetCellIndex(const DiscreteSpatialVector& cellPoint) const
+    {
+        int cellIndex = 0;
+        for (int i = DIMENSIONS - 1; i >= 0; --i)
+        {
+            cellIndex = cellIndex * cellsCounts[i] + cellPoint[i];
+        }
+        return cellIndex;
+    }
+}
@@ -4,6 +4,7 @@
 
 #include "../Headers/CellListNeighborProvider.h"
 
+#include <algorithm>
 #include "Core/Headers/StlUtilities.h"
 #include "Core/Headers/VectorUtilities.h"
 #include "Generation/Model/Headers/Config.h"
@@ -61,21 +62,48 @@ namespace PackingServices
 
     void CellListNeighborProvider::SpreadParticlesByCells()
     {
-        const Packing& particlesRef = *particles;
+        vector<int> ownCellIndexes(config->particlesCount);
+        for (vector<Cell>::size_type i = 0; i < domainCells.size(); ++i)
+        {
+            domainCells[i].particlesCount = 0;
+            domainCells[i].ownParticlesCount = 0;
+        }
+
+        // Count the particles in each cell
         for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
         {
-            DiscreteSpatialVector latticePoint;
-            const DomainParticle& particle = particlesRef[particleIndex];
-            FillDomainCellCoordinates(particle.coordinates, &latticePoint);
-            int cellIndex = latticeIndexingProvider.GetCellNodeIndex(latticePoint);
-            Cell* cell = &domainCells[cellIndex];
-            for (vector<int>::size_type i = 0; i < cell->neighborCellIndexes.size(); ++i)
-            {
-                int neighborCellIndex = cell->neighborCellIndexes[i];
-                Cell* neighborCell = &domainCells[neighborCellIndex];
+            int ownCellIndex = GetOwnCellIndex(particleIndex);
+            ownCellIndexes[particleIndex] = ownCellIndex;
 
-                AddParticleToCell(neighborCell, neighborCellIndex, particleIndex);
+            const Cell& ownCell = domainCells[ownCellIndex];
+            for (vector<int>::size_type i = 0; i < ownCell.neighborCellIndexes.size(); ++i)
+            {
+                domainCells[ownCell.neighborCellIndexes[i]].particlesCount++;
             }
+            domainCells[ownCellIndex].ownParticlesCount++;
+        }
+
+        // Reserve some space in each cell, so that moving particles rarely overflows the cells and requires respreading.
+        // The own particles are stored twice (see Cell).
+        int totalCapacity = 0;
+        for (vector<Cell>::size_type i = 0; i < domainCells.size(); ++i)
+        {
+            Cell* cell = &domainCells[i];
+            int storedParticlesCount = cell->particlesCount + cell->ownParticlesCount;
+            cell->particlesOffset = totalCapacity;
+            cell->particlesCapacity = storedParticlesCount + std::max(MIN_CELL_CAPACITY_RESERVE, storedParticlesCount / 4);
+            cell->particlesCount = 0;
+            cell->ownParticlesCount = 0;
+            totalCapacity += cell->particlesCapacity;
+        }
+
+        cellParticleIndexes.assign(totalCapacity, 0);
+        cellParticleSlots.assign(totalCapacity, 0);
+        particlePositions.assign(config->particlesCount * maxNeighborCellsCount, 0);
+
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            AddParticleToCells(ownCellIndexes[particleIndex], particleIndex);
         }
     }
 
@@ -106,6 +134,7 @@ namespace PackingServices
         linearIndexingProvider.SetGeometryParameters(&geometryParameters);
         latticeIndexingProvider.SetGeometryParameters(&geometryParameters);
 
+        maxNeighborCellsCount = 0;
         for (int i = 0; i < totalCellCount; ++i)
         {
             Cell* cell = &domainCells[i];
@@ -116,6 +145,8 @@ namespace PackingServices
 
             // Neighbor cell indexes may not be unique in the only case: if the cells count at least by one dimension is less than 3.
             StlUtilities::SortAndResizeToUnique(&cell->neighborCellIndexes);
+            cell->ownNeighborSlot = std::find(cell->neighborCellIndexes.begin(), cell->neighborCellIndexes.end(), i) - cell->neighborCellIndexes.begin();
+            maxNeighborCellsCount = std::max(maxNeighborCellsCount, static_cast<int>(cell->neighborCellIndexes.size()));
 
             SpatialVector minVertexCoordinates;
             VectorUtilities::Multiply(latticePoint, cellSize, &minVertexCoordinates);
@@ -125,47 +156,19 @@ namespace PackingServices
 
     const ParticleIndex* CellListNeighborProvider::GetNeighborIndexes(ParticleIndex particleIndex, ParticleIndex* neighborsCount) const
     {
-        const Packing& particlesRef = *particles;
-        ParticleIndex& neighborsCountRef = *neighborsCount;
-        int cellIndex;
-        const DomainParticle* particle = &particlesRef[particleIndex];
-        ParticleIndex* neighborIndexes = GetNeighborIndexes(particle->coordinates, neighborsCount, &cellIndex);
-
-        // We move the particleIndex to the neighborIndexes end, so that the particle is still in the given cell (as neighborIndexes is cell.particleIndexes array),
-        // but decrease neighborsCount, so that the particleIndex is not included in the results (which is correct by semantics).
-        Cell* cell = &domainCells[cellIndex];
-        int localParticleIndex = cell->particleIndexesPermutation[particleIndex]; // the localParticleIndex should always be valid, as particle should reside in the given cell
-        int localNeighborIndex = neighborsCountRef - 1;
-        if (localParticleIndex < localNeighborIndex)
-        {
-            ParticleIndex neighborIndex = neighborIndexes[localNeighborIndex];
-            neighborIndexes[localParticleIndex] = neighborIndex;
-            neighborIndexes[localNeighborIndex] = particleIndex;
-
-            cell->particleIndexesPermutation[neighborIndex] = localParticleIndex;
-            cell->particleIndexesPermutation[particleIndex] = localNeighborIndex;
-        }
-        neighborsCountRef--;
-
-        return neighborIndexes;
+        // The particle is an own particle of its cell, so its neighbors follow it in the [own | others | own] list of the cell (see Cell)
+        int cellIndex = GetOwnCellIndex(particleIndex);
+        const Cell& cell = domainCells[cellIndex];
+        int position = particlePositions[particleIndex * maxNeighborCellsCount + cell.ownNeighborSlot];
+        *neighborsCount = cell.particlesCount - 1;
+        return &cellParticleIndexes[cell.particlesOffset + position + 1];
     }
 
     const ParticleIndex* CellListNeighborProvider::GetNeighborIndexes(const SpatialVector& coordinates, ParticleIndex* neighborsCount) const
     {
-        int linearCellIndex;
-        return GetNeighborIndexes(coordinates, neighborsCount, &linearCellIndex);
-    }
-
-    ParticleIndex* CellListNeighborProvider::GetNeighborIndexes(const SpatialVector& coordinates, ParticleIndex* neighborsCount, int* linearCellIndex) const
-    {
-        DiscreteSpatialVector latticePoint;
-        FillDomainCellCoordinates(coordinates, &latticePoint);
-
-        *linearCellIndex = latticeIndexingProvider.GetCellNodeIndex(latticePoint);
-
-        Cell& cell = domainCells[*linearCellIndex];
-        *neighborsCount = cell.particleIndexes.size();
-        return &cell.particleIndexes[0];
+        const Cell& cell = domainCells[GetCellIndex(coordinates)];
+        *neighborsCount = cell.particlesCount;
+        return &cellParticleIndexes[cell.particlesOffset + cell.ownParticlesCount];
     }
 
     void CellListNeighborProvider::EndMove()
@@ -182,22 +185,16 @@ namespace PackingServices
         }
 
         int previousCellIndex = latticeIndexingProvider.GetCellNodeIndex(previousLatticePoint);
-        Cell* previousCell = &domainCells[previousCellIndex];
-        for (vector<int>::size_type i = 0; i < previousCell->neighborCellIndexes.size(); ++i)
-        {
-            int cellIndex = previousCell->neighborCellIndexes[i];
-            Cell* neighborCell = &domainCells[cellIndex];
-            RemoveParticleFromCell(neighborCell, cellIndex, movedParticleIndex);
-        }
+        RemoveParticleFromCells(previousCellIndex, movedParticleIndex);
 
         int currentCellIndex = latticeIndexingProvider.GetCellNodeIndex(latticePoint);
-        Cell* currentCell = &domainCells[currentCellIndex];
-        for (vector<int>::size_type i = 0; i < currentCell->neighborCellIndexes.size(); ++i)
+        if (!CanAddParticle(currentCellIndex))
         {
-            int cellIndex = currentCell->neighborCellIndexes[i];
-            Cell* neighborCell = &domainCells[cellIndex];
-            AddParticleToCell(neighborCell, cellIndex, movedParticleIndex);
+            // Some cell is full, spread the particles again with the new reserves
+            SpreadParticlesByCells();
+            return;
         }
+        AddParticleToCells(currentCellIndex, movedParticleIndex);
     }
 
     void CellListNeighborProvider::StartMove(ParticleIndex particleIndex)
@@ -230,31 +227,114 @@ namespace PackingServices
         }
     }
 
-    void CellListNeighborProvider::AddParticleToCell(Cell* cell, int cellIndex, ParticleIndex particleIndex)
+    int CellListNeighborProvider::GetOwnCellIndex(ParticleIndex particleIndex) const
     {
-        cell->particleIndexes.push_back(particleIndex);
-        cell->particleIndexesPermutation[particleIndex] = cell->particleIndexes.size() - 1;
+        const Packing& particlesRef = *particles;
+        return GetCellIndex(particlesRef[particleIndex].coordinates);
     }
 
-    void CellListNeighborProvider::RemoveParticleFromCell(Cell* cell, int cellIndex, ParticleIndex particleIndex)
+    int CellListNeighborProvider::GetCellIndex(const SpatialVector& point) const
     {
-        ParticleIndex indexInCell = cell->particleIndexesPermutation[particleIndex];
+        DiscreteSpatialVector latticePoint;
+        FillDomainCellCoordinates(point, &latticePoint);
+        return latticeIndexingProvider.GetCellNodeIndex(latticePoint);
+    }
 
-        if (indexInCell < static_cast<int>(cell->particleIndexes.size() - 1))
+    bool CellListNeighborProvider::CanAddParticle(int ownCellIndex) const
+    {
+        const Cell& ownCell = domainCells[ownCellIndex];
+        for (vector<int>::size_type i = 0; i < ownCell.neighborCellIndexes.size(); ++i)
         {
-            StlUtilities::QuicklyRemoveAt(&cell->particleIndexes, indexInCell);
+            int cellIndex = ownCell.neighborCellIndexes[i];
+            const Cell& cell = domainCells[cellIndex];
 
-            // Update the moved particle index in the cell.
-            // Just one (the last one) particle will be moved to the deleted particle position.
-            ParticleIndex movedParticleIndex = cell->particleIndexes[indexInCell];
-            cell->particleIndexesPermutation[movedParticleIndex] = indexInCell;
-            cell->particleIndexesPermutation.erase(particleIndex);
+            // An own particle is stored twice
+            int requiredCapacity = cell.particlesCount + cell.ownParticlesCount + ((cellIndex == ownCellIndex) ? 2 : 1);
+            if (requiredCapacity > cell.particlesCapacity)
+            {
+                return false;
+            }
         }
-        else // indexInCell is the last particle, so we can simply remove it
+        return true;
+    }
+
+    void CellListNeighborProvider::AddParticleToCells(int ownCellIndex, ParticleIndex particleIndex)
+    {
+        const Cell& ownCell = domainCells[ownCellIndex];
+        for (vector<int>::size_type slot = 0; slot < ownCell.neighborCellIndexes.size(); ++slot)
         {
-            cell->particleIndexes.pop_back();
-            cell->particleIndexesPermutation.erase(particleIndex);
+            Cell* cell = &domainCells[ownCell.neighborCellIndexes[slot]];
+            int othersEnd = cell->particlesCount;
+            if (static_cast<int>(slot) == ownCell.ownNeighborSlot)
+            {
+                // Free the position after the own particles by moving the first of the other particles to the end of the others
+                int position = cell->ownParticlesCount;
+                if (othersEnd > position)
+                {
+                    MoveParticle(*cell, position, othersEnd);
+                }
+                SetParticlePosition(*cell, position, particleIndex, slot);
+                cell->ownParticlesCount++;
+            }
+            else
+            {
+                SetParticlePosition(*cell, othersEnd, particleIndex, slot);
+            }
+            cell->particlesCount++;
+            CopyOwnParticles(*cell);
         }
     }
-}
 
+    void CellListNeighborProvider::RemoveParticleFromCells(int ownCellIndex, ParticleIndex particleIndex)
+    {
+        const Cell& ownCell = domainCells[ownCellIndex];
+        for (vector<int>::size_type slot = 0; slot < ownCell.neighborCellIndexes.size(); ++slot)
+        {
+            Cell* cell = &domainCells[ownCell.neighborCellIndexes[slot]];
+            int position = particlePositions[particleIndex * maxNeighborCellsCount + slot];
+            int lastOtherPosition = cell->particlesCount - 1;
+            if (static_cast<int>(slot) == ownCell.ownNeighborSlot)
+            {
+                // The last own particle fills the removed particle position, and the last of the other particles fills the last own position
+                int lastOwnPosition = cell->ownParticlesCount - 1;
+                if (position < lastOwnPosition)
+                {
+                    MoveParticle(*cell, lastOwnPosition, position);
+                }
+                if (lastOtherPosition > lastOwnPosition)
+                {
+                    MoveParticle(*cell, lastOtherPosition, lastOwnPosition);
+                }
+                cell->ownParticlesCount--;
+            }
+            else if (position < lastOtherPosition)
+            {
+                // Just one (the last one) particle is moved to the deleted particle position
+                MoveParticle(*cell, lastOtherPosition, position);
+            }
+            cell->particlesCount--;
+            CopyOwnParticles(*cell);
+        }
+    }
+
+    void CellListNeighborProvider::SetParticlePosition(const Cell& cell, int position, ParticleIndex particleIndex, int slot)
+    {
+        int index = cell.particlesOffset + position;
+        cellParticleIndexes[index] = particleIndex;
+        cellParticleSlots[index] = slot;
+        particlePositions[particleIndex * maxNeighborCellsCount + slot] = position;
+    }
+
+    void CellListNeighborProvider::MoveParticle(const Cell& cell, int sourcePosition, int targetPosition)
+    {
+        int sourceIndex = cell.particlesOffset + sourcePosition;
+        SetParticlePosition(cell, targetPosition, cellParticleIndexes[sourceIndex], cellParticleSlots[sourceIndex]);
+    }
+
+    void CellListNeighborProvider::CopyOwnParticles(const Cell& cell)
+    {
+        // The own particles and the other particles occupy [0, particlesCount), so the copy starts right after them
+        vector<ParticleIndex>::iterator ownParticlesBegin = cellParticleIndexes.begin() + cell.particlesOffset;
+        std::copy(ownParticlesBegin, ownParticlesBegin + cell.ownParticlesCount, ownParticlesBegin + cell.particlesCount);
+    }
+}
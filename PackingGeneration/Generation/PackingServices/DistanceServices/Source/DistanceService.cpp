@@ -14,6 +14,7 @@
 #include "Generation/PackingServices/Headers/GeometryService.h"
 #include "Generation/PackingServices/Headers/MathService.h"
 #include "../Headers/INeighborProvider.h"
+#include "../Headers/ScatteringSumsKernel.h"
 
 using namespace std;
 using namespace Core;
@@ -25,6 +26,7 @@ namespace PackingServices
             BaseDistanceService(mathService, neighborProvider)
     {
         this->geometryService = geometryService;
+        threadsCount = 0;
     }
 
     void DistanceService::SetParticles(const Packing& particles)
@@ -404,6 +406,25 @@ namespace PackingServices
             throw NotImplementedException("2D structure factor not implemented");
         }
 
+        ScatteringSumsKernel scatteringSumsKernel;
+        if (scatteringSumsKernel.SetWaveVectors(config, waveVectors))
+        {
+            scatteringSumsKernel.FillIntermediateScatteringFunction(firstPacking, secondPacking, threadsCount, intermediateScatteringFunctionValues, selfPartValues);
+        }
+        else
+        {
+            FillIntermediateScatteringFunctionForWaveVectorsNaive(config, firstPacking, secondPacking, waveVectors, intermediateScatteringFunctionValues, selfPartValues);
+        }
+    }
+
+    void DistanceService::FillIntermediateScatteringFunctionForWaveVectorsNaive(const SystemConfig& config, const Packing& firstPacking, const Packing& secondPacking,
+            const vector<SpatialVector>& waveVectors, vector<FLOAT_TYPE>* intermediateScatteringFunctionValues, vector<FLOAT_TYPE>* selfPartValues) const
+    {
+        if (DIMENSIONS == 2)
+        {
+            throw NotImplementedException("2D structure factor not implemented");
+        }
+
         vector<FLOAT_TYPE>& intermediateScatteringFunctionValuesRef = *intermediateScatteringFunctionValues;
         vector<FLOAT_TYPE>& selfPartValuesRef = *selfPartValues;
         intermediateScatteringFunctionValuesRef.resize(waveVectors.size());
@@ -0,0 +1,142 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/GridClosestPairService.h"
+
+#include <cmath>
+#include <algorithm>
+#include "Core/Headers/Constants.h"
+#include "Core/Headers/ThreadPool.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+
+namespace PackingServices
+{
+    GridClosestPairService::GridClosestPairService(MathService* mathService, GeometryService* geometryService, int threadsCount)
+    {
+        this->mathService = mathService;
+        this->geometryService = geometryService;
+        this->threadsCount = threadsCount;
+        partsCount = 0;
+    }
+
+    GridClosestPairService::~GridClosestPairService()
+    {
+    }
+
+    void GridClosestPairService::SetContext(const ModellingContext& context)
+    {
+        config = context.config;
+        geometryService->SetContext(context);
+    }
+
+    ParticlePair GridClosestPairService::FindClosestPair(const Packing& particles)
+    {
+        this->particles = &particles;
+        if (config->particlesCount < 2)
+        {
+            return ParticlePair(0, 0, MAX_FLOAT_VALUE);
+        }
+
+        FLOAT_TYPE maxDiameter = geometryService->GetMaxParticleDiameter(particles);
+        FLOAT_TYPE boxVolume = 1.0;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            boxVolume *= config->packingSize[i];
+        }
+        FLOAT_TYPE minCellSize = std::max(maxDiameter, pow(boxVolume / (MAX_CELLS_PER_PARTICLE * config->particlesCount), 1.0 / DIMENSIONS));
+
+        ThreadPool threadPool(threadsCount);
+        while (true)
+        {
+            cellGrid.Fill(*config, particles, minCellSize);
+
+            int cellsCount = cellGrid.GetCellsCount();
+            partsCount = std::min(cellsCount, threadPool.GetThreadsCount() * PARTS_PER_THREAD);
+            partClosestPairs.assign(partsCount, ParticlePair(0, 0, MAX_FLOAT_VALUE));
+            threadPool.Execute(this, partsCount);
+
+            ParticlePair closestPair = partClosestPairs[0];
+            for (int i = 1; i < partsCount; ++i)
+            {
+                if (IsCloser(partClosestPairs[i], closestPair))
+                {
+                    closestPair = partClosestPairs[i];
+                }
+            }
+
+            bool allPairsChecked = cellGrid.AreAllCellsNeighbors();
+
+            // Safety factor for finite precision, as the pairs from non-neighboring cells are not closer than the bound
+            FLOAT_TYPE normalizedDistanceBound = minCellSize / maxDiameter;
+            if (allPairsChecked || closestPair.normalizedDistanceSquare * (1.0 + 1e-10) < normalizedDistanceBound * normalizedDistanceBound)
+            {
+                return closestPair;
+            }
+
+            minCellSize *= 2.0;
+        }
+    }
+
+    void GridClosestPairService::Execute(int partIndex)
+    {
+        int cellsCount = cellGrid.GetCellsCount();
+        int startCellIndex = static_cast<int>(static_cast<long long>(cellsCount) * partIndex / partsCount);
+        int endCellIndex = static_cast<int>(static_cast<long long>(cellsCount) * (partIndex + 1) / partsCount);
+
+        ParticlePair closestPair(0, 0, MAX_FLOAT_VALUE);
+        int neighborCellIndexes[CellGrid::MAX_NEIGHBOR_CELLS_COUNT];
+        for (int cellIndex = startCellIndex; cellIndex < endCellIndex; ++cellIndex)
+        {
+            int cellParticlesCount;
+            const ParticleIndex* cellParticleIndexes = cellGrid.GetCellParticleIndexes(cellIndex, &cellParticlesCount);
+            int neighborCellsCount = cellGrid.FillNeighborCellIndexes(cellIndex, neighborCellIndexes);
+            for (int neighborCellNumber = 0; neighborCellNumber < neighborCellsCount; ++neighborCellNumber)
+            {
+                int neighborCellParticlesCount;
+                const ParticleIndex* neighborCellParticleIndexes = cellGrid.GetCellParticleIndexes(neighborCellIndexes[neighborCellNumber], &neighborCellParticlesCount);
+
+                // Each pair is checked once: when the cell of the particle with the smaller index is processed
+                for (int i = 0; i < cellParticlesCount; ++i)
+                {
+                    ParticleIndex particleIndex = cellParticleIndexes[i];
+                    for (int j = 0; j < neighborCellParticlesCount; ++j)
+                    {
+                        ParticleIndex neighborIndex = neighborCellParticleIndexes[j];
+                        if (neighborIndex <= particleIndex)
+                        {
+                            continue;
+                        }
+
+                        ParticlePair pair(particleIndex, neighborIndex, mathService->GetNormalizedDistanceSquare(particleIndex, neighborIndex, *particles));
+                        if (IsCloser(pair, closestPair))
+                        {
+                            closestPair = pair;
+                        }
+                    }
+                }
+            }
+        }
+
+        partClosestPairs[partIndex] = closestPair;
+    }
+
+    bool GridClosestPairService::IsCloser(const ParticlePair& pair, const ParticlePair& otherPair)
+    {
+        if (pair.normalizedDistanceSquare != otherPair.normalizedDistanceSquare)
+        {
+            return pair.normalizedDistanceSquare < otherPair.normalizedDistanceSquare;
+        }
+        if (pair.firstParticleIndex != otherPair.firstParticleIndex)
+        {
+            return pair.firstParticleIndex < otherPair.firstParticleIndex;
+        }
+        return pair.secondParticleIndex < otherPair.secondParticleIndex;
+    }
+}
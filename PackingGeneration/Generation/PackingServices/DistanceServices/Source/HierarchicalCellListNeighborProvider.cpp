@@ -0,0 +1,389 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/HierarchicalCellListNeighborProvider.h"
+
+#include <cmath>
+#include <algorithm>
+#include "Core/Headers/VectorUtilities.h"
+#include "Generation/Model/Headers/Config.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/PackingServices/Headers/GeometryCollisionService.h"
+
+using namespace Model;
+using namespace Core;
+using namespace std;
+
+namespace PackingServices
+{
+    const FLOAT_TYPE HierarchicalCellListNeighborProvider::LEVELS_DIAMETER_RATIO = 2.0;
+    thread_local vector<ParticleIndex> HierarchicalCellListNeighborProvider::neighborIndexes;
+
+    HierarchicalCellListNeighborProvider::HierarchicalCellListNeighborProvider(GeometryService* geometryService, GeometryCollisionService* geometryCollisionService)
+    {
+        this->geometryService = geometryService;
+        this->geometryCollisionService = geometryCollisionService;
+    }
+
+    void HierarchicalCellListNeighborProvider::SetContext(const ModellingContext& context)
+    {
+        config = context.config;
+        geometryService->SetContext(context);
+    }
+
+    HierarchicalCellListNeighborProvider::~HierarchicalCellListNeighborProvider()
+    {
+    }
+
+    void HierarchicalCellListNeighborProvider::SetParticles(const Packing& particles)
+    {
+        this->particles = &particles;
+
+        InitializeLevels();
+
+        SpreadParticlesByCells();
+    }
+
+    int HierarchicalCellListNeighborProvider::GetLevelsCount() const
+    {
+        return levels.size();
+    }
+
+    void HierarchicalCellListNeighborProvider::InitializeLevels()
+    {
+        const Packing& particlesRef = *particles;
+        FLOAT_TYPE maxDiameter = geometryService->GetMaxParticleDiameter(particlesRef);
+
+        // Find the diameter classes of the particles: class k contains diameters in (maxDiameter / ratio^(k + 1), maxDiameter / ratio^k]
+        vector<int> classLevels(MAX_LEVELS_COUNT, -1);
+        particleLevels.resize(config->particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            FLOAT_TYPE diameter = particlesRef[particleIndex].diameter;
+            int diameterClass = MAX_LEVELS_COUNT - 1;
+            if (diameter > 0)
+            {
+                diameterClass = static_cast<int>(std::floor(std::log(maxDiameter / diameter) / std::log(LEVELS_DIAMETER_RATIO)));
+                diameterClass = std::max(0, std::min(MAX_LEVELS_COUNT - 1, diameterClass));
+            }
+            particleLevels[particleIndex] = diameterClass;
+            classLevels[diameterClass] = 0;
+        }
+
+        // Skip the empty classes
+        int levelsCount = 0;
+        for (int diameterClass = 0; diameterClass < MAX_LEVELS_COUNT; ++diameterClass)
+        {
+            if (classLevels[diameterClass] >= 0)
+            {
+                classLevels[diameterClass] = levelsCount;
+                levelsCount++;
+            }
+        }
+
+        levels.clear();
+        levels.resize(levelsCount);
+        vector<int> levelParticlesCounts(levelsCount, 0);
+        for (int i = 0; i < levelsCount; ++i)
+        {
+            levels[i].maxDiameter = 0;
+        }
+
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            int levelIndex = classLevels[particleLevels[particleIndex]];
+            particleLevels[particleIndex] = levelIndex;
+            levelParticlesCounts[levelIndex]++;
+            levels[levelIndex].maxDiameter = std::max(levels[levelIndex].maxDiameter, particlesRef[particleIndex].diameter);
+        }
+
+        int cellsCount = 0;
+        for (int i = 0; i < levelsCount; ++i)
+        {
+            Level* level = &levels[i];
+            InitializeLevelCells(level, levelParticlesCounts[i]);
+            level->firstCellIndex = cellsCount;
+            cellsCount += VectorUtilities::GetProduct(level->cellsCounts);
+        }
+
+        cells.resize(cellsCount);
+    }
+
+    void HierarchicalCellListNeighborProvider::InitializeLevelCells(Level* level, int levelParticlesCount)
+    {
+        SpatialVector floatCellCounts;
+        VectorUtilities::DivideByValue(config->packingSize, std::max(level->maxDiameter, static_cast<FLOAT_TYPE>(1e-10)), &floatCellCounts);
+        VectorUtilities::Floor<SpatialVector, SpatialVector>(floatCellCounts, &floatCellCounts);
+
+        // A level with a few small particles should not produce a huge number of cells. Larger cells are still correct, only less efficient.
+        FLOAT_TYPE totalCellsCount = VectorUtilities::GetProduct(floatCellCounts);
+        FLOAT_TYPE maxCellsCount = std::max(1, levelParticlesCount) * static_cast<FLOAT_TYPE>(MAX_CELLS_PER_PARTICLE);
+        if (totalCellsCount > maxCellsCount)
+        {
+            FLOAT_TYPE scalingFactor = std::pow(maxCellsCount / totalCellsCount, 1.0 / DIMENSIONS);
+            VectorUtilities::MultiplyByValue(floatCellCounts, scalingFactor, &floatCellCounts);
+            VectorUtilities::Floor<SpatialVector, SpatialVector>(floatCellCounts, &floatCellCounts);
+        }
+
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            floatCellCounts[i] = std::max(static_cast<FLOAT_TYPE>(1.0), floatCellCounts[i]);
+        }
+
+        VectorUtilities::Convert<SpatialVector, DiscreteSpatialVector>(floatCellCounts, &level->cellsCounts);
+        VectorUtilities::Divide(config->packingSize, level->cellsCounts, &level->cellSize);
+    }
+
+    void HierarchicalCellListNeighborProvider::SpreadParticlesByCells()
+    {
+        const Packing& particlesRef = *particles;
+        for (vector<Cell>::size_type i = 0; i < cells.size(); ++i)
+        {
+            cells[i].particlesCount = 0;
+        }
+
+        particleCellIndexes.resize(config->particlesCount);
+        particlePositions.resize(config->particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            const Level& level = levels[particleLevels[particleIndex]];
+            int cellIndex = GetCellIndex(level, particlesRef[particleIndex].coordinates);
+            particleCellIndexes[particleIndex] = cellIndex;
+            cells[cellIndex].particlesCount++;
+        }
+
+        // Reserve some space in each cell, so that moving particles rarely overflows the cells and requires respreading
+        int totalCapacity = 0;
+        for (vector<Cell>::size_type i = 0; i < cells.size(); ++i)
+        {
+            Cell* cell = &cells[i];
+            cell->particlesOffset = totalCapacity;
+            cell->particlesCapacity = cell->particlesCount + std::max(MIN_CELL_CAPACITY_RESERVE, cell->particlesCount / 4);
+            cell->particlesCount = 0;
+            totalCapacity += cell->particlesCapacity;
+        }
+
+        cellParticleIndexes.assign(totalCapacity, 0);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            AddParticleToCell(particleCellIndexes[particleIndex], particleIndex);
+        }
+    }
+
+    FLOAT_TYPE HierarchicalCellListNeighborProvider::GetTimeToUpdateBoundary(ParticleIndex particleIndex, const SpatialVector& point, const SpatialVector& velocity) const
+    {
+        const Level& level = levels[particleLevels[particleIndex]];
+        DiscreteSpatialVector cellPoint;
+        FillCellCoordinates(level, point, &cellPoint);
+
+        SpatialVector minVertexCoordinates;
+        VectorUtilities::Multiply(cellPoint, level.cellSize, &minVertexCoordinates);
+        CubicBox cell;
+        cell.Initialize(minVertexCoordinates, level.cellSize);
+
+        FLOAT_TYPE intersectionTime;
+        int intersectionWallIndex;
+        geometryCollisionService->FindIntersection(point, velocity, cell, -1, &intersectionTime, &intersectionWallIndex);
+
+        return intersectionTime;
+    }
+
+    const ParticleIndex* HierarchicalCellListNeighborProvider::GetNeighborIndexes(ParticleIndex particleIndex, ParticleIndex* neighborsCount) const
+    {
+        ReserveNeighborIndexes();
+
+        const Packing& particlesRef = *particles;
+        const Level& ownLevel = levels[particleLevels[particleIndex]];
+
+        // The lists are built for the whole own cell (not for the exact particle position), so that they stay valid until the particle leaves the cell
+        DiscreteSpatialVector cellPoint;
+        FillCellCoordinates(ownLevel, particlesRef[particleIndex].coordinates, &cellPoint);
+        SpatialVector minCoordinates;
+        SpatialVector maxCoordinates;
+        VectorUtilities::Multiply(cellPoint, ownLevel.cellSize, &minCoordinates);
+        VectorUtilities::Add(minCoordinates, ownLevel.cellSize, &maxCoordinates);
+
+        *neighborsCount = 0;
+        for (vector<Level>::size_type i = 0; i < levels.size(); ++i)
+        {
+            const Level& level = levels[i];
+            FLOAT_TYPE maxContactDistance = 0.5 * (ownLevel.maxDiameter + level.maxDiameter);
+            AddNeighbors(level, minCoordinates, maxCoordinates, maxContactDistance, particleIndex, neighborsCount);
+        }
+
+        return &neighborIndexes[0];
+    }
+
+    const ParticleIndex* HierarchicalCellListNeighborProvider::GetNeighborIndexes(const SpatialVector& coordinates, ParticleIndex* neighborsCount) const
+    {
+        ReserveNeighborIndexes();
+
+        const Level& largestLevel = levels[0];
+
+        DiscreteSpatialVector cellPoint;
+        FillCellCoordinates(largestLevel, coordinates, &cellPoint);
+        SpatialVector minCoordinates;
+        SpatialVector maxCoordinates;
+        VectorUtilities::Multiply(cellPoint, largestLevel.cellSize, &minCoordinates);
+        VectorUtilities::Add(minCoordinates, largestLevel.cellSize, &maxCoordinates);
+        FLOAT_TYPE distance = VectorUtilities::GetMaxValue(largestLevel.cellSize);
+
+        *neighborsCount = 0;
+        for (vector<Level>::size_type i = 0; i < levels.size(); ++i)
+        {
+            AddNeighbors(levels[i], minCoordinates, maxCoordinates, distance, -1, neighborsCount);
+        }
+
+        return &neighborIndexes[0];
+    }
+
+    void HierarchicalCellListNeighborProvider::ReserveNeighborIndexes() const
+    {
+        // The buffer is shared by all the providers of the thread, so it is only grown
+        if (neighborIndexes.size() < static_cast<size_t>(config->particlesCount))
+        {
+            neighborIndexes.resize(config->particlesCount);
+        }
+    }
+
+    void HierarchicalCellListNeighborProvider::AddNeighbors(const Level& level, const SpatialVector& minCoordinates, const SpatialVector& maxCoordinates,
+            FLOAT_TYPE distance, ParticleIndex particleIndexToExclude, ParticleIndex* neighborsCount) const
+    {
+        DiscreteSpatialVector minCellPoint;
+        DiscreteSpatialVector maxCellPoint;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            minCellPoint[i] = static_cast<int>(std::floor((minCoordinates[i] - distance) / level.cellSize[i]));
+            maxCellPoint[i] = static_cast<int>(std::ceil((maxCoordinates[i] + distance) / level.cellSize[i])) - 1;
+
+            // The boundaries are periodic; if the range covers the whole level, each cell should be visited only once
+            if (maxCellPoint[i] - minCellPoint[i] + 1 >= level.cellsCounts[i])
+            {
+                minCellPoint[i] = 0;
+                maxCellPoint[i] = level.cellsCounts[i] - 1;
+            }
+        }
+
+        ParticleIndex& neighborsCountRef = *neighborsCount;
+        DiscreteSpatialVector cellPoint = minCellPoint;
+        while (true)
+        {
+            DiscreteSpatialVector periodicCellPoint;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                periodicCellPoint[i] = ((cellPoint[i] % level.cellsCounts[i]) + level.cellsCounts[i]) % level.cellsCounts[i];
+            }
+
+            const Cell& cell = cells[GetCellIndex(level, periodicCellPoint)];
+            for (int i = 0; i < cell.particlesCount; ++i)
+            {
+                ParticleIndex neighborIndex = cellParticleIndexes[cell.particlesOffset + i];
+                if (neighborIndex != particleIndexToExclude)
+                {
+                    neighborIndexes[neighborsCountRef] = neighborIndex;
+                    neighborsCountRef++;
+                }
+            }
+
+            // Go to the next cell in the range
+            int dimension = 0;
+            while (dimension < DIMENSIONS && cellPoint[dimension] == maxCellPoint[dimension])
+            {
+                cellPoint[dimension] = minCellPoint[dimension];
+                dimension++;
+            }
+            if (dimension == DIMENSIONS)
+            {
+                break;
+            }
+            cellPoint[dimension]++;
+        }
+    }
+
+    void HierarchicalCellListNeighborProvider::StartMove(ParticleIndex particleIndex)
+    {
+        movedParticleIndex = particleIndex;
+    }
+
+    void HierarchicalCellListNeighborProvider::EndMove()
+    {
+        const Packing& particlesRef = *particles;
+        const Level& level = levels[particleLevels[movedParticleIndex]];
+        int cellIndex = GetCellIndex(level, particlesRef[movedParticleIndex].coordinates);
+        if (cellIndex == particleCellIndexes[movedParticleIndex])
+        {
+            return;
+        }
+
+        RemoveParticleFromCell(movedParticleIndex);
+
+        const Cell& cell = cells[cellIndex];
+        if (cell.particlesCount == cell.particlesCapacity)
+        {
+            // The cell is full, spread the particles again with the new reserves
+            SpreadParticlesByCells();
+            return;
+        }
+        AddParticleToCell(cellIndex, movedParticleIndex);
+    }
+
+    void HierarchicalCellListNeighborProvider::FillCellCoordinates(const Level& level, const SpatialVector& point, DiscreteSpatialVector* cellPoint) const
+    {
+        DiscreteSpatialVector& cellPointRef = *cellPoint;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            cellPointRef[i] = static_cast<int>(std::floor(point[i] / level.cellSize[i]));
+            if (cellPointRef[i] < 0)
+            {
+                cellPointRef[i] = 0;
+            }
+            if (cellPointRef[i] >= level.cellsCounts[i])
+            {
+                cellPointRef[i] = level.cellsCounts[i] - 1;
+            }
+        }
+    }
+
+    int HierarchicalCellListNeighborProvider::GetCellIndex(const Level& level, const DiscreteSpatialVector& cellPoint) const
+    {
+        int index = 0;
+        for (int i = DIMENSIONS - 1; i >= 0; --i)
+        {
+            index = index * level.cellsCounts[i] + cellPoint[i];
+        }
+        return level.firstCellIndex + index;
+    }
+
+    int HierarchicalCellListNeighborProvider::GetCellIndex(const Level& level, const SpatialVector& point) const
+    {
+        DiscreteSpatialVector cellPoint;
+        FillCellCoordinates(level, point, &cellPoint);
+        return GetCellIndex(level, cellPoint);
+    }
+
+    void HierarchicalCellListNeighborProvider::AddParticleToCell(int cellIndex, ParticleIndex particleIndex)
+    {
+        Cell* cell = &cells[cellIndex];
+        cellParticleIndexes[cell->particlesOffset + cell->particlesCount] = particleIndex;
+        particleCellIndexes[particleIndex] = cellIndex;
+        particlePositions[particleIndex] = cell->particlesCount;
+        cell->particlesCount++;
+    }
+
+    void HierarchicalCellListNeighborProvider::RemoveParticleFromCell(ParticleIndex particleIndex)
+    {
+        Cell* cell = &cells[particleCellIndexes[particleIndex]];
+        int position = particlePositions[particleIndex];
+        int lastPosition = cell->particlesCount - 1;
+
+        // Just one (the last one) particle is moved to the deleted particle position
+        if (position < lastPosition)
+        {
+            ParticleIndex lastParticleIndex = cellParticleIndexes[cell->particlesOffset + lastPosition];
+            cellParticleIndexes[cell->particlesOffset + position] = lastParticleIndex;
+            particlePositions[lastParticleIndex] = position;
+        }
+        cell->particlesCount--;
+    }
+}
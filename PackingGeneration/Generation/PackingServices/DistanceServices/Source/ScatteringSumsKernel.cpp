@@ -0,0 +1,242 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/ScatteringSumsKernel.h"
+
+#include <cmath>
+#include <algorithm>
+#include "Core/Headers/Constants.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/ThreadPool.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+
+namespace PackingServices
+{
+    ScatteringSumsKernel::ScatteringSumsKernel()
+    {
+        config = NULL;
+        firstPacking = NULL;
+        secondPacking = NULL;
+        partsCount = 0;
+    }
+
+    ScatteringSumsKernel::~ScatteringSumsKernel()
+    {
+    }
+
+    bool ScatteringSumsKernel::SetWaveVectors(const SystemConfig& config, const vector<SpatialVector>& waveVectors)
+    {
+        this->config = &config;
+        waveIndexes.resize(waveVectors.size());
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            maxWaveIndexes[i] = 0;
+        }
+
+        for (size_t waveVectorIndex = 0; waveVectorIndex < waveVectors.size(); ++waveVectorIndex)
+        {
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                FLOAT_TYPE baseWaveVectorLength = 2.0 * PI / config.packingSize[i];
+                int waveIndex = Math::Round(waveVectors[waveVectorIndex][i] / baseWaveVectorLength);
+                if (std::abs(waveVectors[waveVectorIndex][i] - waveIndex * baseWaveVectorLength) > 1e-10 * baseWaveVectorLength * (std::abs(waveIndex) + 1))
+                {
+                    return false;
+                }
+                waveIndexes[waveVectorIndex][i] = waveIndex;
+                maxWaveIndexes[i] = std::max(maxWaveIndexes[i], std::abs(waveIndex));
+            }
+        }
+
+        return true;
+    }
+
+    void ScatteringSumsKernel::FillIntermediateScatteringFunction(const Packing& firstPacking, const Packing& secondPacking, int threadsCount,
+            vector<FLOAT_TYPE>* intermediateScatteringFunctionValues, vector<FLOAT_TYPE>* selfPartValues)
+    {
+        this->firstPacking = &firstPacking;
+        this->secondPacking = &secondPacking;
+
+        size_t waveVectorsCount = waveIndexes.size();
+        int blocksCount = (config->particlesCount + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+        ThreadPool threadPool(threadsCount);
+        int maxPartsCount = MAX_PARTS_COUNT;
+        partsCount = std::max(1, std::min(blocksCount, maxPartsCount));
+        partFirstSums.assign(partsCount * waveVectorsCount, complex<FLOAT_TYPE>(0.0, 0.0));
+        bool samePackings = (&firstPacking == &secondPacking);
+        if (!samePackings)
+        {
+            partSecondSums.assign(partsCount * waveVectorsCount, complex<FLOAT_TYPE>(0.0, 0.0));
+            partSelfSums.assign(partsCount * waveVectorsCount, complex<FLOAT_TYPE>(0.0, 0.0));
+        }
+        threadPool.Execute(this, partsCount);
+
+        intermediateScatteringFunctionValues->resize(waveVectorsCount);
+        selfPartValues->resize(waveVectorsCount);
+        for (size_t waveVectorIndex = 0; waveVectorIndex < waveVectorsCount; ++waveVectorIndex)
+        {
+            complex<FLOAT_TYPE> firstSum(0.0, 0.0);
+            complex<FLOAT_TYPE> secondSum(0.0, 0.0);
+            complex<FLOAT_TYPE> selfSum(0.0, 0.0);
+            for (int partIndex = 0; partIndex < partsCount; ++partIndex)
+            {
+                size_t index = partIndex * waveVectorsCount + waveVectorIndex;
+                firstSum += partFirstSums[index];
+                if (!samePackings)
+                {
+                    secondSum += partSecondSums[index];
+                    selfSum += partSelfSums[index];
+                }
+            }
+
+            if (samePackings)
+            {
+                secondSum = firstSum;
+                selfSum = config->particlesCount;
+            }
+
+            intermediateScatteringFunctionValues->at(waveVectorIndex) = (firstSum * std::conj(secondSum)).real() / config->particlesCount;
+            selfPartValues->at(waveVectorIndex) = selfSum.real() / config->particlesCount;
+        }
+    }
+
+    void ScatteringSumsKernel::Execute(int partIndex)
+    {
+        int blocksCount = (config->particlesCount + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        int startBlockIndex = static_cast<int>(static_cast<long long>(blocksCount) * partIndex / partsCount);
+        int endBlockIndex = static_cast<int>(static_cast<long long>(blocksCount) * (partIndex + 1) / partsCount);
+
+        size_t waveVectorsCount = waveIndexes.size();
+        complex<FLOAT_TYPE>* firstSums = &partFirstSums[partIndex * waveVectorsCount];
+        bool samePackings = (firstPacking == secondPacking);
+
+        vector<FLOAT_TYPE> firstRealPowers[DIMENSIONS];
+        vector<FLOAT_TYPE> firstImaginaryPowers[DIMENSIONS];
+        vector<FLOAT_TYPE> secondRealPowers[DIMENSIONS];
+        vector<FLOAT_TYPE> secondImaginaryPowers[DIMENSIONS];
+        vector<FLOAT_TYPE> firstRealExponents(BLOCK_SIZE);
+        vector<FLOAT_TYPE> firstImaginaryExponents(BLOCK_SIZE);
+        vector<FLOAT_TYPE> secondRealExponents(BLOCK_SIZE);
+        vector<FLOAT_TYPE> secondImaginaryExponents(BLOCK_SIZE);
+
+        for (int blockIndex = startBlockIndex; blockIndex < endBlockIndex; ++blockIndex)
+        {
+            ParticleIndex blockStart = blockIndex * BLOCK_SIZE;
+            int blockParticlesCount = std::min(BLOCK_SIZE, config->particlesCount - blockStart);
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                FillPowers(*firstPacking, blockStart, blockParticlesCount, i, &firstRealPowers[i], &firstImaginaryPowers[i]);
+                if (!samePackings)
+                {
+                    FillPowers(*secondPacking, blockStart, blockParticlesCount, i, &secondRealPowers[i], &secondImaginaryPowers[i]);
+                }
+            }
+
+            for (size_t waveVectorIndex = 0; waveVectorIndex < waveVectorsCount; ++waveVectorIndex)
+            {
+                const DiscreteSpatialVector& waveIndex = waveIndexes[waveVectorIndex];
+                FillExponents(waveIndex, blockParticlesCount, firstRealPowers, firstImaginaryPowers, &firstRealExponents[0], &firstImaginaryExponents[0]);
+
+                FLOAT_TYPE firstRealSum = 0.0;
+                FLOAT_TYPE firstImaginarySum = 0.0;
+                for (int j = 0; j < blockParticlesCount; ++j)
+                {
+                    firstRealSum += firstRealExponents[j];
+                    firstImaginarySum += firstImaginaryExponents[j];
+                }
+                firstSums[waveVectorIndex] += complex<FLOAT_TYPE>(firstRealSum, firstImaginarySum);
+
+                if (!samePackings)
+                {
+                    FillExponents(waveIndex, blockParticlesCount, secondRealPowers, secondImaginaryPowers, &secondRealExponents[0], &secondImaginaryExponents[0]);
+
+                    // exp(i k r1) * conj(exp(i k r2)), see DistanceService::FillIntermediateScatteringFunctionForWaveVectors
+                    FLOAT_TYPE secondRealSum = 0.0;
+                    FLOAT_TYPE secondImaginarySum = 0.0;
+                    FLOAT_TYPE selfRealSum = 0.0;
+                    FLOAT_TYPE selfImaginarySum = 0.0;
+                    for (int j = 0; j < blockParticlesCount; ++j)
+                    {
+                        secondRealSum += secondRealExponents[j];
+                        secondImaginarySum += secondImaginaryExponents[j];
+                        selfRealSum += firstRealExponents[j] * secondRealExponents[j] + firstImaginaryExponents[j] * secondImaginaryExponents[j];
+                        selfImaginarySum += firstImaginaryExponents[j] * secondRealExponents[j] - firstRealExponents[j] * secondImaginaryExponents[j];
+                    }
+                    partSecondSums[partIndex * waveVectorsCount + waveVectorIndex] += complex<FLOAT_TYPE>(secondRealSum, secondImaginarySum);
+                    partSelfSums[partIndex * waveVectorsCount + waveVectorIndex] += complex<FLOAT_TYPE>(selfRealSum, selfImaginarySum);
+                }
+            }
+        }
+    }
+
+    void ScatteringSumsKernel::FillPowers(const Packing& particles, ParticleIndex blockStart, int blockParticlesCount, int axis,
+            vector<FLOAT_TYPE>* realPowers, vector<FLOAT_TYPE>* imaginaryPowers) const
+    {
+        vector<FLOAT_TYPE>& realPowersRef = *realPowers;
+        vector<FLOAT_TYPE>& imaginaryPowersRef = *imaginaryPowers;
+        realPowersRef.resize((maxWaveIndexes[axis] + 1) * BLOCK_SIZE);
+        imaginaryPowersRef.resize((maxWaveIndexes[axis] + 1) * BLOCK_SIZE);
+
+        FLOAT_TYPE baseWaveVectorLength = 2.0 * PI / config->packingSize[axis];
+        for (int j = 0; j < blockParticlesCount; ++j)
+        {
+            FLOAT_TYPE phase = baseWaveVectorLength * particles[blockStart + j].coordinates[axis];
+            realPowersRef[j] = 1.0;
+            imaginaryPowersRef[j] = 0.0;
+            if (maxWaveIndexes[axis] > 0)
+            {
+                realPowersRef[BLOCK_SIZE + j] = cos(phase);
+                imaginaryPowersRef[BLOCK_SIZE + j] = sin(phase);
+            }
+        }
+
+        // The error of the recurrence grows linearly with the power, i.e. stays about 1e-14 for the usual wave indexes
+        for (int power = 2; power <= maxWaveIndexes[axis]; ++power)
+        {
+            const FLOAT_TYPE* previousRealPowers = &realPowersRef[(power - 1) * BLOCK_SIZE];
+            const FLOAT_TYPE* previousImaginaryPowers = &imaginaryPowersRef[(power - 1) * BLOCK_SIZE];
+            FLOAT_TYPE* currentRealPowers = &realPowersRef[power * BLOCK_SIZE];
+            FLOAT_TYPE* currentImaginaryPowers = &imaginaryPowersRef[power * BLOCK_SIZE];
+            for (int j = 0; j < blockParticlesCount; ++j)
+            {
+                FLOAT_TYPE baseRealPower = realPowersRef[BLOCK_SIZE + j];
+                FLOAT_TYPE baseImaginaryPower = imaginaryPowersRef[BLOCK_SIZE + j];
+                currentRealPowers[j] = previousRealPowers[j] * baseRealPower - previousImaginaryPowers[j] * baseImaginaryPower;
+                currentImaginaryPowers[j] = previousRealPowers[j] * baseImaginaryPower + previousImaginaryPowers[j] * baseRealPower;
+            }
+        }
+    }
+
+    void ScatteringSumsKernel::FillExponents(const DiscreteSpatialVector& waveIndex, int blockParticlesCount,
+            const vector<FLOAT_TYPE>* realPowers, const vector<FLOAT_TYPE>* imaginaryPowers,
+            FLOAT_TYPE* realExponents, FLOAT_TYPE* imaginaryExponents) const
+    {
+        // exp(-i a) = conj(exp(i a))
+        const FLOAT_TYPE* xRealPowers = &realPowers[Axis::X][std::abs(waveIndex[Axis::X]) * BLOCK_SIZE];
+        const FLOAT_TYPE* xImaginaryPowers = &imaginaryPowers[Axis::X][std::abs(waveIndex[Axis::X]) * BLOCK_SIZE];
+        const FLOAT_TYPE* yRealPowers = &realPowers[Axis::Y][std::abs(waveIndex[Axis::Y]) * BLOCK_SIZE];
+        const FLOAT_TYPE* yImaginaryPowers = &imaginaryPowers[Axis::Y][std::abs(waveIndex[Axis::Y]) * BLOCK_SIZE];
+        const FLOAT_TYPE* zRealPowers = &realPowers[Axis::Z][std::abs(waveIndex[Axis::Z]) * BLOCK_SIZE];
+        const FLOAT_TYPE* zImaginaryPowers = &imaginaryPowers[Axis::Z][std::abs(waveIndex[Axis::Z]) * BLOCK_SIZE];
+        FLOAT_TYPE xSign = (waveIndex[Axis::X] < 0) ? -1.0 : 1.0;
+        FLOAT_TYPE ySign = (waveIndex[Axis::Y] < 0) ? -1.0 : 1.0;
+        FLOAT_TYPE zSign = (waveIndex[Axis::Z] < 0) ? -1.0 : 1.0;
+
+        for (int j = 0; j < blockParticlesCount; ++j)
+        {
+            FLOAT_TYPE xImaginaryPower = xSign * xImaginaryPowers[j];
+            FLOAT_TYPE yImaginaryPower = ySign * yImaginaryPowers[j];
+            FLOAT_TYPE zImaginaryPower = zSign * zImaginaryPowers[j];
+            FLOAT_TYPE xyRealPower = xRealPowers[j] * yRealPowers[j] - xImaginaryPower * yImaginaryPower;
+            FLOAT_TYPE xyImaginaryPower = xRealPowers[j] * yImaginaryPower + xImaginaryPower * yRealPowers[j];
+            realExponents[j] = xyRealPower * zRealPowers[j] - xyImaginaryPower * zImaginaryPower;
+            imaginaryExponents[j] = xyRealPower * zImaginaryPower + xyImaginaryPower * zRealPowers[j];
+        }
+    }
+}
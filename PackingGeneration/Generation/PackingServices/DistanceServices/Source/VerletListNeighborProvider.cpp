@@ -4,7 +4,8 @@
 
 #include "../Headers/VerletListNeighborProvider.h"
 
-#include "Core/Headers/StlUtilities.h"
+#include <limits>
+#include <algorithm>
 #include "Generation/PackingServices/Headers/GeometryService.h"
 #include "Generation/PackingServices/Headers/GeometryCollisionService.h"
 #include "Generation/Model/Headers/Config.h"
@@ -26,6 +27,10 @@ namespace PackingServices
         this->geometryCollisionService = geometryCollisionService;
 
         cutoffDistanceSet = false;
+        expectedOuterDiameterRatioSet = false;
+        wastedCapacity = 0;
+        currentStamp = 0;
+        ResetStatistics();
     }
 
     void VerletListNeighborProvider::SetContext(const ModellingContext& context)
@@ -45,6 +50,48 @@ namespace PackingServices
         cutoffDistanceSet = true;
     }
 
+    FLOAT_TYPE VerletListNeighborProvider::GetCutoffDistance() const
+    {
+        return cutoffDistance;
+    }
+
+    void VerletListNeighborProvider::SetExpectedOuterDiameterRatio(FLOAT_TYPE expectedOuterDiameterRatio)
+    {
+        this->expectedOuterDiameterRatio = expectedOuterDiameterRatio;
+        expectedOuterDiameterRatioSet = true;
+    }
+
+    FLOAT_TYPE VerletListNeighborProvider::GetExpectedOuterDiameterRatio() const
+    {
+        return expectedOuterDiameterRatio;
+    }
+
+    FLOAT_TYPE VerletListNeighborProvider::GetMeanListLength() const
+    {
+        size_t listsLength = 0;
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            listsLength += verletLists[particleIndex].neighborsCount;
+        }
+        return static_cast<FLOAT_TYPE>(listsLength) / config->particlesCount;
+    }
+
+    int VerletListNeighborProvider::GetListUpdatesCount() const
+    {
+        return listUpdatesCount;
+    }
+
+    long long VerletListNeighborProvider::GetCheckedCandidatesCount() const
+    {
+        return checkedCandidatesCount;
+    }
+
+    void VerletListNeighborProvider::ResetStatistics()
+    {
+        listUpdatesCount = 0;
+        checkedCandidatesCount = 0;
+    }
+
     void VerletListNeighborProvider::SetParticles(const Packing& particles)
     {
         this->particles = &particles;
@@ -55,22 +102,80 @@ namespace PackingServices
     //        cutoffDistance = 0.5 * geometryService->GetMinParticleDiameter(particles);
     //        cutoffDistance = 0.5 * geometryService->GetMeanParticleDiameter(particles);
         }
+        if (!expectedOuterDiameterRatioSet)
+        {
+            expectedOuterDiameterRatio = MAX_EXPECTED_OUTER_DIAMETER_RATIO;
+        }
+        // The explicit values apply to this call only. They are reset here rather than in the const queries, so that the queries do not modify the provider.
+        cutoffDistanceSet = false;
+        expectedOuterDiameterRatioSet = false;
+
+        // The lists are rebuilt in the same storage. If they are rebuilt with similar parameters, the previous mean length is a good estimate of the capacity.
+        int listCapacity = INITIAL_LIST_CAPACITY;
+        if (static_cast<int>(verletLists.size()) == config->particlesCount)
+        {
+            listCapacity = std::max(listCapacity, static_cast<int>(GetMeanListLength()));
+        }
 
         verletParticles.clear();
-        verletLists.clear();
         verletParticles.resize(config->particlesCount);
         verletLists.resize(config->particlesCount);
+        for (int i = 0; i < config->particlesCount; ++i)
+        {
+            verletLists[i].neighborsCount = 0;
+        }
+        LayOutLists(listCapacity);
+        particleStamps.assign(config->particlesCount, 0);
+        currentStamp = 0;
 
         Particle::CopyPackingTo(particles, &verletParticles);
         for (int i = 0; i < config->particlesCount; ++i)
         {
-            verletParticles[i].diameter = verletParticles[i].diameter * MAX_EXPECTED_OUTER_DIAMETER_RATIO + cutoffDistance;
-            verletLists[i].reserve(50);
+            verletParticles[i].diameter = verletParticles[i].diameter * expectedOuterDiameterRatio + cutoffDistance;
         }
 
         baseNeighborProvider->SetParticles(verletParticles);
 
         SpreadParticlesByLists();
+
+        // Remove the space wasted by the lists, which were moved to the end of the storage
+        LayOutLists(0);
+    }
+
+    void VerletListNeighborProvider::LayOutLists(int minCapacity)
+    {
+        int totalCapacity = 0;
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            int neighborsCount = verletLists[particleIndex].neighborsCount;
+            totalCapacity += std::max(minCapacity, neighborsCount + std::max(MIN_LIST_CAPACITY_RESERVE, neighborsCount / 4));
+        }
+
+        vector<ParticleIndex> newNeighborIndexes(totalCapacity);
+        vector<int> newMirrorPositions(totalCapacity);
+
+        // Positions inside the lists do not change, so mirror positions remain valid
+        int neighborsOffset = 0;
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            VerletList* verletList = &verletLists[particleIndex];
+            int neighborsCount = verletList->neighborsCount;
+            if (neighborsCount > 0)
+            {
+                std::copy(listNeighborIndexes.begin() + verletList->neighborsOffset, listNeighborIndexes.begin() + verletList->neighborsOffset + neighborsCount,
+                        newNeighborIndexes.begin() + neighborsOffset);
+                std::copy(listMirrorPositions.begin() + verletList->neighborsOffset, listMirrorPositions.begin() + verletList->neighborsOffset + neighborsCount,
+                        newMirrorPositions.begin() + neighborsOffset);
+            }
+
+            verletList->neighborsOffset = neighborsOffset;
+            verletList->neighborsCapacity = std::max(minCapacity, neighborsCount + std::max(MIN_LIST_CAPACITY_RESERVE, neighborsCount / 4));
+            neighborsOffset += verletList->neighborsCapacity;
+        }
+
+        listNeighborIndexes.swap(newNeighborIndexes);
+        listMirrorPositions.swap(newMirrorPositions);
+        wastedCapacity = 0;
     }
 
     void VerletListNeighborProvider::SpreadParticlesByLists()
@@ -83,32 +188,49 @@ namespace PackingServices
 
     void VerletListNeighborProvider::FillVerletList(ParticleIndex particleIndex)
     {
-        // Should not clear the list:
-        // 1. it is already prefilled with some of the neighbors from processing of previous particles
-        // 2. more importantly, in case if baseNeighborProvider has bugs and returns asymmetric neighbors, it will lead to asymmetric neighbors in VerletListNeighborProvider.
-        // In turn, it will lead to incorrect Lubachevsky-Stillinger event search operation, some events will be missed.
-        // vector<ParticleIndex>* verletList = &verletLists[particleIndex];
-        // verletList->clear();
+        // Should not clear the list, as it is already prefilled with some of the neighbors from processing of previous particles.
+        // The particles already in the list are stamped, so that duplicates are skipped in O(1).
+        // As the lists are symmetric (see AddPair), the particle is not in the lists of the neighbors, which are not stamped.
+        // Also, if baseNeighborProvider has bugs and returns asymmetric neighbors, the Verlet lists remain symmetric.
+        StartStamp();
+        const VerletList& verletList = verletLists[particleIndex];
+        for (int i = 0; i < verletList.neighborsCount; ++i)
+        {
+            particleStamps[listNeighborIndexes[verletList.neighborsOffset + i]] = currentStamp;
+        }
+        particleStamps[particleIndex] = currentStamp;
 
         ParticleIndex neighborsCount;
         const ParticleIndex* neighborIndexes = baseNeighborProvider->GetNeighborIndexes(particleIndex, &neighborsCount);
+        checkedCandidatesCount += neighborsCount;
 
         for (ParticleIndex i = 0; i < neighborsCount; ++i)
         {
             ParticleIndex neighborIndex = neighborIndexes[i];
+            if (particleStamps[neighborIndex] == currentStamp)
+            {
+                continue;
+            }
 
             if (IsParticleInVerletSphere(particleIndex, neighborIndex))
             {
-                // NOTE: currently we add particles and check for duplicates while adding.
-                // It may be more efficient to add without checking, than in the next cycle sort and remove duplicates.
-                AddParticleToVerletList(particleIndex, neighborIndex);
-
-                // Don't forget to update the neighbour's Verlet list, too
-                AddParticleToVerletList(neighborIndex, particleIndex);
+                // Updates the neighbour's Verlet list, too
+                AddPair(particleIndex, neighborIndex);
+                particleStamps[neighborIndex] = currentStamp;
             }
         }
     }
 
+    void VerletListNeighborProvider::StartStamp()
+    {
+        if (currentStamp == std::numeric_limits<int>::max())
+        {
+            particleStamps.assign(config->particlesCount, 0);
+            currentStamp = 0;
+        }
+        currentStamp++;
+    }
+
     bool VerletListNeighborProvider::IsParticleInVerletSphere(ParticleIndex verletListIndex, ParticleIndex particleIndex) const
     {
         const Particle& particle = verletParticles[verletListIndex];
@@ -123,32 +245,94 @@ namespace PackingServices
         return normalizedDistanceSquare <= 1.0;
     }
 
-    void VerletListNeighborProvider::AddParticleToVerletList(ParticleIndex verletListIndex, ParticleIndex particleIndex)
+    void VerletListNeighborProvider::AddPair(ParticleIndex firstParticleIndex, ParticleIndex secondParticleIndex)
+    {
+        EnsureCapacity(firstParticleIndex);
+        EnsureCapacity(secondParticleIndex);
+
+        VerletList* firstList = &verletLists[firstParticleIndex];
+        VerletList* secondList = &verletLists[secondParticleIndex];
+        int firstIndex = firstList->neighborsOffset + firstList->neighborsCount;
+        int secondIndex = secondList->neighborsOffset + secondList->neighborsCount;
+
+        listNeighborIndexes[firstIndex] = secondParticleIndex;
+        listMirrorPositions[firstIndex] = secondList->neighborsCount;
+        listNeighborIndexes[secondIndex] = firstParticleIndex;
+        listMirrorPositions[secondIndex] = firstList->neighborsCount;
+
+        firstList->neighborsCount++;
+        secondList->neighborsCount++;
+    }
+
+    void VerletListNeighborProvider::EnsureCapacity(ParticleIndex verletListIndex)
     {
-        vector<ParticleIndex>& verletList = verletLists[verletListIndex];
-        if (!StlUtilities::Exists(verletList, particleIndex))
+        VerletList* verletList = &verletLists[verletListIndex];
+        if (verletList->neighborsCount < verletList->neighborsCapacity)
         {
-            verletList.push_back(particleIndex);
+            return;
         }
+
+        if (wastedCapacity > static_cast<int>(listNeighborIndexes.size()) / 2)
+        {
+            LayOutLists(0);
+            return;
+        }
+
+        // Move the list to the end of the storage, doubling its capacity
+        int neighborsOffset = listNeighborIndexes.size();
+        int neighborsCapacity = std::max(MIN_LIST_CAPACITY_RESERVE, 2 * verletList->neighborsCapacity);
+        listNeighborIndexes.resize(neighborsOffset + neighborsCapacity);
+        listMirrorPositions.resize(neighborsOffset + neighborsCapacity);
+        std::copy(listNeighborIndexes.begin() + verletList->neighborsOffset, listNeighborIndexes.begin() + verletList->neighborsOffset + verletList->neighborsCount,
+                listNeighborIndexes.begin() + neighborsOffset);
+        std::copy(listMirrorPositions.begin() + verletList->neighborsOffset, listMirrorPositions.begin() + verletList->neighborsOffset + verletList->neighborsCount,
+                listMirrorPositions.begin() + neighborsOffset);
+
+        wastedCapacity += verletList->neighborsCapacity;
+        verletList->neighborsOffset = neighborsOffset;
+        verletList->neighborsCapacity = neighborsCapacity;
     }
 
-    void VerletListNeighborProvider::RemoveParticleFromVerletList(ParticleIndex verletListIndex, ParticleIndex particleIndex)
+    void VerletListNeighborProvider::RemoveEntry(ParticleIndex verletListIndex, int position)
     {
-        vector<ParticleIndex>* verletList = &verletLists[verletListIndex];
-        StlUtilities::QuicklyRemove(verletList, particleIndex);
+        VerletList* verletList = &verletLists[verletListIndex];
+        int lastPosition = verletList->neighborsCount - 1;
+
+        // Just one (the last one) entry is moved to the deleted entry position, and its mirror entry is updated
+        if (position < lastPosition)
+        {
+            int index = verletList->neighborsOffset + position;
+            int lastIndex = verletList->neighborsOffset + lastPosition;
+            ParticleIndex lastNeighborIndex = listNeighborIndexes[lastIndex];
+            int mirrorPosition = listMirrorPositions[lastIndex];
+
+            listNeighborIndexes[index] = lastNeighborIndex;
+            listMirrorPositions[index] = mirrorPosition;
+            listMirrorPositions[verletLists[lastNeighborIndex].neighborsOffset + mirrorPosition] = position;
+        }
+        verletList->neighborsCount--;
+    }
+
+    void VerletListNeighborProvider::ClearList(ParticleIndex verletListIndex)
+    {
+        VerletList* verletList = &verletLists[verletListIndex];
+        for (int i = 0; i < verletList->neighborsCount; ++i)
+        {
+            int index = verletList->neighborsOffset + i;
+            RemoveEntry(listNeighborIndexes[index], listMirrorPositions[index]);
+        }
+        verletList->neighborsCount = 0;
     }
 
     const ParticleIndex* VerletListNeighborProvider::GetNeighborIndexes(ParticleIndex particleIndex, ParticleIndex* neighborsCount) const
     {
-        cutoffDistanceSet = false;
-        const vector<ParticleIndex>& verletList = verletLists[particleIndex];
-        *neighborsCount = verletList.size();
-        return &verletList[0];
+        const VerletList& verletList = verletLists[particleIndex];
+        *neighborsCount = verletList.neighborsCount;
+        return &listNeighborIndexes[verletList.neighborsOffset];
     }
 
     const ParticleIndex* VerletListNeighborProvider::GetNeighborIndexes(const SpatialVector& coordinates, ParticleIndex* neighborsCount) const
     {
-        cutoffDistanceSet = false;
         return baseNeighborProvider->GetNeighborIndexes(coordinates, neighborsCount);
     }
 
@@ -160,24 +344,22 @@ namespace PackingServices
 
         FLOAT_TYPE shiftSquare = mathService->GetDistanceSquare(particle->coordinates, verletParticle->coordinates);
 
-        bool shouldUpdate = shiftSquare > 0.25 * cutoffDistance * cutoffDistance;
+        // NeighborTransfer events move particles exactly to the half-cutoff sphere, so the shift may be slightly smaller than the half-cutoff due to finite precision.
+        // If the list is not updated in this case, the particle will not get the next NeighborTransfer event and may leave the sphere.
+        bool shouldUpdate = shiftSquare > 0.25 * cutoffDistance * cutoffDistance * (1.0 - 1e-10);
         if (!shouldUpdate)
         {
             return;
         }
 
+        listUpdatesCount++;
         baseNeighborProvider->StartMove(movedParticleIndex);
         verletParticle->coordinates = particle->coordinates;
         baseNeighborProvider->EndMove();
 
-        // Remove the moved particle from all the previous neighbors' Verlet lists
-        vector<ParticleIndex>& verletList = verletLists[movedParticleIndex];
-        int neighborsCount = verletList.size();
-        for (ParticleIndex i = 0; i < neighborsCount; ++i)
-        {
-            ParticleIndex neighborIndex = verletList[i];
-            RemoveParticleFromVerletList(neighborIndex, movedParticleIndex);
-        }
+        // Remove the moved particle from all the previous neighbors' Verlet lists and clear its own list,
+        // otherwise the particles, which are no longer in the Verlet sphere, would remain in the list
+        ClearList(movedParticleIndex);
 
         FillVerletList(movedParticleIndex);
     }
@@ -0,0 +1,87 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/VerletSkinTuner.h"
+
+#include <cmath>
+#include <algorithm>
+
+using namespace std;
+using namespace Core;
+
+namespace PackingServices
+{
+    const FLOAT_TYPE VerletSkinTuner::INITIAL_STEP_FACTOR = 1.25;
+    const FLOAT_TYPE VerletSkinTuner::MIN_STEP_FACTOR = 1.02;
+
+    VerletSkinTuner::VerletSkinTuner()
+    {
+        Initialize(1.0, 1.0, 1.0);
+    }
+
+    VerletSkinTuner::~VerletSkinTuner()
+    {
+    }
+
+    void VerletSkinTuner::Initialize(FLOAT_TYPE cutoffDistance, FLOAT_TYPE minCutoffDistance, FLOAT_TYPE maxCutoffDistance)
+    {
+        this->cutoffDistance = cutoffDistance;
+        this->minCutoffDistance = minCutoffDistance;
+        this->maxCutoffDistance = maxCutoffDistance;
+        direction = 1;
+        Restart();
+    }
+
+    FLOAT_TYPE VerletSkinTuner::GetCutoffDistance() const
+    {
+        return cutoffDistance;
+    }
+
+    FLOAT_TYPE VerletSkinTuner::GetNextCutoffDistance(FLOAT_TYPE cost)
+    {
+        if (heldBlocksCount > 0)
+        {
+            heldBlocksCount--;
+            if (heldBlocksCount == 0)
+            {
+                Restart();
+            }
+            return cutoffDistance;
+        }
+
+        if (previousCostSet && cost > previousCost)
+        {
+            // Return to the previous (better) cutoff distance and look on the other side of it with a smaller step
+            direction = -direction;
+            stepFactor = sqrt(stepFactor);
+        }
+        previousCost = cost;
+        previousCostSet = true;
+
+        if (stepFactor < MIN_STEP_FACTOR)
+        {
+            heldBlocksCount = HELD_BLOCKS_COUNT;
+            return cutoffDistance;
+        }
+
+        FLOAT_TYPE nextCutoffDistance = (direction > 0) ? cutoffDistance * stepFactor : cutoffDistance / stepFactor;
+        if (nextCutoffDistance > maxCutoffDistance || nextCutoffDistance < minCutoffDistance)
+        {
+            // The optimum is probably beyond the bound; check the cutoff distance on the other side instead
+            direction = -direction;
+            nextCutoffDistance = (direction > 0) ? cutoffDistance * stepFactor : cutoffDistance / stepFactor;
+            nextCutoffDistance = std::min(maxCutoffDistance, std::max(minCutoffDistance, nextCutoffDistance));
+        }
+
+        cutoffDistance = nextCutoffDistance;
+        return cutoffDistance;
+    }
+
+    void VerletSkinTuner::Restart()
+    {
+        previousCostSet = false;
+        stepFactor = INITIAL_STEP_FACTOR;
+        heldBlocksCount = 0;
+    }
+}
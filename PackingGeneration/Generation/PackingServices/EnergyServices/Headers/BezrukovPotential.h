@@ -20,9 +20,30 @@ namespace PackingServices
 
         OVERRIDE Core::Nullable<Core::FLOAT_TYPE> GetRepulsionForceFromNeighbor(Core::FLOAT_TYPE particleDiameter, Core::FLOAT_TYPE neighborDiameter, Core::FLOAT_TYPE distance) const;
 
+        // Hides the function of IPairPotential, see the comments there
+        Core::Nullable<Core::FLOAT_TYPE> GetRepulsionForceFromNeighborInline(Core::FLOAT_TYPE particleDiameter, Core::FLOAT_TYPE neighborDiameter, Core::FLOAT_TYPE distance) const;
+
     private:
         DISALLOW_COPY_AND_ASSIGN(BezrukovPotential);
     };
+
+    inline Core::Nullable<Core::FLOAT_TYPE> BezrukovPotential::GetRepulsionForceFromNeighborInline(Core::FLOAT_TYPE particleDiameter, Core::FLOAT_TYPE neighborDiameter, Core::FLOAT_TYPE distance) const
+    {
+        Core::Nullable<Core::FLOAT_TYPE> result;
+        Core::FLOAT_TYPE halfDiameter = (particleDiameter + neighborDiameter) * 0.5;
+        Core::FLOAT_TYPE diameterRatio = distance / halfDiameter;
+        if (diameterRatio >= 1.0)
+        {
+            result.hasValue = false;
+            return result;
+        }
+
+        // It's the repulsion force from neighbor, so it should be positive in case of intersecting elastic particles
+        Core::FLOAT_TYPE force = particleDiameter * neighborDiameter * (1.0 - distance * distance / halfDiameter / halfDiameter);
+        result.hasValue = true;
+        result.value = force;
+        return result;
+    }
 }
 
 #endif /* Generation_PackingServices_EnergyServices_Headers_BezrukovPotential_h */
@@ -5,14 +5,28 @@
 #ifndef Generation_PackingServices_EnergyServices_Headers_EnergyService_h
 #define Generation_PackingServices_EnergyServices_Headers_EnergyService_h
 
+#include <boost/shared_ptr.hpp>
+#include "Core/Headers/IParallelTask.h"
 #include "Generation/PackingServices/DistanceServices/Headers/BaseDistanceService.h"
 #include "IEnergyService.h"
+namespace Core { class ThreadPool; }
+namespace PackingServices { class HarmonicPotential; }
+namespace PackingServices { class BezrukovPotential; }
 
 namespace PackingServices
 {
-    class EnergyService : public BaseDistanceService, public virtual IEnergyService
+    // Pair energies and forces are computed in loops templated by the potential type. The loops are instantiated for the built-in potentials,
+    // so that the potential functions are inlined into them, and for IPairPotential (virtual calls) for all the other potentials.
+    // The type is selected once per call by dynamic_cast.
+    class EnergyService : public BaseDistanceService, public virtual IEnergyService, public virtual Core::IParallelTask
     {
     private:
+        enum ForcesStage
+        {
+            ComputingPairForces,
+            SummingPairForces
+        };
+
         std::vector<Core::SpatialVector> vectorsToNeighbors;
         std::vector<Core::FLOAT_TYPE> distancesToNeighbors;
         const Model::ParticleIndex* neighborIndexes;
@@ -26,10 +40,38 @@ namespace PackingServices
         Core::FLOAT_TYPE potentialNormalizer;
         int minNeighborsCount;
 
+        // Parallel force computation over the half neighbor lists (each pair is stored once, for the particle with the smaller index).
+        // The force of each pair is computed once into pairForces (the force on the particle with the smaller index), the particles of the part i
+        // are partParticleStarts[i], ..., partParticleStarts[i + 1] - 1. Then each particle sums the forces of its pairs in a fixed order
+        // (the pairs with the smaller neighbor indexes from lowerPairIndexes, then its own half list), so the result does not depend on the parts.
+        boost::shared_ptr<Core::ThreadPool> threadPool;
+        std::vector<int> halfNeighborOffsets;
+        std::vector<Model::ParticleIndex> halfNeighborIndexes;
+        std::vector<int> lowerPairOffsets;
+        std::vector<int> lowerPairIndexes;
+        std::vector<Model::ParticleIndex> partParticleStarts;
+        std::vector<Core::SpatialVector> pairForces;
+        int partsCount;
+        std::vector<Model::ParticlePair> partClosestPairs;
+        ForcesStage forcesStage;
+        Core::FLOAT_TYPE currentContractionRatio;
+        const IPairPotential* currentPairPotential;
+        const BezrukovPotential* currentBezrukovPotential;
+        const HarmonicPotential* currentHarmonicPotential;
+        std::vector<Core::SpatialVector>* currentParticleForces;
+
     public:
-        // Max number of close neighbors to contribute to particle energy and force
+        // Max number of close neighbors to contribute to particle energy and force.
+        // If positive, FillParticleForces computes the forces per particle in a single thread, as the close neighbor relation is not symmetric.
         int maxCloseNeighborsCount;
 
+        // Number of threads for FillParticleForces. If not positive, the number of hardware threads is used.
+        int threadsCount;
+
+        // Number of parts the particles are split into by FillParticleForces. The forces do not depend on it.
+        // If not positive, the number of threads is used.
+        int forcePartsCount;
+
     public:
         EnergyService(MathService* mathService, INeighborProvider* neighborProvider);
 
@@ -53,9 +95,42 @@ namespace PackingServices
 
         OVERRIDE void GetContractionEnergiesPerParticle(const std::vector<Core::FLOAT_TYPE>& contractionRatios, const std::vector<const IPairPotential*>& pairPotentials, std::vector<EnergiesPerParticle>* energiesPerParticle);
 
+        // Computes each pair force once and adds it to both particles (pair potentials are symmetric with respect to particle diameters).
+        // The neighbor lists of the provider shall be symmetric (as for all the providers of cell and Verlet lists). Throws InvalidOperationException,
+        // if the numbers of the neighbors with smaller and larger indexes differ.
+        // The forces are exactly the same for any number of threads and parts.
+        // If maxCloseNeighborsCount is set, the neighbors of a particle depend on the particle, so the forces are computed per particle in a single thread.
         OVERRIDE Model::ParticlePair FillParticleForces(Core::FLOAT_TYPE contractionRatio, const IPairPotential& pairPotential, std::vector<Core::SpatialVector>* particleForces);
 
+        OVERRIDE void Execute(int partIndex);
+
+        virtual ~EnergyService();
+
     private:
+        template<class TPairPotential>
+        EnergiesResult GetTypedContractionEnergies(const std::vector<Core::FLOAT_TYPE>& contractionRatios, const std::vector<const TPairPotential*>& pairPotentials);
+
+        template<class TPairPotential>
+        void FillTypedContractionEnergiesPerParticle(const std::vector<Core::FLOAT_TYPE>& contractionRatios, const std::vector<const TPairPotential*>& pairPotentials, std::vector<EnergiesPerParticle>* energiesPerParticle);
+
+        Model::ParticlePair FillParticleForcesPerParticle(Core::FLOAT_TYPE contractionRatio, const IPairPotential& pairPotential, std::vector<Core::SpatialVector>* particleForces);
+
+        template<class TPairPotential>
+        Model::ParticlePair FillTypedParticleForcesPerParticle(Core::FLOAT_TYPE contractionRatio, const TPairPotential& pairPotential, std::vector<Core::SpatialVector>* particleForces);
+
+        // Neighbor providers are not thread-safe, so the half neighbor lists are copied from the provider in a single thread.
+        // Also fills the indexes of the pairs, where each particle is the neighbor with the larger index.
+        void FillHalfNeighborLists();
+
+        void FillPartParticleStarts();
+
+        void ComputePartPairForces(int partIndex);
+
+        template<class TPairPotential>
+        void ComputeTypedPartPairForces(int partIndex, const TPairPotential& pairPotential);
+
+        void SumPartPairForces(int partIndex);
+
         void FilterCloseNeighbors();
 
         void FillDistancesToNeighbors(Model::ParticleIndex particleIndex);
@@ -64,13 +139,15 @@ namespace PackingServices
 
         void UpdateClosestPair(Model::ParticleIndex particleIndex, Model::ParticlePair* closestPair);
 
+        template<class TPairPotential>
         void FillCurrentParticleEnergies(Model::ParticleIndex particleIndex,
                 const std::vector<Core::FLOAT_TYPE>& contractionRatios,
-                const std::vector<const IPairPotential*>& pairPotentials,
+                const std::vector<const TPairPotential*>& pairPotentials,
                 std::vector<Core::FLOAT_TYPE>* currentParticleEnergies,
                 std::vector<int>* currentParticleNeighborsCounts);
 
-        void FillCurrentParticleForce(Model::ParticleIndex particleIndex, Core::FLOAT_TYPE contractionRatio, const IPairPotential& pairPotential, Core::SpatialVector* force);
+        template<class TPairPotential>
+        void FillCurrentParticleForce(Model::ParticleIndex particleIndex, Core::FLOAT_TYPE contractionRatio, const TPairPotential& pairPotential, Core::SpatialVector* force);
 
         DISALLOW_COPY_AND_ASSIGN(EnergyService);
     };
@@ -5,6 +5,7 @@
 #ifndef Generation_PackingServices_EnergyServices_Headers_HarmonicPotential_h
 #define Generation_PackingServices_EnergyServices_Headers_HarmonicPotential_h
 
+#include <cmath>
 #include "Core/Headers/Macros.h"
 #include "IPairPotential.h"
 
@@ -22,9 +23,74 @@ namespace PackingServices
 
         OVERRIDE Core::Nullable<Core::FLOAT_TYPE> GetRepulsionForceFromNeighbor(Core::FLOAT_TYPE particleDiameter, Core::FLOAT_TYPE neighborDiameter, Core::FLOAT_TYPE distance) const;
 
+        // Hide the functions of IPairPotential, see the comments there
+        Core::Nullable<Core::FLOAT_TYPE> GetEnergyInline(Core::FLOAT_TYPE firstParticleDiameter, Core::FLOAT_TYPE secondParticleDiameter, Core::FLOAT_TYPE distance) const;
+
+        Core::Nullable<Core::FLOAT_TYPE> GetRepulsionForceFromNeighborInline(Core::FLOAT_TYPE particleDiameter, Core::FLOAT_TYPE neighborDiameter, Core::FLOAT_TYPE distance) const;
+
     private:
         DISALLOW_COPY_AND_ASSIGN(HarmonicPotential);
     };
+
+    inline Core::Nullable<Core::FLOAT_TYPE> HarmonicPotential::GetEnergyInline(Core::FLOAT_TYPE firstParticleDiameter, Core::FLOAT_TYPE secondParticleDiameter, Core::FLOAT_TYPE distance) const
+    {
+        Core::Nullable<Core::FLOAT_TYPE> result;
+        Core::FLOAT_TYPE diameterRatio = 2.0 * distance / (firstParticleDiameter + secondParticleDiameter);
+        if (diameterRatio >= 1.0)
+        {
+            result.hasValue = false;
+            return result;
+        }
+
+        // From Chaudhury, Berthier, Sastry (2010).
+        // If the potential energy is potentialNormalizer * (1.0 - distance / halfDiameter) ^ energyPower.
+        // Zero power is used to count contacts.
+        Core::FLOAT_TYPE contractionEnergy;
+        if (energyPower == 2.0)
+        {
+            contractionEnergy = (1.0 - diameterRatio) * (1.0 - diameterRatio);
+        }
+        else if (energyPower == 0.0)
+        {
+            contractionEnergy = 1.0;
+        }
+        else
+        {
+            contractionEnergy = std::pow(1.0 - diameterRatio, energyPower);
+        }
+
+        result.hasValue = true;
+        result.value = contractionEnergy;
+        return result;
+    }
+
+    inline Core::Nullable<Core::FLOAT_TYPE> HarmonicPotential::GetRepulsionForceFromNeighborInline(Core::FLOAT_TYPE particleDiameter, Core::FLOAT_TYPE neighborDiameter, Core::FLOAT_TYPE distance) const
+    {
+        Core::Nullable<Core::FLOAT_TYPE> result;
+        Core::FLOAT_TYPE halfDiameter = (particleDiameter + neighborDiameter) * 0.5;
+        Core::FLOAT_TYPE diameterRatio = distance / halfDiameter;
+        if (diameterRatio >= 1.0)
+        {
+            result.hasValue = false;
+            return result;
+        }
+
+        // If the potential energy is potentialNormalizer * (1.0 - distance / halfDiameter) ^ energyPower.
+        Core::FLOAT_TYPE force;
+        if (energyPower == 2.0)
+        {
+            force = 1.0 - diameterRatio;
+        }
+        else
+        {
+            force = std::pow(1.0 - diameterRatio, energyPower - 1.0);
+        }
+        force = energyPower * force / halfDiameter;
+
+        result.hasValue = true;
+        result.value = force;
+        return result;
+    }
 }
 
 #endif /* Generation_PackingServices_EnergyServices_Headers_HarmonicPotential_h */
@@ -5,6 +5,7 @@
 #ifndef Generation_PackingServices_EnergyServices_Headers_IPairPotential_h
 #define Generation_PackingServices_EnergyServices_Headers_IPairPotential_h
 
+#include <vector>
 #include "Generation/Model/Headers/Types.h"
 
 namespace PackingServices
@@ -17,6 +18,37 @@ namespace PackingServices
         virtual Core::Nullable<Core::FLOAT_TYPE> GetRepulsionForceFromNeighbor(Core::FLOAT_TYPE particleDiameter, Core::FLOAT_TYPE neighborDiameter, Core::FLOAT_TYPE distance) const = 0;
 
         virtual ~IPairPotential(){ };
+
+        // Non-virtual counterparts of the functions above for the loops over neighbor pairs, which are templated by the potential type (see EnergyService).
+        // Built-in potentials hide these functions with inline implementations, so that the loops instantiated for them are free of virtual calls and can be optimized by the compiler.
+        // For other potentials these functions just call the virtual ones.
+        Core::Nullable<Core::FLOAT_TYPE> GetEnergyInline(Core::FLOAT_TYPE firstParticleDiameter, Core::FLOAT_TYPE secondParticleDiameter, Core::FLOAT_TYPE distance) const
+        {
+            return GetEnergy(firstParticleDiameter, secondParticleDiameter, distance);
+        }
+
+        Core::Nullable<Core::FLOAT_TYPE> GetRepulsionForceFromNeighborInline(Core::FLOAT_TYPE particleDiameter, Core::FLOAT_TYPE neighborDiameter, Core::FLOAT_TYPE distance) const
+        {
+            return GetRepulsionForceFromNeighbor(particleDiameter, neighborDiameter, distance);
+        }
+
+        // Casts the potentials to TPairPotential to select the templated loops. Returns false if any of the potentials is of another type.
+        template<class TPairPotential>
+        static bool TryCastPairPotentials(const std::vector<const IPairPotential*>& pairPotentials, std::vector<const TPairPotential*>* typedPairPotentials)
+        {
+            std::vector<const TPairPotential*>& typedPairPotentialsRef = *typedPairPotentials;
+            typedPairPotentialsRef.resize(pairPotentials.size());
+            for (size_t i = 0; i < pairPotentials.size(); ++i)
+            {
+                typedPairPotentialsRef[i] = dynamic_cast<const TPairPotential*>(pairPotentials[i]);
+                if (typedPairPotentialsRef[i] == NULL)
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
     };
 }
 
@@ -48,6 +48,13 @@ namespace PackingServices
         OVERRIDE void GetContractionEnergiesPerParticle(const std::vector<Core::FLOAT_TYPE>& contractionRatios, const std::vector<const IPairPotential*>& pairPotentials, std::vector<EnergiesPerParticle>* energiesPerParticle);
 
     private:
+        // Templated by the potential type, see EnergyService
+        template<class TPairPotential>
+        EnergiesResult GetTypedContractionEnergies(const std::vector<Core::FLOAT_TYPE>& contractionRatios, const std::vector<const TPairPotential*>& pairPotentials);
+
+        template<class TPairPotential>
+        void FillTypedContractionEnergiesPerParticle(const std::vector<Core::FLOAT_TYPE>& contractionRatios, const std::vector<const TPairPotential*>& pairPotentials, std::vector<EnergiesPerParticle>* energiesPerParticle);
+
         DISALLOW_COPY_AND_ASSIGN(NoRattlersEnergyService);
     };
 }
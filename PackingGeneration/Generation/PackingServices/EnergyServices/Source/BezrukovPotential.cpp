@@ -20,20 +20,7 @@ namespace PackingServices
 
     Nullable<FLOAT_TYPE> BezrukovPotential::GetRepulsionForceFromNeighbor(FLOAT_TYPE particleDiameter, FLOAT_TYPE neighborDiameter, FLOAT_TYPE distance) const
     {
-        Nullable<FLOAT_TYPE> result;
-        FLOAT_TYPE halfDiameter = (particleDiameter + neighborDiameter) * 0.5;
-        FLOAT_TYPE diameterRatio = distance / halfDiameter;
-        if (diameterRatio >= 1.0)
-        {
-            result.hasValue = false;
-            return result;
-        }
-
-        // It's the repulsion force from neighbor, so it should be positive in case of intersecting elastic particles
-        FLOAT_TYPE force = particleDiameter * neighborDiameter * (1.0 - distance * distance / halfDiameter / halfDiameter);
-        result.hasValue = true;
-        result.value = force;
-        return result;
+        return GetRepulsionForceFromNeighborInline(particleDiameter, neighborDiameter, distance);
     }
 }
 
@@ -4,13 +4,18 @@
 
 #include "../Headers/EnergyService.h"
 
+#include <algorithm>
+#include "Core/Headers/ThreadPool.h"
 #include "Core/Headers/VectorUtilities.h"
 #include "Core/Headers/StlUtilities.h"
 #include "Core/Headers/Constants.h"
+#include "Core/Headers/Exceptions.h"
 #include "Generation/PackingServices/DistanceServices/Headers/INeighborProvider.h"
 #include "Generation/Model/Headers/Config.h"
 #include "Generation/PackingServices/Headers/MathService.h"
 #include "../Headers/IPairPotential.h"
+#include "../Headers/HarmonicPotential.h"
+#include "../Headers/BezrukovPotential.h"
 
 using namespace std;
 using namespace Core;
@@ -23,6 +28,13 @@ namespace PackingServices
     {
         minNeighborsCount = 0;
         maxCloseNeighborsCount = -1;
+        threadsCount = 0;
+        forcePartsCount = 0;
+        partsCount = 0;
+    }
+
+    EnergyService::~EnergyService()
+    {
     }
 
     void EnergyService::SetParticles(const Packing& particles)
@@ -42,6 +54,18 @@ namespace PackingServices
     }
 
     IEnergyService::EnergiesResult EnergyService::GetContractionEnergies(const vector<FLOAT_TYPE>& contractionRatios, const vector<const IPairPotential*>& pairPotentials)
+    {
+        vector<const HarmonicPotential*> harmonicPotentials;
+        if (IPairPotential::TryCastPairPotentials(pairPotentials, &harmonicPotentials))
+        {
+            return GetTypedContractionEnergies(contractionRatios, harmonicPotentials);
+        }
+
+        return GetTypedContractionEnergies(contractionRatios, pairPotentials);
+    }
+
+    template<class TPairPotential>
+    IEnergyService::EnergiesResult EnergyService::GetTypedContractionEnergies(const vector<FLOAT_TYPE>& contractionRatios, const vector<const TPairPotential*>& pairPotentials)
     {
         int energyTypesCount = contractionRatios.size();
         IEnergyService::EnergiesResult energiesResult;
@@ -80,6 +104,20 @@ namespace PackingServices
 
     // TODO: Merge with GetContractionEnergies!!!!
     OVERRIDE void EnergyService::GetContractionEnergiesPerParticle(const vector<FLOAT_TYPE>& contractionRatios, const vector<const IPairPotential*>& pairPotentials, vector<IEnergyService::EnergiesPerParticle>* energiesPerParticle)
+    {
+        vector<const HarmonicPotential*> harmonicPotentials;
+        if (IPairPotential::TryCastPairPotentials(pairPotentials, &harmonicPotentials))
+        {
+            FillTypedContractionEnergiesPerParticle(contractionRatios, harmonicPotentials, energiesPerParticle);
+        }
+        else
+        {
+            FillTypedContractionEnergiesPerParticle(contractionRatios, pairPotentials, energiesPerParticle);
+        }
+    }
+
+    template<class TPairPotential>
+    void EnergyService::FillTypedContractionEnergiesPerParticle(const vector<FLOAT_TYPE>& contractionRatios, const vector<const TPairPotential*>& pairPotentials, vector<IEnergyService::EnergiesPerParticle>* energiesPerParticle)
     {
         size_t energyTypesCount = contractionRatios.size();
         vector<IEnergyService::EnergiesPerParticle>& energiesPerParticleRef = *energiesPerParticle;
@@ -110,6 +148,229 @@ namespace PackingServices
     }
 
     ParticlePair EnergyService::FillParticleForces(FLOAT_TYPE contractionRatio, const IPairPotential& pairPotential, vector<SpatialVector>* particleForces)
+    {
+        if (maxCloseNeighborsCount > 0)
+        {
+            return FillParticleForcesPerParticle(contractionRatio, pairPotential, particleForces);
+        }
+
+        if (threadPool == NULL || (threadsCount > 0 && threadPool->GetThreadsCount() != threadsCount))
+        {
+            threadPool.reset(new ThreadPool(threadsCount));
+        }
+
+        FillHalfNeighborLists();
+
+        partsCount = (forcePartsCount > 0) ? forcePartsCount : threadPool->GetThreadsCount();
+        partsCount = std::min(partsCount, config->particlesCount);
+        partsCount = std::max(partsCount, 1);
+        FillPartParticleStarts();
+        pairForces.resize(halfNeighborIndexes.size());
+        partClosestPairs.assign(partsCount, ParticlePair(0, 0, MAX_FLOAT_VALUE));
+
+        currentContractionRatio = contractionRatio;
+        currentPairPotential = &pairPotential;
+        currentBezrukovPotential = dynamic_cast<const BezrukovPotential*>(&pairPotential);
+        currentHarmonicPotential = dynamic_cast<const HarmonicPotential*>(&pairPotential);
+        currentParticleForces = particleForces;
+        particleForces->resize(config->particlesCount);
+
+        forcesStage = ComputingPairForces;
+        threadPool->Execute(this, partsCount);
+
+        forcesStage = SummingPairForces;
+        threadPool->Execute(this, partsCount);
+
+        // Parts are reduced in a fixed order, so the result does not depend on thread scheduling
+        ParticlePair closestPair = partClosestPairs[0];
+        for (int i = 1; i < partsCount; ++i)
+        {
+            if (partClosestPairs[i].normalizedDistanceSquare < closestPair.normalizedDistanceSquare)
+            {
+                closestPair = partClosestPairs[i];
+            }
+        }
+
+        return closestPair;
+    }
+
+    void EnergyService::Execute(int partIndex)
+    {
+        if (forcesStage == ComputingPairForces)
+        {
+            ComputePartPairForces(partIndex);
+        }
+        else
+        {
+            SumPartPairForces(partIndex);
+        }
+    }
+
+    void EnergyService::FillHalfNeighborLists()
+    {
+        halfNeighborOffsets.resize(config->particlesCount + 1);
+        halfNeighborIndexes.clear();
+        lowerPairOffsets.assign(config->particlesCount + 1, 0);
+
+        int lowerNeighborsCount = 0;
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            halfNeighborOffsets[particleIndex] = halfNeighborIndexes.size();
+
+            ParticleIndex currentNeighborsCount;
+            const ParticleIndex* currentNeighborIndexes = neighborProvider->GetNeighborIndexes(particleIndex, &currentNeighborsCount);
+            for (ParticleIndex i = 0; i < currentNeighborsCount; ++i)
+            {
+                ParticleIndex neighborIndex = currentNeighborIndexes[i];
+                if (neighborIndex > particleIndex)
+                {
+                    halfNeighborIndexes.push_back(neighborIndex);
+                    lowerPairOffsets[neighborIndex + 1]++;
+                }
+                else if (neighborIndex < particleIndex)
+                {
+                    lowerNeighborsCount++;
+                }
+            }
+        }
+
+        halfNeighborOffsets[config->particlesCount] = halfNeighborIndexes.size();
+
+        // Each pair is stored once, so it shall be seen from both particles
+        if (lowerNeighborsCount != static_cast<int>(halfNeighborIndexes.size()))
+        {
+            throw InvalidOperationException("Neighbor lists are not symmetric, so the forces can not be computed over the half neighbor lists.");
+        }
+
+        // The pairs of each particle are ordered by the neighbor index, as they are filled in the order of particles
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            lowerPairOffsets[particleIndex + 1] += lowerPairOffsets[particleIndex];
+        }
+
+        lowerPairIndexes.resize(halfNeighborIndexes.size());
+        vector<int> lowerPairPositions(lowerPairOffsets.begin(), lowerPairOffsets.end() - 1);
+        for (int pairIndex = 0; pairIndex < static_cast<int>(halfNeighborIndexes.size()); ++pairIndex)
+        {
+            ParticleIndex neighborIndex = halfNeighborIndexes[pairIndex];
+            lowerPairIndexes[lowerPairPositions[neighborIndex]] = pairIndex;
+            lowerPairPositions[neighborIndex]++;
+        }
+    }
+
+    void EnergyService::FillPartParticleStarts()
+    {
+        // Parts contain approximately equal numbers of pairs
+        partParticleStarts.resize(partsCount + 1);
+        partParticleStarts[0] = 0;
+        int pairsCount = halfNeighborOffsets[config->particlesCount];
+        for (int i = 1; i < partsCount; ++i)
+        {
+            int partStartOffset = static_cast<int>(static_cast<FLOAT_TYPE>(pairsCount) * i / partsCount);
+            ParticleIndex partStart = std::lower_bound(halfNeighborOffsets.begin(), halfNeighborOffsets.end(), partStartOffset) - halfNeighborOffsets.begin();
+            partParticleStarts[i] = std::max(partParticleStarts[i - 1], std::min(partStart, config->particlesCount));
+        }
+        partParticleStarts[partsCount] = config->particlesCount;
+    }
+
+    void EnergyService::ComputePartPairForces(int partIndex)
+    {
+        if (currentBezrukovPotential != NULL)
+        {
+            ComputeTypedPartPairForces(partIndex, *currentBezrukovPotential);
+        }
+        else if (currentHarmonicPotential != NULL)
+        {
+            ComputeTypedPartPairForces(partIndex, *currentHarmonicPotential);
+        }
+        else
+        {
+            ComputeTypedPartPairForces(partIndex, *currentPairPotential);
+        }
+    }
+
+    template<class TPairPotential>
+    void EnergyService::ComputeTypedPartPairForces(int partIndex, const TPairPotential& pairPotential)
+    {
+        const Packing& particlesRef = *particles;
+        ParticlePair& closestPair = partClosestPairs[partIndex];
+        SpatialVector difference;
+
+        for (ParticleIndex particleIndex = partParticleStarts[partIndex]; particleIndex < partParticleStarts[partIndex + 1]; ++particleIndex)
+        {
+            const DomainParticle& particle = particlesRef[particleIndex];
+            for (int i = halfNeighborOffsets[particleIndex]; i < halfNeighborOffsets[particleIndex + 1]; ++i)
+            {
+                ParticleIndex neighborIndex = halfNeighborIndexes[i];
+                const DomainParticle& neighbor = particlesRef[neighborIndex];
+
+                mathService->FillDistance(neighbor.coordinates, particle.coordinates, &difference);
+                FLOAT_TYPE distance = VectorUtilities::GetLength(difference);
+
+                FLOAT_TYPE diameterRatio = 2.0 * distance / (particle.diameter + neighbor.diameter);
+                if (closestPair.normalizedDistanceSquare > diameterRatio * diameterRatio)
+                {
+                    closestPair.normalizedDistanceSquare = diameterRatio * diameterRatio;
+                    closestPair.firstParticleIndex = particleIndex;
+                    closestPair.secondParticleIndex = neighborIndex;
+                }
+
+                Nullable<FLOAT_TYPE> forceLength = pairPotential.GetRepulsionForceFromNeighborInline(particle.diameter, neighbor.diameter, distance * currentContractionRatio);
+                if (!forceLength.hasValue)
+                {
+                    VectorUtilities::InitializeWith(&pairForces[i], 0.0);
+                    continue;
+                }
+
+                // Difference is directed from the particle to the neighbor, so to get the force on the particle we need to multiply it by -1.
+                // The neighbor gets the opposite force.
+                VectorUtilities::MultiplyByValue(difference, - forceLength.value / distance, &pairForces[i]);
+            }
+        }
+    }
+
+    void EnergyService::SumPartPairForces(int partIndex)
+    {
+        vector<SpatialVector>& particleForcesRef = *currentParticleForces;
+        ParticleIndex startIndex = static_cast<ParticleIndex>(static_cast<FLOAT_TYPE>(config->particlesCount) * partIndex / partsCount);
+        ParticleIndex endIndex = static_cast<ParticleIndex>(static_cast<FLOAT_TYPE>(config->particlesCount) * (partIndex + 1) / partsCount);
+
+        for (ParticleIndex particleIndex = startIndex; particleIndex < endIndex; ++particleIndex)
+        {
+            SpatialVector& force = particleForcesRef[particleIndex];
+            VectorUtilities::InitializeWith(&force, 0.0);
+
+            for (int i = lowerPairOffsets[particleIndex]; i < lowerPairOffsets[particleIndex + 1]; ++i)
+            {
+                VectorUtilities::Subtract(force, pairForces[lowerPairIndexes[i]], &force);
+            }
+
+            for (int i = halfNeighborOffsets[particleIndex]; i < halfNeighborOffsets[particleIndex + 1]; ++i)
+            {
+                VectorUtilities::Add(force, pairForces[i], &force);
+            }
+        }
+    }
+
+    ParticlePair EnergyService::FillParticleForcesPerParticle(FLOAT_TYPE contractionRatio, const IPairPotential& pairPotential, vector<SpatialVector>* particleForces)
+    {
+        const BezrukovPotential* bezrukovPotential = dynamic_cast<const BezrukovPotential*>(&pairPotential);
+        if (bezrukovPotential != NULL)
+        {
+            return FillTypedParticleForcesPerParticle(contractionRatio, *bezrukovPotential, particleForces);
+        }
+
+        const HarmonicPotential* harmonicPotential = dynamic_cast<const HarmonicPotential*>(&pairPotential);
+        if (harmonicPotential != NULL)
+        {
+            return FillTypedParticleForcesPerParticle(contractionRatio, *harmonicPotential, particleForces);
+        }
+
+        return FillTypedParticleForcesPerParticle(contractionRatio, pairPotential, particleForces);
+    }
+
+    template<class TPairPotential>
+    ParticlePair EnergyService::FillTypedParticleForcesPerParticle(FLOAT_TYPE contractionRatio, const TPairPotential& pairPotential, vector<SpatialVector>* particleForces)
     {
         ParticlePair closestPair;
         closestPair.normalizedDistanceSquare = MAX_FLOAT_VALUE;
@@ -182,7 +443,8 @@ namespace PackingServices
         }
     }
 
-    void EnergyService::FillCurrentParticleForce(ParticleIndex particleIndex, FLOAT_TYPE contractionRatio, const IPairPotential& pairPotential, SpatialVector* force)
+    template<class TPairPotential>
+    void EnergyService::FillCurrentParticleForce(ParticleIndex particleIndex, FLOAT_TYPE contractionRatio, const TPairPotential& pairPotential, SpatialVector* force)
     {
         const Packing& particlesRef = *particles;
         const DomainParticle& particle = particlesRef[particleIndex];
@@ -201,7 +463,7 @@ namespace PackingServices
             FLOAT_TYPE distance = distancesToNeighbors[i];
             SpatialVector difference = vectorsToNeighbors[i];
 
-            Nullable<FLOAT_TYPE> forceLength = pairPotential.GetRepulsionForceFromNeighbor(particle.diameter, neighbor.diameter, distance * contractionRatio);
+            Nullable<FLOAT_TYPE> forceLength = pairPotential.GetRepulsionForceFromNeighborInline(particle.diameter, neighbor.diameter, distance * contractionRatio);
             if (!forceLength.hasValue)
             {
                 continue;
@@ -248,9 +510,10 @@ namespace PackingServices
         }
     }
 
+    template<class TPairPotential>
     void EnergyService::FillCurrentParticleEnergies(ParticleIndex particleIndex,
             const vector<FLOAT_TYPE>& contractionRatios,
-            const vector<const IPairPotential*>& pairPotentials,
+            const vector<const TPairPotential*>& pairPotentials,
             vector<FLOAT_TYPE>* currentParticleEnergies,
             vector<int>* currentParticleNeighborsCounts)
     {
@@ -278,9 +541,9 @@ namespace PackingServices
             for (int energyTypeIndex = 0; energyTypeIndex < energyTypesCount; ++energyTypeIndex)
             {
                 FLOAT_TYPE contractionRatio = contractionRatios[energyTypeIndex];
-                const IPairPotential* pairPotential = pairPotentials[energyTypeIndex];
+                const TPairPotential* pairPotential = pairPotentials[energyTypeIndex];
 
-                Nullable<FLOAT_TYPE> energy = pairPotential->GetEnergy(particle.diameter, neighbor.diameter, distance * contractionRatio);
+                Nullable<FLOAT_TYPE> energy = pairPotential->GetEnergyInline(particle.diameter, neighbor.diameter, distance * contractionRatio);
                 if (energy.hasValue)
                 {
                     currentParticleEnergiesRef[energyTypeIndex] += potentialNormalizer * energy.value;
@@ -312,4 +575,3 @@ namespace PackingServices
         }
     }
 }
-
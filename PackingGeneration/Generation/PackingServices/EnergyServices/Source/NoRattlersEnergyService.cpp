@@ -9,6 +9,7 @@
 #include "Generation/PackingServices/PostProcessing/Headers/RattlerRemovalService.h"
 #include "Generation/PackingServices/DistanceServices/Headers/INeighborProvider.h"
 #include "Generation/PackingServices/EnergyServices/Headers/IPairPotential.h"
+#include "Generation/PackingServices/EnergyServices/Headers/HarmonicPotential.h"
 #include "Generation/PackingServices/Headers/MathService.h"
 #include "Generation/Model/Headers/Config.h"
 
@@ -74,49 +75,71 @@ namespace PackingServices
     }
 
     IEnergyService::EnergiesResult NoRattlersEnergyService::GetContractionEnergies(const vector<FLOAT_TYPE>& contractionRatios, const vector<const IPairPotential*>& pairPotentials)
+    {
+        vector<const HarmonicPotential*> harmonicPotentials;
+        if (IPairPotential::TryCastPairPotentials(pairPotentials, &harmonicPotentials))
+        {
+            return GetTypedContractionEnergies(contractionRatios, harmonicPotentials);
+        }
+
+        return GetTypedContractionEnergies(contractionRatios, pairPotentials);
+    }
+
+    template<class TPairPotential>
+    IEnergyService::EnergiesResult NoRattlersEnergyService::GetTypedContractionEnergies(const vector<FLOAT_TYPE>& contractionRatios, const vector<const TPairPotential*>& pairPotentials)
     {
         const Packing& particlesRef = *particles;
-        vector<bool> rattlerMask(config->particlesCount);
         int energyTypesCount = contractionRatios.size();
 
         IEnergyService::EnergiesResult energiesResult;
         energiesResult.contractionEnergies.resize(energyTypesCount, 0.0);
         energiesResult.nonRattlersCounts.resize(energyTypesCount, 0);
 
+        vector<vector<bool> > rattlerMasks(energyTypesCount, vector<bool>(config->particlesCount));
         for (int energyTypeIndex = 0; energyTypeIndex < energyTypesCount; ++energyTypeIndex)
         {
-           FLOAT_TYPE contractionRatio = contractionRatios[energyTypeIndex];
-           const IPairPotential* pairPotential = pairPotentials[energyTypeIndex];
+            rattlerRemovalService->FillRattlerMask(contractionRatios[energyTypeIndex], &rattlerMasks[energyTypeIndex]);
+        }
 
-           rattlerRemovalService->FillRattlerMask(contractionRatio, &rattlerMask);
+        // A single pass over the pairs for all the energy types. The energies are summed in the same order as in separate passes.
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            const DomainParticle* particle = &particlesRef[particleIndex];
+            if (particle->isImmobile)
+            {
+                continue;
+            }
 
-           for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
-           {
-                const DomainParticle* particle = &particlesRef[particleIndex];
-                if (rattlerMask[particleIndex] || particle->isImmobile)
-                {
-                    continue;
-                }
+            ParticleIndex neighborsCount;
+            const ParticleIndex* neighborIndexes = neighborProvider->GetNeighborIndexes(particleIndex, &neighborsCount);
+            for (ParticleIndex i = 0; i < neighborsCount; ++i)
+            {
+                ParticleIndex neighborIndex = neighborIndexes[i];
+                const Particle* neighbor = &particlesRef[neighborIndex];
+                FLOAT_TYPE distance =  mathService->GetDistanceLength(neighbor->coordinates, particle->coordinates);
 
-                ParticleIndex neighborsCount;
-                const ParticleIndex* neighborIndexes = neighborProvider->GetNeighborIndexes(particleIndex, &neighborsCount);
-                for (ParticleIndex i = 0; i < neighborsCount; ++i)
+                for (int energyTypeIndex = 0; energyTypeIndex < energyTypesCount; ++energyTypeIndex)
                 {
-                    ParticleIndex neighborIndex = neighborIndexes[i];
-                    const Particle* neighbor = &particlesRef[neighborIndex];
-                    if (rattlerMask[neighborIndex])
+                    const vector<bool>& rattlerMask = rattlerMasks[energyTypeIndex];
+                    if (rattlerMask[particleIndex] || rattlerMask[neighborIndex])
                     {
                         continue;
                     }
 
-                    FLOAT_TYPE distance =  mathService->GetDistanceLength(neighbor->coordinates, particle->coordinates);
-                    Nullable<FLOAT_TYPE> energy = pairPotential->GetEnergy(particle->diameter, neighbor->diameter, distance * contractionRatio);
+                    Nullable<FLOAT_TYPE> energy = pairPotentials[energyTypeIndex]->GetEnergyInline(particle->diameter, neighbor->diameter, distance * contractionRatios[energyTypeIndex]);
                     if (energy.hasValue)
                     {
                         energiesResult.contractionEnergies[energyTypeIndex] += potentialNormalizer * energy.value;
                     }
                 }
-                energiesResult.nonRattlersCounts[energyTypeIndex]++;
+            }
+
+            for (int energyTypeIndex = 0; energyTypeIndex < energyTypesCount; ++energyTypeIndex)
+            {
+                if (!rattlerMasks[energyTypeIndex][particleIndex])
+                {
+                    energiesResult.nonRattlersCounts[energyTypeIndex]++;
+                }
             }
         }
 
@@ -125,6 +148,20 @@ namespace PackingServices
 
     // TODO: Merge with GetContractionEnergies!!!! (and maybe with EnergyService::GetContractionEnergiesPerParticle
     OVERRIDE void NoRattlersEnergyService::GetContractionEnergiesPerParticle(const vector<FLOAT_TYPE>& contractionRatios, const vector<const IPairPotential*>& pairPotentials, vector<IEnergyService::EnergiesPerParticle>* energiesPerParticle)
+    {
+        vector<const HarmonicPotential*> harmonicPotentials;
+        if (IPairPotential::TryCastPairPotentials(pairPotentials, &harmonicPotentials))
+        {
+            FillTypedContractionEnergiesPerParticle(contractionRatios, harmonicPotentials, energiesPerParticle);
+        }
+        else
+        {
+            FillTypedContractionEnergiesPerParticle(contractionRatios, pairPotentials, energiesPerParticle);
+        }
+    }
+
+    template<class TPairPotential>
+    void NoRattlersEnergyService::FillTypedContractionEnergiesPerParticle(const vector<FLOAT_TYPE>& contractionRatios, const vector<const TPairPotential*>& pairPotentials, vector<IEnergyService::EnergiesPerParticle>* energiesPerParticle)
     {
         int energyTypesCount = contractionRatios.size();
         vector<IEnergyService::EnergiesPerParticle>& energiesPerParticleRef = *energiesPerParticle;
@@ -136,36 +173,38 @@ namespace PackingServices
         {
             energiesPerParticleRef[energyTypeIndex].contractionEnergiesPerParticle.resize(config->particlesCount, 0.0);
             energiesPerParticleRef[energyTypeIndex].rattlerMask.resize(config->particlesCount);
+            rattlerRemovalService->FillRattlerMask(contractionRatios[energyTypeIndex], &energiesPerParticleRef[energyTypeIndex].rattlerMask);
+        }
 
-            FLOAT_TYPE contractionRatio = contractionRatios[energyTypeIndex];
-            const IPairPotential* pairPotential = pairPotentials[energyTypeIndex];
-
-            rattlerRemovalService->FillRattlerMask(contractionRatio, &energiesPerParticleRef[energyTypeIndex].rattlerMask);
+        // A single pass over the pairs for all the energy types
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            const DomainParticle* particle = &particlesRef[particleIndex];
+            if (particle->isImmobile)
+            {
+                continue;
+            }
 
-            for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+            ParticleIndex neighborsCount;
+            const ParticleIndex* neighborIndexes = neighborProvider->GetNeighborIndexes(particleIndex, &neighborsCount);
+            for (ParticleIndex i = 0; i < neighborsCount; ++i)
             {
-                const DomainParticle* particle = &particlesRef[particleIndex];
-                if (energiesPerParticleRef[energyTypeIndex].rattlerMask[particleIndex] ||  particle->isImmobile)
-                {
-                    continue;
-                }
+                ParticleIndex neighborIndex = neighborIndexes[i];
+                const Particle* neighbor = &particlesRef[neighborIndex];
+                FLOAT_TYPE distance =  mathService->GetDistanceLength(neighbor->coordinates, particle->coordinates);
 
-                ParticleIndex neighborsCount;
-                const ParticleIndex* neighborIndexes = neighborProvider->GetNeighborIndexes(particleIndex, &neighborsCount);
-                for (ParticleIndex i = 0; i < neighborsCount; ++i)
+                for (int energyTypeIndex = 0; energyTypeIndex < energyTypesCount; ++energyTypeIndex)
                 {
-                    ParticleIndex neighborIndex = neighborIndexes[i];
-                    const Particle* neighbor = &particlesRef[neighborIndex];
-                    if (energiesPerParticleRef[energyTypeIndex].rattlerMask[neighborIndex])
+                    IEnergyService::EnergiesPerParticle& energies = energiesPerParticleRef[energyTypeIndex];
+                    if (energies.rattlerMask[particleIndex] || energies.rattlerMask[neighborIndex])
                     {
                         continue;
                     }
 
-                    FLOAT_TYPE distance =  mathService->GetDistanceLength(neighbor->coordinates, particle->coordinates);
-                    Nullable<FLOAT_TYPE> energy = pairPotential->GetEnergy(particle->diameter, neighbor->diameter, distance * contractionRatio);
+                    Nullable<FLOAT_TYPE> energy = pairPotentials[energyTypeIndex]->GetEnergyInline(particle->diameter, neighbor->diameter, distance * contractionRatios[energyTypeIndex]);
                     if (energy.hasValue)
                     {
-                        energiesPerParticleRef[energyTypeIndex].contractionEnergiesPerParticle[particleIndex] += potentialNormalizer * energy.value;
+                        energies.contractionEnergiesPerParticle[particleIndex] += potentialNormalizer * energy.value;
                     }
                 }
             }
@@ -0,0 +1,76 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Generation_PackingServices_Headers_AsyncPackingWriter_h
+#define Generation_PackingServices_Headers_AsyncPackingWriter_h
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include "Core/Headers/Macros.h"
+#include "Generation/Model/Headers/Types.h"
+namespace PackingServices { class PackingSerializer; }
+
+namespace PackingServices
+{
+    // Writes intermediate packings (snapshots) in a background thread, so that the generation does not wait for the disk.
+    // The particles are copied when a snapshot is queued; the previous packing file is renamed and the copy is written in the background thread.
+    // At most maxQueuedSnapshotsCount snapshots wait for writing (besides the one being written); queuing more blocks until one is written.
+    class AsyncPackingWriter
+    {
+    private:
+        struct Snapshot
+        {
+            std::string packingFilePath;
+            std::string previousPackingFilePath;
+            Model::Packing particles;
+        };
+
+        // Services
+        PackingSerializer* packingSerializer;
+
+        // Snapshot buffers are reused, so that the particles are not reallocated for each snapshot
+        std::vector<Snapshot> snapshots;
+
+        std::thread writerThread;
+        std::mutex mutex;
+        std::condition_variable snapshotQueued;
+        std::condition_variable snapshotWritten;
+
+        // Working variables, guarded by the mutex
+        std::deque<int> queuedSnapshotIndexes;
+        std::vector<int> freeSnapshotIndexes;
+        bool shouldStop;
+        std::exception_ptr error;
+
+    public:
+        AsyncPackingWriter(PackingSerializer* packingSerializer, int maxQueuedSnapshotsCount);
+
+        // Waits until all the queued snapshots are written. Write errors are only printed, as destructors shall not throw.
+        ~AsyncPackingWriter();
+
+        // Copies the particles and returns. In the background thread the file at packingFilePath is renamed to previousPackingFilePath, and the particles are written to packingFilePath.
+        // If an earlier snapshot failed to be written, rethrows its error.
+        void WritePacking(std::string packingFilePath, std::string previousPackingFilePath, const Model::Packing& particles);
+
+        // Waits until all the queued snapshots are written. If any of them failed to be written, rethrows the first error.
+        void Flush();
+
+    private:
+        void RunWriter();
+
+        void WriteSnapshot(const Snapshot& snapshot) const;
+
+        // Shall be called under the lock.
+        void RethrowError();
+
+        DISALLOW_COPY_AND_ASSIGN(AsyncPackingWriter);
+    };
+}
+
+#endif /* Generation_PackingServices_Headers_AsyncPackingWriter_h */
@@ -24,6 +24,9 @@ namespace PackingServices
     private:
         Core::IEndiannessProvider* endiannessProvider;
 
+        // Packings are read and written by chunks of this number of particles
+        static const int PARTICLES_PER_IO_CHUNK = 65536;
+
     public:
         explicit PackingSerializer(Core::IEndiannessProvider* endiannessProvider);
 
@@ -74,6 +77,9 @@ namespace PackingServices
 
         void SerializeOrder(std::string orderFilePath, const OrderService::Order& order) const;
 
+        // Writes the orders of the first l as SerializeOrder does, and then the orders for all the ls.
+        void SerializeBondOrders(std::string orderFilePath, const OrderService::BondOrders& bondOrders) const;
+
         void SerializeEntropy(std::string entropyFilePath, Core::FLOAT_TYPE entropy) const;
 
         void SerializeLocalEntropy(std::string entropyFilePath, Core::FLOAT_TYPE entropy, const std::vector<Core::FLOAT_TYPE>& localEntropies) const;
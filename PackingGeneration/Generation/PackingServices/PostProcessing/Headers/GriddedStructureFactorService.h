@@ -0,0 +1,62 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Generation_PackingServices_PostProcessing_Headers_GriddedStructureFactorService_h
+#define Generation_PackingServices_PostProcessing_Headers_GriddedStructureFactorService_h
+
+#include <vector>
+#include <complex>
+#include "Core/Headers/Macros.h"
+#include "Generation/Model/Headers/Types.h"
+#include "Generation/PackingServices/Headers/IContextDependentService.h"
+namespace Model { class SystemConfig; }
+
+namespace PackingServices
+{
+    // Calculates the structure factor for all the wave vectors, commensurate with the periodic box, up to a given length
+    // in O(N + M log M) operations instead of O(N K) of DistanceService::FillStructureFactorForWaveVectors (M is the number of mesh nodes, K is the number of wave vectors).
+    // Particles are spread onto a periodic mesh with cardinal B-spline weights, the mesh is Fourier transformed,
+    // and the interpolation error is removed by the Euler exponential spline factors, as in the smooth particle mesh Ewald method
+    // (Essmann et al. (1995) A smooth particle mesh Ewald method, cf. 4.1-4.4).
+    // The relative error is the largest for the largest wave vectors and decreases as (2 * oversamplingFactor - 1)^(-splineOrder) (about 1e-4 by default).
+    class GriddedStructureFactorService : public virtual IContextDependentService
+    {
+    public:
+        // Options
+        int splineOrder;
+        Core::FLOAT_TYPE oversamplingFactor; // the mesh size divided by the number of wave vectors along an axis
+
+    private:
+        // Context
+        const Model::SystemConfig* config;
+
+    public:
+        GriddedStructureFactorService();
+
+        OVERRIDE void SetContext(const Model::ModellingContext& context);
+
+        // Fills the structure factor for all the wave vectors k = 2 pi (m_x / L_x, m_y / L_y, m_z / L_z) with integer m_i and 0 < |k| <= maxWaveVectorLength.
+        void FillStructureFactor(const Model::Packing& particles, Core::FLOAT_TYPE maxWaveVectorLength,
+                std::vector<Core::SpatialVector>* waveVectors, std::vector<Core::FLOAT_TYPE>* structureFactorValues) const;
+
+        // Fills the structure factor values averaged over the wave vectors of the same length, sorted by the length.
+        void FillStructureFactor(const Model::Packing& particles, Core::FLOAT_TYPE maxWaveVectorLength, Model::StructureFactor* structureFactor) const;
+
+        virtual ~GriddedStructureFactorService();
+
+    private:
+        // Fills weights[k] = M_n(w + k), k = 0, ..., n - 1, where M_n is the cardinal B-spline of the order n = splineOrder, 0 <= w < 1.
+        void FillSplineWeights(Core::FLOAT_TYPE fraction, Core::FLOAT_TYPE* weights) const;
+
+        // Fills the density of particles, spread onto the mesh with the spline weights.
+        void FillMeshDensity(const Model::Packing& particles, const Core::DiscreteSpatialVector& meshSizes, std::vector<std::complex<Core::FLOAT_TYPE> >* meshValues) const;
+
+        // Fills the squared absolute values of the Euler exponential spline factors b(m) for -maxIndex <= m <= maxIndex.
+        void FillDeconvolutionFactors(int meshSize, int maxIndex, std::vector<Core::FLOAT_TYPE>* deconvolutionFactors) const;
+
+        DISALLOW_COPY_AND_ASSIGN(GriddedStructureFactorService);
+    };
+}
+
+#endif /* Generation_PackingServices_PostProcessing_Headers_GriddedStructureFactorService_h */
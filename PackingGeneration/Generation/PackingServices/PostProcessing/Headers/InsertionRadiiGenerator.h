@@ -13,6 +13,7 @@
 namespace PackingServices { class GeometryService; }
 namespace PackingServices { class DistanceService; }
 namespace PackingServices { class PackingSerializer; }
+namespace PackingServices { class InsertionRadiiSampler; }
 namespace PackingServices { class IPairPotential; }
 namespace Geometries { class IGeometry; }
 namespace Model { class SystemConfig; }
@@ -26,15 +27,20 @@ namespace PackingServices
     private:
         DistanceService* distanceProvider;
         GeometryService* geometryService;
+        InsertionRadiiSampler* insertionRadiiSampler;
         const Geometries::IGeometry* geometry;
         const Model::SystemConfig* config;
         const Model::ModellingContext* context;
 
     public:
-        InsertionRadiiGenerator(DistanceService* distanceProvider, GeometryService* geometryService);
+        InsertionRadiiGenerator(DistanceService* distanceProvider, GeometryService* geometryService, InsertionRadiiSampler* insertionRadiiSampler);
 
         OVERRIDE void SetContext(const Model::ModellingContext& context);
 
+        // Sets the seed of the sample points for FillInsertionRadii and CalculateEntropy.
+        // These points are drawn by InsertionRadiiSampler in several threads, and the results do not depend on the number of threads.
+        void SetSeed(int seed);
+
         void FillInsertionRadii(const Model::Packing& particles, int insertionRadiiCount, std::vector<Core::FLOAT_TYPE>* insertionRadii) const;
 
         Core::FLOAT_TYPE CalculateEntropy(const Model::Packing& particles, int insertionRadiiCount) const;
@@ -0,0 +1,79 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Generation_PackingServices_PostProcessing_Headers_InsertionRadiiSampler_h
+#define Generation_PackingServices_PostProcessing_Headers_InsertionRadiiSampler_h
+
+#include <vector>
+#include "Core/Headers/Macros.h"
+#include "Core/Headers/IParallelTask.h"
+#include "Core/Headers/CounterBasedRandom.h"
+#include "Generation/Model/Headers/Types.h"
+#include "Generation/PackingServices/Headers/IContextDependentService.h"
+#include "Generation/PackingServices/DistanceServices/Headers/CellGrid.h"
+namespace PackingServices { class MathService; }
+namespace Geometries { class IGeometry; }
+namespace Model { class SystemConfig; }
+
+namespace PackingServices
+{
+    // Computes distances from random points of a static packing to the nearest particle surfaces in several threads.
+    // The point of the sample i is drawn from the counter-based stream i, so the distance of each sample does not depend on the number of threads,
+    // and the samples may be computed in any order and in any batches.
+    // The nearest surfaces are searched in the neighboring cells of a cell grid with the cell size not less than the max diameter.
+    // If the nearest surface found is too far to exclude the particles from the other cells (in large pores), all the particles are checked.
+    class InsertionRadiiSampler : public virtual IContextDependentService, public virtual Core::IParallelTask
+    {
+    private:
+        // Services
+        MathService* mathService;
+
+        // Context
+        const Model::SystemConfig* config;
+        const Geometries::IGeometry* geometry;
+        const Geometries::IGeometry* activeGeometry;
+        int threadsCount;
+        Core::CounterBasedRandom random;
+
+        // Working variables
+        const Model::Packing* particles;
+        CellGrid cellGrid;
+        Core::FLOAT_TYPE maxGuaranteedDistance;
+        long long firstSampleIndex;
+        int samplesCount;
+        Core::FLOAT_TYPE* distances;
+        int partsCount;
+
+        static const int PARTS_PER_THREAD = 4;
+
+    public:
+        // If threadsCount is not positive, the number of hardware threads is used.
+        InsertionRadiiSampler(MathService* mathService, int threadsCount);
+
+        OVERRIDE void SetContext(const Model::ModellingContext& context);
+
+        void SetSeed(int seed);
+
+        void SetParticles(const Model::Packing& particles);
+
+        // Fills the distances to the nearest surfaces for the samples firstSampleIndex, ..., firstSampleIndex + samplesCount - 1.
+        void FillDistancesToNearestSurfaces(long long firstSampleIndex, int samplesCount, Core::FLOAT_TYPE* distances);
+
+        // Fills the random point of the sample, which is inside the geometry and the active geometry (if any). Is thread-safe.
+        void FillRandomPoint(long long sampleIndex, Core::SpatialVector* point) const;
+
+        // Is thread-safe.
+        Core::FLOAT_TYPE GetDistanceToNearestSurface(const Core::SpatialVector& point) const;
+
+        // Fills the distances for a range of samples.
+        OVERRIDE void Execute(int partIndex);
+
+        virtual ~InsertionRadiiSampler();
+
+    private:
+        DISALLOW_COPY_AND_ASSIGN(InsertionRadiiSampler);
+    };
+}
+
+#endif /* Generation_PackingServices_PostProcessing_Headers_InsertionRadiiSampler_h */
@@ -5,13 +5,18 @@
 #ifndef Generation_PackingServices_PostProcessing_Headers_OrderService_h
 #define Generation_PackingServices_PostProcessing_Headers_OrderService_h
 
+#include <complex>
+#include "Core/Headers/IParallelTask.h"
 #include "Generation/PackingServices/DistanceServices/Headers/BaseDistanceService.h"
+namespace Core { class SphericalHarmonicsKernel; }
 
 namespace PackingServices
 {
-    class OrderService : public BaseDistanceService
+    class OrderService : public BaseDistanceService, public virtual Core::IParallelTask
     {
     public:
+        int threadsCount; // for the bond orders. If not positive, the number of hardware threads is used.
+
         struct NeighborDirection
         {
             Model::ParticleIndex neighborIndex;
@@ -27,6 +32,18 @@ namespace PackingServices
             Core::FLOAT_TYPE localOrder;
         };
 
+        // Steinhardt bond orientational orders for several l, see Steinhardt, Nelson, Ronchetti (1983) Bond-orientational order in liquids and glasses.
+        // Global orders are computed from all the bonds of the packing, local orders are averaged over particles with neighbors.
+        // W are the normalized third-order invariants (e.g. W6 is -0.013 for fcc, -0.012 for hcp and -0.170 for icosahedral clusters).
+        struct BondOrders
+        {
+            std::vector<int> ls;
+            std::vector<Core::FLOAT_TYPE> globalOrders;
+            std::vector<Core::FLOAT_TYPE> localOrders;
+            std::vector<Core::FLOAT_TYPE> globalWignerOrders;
+            std::vector<Core::FLOAT_TYPE> localWignerOrders;
+        };
+
         // See Jin, Makse (2010) A first-order phase transition defines the random close packing of hard spheres
         // and Bargiel, Tory (2001) Packing fraction and measures of disorder of ultradense irregular packings of equal spheres. II. Transition from dense random packing
         struct LocalOrientationalDisorder
@@ -46,6 +63,17 @@ namespace PackingServices
             ReferenceLattice(std::string name, int latticeVectorsCount, const Core::FLOAT_TYPE uniqueAnglesInDegrees[], const int uniqueAnglesCounts[], int arraySize);
         };
 
+        // Working variables for the bond orders
+        const std::vector<NeighborDirections>* particleDirections;
+        const std::vector<int>* ls;
+        const Core::SphericalHarmonicsKernel* harmonicsKernel;
+        std::vector<std::complex<Core::FLOAT_TYPE> > particleHarmonicValues; // sums of harmonics over the neighbors, particleHarmonicValues[particleIndex * valuesCount + valueIndex]
+        std::vector<Core::FLOAT_TYPE> particleOrders; // particleOrders[particleIndex * ls.size() + lIndex]
+        std::vector<Core::FLOAT_TYPE> particleWignerOrders;
+        int partsCount;
+
+        static const int PARTS_PER_THREAD = 4;
+
     public:
         OrderService(MathService* mathService, INeighborProvider* neighborProvider);
 
@@ -55,17 +83,17 @@ namespace PackingServices
 
         void FillParticleDirections(std::vector<NeighborDirections>* particleDirections) const;
 
-        Order GetOrder(int l) const; // l is the spherical harmonics index. See Song, Wang, Makse "First order phase transition"
+        Order GetOrder(int l); // l is the spherical harmonics index. See Song, Wang, Makse "First order phase transition"
 
-        void FillLocalOrientationalDisorder(LocalOrientationalDisorder* localOrientationalDisorder) const;
-
-    private:
-        Core::FLOAT_TYPE GetGlobalOrder(const std::vector<NeighborDirections>& particleDirections, int l) const;
+        // Computes the orders for all the ls in one pass over the neighbors. The spherical harmonics of the bonds are computed in several threads.
+        void FillBondOrders(const std::vector<int>& ls, BondOrders* bondOrders);
 
-        Core::FLOAT_TYPE GetLocalOrder(const std::vector<NeighborDirections>& particleDirections, int l) const;
+        // Computes the sums of the spherical harmonics and the local orders for a range of particles.
+        OVERRIDE void Execute(int partIndex);
 
-        Core::FLOAT_TYPE GetParticleOrder(const std::vector<NeighborDirection>& neighborDirections, int l) const;
+        void FillLocalOrientationalDisorder(LocalOrientationalDisorder* localOrientationalDisorder) const;
 
+    private:
         void FillLocalOrientationalDisorder(const std::vector<const ReferenceLattice*>& referenceLattices, LocalOrientationalDisorder* localOrientationalDisorder) const;
 
         DISALLOW_COPY_AND_ASSIGN(OrderService);
@@ -0,0 +1,67 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Generation_PackingServices_PostProcessing_Headers_PairCorrelationService_h
+#define Generation_PackingServices_PostProcessing_Headers_PairCorrelationService_h
+
+#include <vector>
+#include "Core/Headers/Macros.h"
+#include "Core/Headers/IParallelTask.h"
+#include "Generation/Model/Headers/Types.h"
+#include "Generation/PackingServices/Headers/IContextDependentService.h"
+#include "Generation/PackingServices/DistanceServices/Headers/CellGrid.h"
+namespace PackingServices { class MathService; }
+namespace PackingServices { class GeometryService; }
+namespace Model { class SystemConfig; }
+
+namespace PackingServices
+{
+    // Calculates the pair correlation function (the same bins and values as the O(N^2) DistanceService::FillPairCorrelationFunction).
+    // Only the pairs from the neighboring cells of a cell grid with the cell size not less than the cutoff distance are scanned, in several threads, with a histogram per part.
+    class PairCorrelationService : public virtual IContextDependentService, public virtual Core::IParallelTask
+    {
+    private:
+        // Services
+        MathService* mathService;
+        GeometryService* geometryService;
+
+        // Context
+        const Model::SystemConfig* config;
+        int threadsCount;
+
+        // Working variables
+        const Model::Packing* particles;
+        Core::FLOAT_TYPE maxBinRightEdge;
+        Core::FLOAT_TYPE step;
+        int binsCount;
+        CellGrid cellGrid;
+        int partsCount;
+        std::vector<int> partBinPairsCounts; // partBinPairsCounts[partIndex * binsCount + binIndex]
+
+        static const int PARTS_PER_THREAD = 4;
+        static const Core::FLOAT_TYPE MAX_DISTANCE_IN_MEAN_DIAMETERS;
+        static const Core::FLOAT_TYPE EXPECTED_STEP;
+
+    public:
+        // If threadsCount is not positive, the number of hardware threads is used.
+        PairCorrelationService(MathService* mathService, GeometryService* geometryService, int threadsCount);
+
+        OVERRIDE void SetContext(const Model::ModellingContext& context);
+
+        // The context should correspond to the packing.
+        void FillPairCorrelationFunction(const Model::Packing& particles, Model::PairCorrelationFunction* pairCorrelationFunction);
+
+        // Fills the histogram for the pairs of particles from a range of cells.
+        OVERRIDE void Execute(int partIndex);
+
+        virtual ~PairCorrelationService();
+
+    private:
+        void FillValues(const std::vector<long long>& binPairsCounts, Model::PairCorrelationFunction* pairCorrelationFunction) const;
+
+        DISALLOW_COPY_AND_ASSIGN(PairCorrelationService);
+    };
+}
+
+#endif /* Generation_PackingServices_PostProcessing_Headers_PairCorrelationService_h */
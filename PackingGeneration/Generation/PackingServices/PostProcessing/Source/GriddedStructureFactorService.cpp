@@ -0,0 +1,233 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/GriddedStructureFactorService.h"
+
+#include <cmath>
+#include <algorithm>
+#include "Core/Headers/Constants.h"
+#include "Core/Headers/Exceptions.h"
+#include "Core/Headers/StlUtilities.h"
+#include "Core/Headers/FastFourierTransform.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+
+namespace PackingServices
+{
+    GriddedStructureFactorService::GriddedStructureFactorService()
+    {
+        splineOrder = 10;
+        oversamplingFactor = 2.0;
+    }
+
+    GriddedStructureFactorService::~GriddedStructureFactorService()
+    {
+    }
+
+    void GriddedStructureFactorService::SetContext(const ModellingContext& context)
+    {
+        config = context.config;
+    }
+
+    void GriddedStructureFactorService::FillStructureFactor(const Packing& particles, FLOAT_TYPE maxWaveVectorLength,
+            vector<SpatialVector>* waveVectors, vector<FLOAT_TYPE>* structureFactorValues) const
+    {
+        if (splineOrder < 2)
+        {
+            throw InvalidOperationException("Spline order should be at least 2.");
+        }
+
+        waveVectors->clear();
+        structureFactorValues->clear();
+
+        DiscreteSpatialVector maxIndexes;
+        DiscreteSpatialVector meshSizes;
+        vector<FLOAT_TYPE> deconvolutionFactors[DIMENSIONS];
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            maxIndexes[i] = static_cast<int>(floor(maxWaveVectorLength * config->packingSize[i] / (2.0 * PI)));
+            int minMeshSize = std::max(2 * maxIndexes[i] + 1, static_cast<int>(ceil(2.0 * oversamplingFactor * maxIndexes[i])));
+            meshSizes[i] = FastFourierTransform::GetNextFastSize(std::max(minMeshSize, splineOrder));
+            FillDeconvolutionFactors(meshSizes[i], maxIndexes[i], &deconvolutionFactors[i]);
+        }
+
+        vector<complex<FLOAT_TYPE> > meshValues;
+        FillMeshDensity(particles, meshSizes, &meshValues);
+        FastFourierTransform::TransformMultidimensional(meshSizes, &meshValues, false);
+
+        // Enumerate the wave vectors with the first index changing the fastest
+        int candidatesCount = 1;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            candidatesCount *= 2 * maxIndexes[i] + 1;
+        }
+
+        FLOAT_TYPE maxWaveVectorLengthSquare = maxWaveVectorLength * maxWaveVectorLength;
+        for (int candidateIndex = 0; candidateIndex < candidatesCount; ++candidateIndex)
+        {
+            SpatialVector waveVector;
+            FLOAT_TYPE waveVectorLengthSquare = 0.0;
+            FLOAT_TYPE deconvolutionFactor = 1.0;
+            int meshIndex = 0;
+            int meshStride = 1;
+            int remainder = candidateIndex;
+            bool isZero = true;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                int waveIndex = remainder % (2 * maxIndexes[i] + 1) - maxIndexes[i];
+                remainder /= 2 * maxIndexes[i] + 1;
+                isZero = isZero && (waveIndex == 0);
+
+                waveVector[i] = waveIndex * 2.0 * PI / config->packingSize[i];
+                waveVectorLengthSquare += waveVector[i] * waveVector[i];
+                deconvolutionFactor *= deconvolutionFactors[i][waveIndex + maxIndexes[i]];
+
+                int meshCoordinate = (waveIndex >= 0) ? waveIndex : meshSizes[i] + waveIndex;
+                meshIndex += meshCoordinate * meshStride;
+                meshStride *= meshSizes[i];
+            }
+
+            if (isZero || waveVectorLengthSquare > maxWaveVectorLengthSquare)
+            {
+                continue;
+            }
+
+            waveVectors->push_back(waveVector);
+            structureFactorValues->push_back(deconvolutionFactor * std::norm(meshValues[meshIndex]) / config->particlesCount);
+        }
+    }
+
+    void GriddedStructureFactorService::FillStructureFactor(const Packing& particles, FLOAT_TYPE maxWaveVectorLength, StructureFactor* structureFactor) const
+    {
+        vector<SpatialVector> waveVectors;
+        vector<FLOAT_TYPE> structureFactorValues;
+        FillStructureFactor(particles, maxWaveVectorLength, &waveVectors, &structureFactorValues);
+
+        vector<FLOAT_TYPE> waveVectorLengths(waveVectors.size());
+        for (size_t i = 0; i < waveVectors.size(); ++i)
+        {
+            FLOAT_TYPE waveVectorLengthSquare = 0.0;
+            for (int j = 0; j < DIMENSIONS; ++j)
+            {
+                waveVectorLengthSquare += waveVectors[i][j] * waveVectors[i][j];
+            }
+            waveVectorLengths[i] = sqrt(waveVectorLengthSquare);
+        }
+
+        vector<int> permutation;
+        StlUtilities::SortPermutation(waveVectorLengths, &permutation);
+
+        // There are millions of wave vectors for large packings, but in a cubic box many of them have the same length
+        structureFactor->waveVectorLengths.clear();
+        structureFactor->structureFactorValues.clear();
+        size_t groupStart = 0;
+        while (groupStart < permutation.size())
+        {
+            FLOAT_TYPE groupLength = waveVectorLengths[permutation[groupStart]];
+            FLOAT_TYPE valuesSum = 0.0;
+            size_t groupEnd = groupStart;
+            while (groupEnd < permutation.size() && waveVectorLengths[permutation[groupEnd]] <= groupLength * (1.0 + 1e-12))
+            {
+                valuesSum += structureFactorValues[permutation[groupEnd]];
+                groupEnd++;
+            }
+
+            structureFactor->waveVectorLengths.push_back(groupLength);
+            structureFactor->structureFactorValues.push_back(valuesSum / (groupEnd - groupStart));
+            groupStart = groupEnd;
+        }
+    }
+
+    void GriddedStructureFactorService::FillMeshDensity(const Packing& particles, const DiscreteSpatialVector& meshSizes, vector<complex<FLOAT_TYPE> >* meshValues) const
+    {
+        int meshNodesCount = 1;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            meshNodesCount *= meshSizes[i];
+        }
+        meshValues->assign(meshNodesCount, complex<FLOAT_TYPE>(0.0, 0.0));
+        vector<complex<FLOAT_TYPE> >& meshValuesRef = *meshValues;
+
+        int weightsCount = 1;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            weightsCount *= splineOrder;
+        }
+
+        // weights[i * splineOrder + k] is the weight of the mesh node (firstNode - k) along the axis i
+        vector<FLOAT_TYPE> weights(DIMENSIONS * splineOrder);
+        vector<int> meshCoordinates(DIMENSIONS * splineOrder);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                FLOAT_TYPE meshCoordinate = particles[particleIndex].coordinates[i] / config->packingSize[i] * meshSizes[i];
+                FLOAT_TYPE firstNode = floor(meshCoordinate);
+                FillSplineWeights(meshCoordinate - firstNode, &weights[i * splineOrder]);
+
+                // Particles may lie slightly outside the box
+                int periodicFirstNode = static_cast<int>(firstNode) % meshSizes[i];
+                for (int k = 0; k < splineOrder; ++k)
+                {
+                    meshCoordinates[i * splineOrder + k] = ((periodicFirstNode - k) % meshSizes[i] + meshSizes[i]) % meshSizes[i];
+                }
+            }
+
+            for (int weightIndex = 0; weightIndex < weightsCount; ++weightIndex)
+            {
+                FLOAT_TYPE weight = 1.0;
+                int meshIndex = 0;
+                int meshStride = 1;
+                int remainder = weightIndex;
+                for (int i = 0; i < DIMENSIONS; ++i)
+                {
+                    int k = remainder % splineOrder;
+                    remainder /= splineOrder;
+                    weight *= weights[i * splineOrder + k];
+                    meshIndex += meshCoordinates[i * splineOrder + k] * meshStride;
+                    meshStride *= meshSizes[i];
+                }
+                meshValuesRef[meshIndex] += weight;
+            }
+        }
+    }
+
+    void GriddedStructureFactorService::FillSplineWeights(FLOAT_TYPE fraction, FLOAT_TYPE* weights) const
+    {
+        // M_1(x) = 1 for 0 <= x < 1, M_n(x) = (x M_{n-1}(x) + (n - x) M_{n-1}(x - 1)) / (n - 1)
+        weights[0] = 1.0;
+        for (int order = 2; order <= splineOrder; ++order)
+        {
+            weights[order - 1] = 0.0;
+            for (int k = order - 1; k >= 0; --k)
+            {
+                FLOAT_TYPE x = fraction + k;
+                FLOAT_TYPE previousWeight = (k > 0) ? weights[k - 1] : 0.0;
+                weights[k] = (x * weights[k] + (order - x) * previousWeight) / (order - 1);
+            }
+        }
+    }
+
+    void GriddedStructureFactorService::FillDeconvolutionFactors(int meshSize, int maxIndex, vector<FLOAT_TYPE>* deconvolutionFactors) const
+    {
+        // Spline values at integers: M_n(k + 1), k = 0, ..., n - 2
+        vector<FLOAT_TYPE> integerWeights(splineOrder);
+        FillSplineWeights(0.0, &integerWeights[0]);
+
+        deconvolutionFactors->resize(2 * maxIndex + 1);
+        for (int waveIndex = -maxIndex; waveIndex <= maxIndex; ++waveIndex)
+        {
+            complex<FLOAT_TYPE> sum(0.0, 0.0);
+            for (int k = 0; k <= splineOrder - 2; ++k)
+            {
+                FLOAT_TYPE phase = 2.0 * PI * waveIndex * k / meshSize;
+                sum += integerWeights[k + 1] * complex<FLOAT_TYPE>(cos(phase), sin(phase));
+            }
+            deconvolutionFactors->at(waveIndex + maxIndex) = 1.0 / std::norm(sum);
+        }
+    }
+}
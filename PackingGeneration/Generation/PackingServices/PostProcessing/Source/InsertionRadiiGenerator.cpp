@@ -7,6 +7,7 @@
 #include <ctime>
 #include <stdio.h>
 #include "Generation/PackingServices/DistanceServices/Headers/DistanceService.h"
+#include "Generation/PackingServices/PostProcessing/Headers/InsertionRadiiSampler.h"
 #include "Generation/PackingServices/Headers/GeometryService.h"
 #include "Generation/PackingServices/Headers/PackingSerializer.h"
 #include "Generation/PackingServices/EnergyServices/Headers/IEnergyService.h"
@@ -23,10 +24,11 @@ using namespace Model;
 
 namespace PackingServices
 {
-    InsertionRadiiGenerator::InsertionRadiiGenerator(DistanceService* distanceProvider, GeometryService* geometryService)
+    InsertionRadiiGenerator::InsertionRadiiGenerator(DistanceService* distanceProvider, GeometryService* geometryService, InsertionRadiiSampler* insertionRadiiSampler)
     {
         this->distanceProvider = distanceProvider;
         this->geometryService = geometryService;
+        this->insertionRadiiSampler = insertionRadiiSampler;
     }
 
     InsertionRadiiGenerator::~InsertionRadiiGenerator()
@@ -41,6 +43,12 @@ namespace PackingServices
         config = context.config;
         distanceProvider->SetContext(context);
         geometryService->SetContext(context);
+        insertionRadiiSampler->SetContext(context);
+    }
+
+    void InsertionRadiiGenerator::SetSeed(int seed)
+    {
+        insertionRadiiSampler->SetSeed(seed);
     }
 
     void InsertionRadiiGenerator::FillDistancesToSurfaces(const Packing& particles, int samplePointsCount, const vector<int>& sortedSurfaceIndexes, string distancesFolderPath, const PackingSerializer& packingSerializer) const
@@ -182,18 +190,21 @@ namespace PackingServices
 
     void InsertionRadiiGenerator::FillInsertionRadii(const Packing& particles, int insertionRadiiCount, vector<FLOAT_TYPE>* insertionRadii) const
     {
-        distanceProvider->SetParticles(particles);
-        insertionRadii->reserve(insertionRadiiCount);
-
+        insertionRadiiSampler->SetParticles(particles);
         FLOAT_TYPE meanDiameter = geometryService->GetMeanParticleDiameter(particles);
 
-        for (int i = 0; i < insertionRadiiCount; ++i)
+        size_t firstRadiusIndex = insertionRadii->size();
+        insertionRadii->resize(firstRadiusIndex + insertionRadiiCount);
+        if (insertionRadiiCount == 0)
         {
-            SpatialVector point;
-            FillRandomPoint(&point);
+            return;
+        }
 
-            FLOAT_TYPE insertionRadius = distanceProvider->GetDistanceToNearestSurface(point) / meanDiameter;
-            insertionRadii->push_back(insertionRadius);
+        FLOAT_TYPE* radii = &insertionRadii->at(firstRadiusIndex);
+        insertionRadiiSampler->FillDistancesToNearestSurfaces(0, insertionRadiiCount, radii);
+        for (int i = 0; i < insertionRadiiCount; ++i)
+        {
+            radii[i] /= meanDiameter;
         }
     }
 
@@ -205,16 +216,22 @@ namespace PackingServices
         const FLOAT_TYPE meanParticleRadius = 0.5;
         const FLOAT_TYPE normalizationFactor = (meanParticleRadius / minPoreRadius) * (meanParticleRadius / minPoreRadius);
 
-        distanceProvider->SetParticles(particles);
+        insertionRadiiSampler->SetParticles(particles);
         FLOAT_TYPE meanDiameter = geometryService->GetMeanParticleDiameter(particles);
 
         const int checkPeriod = 10000;
         const FLOAT_TYPE relativeTolerance = 1e-3; // entropy values -20 and -21 are acceptably close
+        // Several check periods are sampled in parallel at once. The samples after the converged check are discarded,
+        // so the result is the same as for the serial sampling.
+        const int checkPeriodsPerBatch = 16;
 
         int insertionRadiiCount = 0;
         int largePoresCount = 0;
         FLOAT_TYPE entropy = 0;
         FLOAT_TYPE previousEntropy = 0;
+        const int batchSamplesCount = checkPeriod * checkPeriodsPerBatch;
+        vector<FLOAT_TYPE> distances(batchSamplesCount);
+        int batchSampleNumber = batchSamplesCount;
 
         while (1)
         {
@@ -233,15 +250,19 @@ namespace PackingServices
                 }
             }
 
-            SpatialVector point;
-            FillRandomPoint(&point);
+            if (batchSampleNumber == batchSamplesCount)
+            {
+                batchSampleNumber = 0;
+                insertionRadiiSampler->FillDistancesToNearestSurfaces(insertionRadiiCount, batchSamplesCount, &distances[0]);
+            }
 
-            FLOAT_TYPE poreRadius = distanceProvider->GetDistanceToNearestSurface(point) / meanDiameter;
+            FLOAT_TYPE poreRadius = distances[batchSampleNumber] / meanDiameter;
             if (poreRadius > minPoreRadius)
             {
                 largePoresCount++;
             }
 
+            batchSampleNumber++;
             insertionRadiiCount++;
         }
 
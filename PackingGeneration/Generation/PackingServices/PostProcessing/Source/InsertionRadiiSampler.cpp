@@ -0,0 +1,156 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/InsertionRadiiSampler.h"
+
+#include <algorithm>
+#include "Core/Headers/Constants.h"
+#include "Core/Headers/ThreadPool.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/Geometries/Headers/IGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+
+namespace PackingServices
+{
+    InsertionRadiiSampler::InsertionRadiiSampler(MathService* mathService, int threadsCount) :
+            random(0)
+    {
+        this->mathService = mathService;
+        this->threadsCount = threadsCount;
+        particles = NULL;
+        maxGuaranteedDistance = 0.0;
+        firstSampleIndex = 0;
+        samplesCount = 0;
+        distances = NULL;
+        partsCount = 0;
+    }
+
+    InsertionRadiiSampler::~InsertionRadiiSampler()
+    {
+    }
+
+    void InsertionRadiiSampler::SetContext(const ModellingContext& context)
+    {
+        config = context.config;
+        geometry = context.geometry;
+        activeGeometry = context.activeGeometry;
+    }
+
+    void InsertionRadiiSampler::SetSeed(int seed)
+    {
+        random.SetSeed(seed);
+    }
+
+    void InsertionRadiiSampler::SetParticles(const Packing& particles)
+    {
+        this->particles = &particles;
+
+        FLOAT_TYPE maxDiameter = 0.0;
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            maxDiameter = std::max(maxDiameter, particles[particleIndex].diameter);
+        }
+
+        cellGrid.Fill(*config, particles, maxDiameter);
+
+        // The centers of the particles from the non-neighboring cells are not closer than the cell size to the point,
+        // and their surfaces are not closer than the cell size minus the max radius.
+        maxGuaranteedDistance = cellGrid.AreAllCellsNeighbors() ? MAX_FLOAT_VALUE : cellGrid.GetMinCellSize() - 0.5 * maxDiameter;
+    }
+
+    void InsertionRadiiSampler::FillDistancesToNearestSurfaces(long long firstSampleIndex, int samplesCount, FLOAT_TYPE* distances)
+    {
+        this->firstSampleIndex = firstSampleIndex;
+        this->samplesCount = samplesCount;
+        this->distances = distances;
+
+        ThreadPool threadPool(threadsCount);
+        partsCount = std::min(samplesCount, threadPool.GetThreadsCount() * PARTS_PER_THREAD);
+        threadPool.Execute(this, partsCount);
+    }
+
+    void InsertionRadiiSampler::Execute(int partIndex)
+    {
+        int startSampleNumber = static_cast<int>(static_cast<long long>(samplesCount) * partIndex / partsCount);
+        int endSampleNumber = static_cast<int>(static_cast<long long>(samplesCount) * (partIndex + 1) / partsCount);
+
+        for (int sampleNumber = startSampleNumber; sampleNumber < endSampleNumber; ++sampleNumber)
+        {
+            SpatialVector point;
+            FillRandomPoint(firstSampleIndex + sampleNumber, &point);
+            distances[sampleNumber] = GetDistanceToNearestSurface(point);
+        }
+    }
+
+    void InsertionRadiiSampler::FillRandomPoint(long long sampleIndex, SpatialVector* point) const
+    {
+        const int blocksPerAttempt = (DIMENSIONS + CounterBasedRandom::VALUES_PER_BLOCK - 1) / CounterBasedRandom::VALUES_PER_BLOCK;
+        FLOAT_TYPE randoms[blocksPerAttempt * CounterBasedRandom::VALUES_PER_BLOCK];
+
+        // Each rejected point is replaced with the next point of the same stream
+        for (uint32_t attemptIndex = 0; ; ++attemptIndex)
+        {
+            for (int blockIndex = 0; blockIndex < blocksPerAttempt; ++blockIndex)
+            {
+                random.FillRandoms(sampleIndex, attemptIndex * blocksPerAttempt + blockIndex, &randoms[blockIndex * CounterBasedRandom::VALUES_PER_BLOCK]);
+            }
+
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                (*point)[i] = randoms[i] * config->packingSize[i];
+            }
+
+            bool isPointCorrect = geometry->IsSphereInside(*point, 0);
+            if (isPointCorrect && activeGeometry != NULL)
+            {
+                isPointCorrect &= activeGeometry->IsSphereInside(*point, 0);
+            }
+
+            if (isPointCorrect)
+            {
+                return;
+            }
+        }
+    }
+
+    FLOAT_TYPE InsertionRadiiSampler::GetDistanceToNearestSurface(const SpatialVector& point) const
+    {
+        const Packing& particlesRef = *particles;
+        FLOAT_TYPE minDistance = MAX_FLOAT_VALUE;
+
+        int neighborCellIndexes[CellGrid::MAX_NEIGHBOR_CELLS_COUNT];
+        int neighborCellsCount = cellGrid.FillNeighborCellIndexes(cellGrid.GetCellIndex(point), neighborCellIndexes);
+        for (int neighborCellNumber = 0; neighborCellNumber < neighborCellsCount; ++neighborCellNumber)
+        {
+            int cellParticlesCount;
+            const ParticleIndex* cellParticleIndexes = cellGrid.GetCellParticleIndexes(neighborCellIndexes[neighborCellNumber], &cellParticlesCount);
+            for (int i = 0; i < cellParticlesCount; ++i)
+            {
+                const DomainParticle& particle = particlesRef[cellParticleIndexes[i]];
+                FLOAT_TYPE distance = mathService->GetDistanceLength(point, particle.coordinates) - particle.diameter * 0.5;
+                minDistance = std::min(minDistance, distance);
+            }
+        }
+
+        if (minDistance <= maxGuaranteedDistance)
+        {
+            return minDistance;
+        }
+
+        // The point is in a large pore, a particle from a farther cell may be closer. The minimum of the same distances does not depend on the order.
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            const DomainParticle& particle = particlesRef[particleIndex];
+            FLOAT_TYPE distance = mathService->GetDistanceLength(point, particle.coordinates) - particle.diameter * 0.5;
+            minDistance = std::min(minDistance, distance);
+        }
+
+        return minDistance;
+    }
+}
@@ -10,6 +10,7 @@
 #include "Core/Headers/Path.h"
 #include "Core/Headers/StlUtilities.h"
 #include "Core/Headers/ScopedFile.h"
+#include "Core/Headers/TimeBudget.h"
 #include "Generation/PackingGenerators/LubachevsckyStillinger/Headers/LubachevsckyStillingerStep.h"
 #include "Generation/PackingServices/Headers/PackingSerializer.h"
 #include "Generation/PackingServices/Headers/MathService.h"
@@ -173,6 +174,16 @@ namespace PackingServices
             {
                 break;
             }
+
+            if (TimeBudget::GetInstance()->IsExpired())
+            {
+                // SetParticles reads the equilibrated packing, so the next run continues the equilibration, though the statistics are gathered anew
+                if (!errorsFound)
+                {
+                    packingSerializer->SerializePacking(GetEquilibratedPackingPath(), particles);
+                }
+                throw TimeBudgetExpiredException("The time budget has expired. The equilibration will be continued by the next run.");
+            }
         }
 
         // I write intermediate packing in the SelfDiffusionProcessor. TODO: unify.
@@ -4,9 +4,12 @@
 
 #include "../Headers/OrderService.h"
 
+#include <algorithm>
+#include "Core/Headers/Constants.h"
 #include "Core/Headers/VectorUtilities.h"
 #include "Core/Headers/StlUtilities.h"
-#include "Core/Headers/SphericalHarmonicsComputer.h"
+#include "Core/Headers/SphericalHarmonicsKernel.h"
+#include "Core/Headers/ThreadPool.h"
 #include "Generation/PackingServices/Headers/MathService.h"
 #include "Generation/PackingServices/DistanceServices/Headers/INeighborProvider.h"
 #include "Generation/Model/Headers/Config.h"
@@ -20,7 +23,11 @@ namespace PackingServices
     OrderService::OrderService(MathService* mathService, INeighborProvider* neighborProvider) :
             BaseDistanceService(mathService, neighborProvider)
     {
-
+        threadsCount = 0;
+        particleDirections = NULL;
+        ls = NULL;
+        harmonicsKernel = NULL;
+        partsCount = 0;
     }
 
     void OrderService::SetParticles(const Packing& particles)
@@ -70,115 +77,115 @@ namespace PackingServices
         }
     }
 
-    OrderService::Order OrderService::GetOrder(int l) const
+    OrderService::Order OrderService::GetOrder(int l)
     {
-        vector<NeighborDirections> particleDirections;
-        FillParticleDirections(&particleDirections);
+        vector<int> ls(1, l);
+        BondOrders bondOrders;
+        FillBondOrders(ls, &bondOrders);
 
         Order result;
-        result.globalOrder = GetGlobalOrder(particleDirections, l);
-        result.localOrder = GetLocalOrder(particleDirections, l);
+        result.globalOrder = bondOrders.globalOrders[0];
+        result.localOrder = bondOrders.localOrders[0];
         return result;
     }
 
-    FLOAT_TYPE OrderService::GetGlobalOrder(const vector<NeighborDirections>& particleDirections, int l) const
+    void OrderService::FillBondOrders(const vector<int>& ls, BondOrders* bondOrders)
     {
-        int sphericalHarmonicsCount = 2 * l + 1;
-        vector<complex<FLOAT_TYPE> > currentHarmonicValues(sphericalHarmonicsCount);
-        vector<complex<FLOAT_TYPE> > harmonicValues(sphericalHarmonicsCount);
-        int directionsCount = 0;
+        vector<NeighborDirections> particleDirections;
+        FillParticleDirections(&particleDirections);
+
+        int maxL = *std::max_element(ls.begin(), ls.end());
+        SphericalHarmonicsKernel harmonicsKernel(maxL);
+        int valuesCount = harmonicsKernel.GetValuesCount();
+        size_t lsCount = ls.size();
+
+        this->particleDirections = &particleDirections;
+        this->ls = &ls;
+        this->harmonicsKernel = &harmonicsKernel;
+        particleHarmonicValues.assign(static_cast<size_t>(config->particlesCount) * valuesCount, complex<FLOAT_TYPE>(0.0, 0.0));
+        particleOrders.assign(config->particlesCount * lsCount, 0.0);
+        particleWignerOrders.assign(config->particlesCount * lsCount, 0.0);
 
-        VectorUtilities::InitializeWith(&harmonicValues, 0.0);
+        ThreadPool threadPool(threadsCount);
+        partsCount = std::min(static_cast<int>(config->particlesCount), threadPool.GetThreadsCount() * PARTS_PER_THREAD);
+        threadPool.Execute(this, partsCount);
+
+        // Reduce in the order of particles, so that the result does not depend on the number of threads
+        vector<complex<FLOAT_TYPE> > harmonicValues(valuesCount, complex<FLOAT_TYPE>(0.0, 0.0));
+        int directionsCount = 0;
+        int validParticlesCount = 0;
+        bondOrders->ls = ls;
+        bondOrders->localOrders.assign(lsCount, 0.0);
+        bondOrders->localWignerOrders.assign(lsCount, 0.0);
 
         const Packing& particlesRef = *particles;
-        for (int particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
         {
-            const DomainParticle& particle = particlesRef[particleIndex];
-            if (particlesRef[particleIndex].isImmobile) // exclude fixed particles or particles outside the active geometry
+            int neighborsCount = particleDirections[particleIndex].size();
+            if (particlesRef[particleIndex].isImmobile || neighborsCount == 0) // exclude fixed particles or particles outside the active geometry
             {
                 continue;
             }
 
-            const vector<OrderService::NeighborDirection>& neighborDirections = particleDirections[particleIndex];
-            directionsCount += neighborDirections.size();
-
-            for (vector<OrderService::NeighborDirection>::const_iterator directionsIterator = neighborDirections.begin(); directionsIterator != neighborDirections.end(); ++directionsIterator)
+            directionsCount += neighborsCount;
+            validParticlesCount++;
+            const complex<FLOAT_TYPE>* values = &particleHarmonicValues[static_cast<size_t>(particleIndex) * valuesCount];
+            for (int i = 0; i < valuesCount; ++i)
             {
-                // Do not want a copy constructor of vector<OrderService::DynamicSpatialVector> to be called when dereferencing the iterator, therefore assign to reference
-                const OrderService::NeighborDirection& neighborDirection = *directionsIterator;
-
-                SphericalHarmonicsComputer::FillSphericalHarmonicValues(neighborDirection.direction, l, &currentHarmonicValues);
-                VectorUtilities::Add(currentHarmonicValues, harmonicValues, &harmonicValues);
+                harmonicValues[i] += values[i];
+            }
+            for (size_t lIndex = 0; lIndex < lsCount; ++lIndex)
+            {
+                bondOrders->localOrders[lIndex] += particleOrders[particleIndex * lsCount + lIndex];
+                bondOrders->localWignerOrders[lIndex] += particleWignerOrders[particleIndex * lsCount + lIndex];
             }
         }
 
-        FLOAT_TYPE orderSquaresSum = 0.0;
-        VectorUtilities::DivideByValue(harmonicValues, static_cast<FLOAT_TYPE>(directionsCount), &harmonicValues);
-        for (int i = 0; i < sphericalHarmonicsCount; ++i)
+        bondOrders->globalOrders.resize(lsCount);
+        bondOrders->globalWignerOrders.resize(lsCount);
+        for (size_t lIndex = 0; lIndex < lsCount; ++lIndex)
         {
-            orderSquaresSum += norm(harmonicValues[i]);
+            bondOrders->globalOrders[lIndex] = SphericalHarmonicsKernel::GetOrder(&harmonicValues[0], ls[lIndex], directionsCount);
+            bondOrders->globalWignerOrders[lIndex] = harmonicsKernel.GetWignerOrder(&harmonicValues[0], ls[lIndex]);
+            bondOrders->localOrders[lIndex] /= validParticlesCount;
+            bondOrders->localWignerOrders[lIndex] /= validParticlesCount;
         }
 
-        return sqrt(4.0 * PI / sphericalHarmonicsCount * orderSquaresSum);
+        this->particleDirections = NULL;
+        this->ls = NULL;
+        this->harmonicsKernel = NULL;
     }
 
-    FLOAT_TYPE OrderService::GetLocalOrder(const vector<NeighborDirections>& particleDirections, int l) const
+    void OrderService::Execute(int partIndex)
     {
-        FLOAT_TYPE meanLocalOrder = 0.0;
-        int validParticlesCount = 0;
-        const Packing& particlesRef = *particles;
-        for (int particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        const vector<NeighborDirections>& particleDirectionsRef = *particleDirections;
+        const vector<int>& lsRef = *ls;
+        size_t lsCount = lsRef.size();
+        int valuesCount = harmonicsKernel->GetValuesCount();
+
+        ParticleIndex startParticleIndex = static_cast<ParticleIndex>(static_cast<long long>(config->particlesCount) * partIndex / partsCount);
+        ParticleIndex endParticleIndex = static_cast<ParticleIndex>(static_cast<long long>(config->particlesCount) * (partIndex + 1) / partsCount);
+
+        for (ParticleIndex particleIndex = startParticleIndex; particleIndex < endParticleIndex; ++particleIndex)
         {
-            const DomainParticle& particle = particlesRef[particleIndex];
-            if (particlesRef[particleIndex].isImmobile) // exclude fixed particles or particles outside the active geometry
+            const NeighborDirections& neighborDirections = particleDirectionsRef[particleIndex];
+            if (neighborDirections.size() == 0)
             {
                 continue;
             }
 
-            const vector<OrderService::NeighborDirection>& neighborDirections = particleDirections[particleIndex];
-
-            FLOAT_TYPE particleOrder = GetParticleOrder(neighborDirections, l);
-            if (particleOrder >= 0)
+            complex<FLOAT_TYPE>* values = &particleHarmonicValues[static_cast<size_t>(particleIndex) * valuesCount];
+            for (NeighborDirections::const_iterator directionsIterator = neighborDirections.begin(); directionsIterator != neighborDirections.end(); ++directionsIterator)
             {
-                meanLocalOrder += particleOrder;
-                validParticlesCount++;
+                harmonicsKernel->AddSphericalHarmonicValues(directionsIterator->direction, values);
             }
-        }
-
-        meanLocalOrder /= validParticlesCount;
-        return meanLocalOrder;
-    }
-
-    FLOAT_TYPE OrderService::GetParticleOrder(const vector<NeighborDirection>& neighborDirections, int l) const
-    {
-        if (neighborDirections.size() == 0)
-        {
-            return -1.0;
-        }
 
-        int sphericalHarmonicsCount = 2 * l + 1;
-        vector<complex<FLOAT_TYPE> > currentHarmonicValues(sphericalHarmonicsCount);
-        vector<complex<FLOAT_TYPE> > harmonicValues(sphericalHarmonicsCount);
-
-        VectorUtilities::InitializeWith(&harmonicValues, 0.0);
-
-        for (vector<OrderService::NeighborDirection>::const_iterator directionsIterator = neighborDirections.begin(); directionsIterator != neighborDirections.end(); ++directionsIterator)
-        {
-            // Do not want a copy constructor of vector<OrderService::DynamicSpatialVector> to be called when dereferencing the iterator, therefore assign to reference
-            const OrderService::NeighborDirection& neighborDirection = *directionsIterator;
-
-            SphericalHarmonicsComputer::FillSphericalHarmonicValues(neighborDirection.direction, l, &currentHarmonicValues);
-            VectorUtilities::Add(currentHarmonicValues, harmonicValues, &harmonicValues);
-        }
-
-        FLOAT_TYPE orderSquaresSum = 0.0;
-        VectorUtilities::DivideByValue(harmonicValues, static_cast<FLOAT_TYPE>(neighborDirections.size()), &harmonicValues);
-        for (int i = 0; i < sphericalHarmonicsCount; ++i)
-        {
-            orderSquaresSum += norm(harmonicValues[i]);
+            for (size_t lIndex = 0; lIndex < lsCount; ++lIndex)
+            {
+                particleOrders[particleIndex * lsCount + lIndex] = SphericalHarmonicsKernel::GetOrder(values, lsRef[lIndex], neighborDirections.size());
+                particleWignerOrders[particleIndex * lsCount + lIndex] = harmonicsKernel->GetWignerOrder(values, lsRef[lIndex]);
+            }
         }
-
-        return sqrt(4.0 * PI / sphericalHarmonicsCount * orderSquaresSum);
     }
 
     void OrderService::FillLocalOrientationalDisorder(LocalOrientationalDisorder* localOrientationalDisorder) const
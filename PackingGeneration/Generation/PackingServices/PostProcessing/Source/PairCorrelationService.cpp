@@ -0,0 +1,152 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/PairCorrelationService.h"
+
+#include <cmath>
+#include <algorithm>
+#include "Core/Headers/Constants.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/VectorUtilities.h"
+#include "Core/Headers/ThreadPool.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+
+namespace PackingServices
+{
+    const FLOAT_TYPE PairCorrelationService::MAX_DISTANCE_IN_MEAN_DIAMETERS = 6.0;
+    const FLOAT_TYPE PairCorrelationService::EXPECTED_STEP = 0.001;
+
+    PairCorrelationService::PairCorrelationService(MathService* mathService, GeometryService* geometryService, int threadsCount)
+    {
+        this->mathService = mathService;
+        this->geometryService = geometryService;
+        this->threadsCount = threadsCount;
+        partsCount = 0;
+        binsCount = 0;
+    }
+
+    PairCorrelationService::~PairCorrelationService()
+    {
+    }
+
+    void PairCorrelationService::SetContext(const ModellingContext& context)
+    {
+        config = context.config;
+        geometryService->SetContext(context);
+    }
+
+    void PairCorrelationService::FillPairCorrelationFunction(const Packing& particles, PairCorrelationFunction* pairCorrelationFunction)
+    {
+        this->particles = &particles;
+        FLOAT_TYPE meanDiameter = geometryService->GetMeanParticleDiameter(particles);
+        maxBinRightEdge = MAX_DISTANCE_IN_MEAN_DIAMETERS * meanDiameter;
+        Math::CalculateStepSize(0.0, maxBinRightEdge, EXPECTED_STEP, &step, &binsCount);
+
+        // Safety factor for finite precision, as the pairs with floor(distance / step) < binsCount should be in the neighboring cells
+        FLOAT_TYPE cutoffDistance = maxBinRightEdge * (1.0 + 1e-10);
+        cellGrid.Fill(*config, particles, cutoffDistance);
+
+        ThreadPool threadPool(threadsCount);
+        partsCount = std::min(cellGrid.GetCellsCount(), threadPool.GetThreadsCount() * PARTS_PER_THREAD);
+        partBinPairsCounts.assign(static_cast<size_t>(partsCount) * binsCount, 0);
+        threadPool.Execute(this, partsCount);
+
+        vector<long long> binPairsCounts(binsCount, 0);
+        for (int partIndex = 0; partIndex < partsCount; ++partIndex)
+        {
+            const int* binPairsCountsOfPart = &partBinPairsCounts[static_cast<size_t>(partIndex) * binsCount];
+            for (int binIndex = 0; binIndex < binsCount; ++binIndex)
+            {
+                binPairsCounts[binIndex] += binPairsCountsOfPart[binIndex];
+            }
+        }
+
+        FillValues(binPairsCounts, pairCorrelationFunction);
+    }
+
+    void PairCorrelationService::Execute(int partIndex)
+    {
+        const Packing& particlesRef = *particles;
+        int* binPairsCountsOfPart = &partBinPairsCounts[static_cast<size_t>(partIndex) * binsCount];
+
+        int cellsCount = cellGrid.GetCellsCount();
+        int startCellIndex = static_cast<int>(static_cast<long long>(cellsCount) * partIndex / partsCount);
+        int endCellIndex = static_cast<int>(static_cast<long long>(cellsCount) * (partIndex + 1) / partsCount);
+
+        int neighborCellIndexes[CellGrid::MAX_NEIGHBOR_CELLS_COUNT];
+        for (int cellIndex = startCellIndex; cellIndex < endCellIndex; ++cellIndex)
+        {
+            int cellParticlesCount;
+            const ParticleIndex* cellParticleIndexes = cellGrid.GetCellParticleIndexes(cellIndex, &cellParticlesCount);
+            int neighborCellsCount = cellGrid.FillNeighborCellIndexes(cellIndex, neighborCellIndexes);
+            for (int neighborCellNumber = 0; neighborCellNumber < neighborCellsCount; ++neighborCellNumber)
+            {
+                int neighborCellParticlesCount;
+                const ParticleIndex* neighborCellParticleIndexes = cellGrid.GetCellParticleIndexes(neighborCellIndexes[neighborCellNumber], &neighborCellParticlesCount);
+
+                // Each pair is counted once: when the cell of the particle with the smaller index is processed.
+                // The distance is computed exactly as in DistanceService::FillPairCorrelationFunction, so the pairs fall into the same bins.
+                for (int i = 0; i < cellParticlesCount; ++i)
+                {
+                    ParticleIndex particleIndex = cellParticleIndexes[i];
+                    for (int j = 0; j < neighborCellParticlesCount; ++j)
+                    {
+                        ParticleIndex neighborIndex = neighborCellParticleIndexes[j];
+                        if (neighborIndex <= particleIndex)
+                        {
+                            continue;
+                        }
+
+                        FLOAT_TYPE distance = mathService->GetDistanceLength(particlesRef[particleIndex].coordinates, particlesRef[neighborIndex].coordinates);
+                        int binIndex = static_cast<int>(std::floor(distance / step));
+                        if (binIndex >= binsCount)
+                        {
+                            continue;
+                        }
+                        binPairsCountsOfPart[binIndex]++;
+                    }
+                }
+            }
+        }
+    }
+
+    void PairCorrelationService::FillValues(const vector<long long>& binPairsCounts, PairCorrelationFunction* pairCorrelationFunction) const
+    {
+        pairCorrelationFunction->binLeftEdges.resize(binsCount, 0.0);
+        pairCorrelationFunction->binParticleCounts.resize(binsCount, 0);
+        pairCorrelationFunction->pairCorrelationFunctionValues.resize(binsCount, 0.0);
+
+        if (binsCount == 0)
+        {
+            return;
+        }
+
+        VectorUtilities::FillLinearScale(0.0, maxBinRightEdge - step, &pairCorrelationFunction->binLeftEdges);
+
+        for (int binIndex = 0; binIndex < binsCount; ++binIndex)
+        {
+            // We consider just unique particle pairs when filling binPairsCounts. To convert to "all pairs mode" we need to multiply by 2.
+            long long particlesCount = 2 * binPairsCounts[binIndex];
+            pairCorrelationFunction->binParticleCounts[binIndex] = static_cast<int>(particlesCount);
+
+            FLOAT_TYPE distance = pairCorrelationFunction->binLeftEdges[binIndex] + step * 0.5;
+            FLOAT_TYPE sphereSurface;
+            if (DIMENSIONS == 3)
+            {
+                sphereSurface = 4.0 * PI * distance * distance;
+            }
+            if (DIMENSIONS == 2)
+            {
+                sphereSurface = 2.0 * PI * distance;
+            }
+            pairCorrelationFunction->pairCorrelationFunctionValues[binIndex] = particlesCount / sphereSurface / step / config->particlesCount;
+        }
+    }
+}
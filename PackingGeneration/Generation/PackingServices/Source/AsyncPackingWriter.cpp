@@ -0,0 +1,147 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/AsyncPackingWriter.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include "Core/Headers/Path.h"
+#include "Generation/PackingServices/Headers/PackingSerializer.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+
+namespace PackingServices
+{
+    AsyncPackingWriter::AsyncPackingWriter(PackingSerializer* packingSerializer, int maxQueuedSnapshotsCount)
+    {
+        this->packingSerializer = packingSerializer;
+        shouldStop = false;
+
+        // One more buffer for the snapshot being written
+        int snapshotsCount = std::max(1, maxQueuedSnapshotsCount) + 1;
+        snapshots.resize(snapshotsCount);
+        for (int i = 0; i < snapshotsCount; ++i)
+        {
+            freeSnapshotIndexes.push_back(i);
+        }
+
+        writerThread = thread(&AsyncPackingWriter::RunWriter, this);
+    }
+
+    AsyncPackingWriter::~AsyncPackingWriter()
+    {
+        // The writer thread finishes the queued snapshots before stopping
+        {
+            unique_lock<std::mutex> lock(mutex);
+            shouldStop = true;
+        }
+        snapshotQueued.notify_all();
+        writerThread.join();
+
+        if (error)
+        {
+            printf("ERROR: an intermediate packing was not written.\n");
+        }
+    }
+
+    void AsyncPackingWriter::WritePacking(string packingFilePath, string previousPackingFilePath, const Packing& particles)
+    {
+        unique_lock<std::mutex> lock(mutex);
+        while (!error && freeSnapshotIndexes.empty())
+        {
+            snapshotWritten.wait(lock);
+        }
+        RethrowError();
+
+        int snapshotIndex = freeSnapshotIndexes.back();
+        freeSnapshotIndexes.pop_back();
+        lock.unlock();
+
+        // The buffer is not accessed by the writer thread until it is queued
+        Snapshot& snapshot = snapshots[snapshotIndex];
+        snapshot.packingFilePath = packingFilePath;
+        snapshot.previousPackingFilePath = previousPackingFilePath;
+        snapshot.particles = particles;
+
+        lock.lock();
+        queuedSnapshotIndexes.push_back(snapshotIndex);
+        snapshotQueued.notify_one();
+    }
+
+    void AsyncPackingWriter::Flush()
+    {
+        unique_lock<std::mutex> lock(mutex);
+        while (freeSnapshotIndexes.size() < snapshots.size())
+        {
+            snapshotWritten.wait(lock);
+        }
+        RethrowError();
+    }
+
+    void AsyncPackingWriter::RethrowError()
+    {
+        if (error)
+        {
+            exception_ptr writeError = error;
+            error = exception_ptr();
+            rethrow_exception(writeError);
+        }
+    }
+
+    void AsyncPackingWriter::RunWriter()
+    {
+        unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            while (!shouldStop && queuedSnapshotIndexes.empty())
+            {
+                snapshotQueued.wait(lock);
+            }
+            if (queuedSnapshotIndexes.empty())
+            {
+                return;
+            }
+
+            int snapshotIndex = queuedSnapshotIndexes.front();
+            queuedSnapshotIndexes.pop_front();
+            lock.unlock();
+
+            exception_ptr writeError;
+            try
+            {
+                WriteSnapshot(snapshots[snapshotIndex]);
+            }
+            catch (...)
+            {
+                writeError = current_exception();
+            }
+            lock.lock();
+
+            if (writeError && !error)
+            {
+                error = writeError;
+            }
+
+            freeSnapshotIndexes.push_back(snapshotIndex);
+            snapshotWritten.notify_all();
+        }
+    }
+
+    void AsyncPackingWriter::WriteSnapshot(const Snapshot& snapshot) const
+    {
+        // Renaming the previously saved packing. Though all IO is set up to flush the buffer immediately,
+        // packing files may be empty, when the program is terminated (at least by the MPI timeout).
+        if (Path::Exists(snapshot.packingFilePath))
+        {
+            if (Path::Exists(snapshot.previousPackingFilePath))
+            {
+                Path::DeleteFile(snapshot.previousPackingFilePath);
+            }
+            Path::Rename(snapshot.packingFilePath, snapshot.previousPackingFilePath);
+        }
+        packingSerializer->SerializePacking(snapshot.packingFilePath, snapshot.particles);
+    }
+}
@@ -176,7 +176,8 @@ namespace PackingServices
             }
         }
 
-        int randomParticleNearCellCenter = (validNeighborsCount == 0) ? 0 : std::rand() % validNeighborsCount;
+        // Unlike rand(), the sequence is restarted by each task, so it does not depend on the tasks executed concurrently
+        int randomParticleNearCellCenter = (validNeighborsCount == 0) ? 0 : Math::GetNextRandomInteger() % validNeighborsCount;
         int immobileNeighborIndex = closestNeighborsPermutation[randomParticleNearCellCenter];
         return immobileNeighborIndex;
     }
@@ -5,6 +5,7 @@
 #include "../Headers/PackingSerializer.h"
 
 #include <cmath>
+#include <algorithm>
 #include "Core/Headers/Path.h"
 #include "Core/Headers/ScopedFile.h"
 #include "Core/Headers/IEndiannessProvider.h"
@@ -33,17 +34,32 @@ namespace PackingServices
         ScopedFile<ExceptionErrorHandler> file(packingFilePath, FileOpenMode::Read | FileOpenMode::Binary);
 
         printf("file '%s' was opened\n", packingFilePath.c_str());
-        for (int i = 0; i < numberOfParticles; ++i)
+
+        // DomainParticle objects contain more than 4 floats, so the file is read by large chunks into a contiguous buffer, which is then scattered to the particles
+        const int floatsPerParticle = DIMENSIONS + 1;
+        const int particlesPerChunk = PARTICLES_PER_IO_CHUNK;
+        vector<FLOAT_TYPE> buffer(std::min(numberOfParticles, particlesPerChunk) * floatsPerParticle);
+        for (int chunkStart = 0; chunkStart < numberOfParticles; chunkStart += particlesPerChunk)
         {
-            // Can not read the whole array at once, as DomainParticle objects contain more than 4 floats
-            FLOAT_TYPE* data = reinterpret_cast<FLOAT_TYPE*>(&particlesRef[i]);
-            const int floatsPerParticle = DIMENSIONS + 1;
-            bool success = ReadLittleEndian<FLOAT_TYPE>(data, floatsPerParticle, file);
+            int chunkParticlesCount = std::min(particlesPerChunk, numberOfParticles - chunkStart);
+            bool success = ReadLittleEndian<FLOAT_TYPE>(&buffer[0], chunkParticlesCount * floatsPerParticle, file);
             if (!success)
             {
                 throw InvalidOperationException("Particles' file is too small.");
             }
-            particlesRef[i].index = i;
+
+            const FLOAT_TYPE* values = &buffer[0];
+            for (int i = chunkStart; i < chunkStart + chunkParticlesCount; ++i)
+            {
+                DomainParticle& particle = particlesRef[i];
+                for (int j = 0; j < DIMENSIONS; ++j)
+                {
+                    particle.coordinates[j] = values[j];
+                }
+                particle.diameter = values[DIMENSIONS];
+                particle.index = i;
+                values += floatsPerParticle;
+            }
         }
     }
 
@@ -165,12 +181,28 @@ namespace PackingServices
         FileOpenMode::Type mode = shouldAppend ? (FileOpenMode::Append | FileOpenMode::Binary) : (FileOpenMode::Write | FileOpenMode::Binary);
         ScopedFile<LogErrorHandler> file(packingFilePath, mode);
         int numberOfParticles = particles.size();
-        for (int i = 0; i < numberOfParticles; ++i)
+
+        // DomainParticle objects contain more than 4 floats, so the particles are gathered by large chunks into a contiguous buffer, which is written at once
+        const int floatsPerParticle = DIMENSIONS + 1;
+        const int particlesPerChunk = PARTICLES_PER_IO_CHUNK;
+        vector<FLOAT_TYPE> buffer(std::min(numberOfParticles, particlesPerChunk) * floatsPerParticle);
+        for (int chunkStart = 0; chunkStart < numberOfParticles; chunkStart += particlesPerChunk)
         {
-            // Can not write the whole array at once, as DomainParticle objects contain more than 4 floats
-            const FLOAT_TYPE* data = reinterpret_cast<const FLOAT_TYPE*>(&particles[i]);
-            const int floatsPerParticle = DIMENSIONS + 1;
-            WriteLittleEndian<FLOAT_TYPE>(data, floatsPerParticle, file);
+            int chunkParticlesCount = std::min(particlesPerChunk, numberOfParticles - chunkStart);
+            FLOAT_TYPE* values = &buffer[0];
+            for (int i = chunkStart; i < chunkStart + chunkParticlesCount; ++i)
+            {
+                const DomainParticle& particle = particles[i];
+                for (int j = 0; j < DIMENSIONS; ++j)
+                {
+                    values[j] = particle.coordinates[j];
+                }
+                values[DIMENSIONS] = particle.diameter;
+                values += floatsPerParticle;
+            }
+
+            SwapBytesIfNecessary(&buffer[0], &buffer[0], chunkParticlesCount * floatsPerParticle);
+            fwrite(&buffer[0], sizeof(FLOAT_TYPE), chunkParticlesCount * floatsPerParticle, file);
         }
     }
 
@@ -509,6 +541,19 @@ namespace PackingServices
 
     }
 
+    void PackingSerializer::SerializeBondOrders(string orderFilePath, const OrderService::BondOrders& bondOrders) const
+    {
+        ScopedFile<LogErrorHandler> file(orderFilePath, FileOpenMode::Write | FileOpenMode::Binary);
+        fprintf(file, "Global: %f\nLocal: %f", bondOrders.globalOrders[0], bondOrders.localOrders[0]);
+
+        for (size_t i = 0; i < bondOrders.ls.size(); ++i)
+        {
+            int l = bondOrders.ls[i];
+            fprintf(file, "\nQ%d global: %f\nQ%d local: %f", l, bondOrders.globalOrders[i], l, bondOrders.localOrders[i]);
+            fprintf(file, "\nW%d global: %f\nW%d local: %f", l, bondOrders.globalWignerOrders[i], l, bondOrders.localWignerOrders[i]);
+        }
+    }
+
     void PackingSerializer::SerializeEntropy(string entropyFilePath, FLOAT_TYPE entropy) const
     {
         ScopedFile<LogErrorHandler> file(entropyFilePath, FileOpenMode::Write | FileOpenMode::Binary);
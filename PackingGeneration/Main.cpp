@@ -10,6 +10,7 @@
 #include "Execution/Headers/PackingTaskFactory.h"
 #include "Core/Headers/Path.h"
 #include "Core/Headers/MpiManager.h"
+#include "Core/Headers/TimeBudget.h"
 #include "Parallelism/Headers/TaskManager.h"
 #include "Parallelism/Headers/RandomLoadBalancer.h"
 
@@ -53,7 +54,9 @@ int main (int argc, char **argv)
 //#endif
 
     PackingTaskFactory packingTaskFactory(Path::GetCurrentWorkingFolder(), argc, argv);
+    TimeBudget::GetInstance()->Start(packingTaskFactory.GetTimeBudget());
     TaskManager taskManager(&packingTaskFactory);
+    taskManager.concurrentTasksCount = packingTaskFactory.GetConcurrentTasksCount();
 
     taskManager.SubmitTasks();
 
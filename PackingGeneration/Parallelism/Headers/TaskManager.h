@@ -5,29 +5,50 @@
 #ifndef Parallelism_Headers_TaskManager_h
 #define Parallelism_Headers_TaskManager_h
 
+#include <string>
 #include <vector>
 #include <boost/shared_ptr.hpp>
 #include "ITaskManager.h"
 #include "Core/Headers/Macros.h"
 #include "Core/Headers/Types.h"
+#include "Core/Headers/MpiManager.h"
+#include "Core/Headers/IParallelTask.h"
 namespace Parallelism { class ITask; }
 
 namespace Parallelism
 {
-    // Implements a default load balancer to split tasks per process in a random manner, thus minimizing execution time deviation.
-    class TaskManager : public virtual ITaskManager
+    // Executes tasks in a single-process environment, sequentially or concurrently by several threads. In a parallel environment the master process dispatches tasks to the other (worker) processes
+    // through MPI messages: a worker reports the task it has finished and receives the next task, until the master replies that no tasks are left.
+    // The tasks are started in the order of decreasing weight (the longest processing time first), so that a long task does not start when the others are almost finished.
+    // The master optionally keeps a journal of finished tasks on the file system, so that a crashed run can be restarted without repeating them.
+    // When the time budget (see Core::TimeBudget) expires, no more tasks are started, and the interrupted tasks are not journaled, so that the next run resumes them.
+    class TaskManager : public virtual ITaskManager, public virtual Core::IParallelTask
     {
+    public:
+        // The number of tasks executed concurrently in a single-process environment. One by default. If not positive, the number of hardware threads is used.
+        // The tasks shall not share mutable state (each PackingGenerationTask creates its own services, and the random generator of Math is per thread).
+        int concurrentTasksCount;
+
+        // True by default. The journal is written only by the master, once per finished task, and is deleted when all the tasks are finished (not when the time budget expires).
+        bool useJournal;
+
     private:
         ITaskFactory* taskFactory;
         std::vector<boost::shared_ptr<ITask> > tasks;
+        std::vector<int> taskOrder;
 
-        // Values used only in single-process environment to avoid writing to the file system and file locking.
-        int startedTasksCount;
-        int finishedTasksCount;
+        // Values used only by the master
+        std::vector<bool> finishedTasks;
+        int nextOrderIndex;
 
         static const std::string syncFolderName;
         static const std::string finishedTasksFileName;
-        static const std::string startedTasksFileName;
+
+        static const int NO_TASK_INDEX = -1;
+        static const int TASK_REQUEST_TAG = 101;
+        static const int TASK_ASSIGNMENT_TAG = 102;
+        // The master sleeps between checks for requests, so that it does not occupy a core while workers execute tasks
+        static const int REQUEST_POLL_MILLISECONDS = 10;
 
     public:
         TaskManager(ITaskFactory* taskFactory);
@@ -36,24 +57,40 @@ namespace Parallelism
 
         OVERRIDE void SubmitTasks();
 
+        // Executes a single task in a single-process environment.
+        OVERRIDE void Execute(int partIndex);
+
     private:
-        ITask* GetFirstTask(const std::vector<boost::shared_ptr<ITask> >& tasks) const;
+        // Orders the tasks by decreasing weight. The tasks of equal weights keep their order.
+        void FillTaskOrder();
+
+        void ExecuteTasksInProcess();
+
+        // Answers worker requests until all the workers are told that no tasks are left.
+        void DispatchTasks();
+
+        void ExecuteDispatchedTasks();
+
+        // Returns false if the task has not been started or has been interrupted (has thrown TimeBudgetExpiredException), as the time budget has expired.
+        bool ExecuteTask(ITask* task) const;
 
-        void LogTaskFinish();
+        // Returns NO_TASK_INDEX if no tasks are left or the time budget has expired.
+        int GetNextTaskIndex();
 
-        void LogInitialValues();
+        void WaitForRequest(MPI_Status* status) const;
 
-        ITask* GetNextTaskAndLogStart();
+        // Marks as finished the tasks from the journal of a previous run, if the journal exists and corresponds to the same set of tasks.
+        void ReadJournal();
 
-        bool AllTasksFinished();
+        void InitializeJournal() const;
 
-        void ClearLogs();
+        void LogTaskFinish(int taskIndex) const;
 
-        std::string GetSyncFolderPath();
+        void ClearJournal() const;
 
-        std::string GetFinishedTasksPath();
+        std::string GetSyncFolderPath() const;
 
-        std::string GetStartedTasksPath();
+        std::string GetFinishedTasksPath() const;
 
         DISALLOW_COPY_AND_ASSIGN(TaskManager);
     };
@@ -4,16 +4,17 @@
 
 #include "../Headers/TaskManager.h"
 #include <stdio.h>
+#include <map>
+#include <algorithm>
 #include "Core/Headers/Exceptions.h"
 #include "Core/Headers/MpiManager.h"
-#include "Core/Headers/StlUtilities.h"
-#include "Core/Headers/Math.h"
 #include "Core/Headers/Path.h"
 #include "Core/Headers/ScopedFile.h"
 #include "Core/Headers/Utilities.h"
+#include "Core/Headers/ThreadPool.h"
+#include "Core/Headers/TimeBudget.h"
 #include "../Headers/ITask.h"
 #include "../Headers/ITaskFactory.h"
-#include "../Headers/FileLock.h"
 
 using namespace std;
 using namespace Core;
@@ -22,11 +23,13 @@ namespace Parallelism
 {
     const string TaskManager::syncFolderName = "sync";
     const string TaskManager::finishedTasksFileName = "finished.txt";
-    const string TaskManager::startedTasksFileName = "started.txt";
 
     TaskManager::TaskManager(ITaskFactory* taskFactory)
     {
         this->taskFactory = taskFactory;
+        concurrentTasksCount = 1;
+        useJournal = true;
+        nextOrderIndex = 0;
     }
 
     ITaskFactory* TaskManager::GetTaskFactory() const
@@ -37,170 +40,274 @@ namespace Parallelism
     void TaskManager::SubmitTasks()
     {
         taskFactory->FillTasks(&tasks);
+        FillTaskOrder();
 
-        // May be shuffle tasks in a parallel environment?
+        MpiManager* mpiManager = MpiManager::GetInstance();
+        if (!mpiManager->IsParallel())
+        {
+            ExecuteTasksInProcess();
+        }
+        else if (mpiManager->IsMaster())
+        {
+            DispatchTasks();
+        }
+        else
+        {
+            ExecuteDispatchedTasks();
+        }
+    }
 
-        LogInitialValues();
+    void TaskManager::FillTaskOrder()
+    {
+        vector<pair<FLOAT_TYPE, int> > negativeWeightsAndIndexes(tasks.size());
+        for (size_t taskIndex = 0; taskIndex < tasks.size(); ++taskIndex)
+        {
+            negativeWeightsAndIndexes[taskIndex] = make_pair(-tasks[taskIndex]->GetWeight(), static_cast<int>(taskIndex));
+        }
+        std::sort(negativeWeightsAndIndexes.begin(), negativeWeightsAndIndexes.end());
 
-        ITask* task = GetFirstTask(tasks);
+        taskOrder.resize(tasks.size());
+        for (size_t i = 0; i < tasks.size(); ++i)
+        {
+            taskOrder[i] = negativeWeightsAndIndexes[i].second;
+        }
+    }
 
-        while (task != NULL)
+    void TaskManager::ExecuteTasksInProcess()
+    {
+        if (concurrentTasksCount == 1 || tasks.size() <= 1)
         {
-            try
+            for (vector<int>::iterator it = taskOrder.begin(); it != taskOrder.end(); ++it)
             {
-                 task->Execute();
+                ExecuteTask(tasks[*it].get());
             }
-            catch (Exception& e)
-            {
-                printf(e.GetMessage().c_str());
-            }
-            catch (std::exception& e)
+            return;
+        }
+
+        // The pool hands out the tasks in their order, the next one to the first free thread
+        int tasksCount = static_cast<int>(tasks.size());
+        int threadsCount = (concurrentTasksCount > 0) ? concurrentTasksCount : ThreadPool::GetHardwareThreadsCount();
+        ThreadPool threadPool(std::min(threadsCount, tasksCount));
+        threadPool.Execute(this, tasksCount);
+    }
+
+    void TaskManager::Execute(int partIndex)
+    {
+        ExecuteTask(tasks[taskOrder[partIndex]].get());
+    }
+
+    void TaskManager::DispatchTasks()
+    {
+        MpiManager* mpiManager = MpiManager::GetInstance();
+
+        finishedTasks.assign(tasks.size(), false);
+        nextOrderIndex = 0;
+        if (useJournal)
+        {
+            ReadJournal();
+            InitializeJournal();
+        }
+
+        int activeWorkersCount = mpiManager->GetNumberOfProcesses() - 1;
+        while (activeWorkersCount > 0)
+        {
+            MPI_Status status;
+            WaitForRequest(&status);
+            int workerRank = status.MPI_SOURCE;
+
+            // A request contains the index of the task the worker has finished, or NO_TASK_INDEX for the first request
+            int finishedTaskIndex;
+            mpiManager->Receive(&finishedTaskIndex, 1, MPI_INT, workerRank, TASK_REQUEST_TAG, &status);
+            if (finishedTaskIndex != NO_TASK_INDEX)
             {
-                printf(e.what());
+                finishedTasks[finishedTaskIndex] = true;
+                if (useJournal)
+                {
+                    LogTaskFinish(finishedTaskIndex);
+                }
             }
-            catch (...)
+
+            int taskIndex = GetNextTaskIndex();
+            mpiManager->Send(&taskIndex, 1, MPI_INT, workerRank, TASK_ASSIGNMENT_TAG);
+            if (taskIndex == NO_TASK_INDEX)
             {
-                // TODO: log
+                activeWorkersCount--;
             }
-
-            LogTaskFinish();
-            task = GetNextTaskAndLogStart();
         }
 
-        // If no task to execute, wait, periodically check finished tasks. If all tasks are finished, exit
-        while (!AllTasksFinished())
+        // All the workers have reported their last tasks. Unless the time budget has expired, all the tasks are finished
+        bool allTasksFinished = std::find(finishedTasks.begin(), finishedTasks.end(), false) == finishedTasks.end();
+        if (useJournal && allTasksFinished)
         {
-            const int secondsToWait = 30;
-            Utilities::Sleep(secondsToWait * 1000);
+            ClearJournal();
         }
-
-        ClearLogs();
     }
 
-    void TaskManager::LogInitialValues()
+    void TaskManager::ExecuteDispatchedTasks()
     {
-        if (!MpiManager::GetInstance()->IsParallel())
-        {
-            startedTasksCount = 1;
-            finishedTasksCount = 0;
-            return;
-        }
+        MpiManager* mpiManager = MpiManager::GetInstance();
+        int masterRank = mpiManager->GetMasterRank();
 
-        if (MpiManager::GetInstance()->IsMaster())
+        int finishedTaskIndex = NO_TASK_INDEX;
+        while (true)
         {
-            Path::EnsureClearDirectory(GetSyncFolderPath());
+            mpiManager->Send(&finishedTaskIndex, 1, MPI_INT, masterRank, TASK_REQUEST_TAG);
 
-            ScopedFile<ExceptionErrorHandler> finishedFile(GetFinishedTasksPath(), FileOpenMode::Write);
-            fprintf(finishedFile, "0");
+            int taskIndex;
+            MPI_Status status;
+            mpiManager->Receive(&taskIndex, 1, MPI_INT, masterRank, TASK_ASSIGNMENT_TAG, &status);
+            if (taskIndex == NO_TASK_INDEX)
+            {
+                return;
+            }
 
-            ScopedFile<ExceptionErrorHandler> startedFile(GetStartedTasksPath(), FileOpenMode::Write);
-            fprintf(startedFile, "%d", MpiManager::GetInstance()->GetNumberOfProcesses());
+            // A task interrupted by the time budget is not reported, so that the next run resumes it
+            bool taskFinished = ExecuteTask(tasks[taskIndex].get());
+            finishedTaskIndex = taskFinished ? taskIndex : NO_TASK_INDEX;
         }
-
-        // No tasks shall start operation before initial files are written
-        MpiManager::GetInstance()->Barrier();
     }
 
-    void TaskManager::LogTaskFinish()
+    bool TaskManager::ExecuteTask(ITask* task) const
     {
-        if (!MpiManager::GetInstance()->IsParallel())
+        TimeBudget* timeBudget = TimeBudget::GetInstance();
+        if (timeBudget->IsExpired())
         {
-            finishedTasksCount++;
-            return;
+            return false;
         }
 
-        string finishedTasksPath = GetFinishedTasksPath();
-        FileLock fileLock(finishedTasksPath);
-        ScopedFile<ExceptionErrorHandler> finishedTasksFile(finishedTasksPath, FileOpenMode::Read | FileOpenMode::Update);
-        int finishedTasksCount;
-        fscanf(finishedTasksFile, "%d", &finishedTasksCount);
-        fseek(finishedTasksFile, 0, SEEK_SET);
-        fprintf(finishedTasksFile, "%d", finishedTasksCount + 1);
+        try
+        {
+             task->Execute();
+        }
+        catch (TimeBudgetExpiredException& e)
+        {
+            // The task has saved its state, and the next run resumes it
+            printf("%s\n", e.GetMessage().c_str());
+            return false;
+        }
+        catch (Exception& e)
+        {
+            printf("%s\n", e.GetMessage().c_str());
+        }
+        catch (std::exception& e)
+        {
+            printf(e.what());
+        }
+        catch (...)
+        {
+            // TODO: log
+        }
+
+        return true;
     }
 
-    ITask* TaskManager::GetNextTaskAndLogStart()
+    int TaskManager::GetNextTaskIndex()
     {
-        if (!MpiManager::GetInstance()->IsParallel())
+        if (TimeBudget::GetInstance()->IsExpired())
         {
-            if (static_cast<size_t>(startedTasksCount) < tasks.size())
-            {
-                ITask* task = tasks[startedTasksCount].get();
-                startedTasksCount++;
-                return task;
-            }
-            else
-            {
-                return NULL;
-            }
+            return NO_TASK_INDEX;
         }
 
-        string startedTasksPath = GetStartedTasksPath();
-        FileLock fileLock(startedTasksPath);
-
-        ScopedFile<ExceptionErrorHandler> startedTasksFile(startedTasksPath, FileOpenMode::Read | FileOpenMode::Update);
-        int startedTasksCount;
-        fscanf(startedTasksFile, "%d", &startedTasksCount);
+        while (static_cast<size_t>(nextOrderIndex) < taskOrder.size() && finishedTasks[taskOrder[nextOrderIndex]])
+        {
+            nextOrderIndex++;
+        }
 
-        ITask* nextTask = NULL;
-        if (static_cast<size_t>(startedTasksCount) < tasks.size())
+        if (static_cast<size_t>(nextOrderIndex) == taskOrder.size())
         {
-            nextTask = tasks[startedTasksCount].get();
-            fseek(startedTasksFile, 0, SEEK_SET);
-            fprintf(startedTasksFile, "%d", startedTasksCount + 1);
+            return NO_TASK_INDEX;
         }
 
-        return nextTask;
+        int taskIndex = taskOrder[nextOrderIndex];
+        nextOrderIndex++;
+        return taskIndex;
     }
 
-    bool TaskManager::AllTasksFinished()
+    void TaskManager::WaitForRequest(MPI_Status* status) const
     {
-        if (!MpiManager::GetInstance()->IsParallel())
+        // A blocking receive busy-waits in many MPI implementations, so the master probes for requests and sleeps in between
+        MpiManager* mpiManager = MpiManager::GetInstance();
+        bool requestArrived = false;
+        mpiManager->ProbeNonBlocking(MPI_ANY_SOURCE, TASK_REQUEST_TAG, &requestArrived, status);
+        while (!requestArrived)
         {
-            return static_cast<size_t>(finishedTasksCount) == tasks.size();
+            Utilities::Sleep(REQUEST_POLL_MILLISECONDS);
+            mpiManager->ProbeNonBlocking(MPI_ANY_SOURCE, TASK_REQUEST_TAG, &requestArrived, status);
         }
+    }
 
+    void TaskManager::ReadJournal()
+    {
         string finishedTasksPath = GetFinishedTasksPath();
+        if (!Path::Exists(finishedTasksPath))
+        {
+            return;
+        }
+
+        // The first line contains the number of tasks, the next lines contain the ids of the finished tasks
         ScopedFile<ExceptionErrorHandler> finishedTasksFile(finishedTasksPath, FileOpenMode::Read);
-        int finishedTasksCount;
-        fscanf(finishedTasksFile, "%d", &finishedTasksCount);
+        int tasksCount;
+        if (fscanf(finishedTasksFile, "%d", &tasksCount) != 1 || static_cast<size_t>(tasksCount) != tasks.size())
+        {
+            printf("Journal of finished tasks does not correspond to the current tasks. Ignoring it\n");
+            return;
+        }
+
+        map<int, int> taskIndexesByIds;
+        for (size_t taskIndex = 0; taskIndex < tasks.size(); ++taskIndex)
+        {
+            taskIndexesByIds[tasks[taskIndex]->GetId()] = static_cast<int>(taskIndex);
+        }
+
+        int finishedTasksCount = 0;
+        int taskId;
+        while (fscanf(finishedTasksFile, "%d", &taskId) == 1)
+        {
+            map<int, int>::const_iterator it = taskIndexesByIds.find(taskId);
+            if (it != taskIndexesByIds.end() && !finishedTasks[it->second])
+            {
+                finishedTasks[it->second] = true;
+                finishedTasksCount++;
+            }
+        }
 
-        return static_cast<size_t>(finishedTasksCount) == tasks.size();
+        printf("Journal of finished tasks found. Skipping %d finished tasks\n", finishedTasksCount);
     }
 
-    void TaskManager::ClearLogs()
+    void TaskManager::InitializeJournal() const
     {
-        MpiManager::GetInstance()->Barrier();
+        Path::EnsureDirectory(GetSyncFolderPath());
 
-        if (MpiManager::GetInstance()->IsMaster())
+        // The finished tasks from the previous journal are written again, as the journal may have been ignored
+        ScopedFile<ExceptionErrorHandler> finishedTasksFile(GetFinishedTasksPath(), FileOpenMode::Write);
+        fprintf(finishedTasksFile, "%d\n", static_cast<int>(tasks.size()));
+        for (size_t taskIndex = 0; taskIndex < tasks.size(); ++taskIndex)
         {
-            Path::DeleteFolder(GetSyncFolderPath());
+            if (finishedTasks[taskIndex])
+            {
+                fprintf(finishedTasksFile, "%d\n", tasks[taskIndex]->GetId());
+            }
         }
     }
 
-    string TaskManager::GetSyncFolderPath()
+    void TaskManager::LogTaskFinish(int taskIndex) const
     {
-        return Path::Append(Path::GetCurrentWorkingFolder(), syncFolderName);
+        ScopedFile<ExceptionErrorHandler> finishedTasksFile(GetFinishedTasksPath(), FileOpenMode::Append);
+        fprintf(finishedTasksFile, "%d\n", tasks[taskIndex]->GetId());
     }
 
-    string TaskManager::GetFinishedTasksPath()
+    void TaskManager::ClearJournal() const
     {
-        return Path::Append(GetSyncFolderPath(), finishedTasksFileName);
+        Path::DeleteFolder(GetSyncFolderPath());
     }
 
-    string TaskManager::GetStartedTasksPath()
+    string TaskManager::GetSyncFolderPath() const
     {
-        return Path::Append(GetSyncFolderPath(), startedTasksFileName);
+        return Path::Append(Path::GetCurrentWorkingFolder(), syncFolderName);
     }
 
-    ITask* TaskManager::GetFirstTask(const vector<boost::shared_ptr<ITask> >& tasks) const
+    string TaskManager::GetFinishedTasksPath() const
     {
-        size_t currentRank = MpiManager::GetInstance()->GetCurrentRank();
-        if (currentRank >= tasks.size())
-        {
-            return NULL;
-        }
-
-        return tasks[currentRank].get();
+        return Path::Append(GetSyncFolderPath(), finishedTasksFileName);
     }
 }
-
@@ -0,0 +1,44 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_AsyncPackingWriterTests_h
+#define Headers_AsyncPackingWriterTests_h
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include "Generation/Model/Headers/Types.h"
+#include "EndiannessProviderStub.h"
+namespace PackingServices { class PackingSerializer; }
+
+namespace Tests
+{
+    class AsyncPackingWriterTests
+    {
+    private:
+        static boost::shared_ptr<EndiannessProviderStub> endiannessProvider;
+        static boost::shared_ptr<PackingServices::PackingSerializer> packingSerializer;
+
+        static const int particlesCount = 1000;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp();
+
+        static void TearDown();
+
+        static void FillParticles(Core::FLOAT_TYPE diameter, Model::Packing* particles);
+
+        static void AssertPackingFile(std::string filePath, Core::FLOAT_TYPE expectedDiameter, std::string testName);
+
+        static void WritePacking_ForSeveralSnapshots_LastTwoSnapshotsWritten();
+
+        static void WritePacking_ParticlesChangedAfterQueuing_SnapshotNotChanged();
+
+        static void Destructor_WithQueuedSnapshots_SnapshotsWritten();
+    };
+}
+
+#endif /* Headers_AsyncPackingWriterTests_h */
@@ -0,0 +1,53 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_CalendarOrderedPriorityQueueTests_h
+#define Headers_CalendarOrderedPriorityQueueTests_h
+
+#include "Core/Headers/CalendarOrderedPriorityQueue.h"
+
+namespace Tests
+{
+    class CalendarOrderedPriorityQueueTests
+    {
+    private:
+        class DoubleComparer
+        {
+        public:
+            bool operator()(const double& first, const double& second)
+            {
+                return first < second;
+            };
+
+            Core::FLOAT_TYPE GetPriority(const double& value) const
+            {
+                return value;
+            };
+        };
+
+    private:
+        static Core::CalendarOrderedPriorityQueue<std::vector<double>, DoubleComparer> eventsQueue;
+        static std::vector<double> values;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp();
+
+        static void TearDown();
+
+        static void GetTop_ForOrdered_TopCorrect();
+
+        static void UpdateValue_MakeEachMinimal_TopAlwaysCorrect();
+
+        static void UpdateValue_MakeEachMaximal_TopAlwaysCorrect();
+
+        static void UpdateValue_MakeInfinite_InfiniteValuesLast();
+
+        static void UpdateValue_SimulateEvents_SameOrderAsSorting();
+    };
+}
+
+#endif /* Headers_CalendarOrderedPriorityQueueTests_h */
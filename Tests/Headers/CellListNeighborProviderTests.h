@@ -0,0 +1,59 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_CellListNeighborProviderTests_h
+#define Headers_CellListNeighborProviderTests_h
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include "Generation/Model/Headers/Types.h"
+namespace PackingServices { class MathService; }
+namespace PackingServices { class GeometryService; }
+namespace PackingServices { class GeometryCollisionService; }
+namespace PackingServices { class CellListNeighborProvider; }
+namespace Geometries { class IGeometry; }
+namespace Model { class SystemConfig; }
+namespace Model { class ModellingContext; }
+
+namespace Tests
+{
+    class CellListNeighborProviderTests
+    {
+    private:
+        static boost::shared_ptr<PackingServices::MathService> mathService;
+        static boost::shared_ptr<PackingServices::GeometryService> geometryService;
+        static boost::shared_ptr<PackingServices::GeometryCollisionService> geometryCollisionService;
+        static boost::shared_ptr<PackingServices::CellListNeighborProvider> neighborProvider;
+
+        static boost::shared_ptr<Geometries::IGeometry> geometry;
+        static boost::shared_ptr<Model::SystemConfig> config;
+        static boost::shared_ptr<Model::ModellingContext> context;
+        static Model::Packing particles;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp();
+
+        static void TearDown();
+
+        static void MoveParticle(Model::ParticleIndex particleIndex, const Core::SpatialVector& coordinates);
+
+        // Checks that the neighbors of each particle exclude the particle itself, have no duplicates and include all the intersecting particles,
+        // and that they coincide with the neighbors of the particle center without the particle itself.
+        static void AssertNeighborsCorrect(std::string callerName);
+
+        // Checks that the neighbors coincide with the neighbors from a provider that is built from scratch for the current particles.
+        static void AssertNeighborsEqualRebuiltNeighbors(std::string callerName);
+
+        static void GetNeighborIndexes_ForRandomParticles_NeighborsCorrect();
+
+        static void GetNeighborIndexes_AfterMoves_NeighborsEqualRebuiltNeighbors();
+
+        static void GetNeighborIndexes_AfterMovesOverflowingCell_NeighborsEqualRebuiltNeighbors();
+    };
+}
+
+#endif /* Headers_CellListNeighborProviderTests_h */
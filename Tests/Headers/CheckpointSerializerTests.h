@@ -0,0 +1,69 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_CheckpointSerializerTests_h
+#define Headers_CheckpointSerializerTests_h
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include "Generation/Model/Headers/Types.h"
+#include "Generation/PackingGenerators/LubachevsckyStillinger/Headers/Types.h"
+namespace PackingServices { class MathService; }
+namespace PackingServices { class GeometryService; }
+namespace PackingServices { class GeometryCollisionService; }
+namespace PackingServices { class INeighborProvider; }
+namespace PackingServices { class DistanceService; }
+namespace PackingGenerators { class CheckpointSerializer; }
+namespace PackingGenerators { class LubachevsckyStillingerStep; }
+namespace Geometries { class IGeometry; }
+namespace Model { class SystemConfig; }
+namespace Model { class ModellingContext; }
+namespace Model { class GenerationConfig; }
+
+namespace Tests
+{
+    class CheckpointSerializerTests
+    {
+    private:
+        static boost::shared_ptr<PackingGenerators::CheckpointSerializer> checkpointSerializer;
+
+        static boost::shared_ptr<PackingServices::MathService> mathService;
+        static boost::shared_ptr<PackingServices::GeometryService> geometryService;
+        static boost::shared_ptr<PackingServices::GeometryCollisionService> geometryCollisionService;
+        static boost::shared_ptr<PackingServices::INeighborProvider> baseNeighborProvider;
+        static boost::shared_ptr<PackingServices::INeighborProvider> neighborProvider;
+        static boost::shared_ptr<PackingServices::DistanceService> distanceService;
+
+        static boost::shared_ptr<Geometries::IGeometry> geometry;
+        static boost::shared_ptr<Model::SystemConfig> config;
+        static boost::shared_ptr<Model::ModellingContext> context;
+        static boost::shared_ptr<Model::GenerationConfig> generationConfig;
+
+        static const std::string checkpointFilePath;
+        static const int particlesPerSide;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp();
+
+        static void TearDown();
+
+        // Creates a Lubachevsky-Stillinger step over the services of the fixture, which writes checkpoints after each block of events.
+        static boost::shared_ptr<PackingGenerators::LubachevsckyStillingerStep> CreateStep();
+
+        static void FillJitteredLattice(Model::Packing* particles);
+
+        static void FillCheckpoint(int particlesCount, PackingGenerators::LubachevsckyStillingerCheckpoint* checkpoint);
+
+        static void WriteCheckpoint_ReadCheckpoint_StateIsPreserved();
+
+        static void ReadCheckpoint_ForTruncatedFile_ReturnsFalse();
+
+        static void SetParticles_WithCheckpoint_ContinuesAsUninterruptedRun();
+    };
+}
+
+#endif /* Headers_CheckpointSerializerTests_h */
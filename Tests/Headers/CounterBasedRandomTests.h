@@ -0,0 +1,33 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_CounterBasedRandomTests_h
+#define Headers_CounterBasedRandomTests_h
+
+#include <string>
+#include <stdint.h>
+
+namespace Tests
+{
+    class CounterBasedRandomTests
+    {
+    public:
+        static void RunTests();
+
+    private:
+        static void AssertKnownAnswer(const uint32_t* key, const uint32_t* counter, const uint32_t* expectedWords, std::string callerName);
+
+        static void FillRandomWords_ForZeroCounterAndKey_KnownAnswer();
+
+        static void FillRandomWords_ForMaxCounterAndKey_KnownAnswer();
+
+        static void FillRandomWords_ForPiDigitsCounterAndKey_KnownAnswer();
+
+        static void FillRandoms_ForSameStreamAndBlock_SameValuesInUnitInterval();
+
+        static void FillRandoms_ForDifferentStreamsAndBlocks_DifferentValues();
+    };
+}
+
+#endif /* Headers_CounterBasedRandomTests_h */
@@ -0,0 +1,60 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_EnergyServiceTests_h
+#define Headers_EnergyServiceTests_h
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include "Generation/Model/Headers/Types.h"
+namespace PackingServices { class MathService; }
+namespace PackingServices { class GeometryService; }
+namespace PackingServices { class GeometryCollisionService; }
+namespace PackingServices { class CellListNeighborProvider; }
+namespace PackingServices { class EnergyService; }
+namespace PackingServices { class BezrukovPotential; }
+namespace Geometries { class IGeometry; }
+namespace Model { class SystemConfig; }
+namespace Model { class ModellingContext; }
+
+namespace Tests
+{
+    class EnergyServiceTests
+    {
+    private:
+        static boost::shared_ptr<PackingServices::MathService> mathService;
+        static boost::shared_ptr<PackingServices::GeometryService> geometryService;
+        static boost::shared_ptr<PackingServices::GeometryCollisionService> geometryCollisionService;
+        static boost::shared_ptr<PackingServices::CellListNeighborProvider> neighborProvider;
+        static boost::shared_ptr<PackingServices::EnergyService> energyService;
+        static boost::shared_ptr<PackingServices::BezrukovPotential> pairPotential;
+
+        static boost::shared_ptr<Geometries::IGeometry> geometry;
+        static boost::shared_ptr<Model::SystemConfig> config;
+        static boost::shared_ptr<Model::ModellingContext> context;
+        static Model::Packing particles;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp(int threadsCount);
+
+        static void TearDown();
+
+        static void AssertForcesSameAsNaive(std::string callerName);
+
+        static void FillParticleForces_ForSingleThread_SameAsNaive();
+
+        static void FillParticleForces_ForSeveralThreads_SameAsNaive();
+
+        static void FillParticleForces_ForBuiltInPotential_SameAsForVirtualCalls();
+
+        static void FillParticleForces_ForDifferentPartsCounts_ExactlySame();
+
+        static void GetContractionEnergies_ForBuiltInPotentials_SameAsForVirtualCalls();
+    };
+}
+
+#endif /* Headers_EnergyServiceTests_h */
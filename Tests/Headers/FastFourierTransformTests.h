@@ -0,0 +1,39 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_FastFourierTransformTests_h
+#define Headers_FastFourierTransformTests_h
+
+#include <string>
+#include <vector>
+#include <complex>
+#include "Core/Headers/Types.h"
+
+namespace Tests
+{
+    class FastFourierTransformTests
+    {
+    public:
+        static void RunTests();
+
+    private:
+        static void FillRandomValues(int size, std::vector<std::complex<Core::FLOAT_TYPE> >* values);
+
+        static void AssertSameAsNaive(int size, bool inverse, std::string callerName);
+
+        static void Transform_ForPowerOfTwo_SameAsNaive();
+
+        static void Transform_ForMixedRadix_SameAsNaive();
+
+        static void Transform_ForLargePrimeFactors_SameAsNaive();
+
+        static void Transform_Inverse_SameAsNaive();
+
+        static void TransformMultidimensional_ForMixedSizes_SameAsNaive();
+
+        static void GetNextFastSize_ForSeveralSizes_SmallPrimeFactorsOnly();
+    };
+}
+
+#endif /* Headers_FastFourierTransformTests_h */
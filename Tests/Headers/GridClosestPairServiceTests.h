@@ -0,0 +1,50 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_GridClosestPairServiceTests_h
+#define Headers_GridClosestPairServiceTests_h
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include "Generation/Model/Headers/Types.h"
+namespace PackingServices { class MathService; }
+namespace PackingServices { class GeometryService; }
+namespace PackingServices { class GridClosestPairService; }
+namespace Geometries { class IGeometry; }
+namespace Model { class SystemConfig; }
+namespace Model { class ModellingContext; }
+
+namespace Tests
+{
+    class GridClosestPairServiceTests
+    {
+    private:
+        static boost::shared_ptr<PackingServices::MathService> mathService;
+        static boost::shared_ptr<PackingServices::GeometryService> geometryService;
+        static boost::shared_ptr<PackingServices::GridClosestPairService> closestPairService;
+
+        static boost::shared_ptr<Geometries::IGeometry> geometry;
+        static boost::shared_ptr<Model::SystemConfig> config;
+        static boost::shared_ptr<Model::ModellingContext> context;
+        static Model::Packing particles;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp(int particlesCount, Core::FLOAT_TYPE boxSize);
+
+        static void TearDown();
+
+        static void AssertSameAsNaive(std::string callerName);
+
+        static void FindClosestPair_ForDensePolydispersePacking_SameAsNaive();
+
+        static void FindClosestPair_ForDilutePacking_SameAsNaive();
+
+        static void FindClosestPair_ForCubicLatticeWithEqualDistances_SameAsNaive();
+    };
+}
+
+#endif /* Headers_GridClosestPairServiceTests_h */
@@ -0,0 +1,69 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_HierarchicalCellListNeighborProviderTests_h
+#define Headers_HierarchicalCellListNeighborProviderTests_h
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "Core/Headers/Macros.h"
+#include "Core/Headers/IParallelTask.h"
+#include "Generation/Model/Headers/Types.h"
+namespace PackingServices { class MathService; }
+namespace PackingServices { class GeometryService; }
+namespace PackingServices { class GeometryCollisionService; }
+namespace PackingServices { class HierarchicalCellListNeighborProvider; }
+namespace Geometries { class IGeometry; }
+namespace Model { class SystemConfig; }
+namespace Model { class ModellingContext; }
+
+namespace Tests
+{
+    class HierarchicalCellListNeighborProviderTests
+    {
+    private:
+        // Copies the neighbors of the points i, i + partsCount, i + 2 * partsCount, ... in the thread of the part i.
+        class PointQueryTask : public virtual Core::IParallelTask
+        {
+        public:
+            const PackingServices::HierarchicalCellListNeighborProvider* neighborProvider;
+            const std::vector<Core::SpatialVector>* points;
+            std::vector<std::vector<Model::ParticleIndex> > pointNeighborIndexes;
+            int partsCount;
+
+            OVERRIDE void Execute(int partIndex);
+        };
+
+        static boost::shared_ptr<PackingServices::MathService> mathService;
+        static boost::shared_ptr<PackingServices::GeometryService> geometryService;
+        static boost::shared_ptr<PackingServices::GeometryCollisionService> geometryCollisionService;
+        static boost::shared_ptr<PackingServices::HierarchicalCellListNeighborProvider> neighborProvider;
+
+        static boost::shared_ptr<Geometries::IGeometry> geometry;
+        static boost::shared_ptr<Model::SystemConfig> config;
+        static boost::shared_ptr<Model::ModellingContext> context;
+        static Model::Packing particles;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp(int largeParticlesCount, Core::FLOAT_TYPE largeDiameter, int smallParticlesCount, Core::FLOAT_TYPE smallDiameter);
+
+        static void TearDown();
+
+        static void AssertIntersectingNeighborsFound(std::string callerName);
+
+        static void GetNeighborIndexes_ForMonodispersePacking_SingleLevelAndIntersectingNeighborsFound();
+
+        static void GetNeighborIndexes_ForBimodalPacking_TwoLevelsAndIntersectingNeighborsFound();
+
+        static void GetNeighborIndexes_ForBimodalPackingAfterMoves_IntersectingNeighborsFound();
+
+        static void GetNeighborIndexes_ForPointsInSeveralThreads_SameAsInSingleThread();
+    };
+}
+
+#endif /* Headers_HierarchicalCellListNeighborProviderTests_h */
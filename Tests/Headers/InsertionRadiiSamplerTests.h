@@ -0,0 +1,54 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_InsertionRadiiSamplerTests_h
+#define Headers_InsertionRadiiSamplerTests_h
+
+#include <vector>
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include "Generation/Model/Headers/Types.h"
+namespace PackingServices { class MathService; }
+namespace PackingServices { class InsertionRadiiSampler; }
+namespace Geometries { class IGeometry; }
+namespace Model { class SystemConfig; }
+namespace Model { class ModellingContext; }
+
+namespace Tests
+{
+    class InsertionRadiiSamplerTests
+    {
+    private:
+        static boost::shared_ptr<PackingServices::MathService> mathService;
+
+        static boost::shared_ptr<Geometries::IGeometry> geometry;
+        static boost::shared_ptr<Model::SystemConfig> config;
+        static boost::shared_ptr<Model::ModellingContext> context;
+        static Model::Packing particles;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp(int particlesCount, Core::FLOAT_TYPE boxSize);
+
+        static void TearDown();
+
+        static void FillDistances(int threadsCount, int seed, long long firstSampleIndex, int samplesCount, std::vector<Core::FLOAT_TYPE>* distances);
+
+        static void AssertDistancesSameAsNaive(int seed, std::string testName);
+
+        static void FillDistancesToNearestSurfaces_ForDifferentThreadsCounts_SameDistances();
+
+        static void FillDistancesToNearestSurfaces_ForDifferentBatches_SameDistances();
+
+        static void FillDistancesToNearestSurfaces_ForDifferentSeeds_DifferentDistances();
+
+        static void GetDistanceToNearestSurface_ForDensePacking_SameAsNaive();
+
+        static void GetDistanceToNearestSurface_ForDilutePacking_SameAsNaive();
+    };
+}
+
+#endif /* Headers_InsertionRadiiSamplerTests_h */
@@ -0,0 +1,88 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_LubachevsckyStillingerStepTests_h
+#define Headers_LubachevsckyStillingerStepTests_h
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <vector>
+#include "Generation/Model/Headers/Types.h"
+#include "Generation/PackingGenerators/LubachevsckyStillinger/Headers/Types.h"
+namespace PackingServices { class MathService; }
+namespace PackingServices { class GeometryService; }
+namespace PackingServices { class GeometryCollisionService; }
+namespace PackingServices { class INeighborProvider; }
+namespace PackingServices { class DistanceService; }
+namespace PackingGenerators { class CheckpointSerializer; }
+namespace PackingGenerators { class LubachevsckyStillingerStep; }
+namespace Geometries { class IGeometry; }
+namespace Model { class SystemConfig; }
+namespace Model { class ModellingContext; }
+namespace Model { class GenerationConfig; }
+
+namespace Tests
+{
+    class LubachevsckyStillingerStepTests
+    {
+    private:
+        static boost::shared_ptr<PackingGenerators::CheckpointSerializer> checkpointSerializer;
+
+        static boost::shared_ptr<PackingServices::MathService> mathService;
+        static boost::shared_ptr<PackingServices::GeometryService> geometryService;
+        static boost::shared_ptr<PackingServices::GeometryCollisionService> geometryCollisionService;
+        static boost::shared_ptr<PackingServices::INeighborProvider> neighborProvider;
+        static boost::shared_ptr<PackingServices::DistanceService> distanceService;
+
+        static boost::shared_ptr<Geometries::IGeometry> geometry;
+        static boost::shared_ptr<Model::SystemConfig> config;
+        static boost::shared_ptr<Model::ModellingContext> context;
+        static boost::shared_ptr<Model::GenerationConfig> generationConfig;
+
+        static const std::string checkpointFilePath;
+        static const int particlesPerSide;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp();
+
+        static void TearDown();
+
+        static boost::shared_ptr<PackingGenerators::LubachevsckyStillingerStep> CreateStep(bool updateEventsIncrementally);
+
+        static void FillJitteredLattice(Model::Packing* particles);
+
+        static void FillRandomVelocities(std::vector<Core::SpatialVector>* velocities);
+
+        // Fills the same velocity along the first axis for each lattice row along it, so that the particles do not collide. Every fourth row is at rest.
+        static void FillRowVelocities(std::vector<Core::SpatialVector>* velocities);
+
+        // Writes the checkpoint without growth with the given particles and velocities (which do not correspond to the temperature).
+        static void WriteCheckpoint(const Model::Packing& particles, const std::vector<Core::SpatialVector>& velocities);
+
+        // Copies the collision and transfer events earlier than cutoffTime in the order of particles.
+        static void FillFinalEvents(const std::vector<PackingGenerators::MovingParticle>& movingParticles, Core::FLOAT_TYPE cutoffTime, std::vector<PackingGenerators::Event>* events);
+
+        static Core::FLOAT_TYPE GetFirstMoveEventTime(const std::vector<PackingGenerators::MovingParticle>& movingParticles);
+
+        static int CountNeverEvents(const std::vector<PackingGenerators::MovingParticle>& movingParticles);
+
+        // Runs one block of events without growth from the checkpoint with the given velocities.
+        static boost::shared_ptr<PackingGenerators::LubachevsckyStillingerStep> RunBlock(const std::vector<Core::SpatialVector>& velocities, bool updateEventsIncrementally, Model::Packing* particles);
+
+        static void AssertFinalEventsEqual(const std::vector<PackingGenerators::MovingParticle>& actualMovingParticles,
+                const std::vector<PackingGenerators::MovingParticle>& expectedMovingParticles, std::string testName);
+
+        static void AssertNeverEventsKept(const std::vector<PackingGenerators::MovingParticle>& actualMovingParticles,
+                const std::vector<PackingGenerators::MovingParticle>& expectedMovingParticles, std::string testName);
+
+        static void DisplaceParticles_ForRandomVelocities_IncrementalEventsEqualRebuiltEvents();
+
+        static void DisplaceParticles_ForParticlesAtRest_NeverEventsKept();
+    };
+}
+
+#endif /* Headers_LubachevsckyStillingerStepTests_h */
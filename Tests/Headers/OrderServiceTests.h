@@ -0,0 +1,49 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_OrderServiceTests_h
+#define Headers_OrderServiceTests_h
+
+#include <boost/shared_ptr.hpp>
+#include "Generation/Model/Headers/Types.h"
+namespace PackingServices { class MathService; }
+namespace PackingServices { class GeometryService; }
+namespace PackingServices { class GeometryCollisionService; }
+namespace PackingServices { class CellListNeighborProvider; }
+namespace PackingServices { class OrderService; }
+namespace Geometries { class IGeometry; }
+namespace Model { class SystemConfig; }
+namespace Model { class ModellingContext; }
+
+namespace Tests
+{
+    class OrderServiceTests
+    {
+    private:
+        static boost::shared_ptr<PackingServices::MathService> mathService;
+        static boost::shared_ptr<PackingServices::GeometryService> geometryService;
+        static boost::shared_ptr<PackingServices::GeometryCollisionService> geometryCollisionService;
+        static boost::shared_ptr<PackingServices::CellListNeighborProvider> neighborProvider;
+        static boost::shared_ptr<PackingServices::OrderService> orderService;
+
+        static boost::shared_ptr<Geometries::IGeometry> geometry;
+        static boost::shared_ptr<Model::SystemConfig> config;
+        static boost::shared_ptr<Model::ModellingContext> context;
+        static Model::Packing particles;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp(int particlesCount, Core::FLOAT_TYPE boxSize);
+
+        static void TearDown();
+
+        static void FillBondOrders_ForFccLattice_KnownValues();
+
+        static void FillBondOrders_ForDifferentThreadsCounts_SameValues();
+    };
+}
+
+#endif /* Headers_OrderServiceTests_h */
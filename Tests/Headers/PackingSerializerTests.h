@@ -31,6 +31,7 @@ namespace Tests
         static void SavePacking_InBigEndian_PackingIsNotChanged();
         static void SavePacking_InBigEndian_PackingIsCorrectWhenLoadedInBigEndian();
         static void SavePacking_InLittleEndian_PackingIsCorrectWhenLoadedInLittleEndian();
+        static void SavePacking_ForSeveralChunks_PackingIsCorrectWhenLoaded();
 
         static void SerializeInsertionRadii_InBigEndian_DataIsDifferentWhenLoadingInLittleEndian();
         static void SerializeInsertionRadii_InLittleEndian_DataIsDifferentWhenLoadingInBigEndian();
@@ -0,0 +1,23 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_PackingTestUtilities_h
+#define Headers_PackingTestUtilities_h
+
+#include "Generation/Model/Headers/Types.h"
+namespace Model { class SystemConfig; }
+
+namespace Tests
+{
+    // Includes methods for preparing test packings.
+    class PackingTestUtilities
+    {
+    public:
+        // Fills the particles with uniformly distributed (possibly overlapping) centers in the box and uniformly distributed diameters.
+        // The particles shall already have config.particlesCount elements. Resets the seed of Core::Math.
+        static void FillRandomParticles(const Model::SystemConfig& config, int seed, Core::FLOAT_TYPE minDiameter, Core::FLOAT_TYPE maxDiameter, Model::Packing* particles);
+    };
+}
+
+#endif /* Headers_PackingTestUtilities_h */
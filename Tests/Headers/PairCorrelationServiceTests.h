@@ -0,0 +1,56 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_PairCorrelationServiceTests_h
+#define Headers_PairCorrelationServiceTests_h
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include "Generation/Model/Headers/Types.h"
+namespace PackingServices { class MathService; }
+namespace PackingServices { class GeometryService; }
+namespace PackingServices { class GeometryCollisionService; }
+namespace PackingServices { class CellListNeighborProvider; }
+namespace PackingServices { class DistanceService; }
+namespace PackingServices { class PairCorrelationService; }
+namespace Geometries { class IGeometry; }
+namespace Model { class SystemConfig; }
+namespace Model { class ModellingContext; }
+
+namespace Tests
+{
+    class PairCorrelationServiceTests
+    {
+    private:
+        static boost::shared_ptr<PackingServices::MathService> mathService;
+        static boost::shared_ptr<PackingServices::GeometryService> geometryService;
+        static boost::shared_ptr<PackingServices::GeometryCollisionService> geometryCollisionService;
+        static boost::shared_ptr<PackingServices::CellListNeighborProvider> neighborProvider;
+        static boost::shared_ptr<PackingServices::DistanceService> distanceService;
+        static boost::shared_ptr<PackingServices::PairCorrelationService> pairCorrelationService;
+
+        static boost::shared_ptr<Geometries::IGeometry> geometry;
+        static boost::shared_ptr<Model::SystemConfig> config;
+        static boost::shared_ptr<Model::ModellingContext> context;
+        static Model::Packing particles;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp(int particlesCount, Core::FLOAT_TYPE boxSize);
+
+        static void TearDown();
+
+        static void FillNaivePairCorrelationFunction(Model::PairCorrelationFunction* pairCorrelationFunction);
+
+        static void AssertSameAsNaive(std::string callerName);
+
+        static void FillPairCorrelationFunction_ForLargeBox_SameAsNaive();
+
+        static void FillPairCorrelationFunction_ForSmallBox_SameAsNaive();
+    };
+}
+
+#endif /* Headers_PairCorrelationServiceTests_h */
@@ -0,0 +1,60 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_ScatteringSumsKernelTests_h
+#define Headers_ScatteringSumsKernelTests_h
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "Generation/Model/Headers/Types.h"
+namespace PackingServices { class MathService; }
+namespace PackingServices { class GeometryService; }
+namespace PackingServices { class GeometryCollisionService; }
+namespace PackingServices { class CellListNeighborProvider; }
+namespace PackingServices { class DistanceService; }
+namespace Geometries { class IGeometry; }
+namespace Model { class SystemConfig; }
+namespace Model { class ModellingContext; }
+
+namespace Tests
+{
+    class ScatteringSumsKernelTests
+    {
+    private:
+        static boost::shared_ptr<PackingServices::MathService> mathService;
+        static boost::shared_ptr<PackingServices::GeometryService> geometryService;
+        static boost::shared_ptr<PackingServices::GeometryCollisionService> geometryCollisionService;
+        static boost::shared_ptr<PackingServices::CellListNeighborProvider> neighborProvider;
+        static boost::shared_ptr<PackingServices::DistanceService> distanceService;
+
+        static boost::shared_ptr<Geometries::IGeometry> geometry;
+        static boost::shared_ptr<Model::SystemConfig> config;
+        static boost::shared_ptr<Model::ModellingContext> context;
+        static Model::Packing firstParticles;
+        static Model::Packing secondParticles;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp();
+
+        static void TearDown();
+
+        static void FillRandomParticles(Model::Packing* particles);
+
+        static void AssertSameAsNaive(const Model::Packing& firstPacking, const Model::Packing& secondPacking, const std::vector<Core::SpatialVector>& waveVectors, std::string callerName);
+
+        static void FillIntermediateScatteringFunction_ForSamePackings_SameAsNaive();
+
+        static void FillIntermediateScatteringFunction_ForDifferentPackings_SameAsNaive();
+
+        static void FillIntermediateScatteringFunction_ForNotCommensurateWaveVectors_SameAsNaive();
+
+        static void FillIntermediateScatteringFunction_ForDifferentThreadsCounts_SameValues();
+    };
+}
+
+#endif /* Headers_ScatteringSumsKernelTests_h */
@@ -0,0 +1,34 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_SphericalHarmonicsKernelTests_h
+#define Headers_SphericalHarmonicsKernelTests_h
+
+#include <vector>
+#include <complex>
+#include "Core/Headers/Types.h"
+
+namespace Tests
+{
+    class SphericalHarmonicsKernelTests
+    {
+    public:
+        static void RunTests();
+
+    private:
+        static void FillFccNeighborDirections(std::vector<Core::SpatialVector>* directions);
+
+        static void AddSphericalHarmonicValues_ForLIsSix_SameAsAnalytical();
+
+        static void AddSphericalHarmonicValues_ForPoles_SameAsAnalytical();
+
+        static void AddSphericalHarmonicValues_ForRandomDirection_SatisfiesAdditionTheorem();
+
+        static void GetWignerSymbol_ForKnownSymbols_KnownValues();
+
+        static void GetOrders_ForFccCluster_KnownValues();
+    };
+}
+
+#endif /* Headers_SphericalHarmonicsKernelTests_h */
@@ -0,0 +1,43 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_TaskCostEstimatorTests_h
+#define Headers_TaskCostEstimatorTests_h
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+namespace Execution { class TaskCostEstimator; }
+namespace Model { class GenerationConfig; }
+
+namespace Tests
+{
+    class TaskCostEstimatorTests
+    {
+    private:
+        static boost::shared_ptr<Execution::TaskCostEstimator> costEstimator;
+        static boost::shared_ptr<Model::GenerationConfig> generationConfig;
+        static std::vector<std::string> folders;
+
+        static const std::string baseFolder;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp();
+
+        static void TearDown();
+
+        static void CreateFolder(std::string folderName, int particlesCount);
+
+        static void GetModelCost_ForMoreParticles_LargerCost();
+
+        static void FillCosts_ForRecordedTime_RecordedTimeUsedAndOtherCostsCalibrated();
+
+        static void FillCosts_ForGeneratedPacking_ZeroCost();
+    };
+}
+
+#endif /* Headers_TaskCostEstimatorTests_h */
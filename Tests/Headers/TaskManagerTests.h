@@ -0,0 +1,68 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_TaskManagerTests_h
+#define Headers_TaskManagerTests_h
+
+#include <vector>
+#include <mutex>
+#include <boost/shared_ptr.hpp>
+#include "Core/Headers/Macros.h"
+#include "Core/Headers/Types.h"
+#include "Parallelism/Headers/ITask.h"
+#include "Parallelism/Headers/ITaskFactory.h"
+
+namespace Tests
+{
+    class TaskManagerTests
+    {
+    private:
+        // Records the ids of the tasks in the order of their start
+        class TaskStub : public virtual Parallelism::ITask
+        {
+        private:
+            int id;
+            Core::FLOAT_TYPE weight;
+
+        public:
+            TaskStub(int id, Core::FLOAT_TYPE weight);
+
+            OVERRIDE int GetId() const;
+
+            OVERRIDE Core::FLOAT_TYPE GetWeight() const;
+
+            OVERRIDE void Execute();
+        };
+
+        class TaskFactoryStub : public virtual Parallelism::ITaskFactory
+        {
+        public:
+            std::vector<Core::FLOAT_TYPE> weights;
+
+        public:
+            OVERRIDE void FillTasks(std::vector<boost::shared_ptr<Parallelism::ITask> >* tasks);
+        };
+
+        static std::vector<int> startedTaskIds;
+        static std::mutex startedTaskIdsMutex;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp();
+
+        static void TearDown();
+
+        static void SubmitTasks_ForDifferentWeights_HeaviestTasksStartFirst();
+
+        static void SubmitTasks_ForEqualWeights_TasksStartInOriginalOrder();
+
+        static void SubmitTasks_ForSeveralThreads_AllTasksExecutedOnce();
+
+        static void SubmitTasks_ForExpiredTimeBudget_NoTasksStarted();
+    };
+}
+
+#endif /* Headers_TaskManagerTests_h */
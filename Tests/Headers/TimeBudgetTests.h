@@ -0,0 +1,26 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_TimeBudgetTests_h
+#define Headers_TimeBudgetTests_h
+
+namespace Tests
+{
+    class TimeBudgetTests
+    {
+    public:
+        static void RunTests();
+
+    private:
+        static void TearDown();
+
+        static void IsExpired_ForNotPositiveBudget_False();
+
+        static void IsExpired_ForElapsedBudget_True();
+
+        static void ThrowIfExpired_ForElapsedBudget_Throws();
+    };
+}
+
+#endif /* Headers_TimeBudgetTests_h */
@@ -0,0 +1,55 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_VerletListNeighborProviderTests_h
+#define Headers_VerletListNeighborProviderTests_h
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include "Generation/Model/Headers/Types.h"
+namespace PackingServices { class MathService; }
+namespace PackingServices { class GeometryService; }
+namespace PackingServices { class GeometryCollisionService; }
+namespace PackingServices { class CellListNeighborProvider; }
+namespace PackingServices { class VerletListNeighborProvider; }
+namespace Geometries { class IGeometry; }
+namespace Model { class SystemConfig; }
+namespace Model { class ModellingContext; }
+
+namespace Tests
+{
+    class VerletListNeighborProviderTests
+    {
+    private:
+        static boost::shared_ptr<PackingServices::MathService> mathService;
+        static boost::shared_ptr<PackingServices::GeometryService> geometryService;
+        static boost::shared_ptr<PackingServices::GeometryCollisionService> geometryCollisionService;
+        static boost::shared_ptr<PackingServices::CellListNeighborProvider> baseNeighborProvider;
+        static boost::shared_ptr<PackingServices::VerletListNeighborProvider> neighborProvider;
+
+        static boost::shared_ptr<Geometries::IGeometry> geometry;
+        static boost::shared_ptr<Model::SystemConfig> config;
+        static boost::shared_ptr<Model::ModellingContext> context;
+        static Model::Packing particles;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp();
+
+        static void TearDown();
+
+        static void MoveParticlesRandomly(int movesCount);
+
+        // Asserts that the lists are symmetric, have no duplicates and contain all the intersecting neighbors
+        static void AssertListsCorrect(std::string callerName);
+
+        static void GetNeighborIndexes_AfterSetParticles_ListsCorrect();
+
+        static void GetNeighborIndexes_AfterMovesAndRebuild_ListsCorrect();
+    };
+}
+
+#endif /* Headers_VerletListNeighborProviderTests_h */
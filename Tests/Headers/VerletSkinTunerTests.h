@@ -0,0 +1,36 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_VerletSkinTunerTests_h
+#define Headers_VerletSkinTunerTests_h
+
+#include <boost/shared_ptr.hpp>
+#include "Core/Headers/Types.h"
+namespace PackingServices { class VerletSkinTuner; }
+
+namespace Tests
+{
+    class VerletSkinTunerTests
+    {
+    private:
+        static boost::shared_ptr<PackingServices::VerletSkinTuner> verletSkinTuner;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp();
+
+        static void TearDown();
+
+        // Runs the tuner for a cost a / s + b * s, where s is the cutoff distance, and returns the final cutoff distance
+        static Core::FLOAT_TYPE Tune(Core::FLOAT_TYPE listUpdatesCostFactor, Core::FLOAT_TYPE listLengthCostFactor);
+
+        static void GetNextCutoffDistance_ForConvexCost_ConvergesToOptimum();
+
+        static void GetNextCutoffDistance_ForOptimumBeyondMaxCutoff_StaysNearMaxCutoff();
+    };
+}
+
+#endif /* Headers_VerletSkinTunerTests_h */
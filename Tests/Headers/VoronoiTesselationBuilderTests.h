@@ -0,0 +1,55 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_VoronoiTesselationBuilderTests_h
+#define Headers_VoronoiTesselationBuilderTests_h
+
+#include <vector>
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include "Generation/Model/Headers/Types.h"
+#include "Generation/PackingGenerators/LubachevsckyStillinger/Headers/Types.h"
+namespace PackingServices { class MathService; }
+namespace PackingGenerators { class VoronoiTesselationBuilder; }
+namespace Geometries { class IGeometry; }
+namespace Model { class SystemConfig; }
+namespace Model { class ModellingContext; }
+
+namespace Tests
+{
+    class VoronoiTesselationBuilderTests
+    {
+    private:
+        static boost::shared_ptr<PackingServices::MathService> mathService;
+        static boost::shared_ptr<PackingGenerators::VoronoiTesselationBuilder> tesselationBuilder;
+
+        static boost::shared_ptr<Geometries::IGeometry> geometry;
+        static boost::shared_ptr<Model::SystemConfig> config;
+        static boost::shared_ptr<Model::ModellingContext> context;
+        static Model::Packing particles;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp(int particlesCount, Core::FLOAT_TYPE boxSize);
+
+        static void TearDown();
+
+        static Core::FLOAT_TYPE GetSignedDistance(const Core::SpatialVector& point, const PackingGenerators::VoronoiPlane& plane);
+
+        // Own planes are the bisectors with the closest periodic images of the neighbors (the other planes are the planes of the periodic images of the cell).
+        static void FillOwnPlanes(Model::ParticleIndex particleIndex, const std::vector<PackingGenerators::VoronoiPlane>& planes, std::vector<PackingGenerators::VoronoiPlane>* ownPlanes);
+
+        static bool IsInsideOwnPlanes(const Core::SpatialVector& point, Model::ParticleIndex particleIndex, const std::vector<PackingGenerators::VoronoiPlane>& ownPlanes);
+
+        static void FillVoronoiPlanes_ForCubicLattice_SixPlanesAtHalfSpacing();
+
+        static void FillVoronoiPlanes_ForRandomPacking_CellsContainClosestPoints();
+
+        static void FillVoronoiPlanes_ForTwoParticlesInBox_TruncatedOctahedra();
+    };
+}
+
+#endif /* Headers_VoronoiTesselationBuilderTests_h */
@@ -0,0 +1,39 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#ifndef Headers_WorkingFolderIndexTests_h
+#define Headers_WorkingFolderIndexTests_h
+
+#include <string>
+
+namespace Tests
+{
+    class WorkingFolderIndexTests
+    {
+    private:
+        static const std::string baseFolder;
+
+    public:
+        static void RunTests();
+
+    private:
+        static void SetUp();
+
+        static void TearDown();
+
+        // Creates the folder with the given files (empty), if they are not empty strings.
+        static void CreateFolder(std::string folderName, std::string firstFileName, std::string secondFileName);
+
+        // Compares the folders of a new index with the ones from the recursive search.
+        static void AssertIndexCorrect(std::string testName);
+
+        static void Update_ForFolderTree_SameFoldersAsRecursiveSearch();
+
+        static void Update_ForChangedFoldersAfterPreviousIndex_ChangesFound();
+
+        static void Update_ForInvalidIndexFile_AllFoldersFound();
+    };
+}
+
+#endif /* Headers_WorkingFolderIndexTests_h */
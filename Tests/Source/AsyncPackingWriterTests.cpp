@@ -0,0 +1,135 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/AsyncPackingWriterTests.h"
+
+#include <stdio.h>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Path.h"
+#include "Generation/PackingServices/Headers/PackingSerializer.h"
+#include "Generation/PackingServices/Headers/AsyncPackingWriter.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace PackingServices;
+
+namespace Tests
+{
+    boost::shared_ptr<EndiannessProviderStub> AsyncPackingWriterTests::endiannessProvider;
+    boost::shared_ptr<PackingSerializer> AsyncPackingWriterTests::packingSerializer;
+
+    void AsyncPackingWriterTests::SetUp()
+    {
+        endiannessProvider.reset(new EndiannessProviderStub());
+        endiannessProvider->isBigEndian = false;
+        packingSerializer.reset(new PackingSerializer(endiannessProvider.get()));
+
+        Path::DeleteFile("snapshot.xyzd");
+        Path::DeleteFile("snapshot_previous.xyzd");
+    }
+
+    void AsyncPackingWriterTests::TearDown()
+    {
+        Path::DeleteFile("snapshot.xyzd");
+        Path::DeleteFile("snapshot_previous.xyzd");
+    }
+
+    void AsyncPackingWriterTests::FillParticles(FLOAT_TYPE diameter, Packing* particles)
+    {
+        particles->resize(particlesCount);
+        for (ParticleIndex i = 0; i < particlesCount; ++i)
+        {
+            SpatialVector coordinates;
+            for (int j = 0; j < DIMENSIONS; ++j)
+            {
+                coordinates[j] = i + j;
+            }
+            particles->at(i) = DomainParticle(i, diameter, coordinates);
+        }
+    }
+
+    void AsyncPackingWriterTests::AssertPackingFile(string filePath, FLOAT_TYPE expectedDiameter, string testName)
+    {
+        Packing loadedParticles(particlesCount);
+        packingSerializer->ReadPacking(filePath, &loadedParticles);
+        for (ParticleIndex i = 0; i < particlesCount; ++i)
+        {
+            Assert::AreEqual(loadedParticles[i].diameter, expectedDiameter, testName);
+            Assert::AreEqual(loadedParticles[i].coordinates[0], static_cast<FLOAT_TYPE>(i), testName);
+        }
+    }
+
+    void AsyncPackingWriterTests::WritePacking_ForSeveralSnapshots_LastTwoSnapshotsWritten()
+    {
+        string testName = "WritePacking_ForSeveralSnapshots_LastTwoSnapshotsWritten";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        {
+            AsyncPackingWriter packingWriter(packingSerializer.get(), 1);
+            Packing particles;
+            for (int snapshotIndex = 1; snapshotIndex <= 5; ++snapshotIndex)
+            {
+                FillParticles(snapshotIndex, &particles);
+                packingWriter.WritePacking("snapshot.xyzd", "snapshot_previous.xyzd", particles);
+            }
+            packingWriter.Flush();
+
+            AssertPackingFile("snapshot.xyzd", 5.0, testName);
+            AssertPackingFile("snapshot_previous.xyzd", 4.0, testName);
+        }
+
+        TearDown();
+    }
+
+    void AsyncPackingWriterTests::WritePacking_ParticlesChangedAfterQueuing_SnapshotNotChanged()
+    {
+        string testName = "WritePacking_ParticlesChangedAfterQueuing_SnapshotNotChanged";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        {
+            AsyncPackingWriter packingWriter(packingSerializer.get(), 2);
+            Packing particles;
+            FillParticles(1.0, &particles);
+            packingWriter.WritePacking("snapshot.xyzd", "snapshot_previous.xyzd", particles);
+            FillParticles(2.0, &particles);
+            packingWriter.Flush();
+
+            AssertPackingFile("snapshot.xyzd", 1.0, testName);
+            Assert::IsTrue(!Path::Exists("snapshot_previous.xyzd"), testName);
+        }
+
+        TearDown();
+    }
+
+    void AsyncPackingWriterTests::Destructor_WithQueuedSnapshots_SnapshotsWritten()
+    {
+        string testName = "Destructor_WithQueuedSnapshots_SnapshotsWritten";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        {
+            AsyncPackingWriter packingWriter(packingSerializer.get(), 2);
+            Packing particles;
+            FillParticles(1.0, &particles);
+            packingWriter.WritePacking("snapshot.xyzd", "snapshot_previous.xyzd", particles);
+            FillParticles(2.0, &particles);
+            packingWriter.WritePacking("snapshot.xyzd", "snapshot_previous.xyzd", particles);
+        }
+
+        AssertPackingFile("snapshot.xyzd", 2.0, testName);
+        AssertPackingFile("snapshot_previous.xyzd", 1.0, testName);
+
+        TearDown();
+    }
+
+    void AsyncPackingWriterTests::RunTests()
+    {
+        WritePacking_ForSeveralSnapshots_LastTwoSnapshotsWritten();
+        WritePacking_ParticlesChangedAfterQueuing_SnapshotNotChanged();
+        Destructor_WithQueuedSnapshots_SnapshotsWritten();
+    }
+}
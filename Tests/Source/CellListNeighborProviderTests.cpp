@@ -0,0 +1,223 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/CellListNeighborProviderTests.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include <vector>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Math.h"
+#include "Generation/PackingServices/DistanceServices/Headers/CellListNeighborProvider.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/PackingServices/Headers/GeometryCollisionService.h"
+#include "Generation/Geometries/Headers/BulkGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+using namespace PackingServices;
+
+namespace Tests
+{
+    boost::shared_ptr<MathService> CellListNeighborProviderTests::mathService;
+    boost::shared_ptr<GeometryService> CellListNeighborProviderTests::geometryService;
+    boost::shared_ptr<GeometryCollisionService> CellListNeighborProviderTests::geometryCollisionService;
+    boost::shared_ptr<CellListNeighborProvider> CellListNeighborProviderTests::neighborProvider;
+
+    boost::shared_ptr<IGeometry> CellListNeighborProviderTests::geometry;
+    boost::shared_ptr<SystemConfig> CellListNeighborProviderTests::config;
+    boost::shared_ptr<ModellingContext> CellListNeighborProviderTests::context;
+    Packing CellListNeighborProviderTests::particles;
+
+    void CellListNeighborProviderTests::SetUp()
+    {
+        mathService.reset(new MathService());
+        geometryService.reset(new GeometryService(mathService.get()));
+        geometryCollisionService.reset(new GeometryCollisionService());
+        neighborProvider.reset(new CellListNeighborProvider(geometryService.get(), geometryCollisionService.get()));
+
+        config.reset(new SystemConfig());
+        SpatialVector packingSize = REMOVE_LAST_DIMENSION_IF_NEEDED(10, 10, 10);
+        config->packingSize = packingSize;
+        config->particlesCount = 500;
+        config->boundariesMode = BoundariesMode::Bulk;
+
+        geometry.reset(new BulkGeometry(*config.get()));
+        context.reset(new ModellingContext(config.get(), geometry.get()));
+
+        mathService->SetContext(*context.get());
+        geometryService->SetContext(*context.get());
+        neighborProvider->SetContext(*context.get());
+
+        // Random (overlapping) particles, so that there are many intersecting pairs
+        Math::SetSeed(19);
+        particles.resize(config->particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                coordinates[i] = config->packingSize[i] * Math::GetNextRandom();
+            }
+            particles[particleIndex] = DomainParticle(particleIndex, 1.0, coordinates);
+        }
+
+        neighborProvider->SetParticles(particles);
+    }
+
+    void CellListNeighborProviderTests::TearDown()
+    {
+    }
+
+    void CellListNeighborProviderTests::MoveParticle(ParticleIndex particleIndex, const SpatialVector& coordinates)
+    {
+        neighborProvider->StartMove(particleIndex);
+        particles[particleIndex].coordinates = coordinates;
+        neighborProvider->EndMove();
+    }
+
+    void CellListNeighborProviderTests::AssertNeighborsCorrect(string callerName)
+    {
+        vector<bool> isNeighbor(config->particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            isNeighbor.assign(config->particlesCount, false);
+
+            ParticleIndex neighborsCount;
+            const ParticleIndex* neighborIndexes = neighborProvider->GetNeighborIndexes(particleIndex, &neighborsCount);
+            for (ParticleIndex i = 0; i < neighborsCount; ++i)
+            {
+                ParticleIndex neighborIndex = neighborIndexes[i];
+                Assert::IsTrue(neighborIndex != particleIndex, callerName + ": the particle is its own neighbor");
+                Assert::IsTrue(!isNeighbor[neighborIndex], callerName + ": duplicate neighbor");
+                isNeighbor[neighborIndex] = true;
+            }
+
+            for (ParticleIndex neighborIndex = 0; neighborIndex < config->particlesCount; ++neighborIndex)
+            {
+                bool intersects = neighborIndex != particleIndex && mathService->GetNormalizedDistanceSquare(particleIndex, neighborIndex, particles) < 1.0;
+                if (intersects)
+                {
+                    Assert::IsTrue(isNeighbor[neighborIndex], callerName + ": intersecting neighbor not found");
+                }
+            }
+
+            // The neighbors of the particle center are the same, but include the particle itself
+            ParticleIndex pointNeighborsCount;
+            const ParticleIndex* pointNeighborIndexes = neighborProvider->GetNeighborIndexes(particles[particleIndex].coordinates, &pointNeighborsCount);
+            Assert::AreEqual(pointNeighborsCount, neighborsCount + 1, callerName + ": different neighbors of the particle center");
+            for (ParticleIndex i = 0; i < pointNeighborsCount; ++i)
+            {
+                ParticleIndex neighborIndex = pointNeighborIndexes[i];
+                Assert::IsTrue(neighborIndex == particleIndex || isNeighbor[neighborIndex], callerName + ": different neighbors of the particle center");
+            }
+        }
+    }
+
+    void CellListNeighborProviderTests::AssertNeighborsEqualRebuiltNeighbors(string callerName)
+    {
+        CellListNeighborProvider rebuiltNeighborProvider(geometryService.get(), geometryCollisionService.get());
+        rebuiltNeighborProvider.SetContext(*context.get());
+        rebuiltNeighborProvider.SetParticles(particles);
+
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            ParticleIndex neighborsCount;
+            const ParticleIndex* neighborIndexes = neighborProvider->GetNeighborIndexes(particleIndex, &neighborsCount);
+            vector<ParticleIndex> actualNeighborIndexes(neighborIndexes, neighborIndexes + neighborsCount);
+
+            neighborIndexes = rebuiltNeighborProvider.GetNeighborIndexes(particleIndex, &neighborsCount);
+            vector<ParticleIndex> expectedNeighborIndexes(neighborIndexes, neighborIndexes + neighborsCount);
+
+            std::sort(actualNeighborIndexes.begin(), actualNeighborIndexes.end());
+            std::sort(expectedNeighborIndexes.begin(), expectedNeighborIndexes.end());
+            Assert::IsTrue(actualNeighborIndexes == expectedNeighborIndexes, callerName + ": neighbors differ from the rebuilt ones");
+        }
+    }
+
+    void CellListNeighborProviderTests::GetNeighborIndexes_ForRandomParticles_NeighborsCorrect()
+    {
+        string testName = "GetNeighborIndexes_ForRandomParticles_NeighborsCorrect";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        AssertNeighborsCorrect(testName);
+
+        TearDown();
+    }
+
+    void CellListNeighborProviderTests::GetNeighborIndexes_AfterMoves_NeighborsEqualRebuiltNeighbors()
+    {
+        string testName = "GetNeighborIndexes_AfterMoves_NeighborsEqualRebuiltNeighbors";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        // Short moves, so that the particles cross the cell boundaries, but the cell reserves are rarely exhausted
+        for (int move = 0; move < 5000; ++move)
+        {
+            ParticleIndex particleIndex = static_cast<ParticleIndex>(Math::GetNextRandom() * (config->particlesCount - 1));
+            SpatialVector coordinates;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                FLOAT_TYPE coordinate = particles[particleIndex].coordinates[i] + (Math::GetNextRandom() - 0.5);
+                coordinates[i] = coordinate - config->packingSize[i] * std::floor(coordinate / config->packingSize[i]);
+            }
+            MoveParticle(particleIndex, coordinates);
+        }
+
+        AssertNeighborsCorrect(testName);
+        AssertNeighborsEqualRebuiltNeighbors(testName);
+
+        TearDown();
+    }
+
+    void CellListNeighborProviderTests::GetNeighborIndexes_AfterMovesOverflowingCell_NeighborsEqualRebuiltNeighbors()
+    {
+        string testName = "GetNeighborIndexes_AfterMovesOverflowingCell_NeighborsEqualRebuiltNeighbors";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        // Gather many particles in a single cell, so that its reserve and the reserves of its neighbor cells are exhausted, and the particles are spread again
+        const int gatheredParticlesCount = 50;
+        for (ParticleIndex particleIndex = 0; particleIndex < gatheredParticlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                coordinates[i] = 5.1 + 0.8 * Math::GetNextRandom();
+            }
+            MoveParticle(particleIndex, coordinates);
+        }
+
+        AssertNeighborsCorrect(testName);
+        AssertNeighborsEqualRebuiltNeighbors(testName);
+
+        // Disperse the particles again, so that the gathered particles leave the cell
+        for (ParticleIndex particleIndex = 0; particleIndex < gatheredParticlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                coordinates[i] = config->packingSize[i] * Math::GetNextRandom();
+            }
+            MoveParticle(particleIndex, coordinates);
+        }
+
+        AssertNeighborsCorrect(testName);
+        AssertNeighborsEqualRebuiltNeighbors(testName);
+
+        TearDown();
+    }
+
+    void CellListNeighborProviderTests::RunTests()
+    {
+        GetNeighborIndexes_ForRandomParticles_NeighborsCorrect();
+        GetNeighborIndexes_AfterMoves_NeighborsEqualRebuiltNeighbors();
+        GetNeighborIndexes_AfterMovesOverflowingCell_NeighborsEqualRebuiltNeighbors();
+    }
+}
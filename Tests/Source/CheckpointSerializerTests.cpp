@@ -0,0 +1,315 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/CheckpointSerializerTests.h"
+
+#include <stdio.h>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/Path.h"
+#include "Core/Headers/ScopedFile.h"
+#include "Generation/Constants.h"
+#include "Generation/Geometries/Headers/BulkGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+#include "Generation/PackingServices/DistanceServices/Headers/CellListNeighborProvider.h"
+#include "Generation/PackingServices/DistanceServices/Headers/VerletListNeighborProvider.h"
+#include "Generation/PackingServices/DistanceServices/Headers/DistanceService.h"
+
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/PackingServices/Headers/GeometryCollisionService.h"
+
+#include "Generation/PackingGenerators/LubachevsckyStillinger/Headers/CheckpointSerializer.h"
+#include "Generation/PackingGenerators/LubachevsckyStillinger/Headers/LubachevsckyStillingerStep.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+using namespace PackingServices;
+using namespace PackingGenerators;
+
+namespace Tests
+{
+    boost::shared_ptr<CheckpointSerializer> CheckpointSerializerTests::checkpointSerializer;
+
+    boost::shared_ptr<MathService> CheckpointSerializerTests::mathService;
+    boost::shared_ptr<GeometryService> CheckpointSerializerTests::geometryService;
+    boost::shared_ptr<GeometryCollisionService> CheckpointSerializerTests::geometryCollisionService;
+    boost::shared_ptr<INeighborProvider> CheckpointSerializerTests::baseNeighborProvider;
+    boost::shared_ptr<INeighborProvider> CheckpointSerializerTests::neighborProvider;
+    boost::shared_ptr<DistanceService> CheckpointSerializerTests::distanceService;
+
+    boost::shared_ptr<IGeometry> CheckpointSerializerTests::geometry;
+    boost::shared_ptr<SystemConfig> CheckpointSerializerTests::config;
+    boost::shared_ptr<ModellingContext> CheckpointSerializerTests::context;
+    boost::shared_ptr<GenerationConfig> CheckpointSerializerTests::generationConfig;
+
+    const string CheckpointSerializerTests::checkpointFilePath = Generation::CHECKPOINT_FILE_NAME;
+    const int CheckpointSerializerTests::particlesPerSide = 8;
+
+    void CheckpointSerializerTests::SetUp()
+    {
+        checkpointSerializer.reset(new CheckpointSerializer());
+
+        mathService.reset(new MathService());
+        geometryService.reset(new GeometryService(mathService.get()));
+        geometryCollisionService.reset(new GeometryCollisionService());
+        baseNeighborProvider.reset(new CellListNeighborProvider(geometryService.get(), geometryCollisionService.get()));
+        neighborProvider.reset(new VerletListNeighborProvider(geometryService.get(), mathService.get(), baseNeighborProvider.get(), geometryCollisionService.get()));
+        distanceService.reset(new DistanceService(mathService.get(), geometryService.get(), neighborProvider.get()));
+
+        int particlesCount = 1;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            particlesCount *= particlesPerSide;
+        }
+
+        config.reset(new SystemConfig());
+        VectorUtilities::InitializeWith(&config->packingSize, particlesPerSide);
+        config->particlesCount = particlesCount;
+        config->boundariesMode = BoundariesMode::Bulk;
+
+        geometry.reset(new BulkGeometry(*config));
+        context.reset(new ModellingContext(config.get(), geometry.get()));
+
+        // The checkpoint is written to the current folder
+        generationConfig.reset(new GenerationConfig());
+        generationConfig->baseFolder = "";
+        generationConfig->contractionRate = 1e-2;
+        generationConfig->stepsToWrite = 1;
+        generationConfig->generationAlgorithm = PackingGenerationAlgorithm::LubachevskyStillingerSimple;
+
+        mathService->SetContext(*context);
+        geometryService->SetContext(*context);
+        baseNeighborProvider->SetContext(*context);
+        neighborProvider->SetContext(*context);
+        distanceService->SetContext(*context);
+
+        Path::DeleteFile(checkpointFilePath);
+    }
+
+    void CheckpointSerializerTests::TearDown()
+    {
+        Path::DeleteFile(checkpointFilePath);
+    }
+
+    boost::shared_ptr<LubachevsckyStillingerStep> CheckpointSerializerTests::CreateStep()
+    {
+        boost::shared_ptr<LubachevsckyStillingerStep> step(new LubachevsckyStillingerStep(geometryService.get(), neighborProvider.get(), distanceService.get(), mathService.get(), NULL, NULL));
+        step->writeCheckpoints = true;
+        step->SetContext(*context);
+        step->SetGenerationConfig(*generationConfig);
+        return step;
+    }
+
+    void CheckpointSerializerTests::FillJitteredLattice(Packing* particles)
+    {
+        Math::SetSeed(1);
+        particles->clear();
+        particles->resize(config->particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates;
+            int remainder = particleIndex;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                coordinates[i] = remainder % particlesPerSide + 0.5 + 0.2 * (Math::GetNextRandom() - 0.5);
+                remainder /= particlesPerSide;
+            }
+            (*particles)[particleIndex] = DomainParticle(particleIndex, 1.0, coordinates);
+        }
+    }
+
+    void CheckpointSerializerTests::FillCheckpoint(int particlesCount, LubachevsckyStillingerCheckpoint* checkpoint)
+    {
+        checkpoint->generationAlgorithm = PackingGenerationAlgorithm::LubachevskyStillingerEquilibrationBetweenCompressions;
+        checkpoint->lockParticles = true;
+        checkpoint->initialInnerDiameterRatio = 0.75;
+        checkpoint->ratioGrowthRate = 0.0;
+        checkpoint->growthRateUpdatesCount = 3;
+        checkpoint->equilibrationsCount = 5;
+        checkpoint->shouldContinue = true;
+        checkpoint->statistics.reducedPressure = 123.5;
+        checkpoint->statistics.exchangedMomentum = 17.25;
+        checkpoint->statistics.kineticEnergy = 1.5;
+        checkpoint->statistics.timePeriod = 0.125;
+        checkpoint->statistics.eventsCount = 4000;
+        checkpoint->statistics.collisionErrorsExisted = false;
+
+        Math::SetSeed(7);
+        checkpoint->particles.resize(particlesCount);
+        checkpoint->movingParticles.resize(particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < particlesCount; ++particleIndex)
+        {
+            DomainParticle& particle = checkpoint->particles[particleIndex];
+            MovingParticle& movingParticle = checkpoint->movingParticles[particleIndex];
+            particle.index = particleIndex;
+            particle.diameter = 1.0 + Math::GetNextRandom();
+            movingParticle.index = particleIndex;
+            movingParticle.diameter = particle.diameter;
+            movingParticle.lastEventTime = -Math::GetNextRandom();
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                particle.coordinates[i] = 10.0 * Math::GetNextRandom();
+                movingParticle.coordinates[i] = 10.0 * Math::GetNextRandom();
+                movingParticle.velocity[i] = Math::GetNextRandom() - 0.5;
+            }
+        }
+
+        // The spare Gaussian value is ready
+        Math::GetNextGaussianRandom(0.0, 1.0);
+        Math::FillRandomState(&checkpoint->randomState);
+    }
+
+    void CheckpointSerializerTests::WriteCheckpoint_ReadCheckpoint_StateIsPreserved()
+    {
+        string testName = "WriteCheckpoint_ReadCheckpoint_StateIsPreserved";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        // Several chunks of particles
+        const int particlesCount = 70000;
+        LubachevsckyStillingerCheckpoint expectedCheckpoint;
+        FillCheckpoint(particlesCount, &expectedCheckpoint);
+        FLOAT_TYPE expectedGaussianRandom = Math::GetNextGaussianRandom(0.0, 1.0);
+        FLOAT_TYPE expectedRandom = Math::GetNextRandom();
+
+        checkpointSerializer->WriteCheckpoint(checkpointFilePath, expectedCheckpoint);
+        LubachevsckyStillingerCheckpoint actualCheckpoint;
+        bool checkpointRead = checkpointSerializer->ReadCheckpoint(checkpointFilePath, &actualCheckpoint);
+
+        Assert::IsTrue(checkpointRead, testName);
+        Assert::AreEqual(actualCheckpoint.generationAlgorithm, expectedCheckpoint.generationAlgorithm, testName);
+        Assert::AreEqual(actualCheckpoint.lockParticles, expectedCheckpoint.lockParticles, testName);
+        Assert::AreEqual(actualCheckpoint.initialInnerDiameterRatio, expectedCheckpoint.initialInnerDiameterRatio, testName);
+        Assert::AreEqual(actualCheckpoint.ratioGrowthRate, expectedCheckpoint.ratioGrowthRate, testName);
+        Assert::AreEqual(actualCheckpoint.growthRateUpdatesCount, expectedCheckpoint.growthRateUpdatesCount, testName);
+        Assert::AreEqual(actualCheckpoint.equilibrationsCount, expectedCheckpoint.equilibrationsCount, testName);
+        Assert::AreEqual(actualCheckpoint.shouldContinue, expectedCheckpoint.shouldContinue, testName);
+        Assert::AreEqual(actualCheckpoint.statistics.reducedPressure, expectedCheckpoint.statistics.reducedPressure, testName);
+        Assert::AreEqual(actualCheckpoint.statistics.exchangedMomentum, expectedCheckpoint.statistics.exchangedMomentum, testName);
+        Assert::AreEqual(actualCheckpoint.statistics.kineticEnergy, expectedCheckpoint.statistics.kineticEnergy, testName);
+        Assert::AreEqual(actualCheckpoint.statistics.timePeriod, expectedCheckpoint.statistics.timePeriod, testName);
+        Assert::AreEqual(actualCheckpoint.statistics.eventsCount, expectedCheckpoint.statistics.eventsCount, testName);
+        Assert::AreEqual(static_cast<int>(actualCheckpoint.particles.size()), particlesCount, testName);
+        Assert::AreEqual(static_cast<int>(actualCheckpoint.movingParticles.size()), particlesCount, testName);
+
+        for (ParticleIndex particleIndex = 0; particleIndex < particlesCount; ++particleIndex)
+        {
+            const DomainParticle& actualParticle = actualCheckpoint.particles[particleIndex];
+            const MovingParticle& actualMovingParticle = actualCheckpoint.movingParticles[particleIndex];
+            const MovingParticle& expectedMovingParticle = expectedCheckpoint.movingParticles[particleIndex];
+            Assert::AreEqual(actualParticle.index, particleIndex, testName);
+            Assert::AreEqual(actualParticle.diameter, expectedCheckpoint.particles[particleIndex].diameter, testName);
+            Assert::IsTrue(actualParticle.coordinates == expectedCheckpoint.particles[particleIndex].coordinates, testName);
+            Assert::AreEqual(actualMovingParticle.diameter, expectedMovingParticle.diameter, testName);
+            Assert::AreEqual(actualMovingParticle.lastEventTime, expectedMovingParticle.lastEventTime, testName);
+            Assert::IsTrue(actualMovingParticle.coordinates == expectedMovingParticle.coordinates, testName);
+            Assert::IsTrue(actualMovingParticle.velocity == expectedMovingParticle.velocity, testName);
+        }
+
+        // The random sequence continues from the saved state, including the spare Gaussian value
+        Math::SetSeed(8);
+        Math::GetNextGaussianRandom(0.0, 1.0);
+        Math::SetRandomState(actualCheckpoint.randomState);
+        Assert::AreEqual(Math::GetNextGaussianRandom(0.0, 1.0), expectedGaussianRandom, testName);
+#ifndef WINDOWS
+        Assert::AreEqual(Math::GetNextRandom(), expectedRandom, testName);
+#endif
+
+        TearDown();
+    }
+
+    void CheckpointSerializerTests::ReadCheckpoint_ForTruncatedFile_ReturnsFalse()
+    {
+        string testName = "ReadCheckpoint_ForTruncatedFile_ReturnsFalse";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        LubachevsckyStillingerCheckpoint checkpoint;
+        FillCheckpoint(10, &checkpoint);
+        checkpointSerializer->WriteCheckpoint(checkpointFilePath, checkpoint);
+
+        // Drop the last particle
+        vector<char> bytes;
+        {
+            ScopedFile<ExceptionErrorHandler> file(checkpointFilePath, FileOpenMode::Read | FileOpenMode::Binary);
+            char byte;
+            while (fread(&byte, 1, 1, file) == 1)
+            {
+                bytes.push_back(byte);
+            }
+        }
+        {
+            ScopedFile<ExceptionErrorHandler> file(checkpointFilePath, FileOpenMode::Write | FileOpenMode::Binary);
+            fwrite(&bytes[0], 1, bytes.size() - sizeof(FLOAT_TYPE), file);
+        }
+
+        LubachevsckyStillingerCheckpoint actualCheckpoint;
+        Assert::IsTrue(!checkpointSerializer->ReadCheckpoint(checkpointFilePath, &actualCheckpoint), testName);
+        Assert::IsTrue(!checkpointSerializer->ReadCheckpoint("absent_checkpoint.bin", &actualCheckpoint), testName);
+
+        TearDown();
+    }
+
+    void CheckpointSerializerTests::SetParticles_WithCheckpoint_ContinuesAsUninterruptedRun()
+    {
+        string testName = "SetParticles_WithCheckpoint_ContinuesAsUninterruptedRun";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        const int blocksBeforeInterruption = 3;
+        const int blocksAfterInterruption = 3;
+
+        // Arrange
+        Packing expectedParticles;
+        FillJitteredLattice(&expectedParticles);
+        boost::shared_ptr<LubachevsckyStillingerStep> uninterruptedStep = CreateStep();
+        uninterruptedStep->SetParticles(&expectedParticles);
+        for (int block = 0; block < blocksBeforeInterruption + blocksAfterInterruption; ++block)
+        {
+            uninterruptedStep->DisplaceParticles();
+        }
+
+        // Act
+        Path::DeleteFile(checkpointFilePath);
+        Packing interruptedParticles;
+        FillJitteredLattice(&interruptedParticles);
+        boost::shared_ptr<LubachevsckyStillingerStep> interruptedStep = CreateStep();
+        interruptedStep->SetParticles(&interruptedParticles);
+        for (int block = 0; block < blocksBeforeInterruption; ++block)
+        {
+            interruptedStep->DisplaceParticles();
+        }
+        FLOAT_TYPE interruptedInnerDiameterRatio = interruptedStep->GetInnerDiameterRatio();
+
+        // The growth rate is taken from the checkpoint, not from the config
+        generationConfig->contractionRate = 5e-2;
+        Packing actualParticles = interruptedParticles;
+        boost::shared_ptr<LubachevsckyStillingerStep> resumedStep = CreateStep();
+        resumedStep->SetParticles(&actualParticles);
+        FLOAT_TYPE resumedInnerDiameterRatio = resumedStep->GetInnerDiameterRatio();
+        for (int block = 0; block < blocksAfterInterruption; ++block)
+        {
+            resumedStep->DisplaceParticles();
+        }
+
+        // Assert
+        // The event blocks include the neighbor transfer events, which depend on the rebuilt Verlet lists, so the trajectories are compared statistically
+        Assert::AreEqual(resumedInnerDiameterRatio, interruptedInnerDiameterRatio, testName);
+        Assert::AreAlmostEqual(resumedStep->GetInnerDiameterRatio(), uninterruptedStep->GetInnerDiameterRatio(), testName, 1e-2);
+        Assert::AreAlmostEqual(resumedStep->statistics.reducedPressure, uninterruptedStep->statistics.reducedPressure, testName, 0.1);
+
+        TearDown();
+    }
+
+    void CheckpointSerializerTests::RunTests()
+    {
+        WriteCheckpoint_ReadCheckpoint_StateIsPreserved();
+        ReadCheckpoint_ForTruncatedFile_ReturnsFalse();
+        SetParticles_WithCheckpoint_ContinuesAsUninterruptedRun();
+    }
+}
@@ -0,0 +1,120 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/CounterBasedRandomTests.h"
+
+#include <stdio.h>
+#include "../Headers/Assert.h"
+#include "Core/Headers/CounterBasedRandom.h"
+
+using namespace std;
+using namespace Core;
+
+namespace Tests
+{
+    // The known answers of Philox4x32-10 are from the Random123 library (kat_vectors)
+    void CounterBasedRandomTests::AssertKnownAnswer(const uint32_t* key, const uint32_t* counter, const uint32_t* expectedWords, string callerName)
+    {
+        CounterBasedRandom random(0);
+        random.SetKey(key[0], key[1]);
+
+        uint32_t words[CounterBasedRandom::WORDS_PER_BLOCK];
+        random.FillRandomWords(counter, words);
+
+        for (int i = 0; i < CounterBasedRandom::WORDS_PER_BLOCK; ++i)
+        {
+            Assert::AreEqual(words[i], expectedWords[i], callerName);
+        }
+    }
+
+    void CounterBasedRandomTests::FillRandomWords_ForZeroCounterAndKey_KnownAnswer()
+    {
+        string testName = "FillRandomWords_ForZeroCounterAndKey_KnownAnswer";
+        printf("%s\n", testName.c_str());
+
+        uint32_t key[2] = {0, 0};
+        uint32_t counter[CounterBasedRandom::WORDS_PER_BLOCK] = {0, 0, 0, 0};
+        uint32_t expectedWords[CounterBasedRandom::WORDS_PER_BLOCK] = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8};
+        AssertKnownAnswer(key, counter, expectedWords, testName);
+    }
+
+    void CounterBasedRandomTests::FillRandomWords_ForMaxCounterAndKey_KnownAnswer()
+    {
+        string testName = "FillRandomWords_ForMaxCounterAndKey_KnownAnswer";
+        printf("%s\n", testName.c_str());
+
+        uint32_t key[2] = {0xffffffff, 0xffffffff};
+        uint32_t counter[CounterBasedRandom::WORDS_PER_BLOCK] = {0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff};
+        uint32_t expectedWords[CounterBasedRandom::WORDS_PER_BLOCK] = {0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd};
+        AssertKnownAnswer(key, counter, expectedWords, testName);
+    }
+
+    void CounterBasedRandomTests::FillRandomWords_ForPiDigitsCounterAndKey_KnownAnswer()
+    {
+        string testName = "FillRandomWords_ForPiDigitsCounterAndKey_KnownAnswer";
+        printf("%s\n", testName.c_str());
+
+        uint32_t key[2] = {0xa4093822, 0x299f31d0};
+        uint32_t counter[CounterBasedRandom::WORDS_PER_BLOCK] = {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344};
+        uint32_t expectedWords[CounterBasedRandom::WORDS_PER_BLOCK] = {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1};
+        AssertKnownAnswer(key, counter, expectedWords, testName);
+    }
+
+    void CounterBasedRandomTests::FillRandoms_ForSameStreamAndBlock_SameValuesInUnitInterval()
+    {
+        string testName = "FillRandoms_ForSameStreamAndBlock_SameValuesInUnitInterval";
+        printf("%s\n", testName.c_str());
+
+        CounterBasedRandom firstRandom(23);
+        CounterBasedRandom secondRandom(23);
+
+        for (uint64_t streamIndex = 0; streamIndex < 1000; ++streamIndex)
+        {
+            FLOAT_TYPE firstValues[CounterBasedRandom::VALUES_PER_BLOCK];
+            FLOAT_TYPE secondValues[CounterBasedRandom::VALUES_PER_BLOCK];
+            firstRandom.FillRandoms(streamIndex, 3, firstValues);
+            // Other blocks drawn in between do not change the values
+            secondRandom.FillRandoms(streamIndex, 2, secondValues);
+            secondRandom.FillRandoms(streamIndex, 3, secondValues);
+
+            for (int i = 0; i < CounterBasedRandom::VALUES_PER_BLOCK; ++i)
+            {
+                Assert::AreEqual(secondValues[i], firstValues[i], testName);
+                Assert::IsTrue(firstValues[i] >= 0.0 && firstValues[i] < 1.0, testName);
+            }
+        }
+    }
+
+    void CounterBasedRandomTests::FillRandoms_ForDifferentStreamsAndBlocks_DifferentValues()
+    {
+        string testName = "FillRandoms_ForDifferentStreamsAndBlocks_DifferentValues";
+        printf("%s\n", testName.c_str());
+
+        CounterBasedRandom random(29);
+        FLOAT_TYPE values[CounterBasedRandom::VALUES_PER_BLOCK];
+        FLOAT_TYPE otherStreamValues[CounterBasedRandom::VALUES_PER_BLOCK];
+        FLOAT_TYPE otherBlockValues[CounterBasedRandom::VALUES_PER_BLOCK];
+
+        // Stream indexes differing in the high word only
+        uint64_t streamIndex = 5;
+        random.FillRandoms(streamIndex, 0, values);
+        random.FillRandoms(streamIndex + (static_cast<uint64_t>(1) << 32), 0, otherStreamValues);
+        random.FillRandoms(streamIndex, 1, otherBlockValues);
+
+        for (int i = 0; i < CounterBasedRandom::VALUES_PER_BLOCK; ++i)
+        {
+            Assert::IsTrue(values[i] != otherStreamValues[i], testName);
+            Assert::IsTrue(values[i] != otherBlockValues[i], testName);
+        }
+    }
+
+    void CounterBasedRandomTests::RunTests()
+    {
+        FillRandomWords_ForZeroCounterAndKey_KnownAnswer();
+        FillRandomWords_ForMaxCounterAndKey_KnownAnswer();
+        FillRandomWords_ForPiDigitsCounterAndKey_KnownAnswer();
+        FillRandoms_ForSameStreamAndBlock_SameValuesInUnitInterval();
+        FillRandoms_ForDifferentStreamsAndBlocks_DifferentValues();
+    }
+}
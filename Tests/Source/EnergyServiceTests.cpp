@@ -0,0 +1,273 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/EnergyServiceTests.h"
+
+#include <stdio.h>
+#include <vector>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/VectorUtilities.h"
+#include "Generation/PackingServices/EnergyServices/Headers/EnergyService.h"
+#include "Generation/PackingServices/EnergyServices/Headers/BezrukovPotential.h"
+#include "Generation/PackingServices/EnergyServices/Headers/HarmonicPotential.h"
+#include "Generation/PackingServices/DistanceServices/Headers/CellListNeighborProvider.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/PackingServices/Headers/GeometryCollisionService.h"
+#include "Generation/Geometries/Headers/BulkGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+using namespace PackingServices;
+
+namespace Tests
+{
+    // Forwards the calls to another potential. EnergyService does not recognize it as a built-in potential, so it calls its virtual functions.
+    class ForwardingPairPotential : public virtual IPairPotential
+    {
+    private:
+        const IPairPotential* pairPotential;
+
+    public:
+        explicit ForwardingPairPotential(const IPairPotential* pairPotential)
+        {
+            this->pairPotential = pairPotential;
+        }
+
+        OVERRIDE Nullable<FLOAT_TYPE> GetEnergy(FLOAT_TYPE firstParticleDiameter, FLOAT_TYPE secondParticleDiameter, FLOAT_TYPE distance) const
+        {
+            return pairPotential->GetEnergy(firstParticleDiameter, secondParticleDiameter, distance);
+        }
+
+        OVERRIDE Nullable<FLOAT_TYPE> GetRepulsionForceFromNeighbor(FLOAT_TYPE particleDiameter, FLOAT_TYPE neighborDiameter, FLOAT_TYPE distance) const
+        {
+            return pairPotential->GetRepulsionForceFromNeighbor(particleDiameter, neighborDiameter, distance);
+        }
+    };
+
+    boost::shared_ptr<MathService> EnergyServiceTests::mathService;
+    boost::shared_ptr<GeometryService> EnergyServiceTests::geometryService;
+    boost::shared_ptr<GeometryCollisionService> EnergyServiceTests::geometryCollisionService;
+    boost::shared_ptr<CellListNeighborProvider> EnergyServiceTests::neighborProvider;
+    boost::shared_ptr<EnergyService> EnergyServiceTests::energyService;
+    boost::shared_ptr<BezrukovPotential> EnergyServiceTests::pairPotential;
+
+    boost::shared_ptr<IGeometry> EnergyServiceTests::geometry;
+    boost::shared_ptr<SystemConfig> EnergyServiceTests::config;
+    boost::shared_ptr<ModellingContext> EnergyServiceTests::context;
+    Packing EnergyServiceTests::particles;
+
+    void EnergyServiceTests::SetUp(int threadsCount)
+    {
+        mathService.reset(new MathService());
+        geometryService.reset(new GeometryService(mathService.get()));
+        geometryCollisionService.reset(new GeometryCollisionService());
+        neighborProvider.reset(new CellListNeighborProvider(geometryService.get(), geometryCollisionService.get()));
+        energyService.reset(new EnergyService(mathService.get(), neighborProvider.get()));
+        energyService->threadsCount = threadsCount;
+        pairPotential.reset(new BezrukovPotential());
+
+        config.reset(new SystemConfig());
+        SpatialVector packingSize = REMOVE_LAST_DIMENSION_IF_NEEDED(10, 10, 10);
+        config->packingSize = packingSize;
+        config->particlesCount = 1000;
+        config->boundariesMode = BoundariesMode::Bulk;
+
+        geometry.reset(new BulkGeometry(*config.get()));
+        context.reset(new ModellingContext(config.get(), geometry.get()));
+
+        geometryService->SetContext(*context.get());
+        energyService->SetContext(*context.get());
+
+        // Random (overlapping) polydisperse particles, so that there are many repulsing pairs
+        Math::SetSeed(29);
+        particles.resize(config->particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                coordinates[i] = config->packingSize[i] * Math::GetNextRandom();
+            }
+            FLOAT_TYPE diameter = 0.5 + Math::GetNextRandom();
+            particles[particleIndex] = DomainParticle(particleIndex, diameter, coordinates);
+        }
+
+        energyService->SetParticles(particles);
+    }
+
+    void EnergyServiceTests::TearDown()
+    {
+    }
+
+    void EnergyServiceTests::AssertForcesSameAsNaive(string callerName)
+    {
+        const FLOAT_TYPE contractionRatio = 1.0;
+        vector<SpatialVector> particleForces(config->particlesCount);
+        ParticlePair closestPair = energyService->FillParticleForces(contractionRatio, *pairPotential, &particleForces);
+
+        ParticlePair expectedClosestPair = geometryService->GetMinNormalizedDistanceNaive(particles);
+        Assert::AreAlmostEqual(closestPair.normalizedDistanceSquare, expectedClosestPair.normalizedDistanceSquare, callerName, 1e-12);
+
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            const DomainParticle& particle = particles[particleIndex];
+            SpatialVector expectedForce;
+            VectorUtilities::InitializeWith(&expectedForce, 0.0);
+
+            for (ParticleIndex neighborIndex = 0; neighborIndex < config->particlesCount; ++neighborIndex)
+            {
+                if (neighborIndex == particleIndex)
+                {
+                    continue;
+                }
+
+                const DomainParticle& neighbor = particles[neighborIndex];
+                SpatialVector difference;
+                mathService->FillDistance(neighbor.coordinates, particle.coordinates, &difference);
+                FLOAT_TYPE distance = VectorUtilities::GetLength(difference);
+
+                Nullable<FLOAT_TYPE> forceLength = pairPotential->GetRepulsionForceFromNeighbor(particle.diameter, neighbor.diameter, distance * contractionRatio);
+                if (forceLength.hasValue)
+                {
+                    SpatialVector neighborForce;
+                    VectorUtilities::MultiplyByValue(difference, - forceLength.value / distance, &neighborForce);
+                    VectorUtilities::Add(expectedForce, neighborForce, &expectedForce);
+                }
+            }
+
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                Assert::AreAlmostEqual(particleForces[particleIndex][i], expectedForce[i], callerName, 1e-10);
+            }
+        }
+    }
+
+    void EnergyServiceTests::FillParticleForces_ForSingleThread_SameAsNaive()
+    {
+        string testName = "FillParticleForces_ForSingleThread_SameAsNaive";
+        printf("%s\n", testName.c_str());
+        SetUp(1);
+
+        AssertForcesSameAsNaive(testName);
+
+        TearDown();
+    }
+
+    void EnergyServiceTests::FillParticleForces_ForSeveralThreads_SameAsNaive()
+    {
+        string testName = "FillParticleForces_ForSeveralThreads_SameAsNaive";
+        printf("%s\n", testName.c_str());
+        SetUp(3);
+
+        AssertForcesSameAsNaive(testName);
+        // Buffers from the previous call should not affect the result
+        AssertForcesSameAsNaive(testName);
+
+        TearDown();
+    }
+
+    void EnergyServiceTests::FillParticleForces_ForBuiltInPotential_SameAsForVirtualCalls()
+    {
+        string testName = "FillParticleForces_ForBuiltInPotential_SameAsForVirtualCalls";
+        printf("%s\n", testName.c_str());
+        // The cell list provider reorders neighbors on each call, so the set up is repeated to sum the forces in the same order
+        SetUp(1);
+        ForwardingPairPotential forwardingPotential(pairPotential.get());
+        vector<SpatialVector> expectedParticleForces(config->particlesCount);
+        energyService->FillParticleForces(0.9, forwardingPotential, &expectedParticleForces);
+
+        SetUp(1);
+        vector<SpatialVector> particleForces(config->particlesCount);
+        energyService->FillParticleForces(0.9, *pairPotential, &particleForces);
+
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            Assert::AreVectorsEqual(particleForces[particleIndex], expectedParticleForces[particleIndex], testName);
+        }
+
+        TearDown();
+    }
+
+    void EnergyServiceTests::FillParticleForces_ForDifferentPartsCounts_ExactlySame()
+    {
+        string testName = "FillParticleForces_ForDifferentPartsCounts_ExactlySame";
+        printf("%s\n", testName.c_str());
+        SetUp(1);
+        energyService->forcePartsCount = 1;
+        vector<SpatialVector> expectedParticleForces(config->particlesCount);
+        ParticlePair expectedClosestPair = energyService->FillParticleForces(0.9, *pairPotential, &expectedParticleForces);
+
+        SetUp(3);
+        energyService->forcePartsCount = 7;
+        vector<SpatialVector> particleForces(config->particlesCount);
+        ParticlePair closestPair = energyService->FillParticleForces(0.9, *pairPotential, &particleForces);
+
+        // The forces of each particle are summed in the same order of pairs, so they are exactly equal
+        Assert::AreEqual(closestPair.normalizedDistanceSquare, expectedClosestPair.normalizedDistanceSquare, testName);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            Assert::AreVectorsEqual(particleForces[particleIndex], expectedParticleForces[particleIndex], testName);
+        }
+
+        TearDown();
+    }
+
+    void EnergyServiceTests::GetContractionEnergies_ForBuiltInPotentials_SameAsForVirtualCalls()
+    {
+        string testName = "GetContractionEnergies_ForBuiltInPotentials_SameAsForVirtualCalls";
+        printf("%s\n", testName.c_str());
+        HarmonicPotential zeroPotential(0.0);
+        HarmonicPotential harmonicPotential(2.0);
+        HarmonicPotential powerPotential(2.5);
+        ForwardingPairPotential forwardingZeroPotential(&zeroPotential);
+        ForwardingPairPotential forwardingHarmonicPotential(&harmonicPotential);
+        ForwardingPairPotential forwardingPowerPotential(&powerPotential);
+
+        vector<FLOAT_TYPE> contractionRatios;
+        vector<const IPairPotential*> pairPotentials;
+        vector<const IPairPotential*> forwardingPairPotentials;
+        FLOAT_TYPE ratios[] = {0.9, 1.0};
+        for (int i = 0; i < 2; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                contractionRatios.push_back(ratios[i]);
+            }
+            pairPotentials.push_back(&zeroPotential);
+            pairPotentials.push_back(&harmonicPotential);
+            pairPotentials.push_back(&powerPotential);
+            forwardingPairPotentials.push_back(&forwardingZeroPotential);
+            forwardingPairPotentials.push_back(&forwardingHarmonicPotential);
+            forwardingPairPotentials.push_back(&forwardingPowerPotential);
+        }
+
+        SetUp(1);
+        energyService->SetPotentialNormalizer(1.0);
+        IEnergyService::EnergiesResult expectedResult = energyService->GetContractionEnergies(contractionRatios, forwardingPairPotentials);
+
+        SetUp(1);
+        energyService->SetPotentialNormalizer(1.0);
+        IEnergyService::EnergiesResult result = energyService->GetContractionEnergies(contractionRatios, pairPotentials);
+
+        Assert::AreVectorsEqual(result.contractionEnergies, expectedResult.contractionEnergies, testName);
+        Assert::AreVectorsEqual(result.nonRattlersCounts, expectedResult.nonRattlersCounts, testName);
+        Assert::IsGreaterThanZero(result.contractionEnergies[1], testName);
+
+        TearDown();
+    }
+
+    void EnergyServiceTests::RunTests()
+    {
+        FillParticleForces_ForSingleThread_SameAsNaive();
+        FillParticleForces_ForSeveralThreads_SameAsNaive();
+        FillParticleForces_ForBuiltInPotential_SameAsForVirtualCalls();
+        FillParticleForces_ForDifferentPartsCounts_ExactlySame();
+        GetContractionEnergies_ForBuiltInPotentials_SameAsForVirtualCalls();
+    }
+}
@@ -0,0 +1,146 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/FastFourierTransformTests.h"
+
+#include <stdio.h>
+#include <cmath>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/Constants.h"
+#include "Core/Headers/FastFourierTransform.h"
+
+using namespace std;
+using namespace Core;
+
+namespace Tests
+{
+    void FastFourierTransformTests::FillRandomValues(int size, vector<complex<FLOAT_TYPE> >* values)
+    {
+        Math::SetSeed(59);
+        values->resize(size);
+        for (int i = 0; i < size; ++i)
+        {
+            values->at(i) = complex<FLOAT_TYPE>(Math::GetNextRandom() - 0.5, Math::GetNextRandom() - 0.5);
+        }
+    }
+
+    void FastFourierTransformTests::AssertSameAsNaive(int size, bool inverse, string callerName)
+    {
+        vector<complex<FLOAT_TYPE> > values;
+        FillRandomValues(size, &values);
+
+        vector<complex<FLOAT_TYPE> > actualValues(size);
+        FastFourierTransform transform(size);
+        transform.Transform(&values[0], 1, &actualValues[0], inverse);
+
+        FLOAT_TYPE sign = inverse ? 1.0 : -1.0;
+        for (int k = 0; k < size; ++k)
+        {
+            complex<FLOAT_TYPE> expectedValue(0.0, 0.0);
+            for (int j = 0; j < size; ++j)
+            {
+                FLOAT_TYPE phase = sign * 2.0 * PI * static_cast<FLOAT_TYPE>((static_cast<long long>(j) * k) % size) / size;
+                expectedValue += values[j] * complex<FLOAT_TYPE>(cos(phase), sin(phase));
+            }
+            Assert::IsTrue(std::abs(actualValues[k] - expectedValue) < 1e-10 * size, callerName);
+        }
+    }
+
+    void FastFourierTransformTests::Transform_ForPowerOfTwo_SameAsNaive()
+    {
+        string testName = "Transform_ForPowerOfTwo_SameAsNaive";
+        printf("%s\n", testName.c_str());
+
+        AssertSameAsNaive(1, false, testName);
+        AssertSameAsNaive(2, false, testName);
+        AssertSameAsNaive(64, false, testName);
+    }
+
+    void FastFourierTransformTests::Transform_ForMixedRadix_SameAsNaive()
+    {
+        string testName = "Transform_ForMixedRadix_SameAsNaive";
+        printf("%s\n", testName.c_str());
+
+        AssertSameAsNaive(12, false, testName);
+        AssertSameAsNaive(90, false, testName);
+    }
+
+    void FastFourierTransformTests::Transform_ForLargePrimeFactors_SameAsNaive()
+    {
+        string testName = "Transform_ForLargePrimeFactors_SameAsNaive";
+        printf("%s\n", testName.c_str());
+
+        AssertSameAsNaive(7, false, testName);
+        AssertSameAsNaive(2 * 11 * 13, false, testName);
+    }
+
+    void FastFourierTransformTests::Transform_Inverse_SameAsNaive()
+    {
+        string testName = "Transform_Inverse_SameAsNaive";
+        printf("%s\n", testName.c_str());
+
+        AssertSameAsNaive(60, true, testName);
+        AssertSameAsNaive(77, true, testName);
+    }
+
+    void FastFourierTransformTests::TransformMultidimensional_ForMixedSizes_SameAsNaive()
+    {
+        string testName = "TransformMultidimensional_ForMixedSizes_SameAsNaive";
+        printf("%s\n", testName.c_str());
+
+        DiscreteSpatialVector sizes = REMOVE_LAST_DIMENSION_IF_NEEDED(4, 6, 5);
+        int totalSize = 1;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            totalSize *= sizes[i];
+        }
+
+        vector<complex<FLOAT_TYPE> > values;
+        FillRandomValues(totalSize, &values);
+        vector<complex<FLOAT_TYPE> > actualValues = values;
+        FastFourierTransform::TransformMultidimensional(sizes, &actualValues, false);
+
+        for (int k = 0; k < totalSize; ++k)
+        {
+            complex<FLOAT_TYPE> expectedValue(0.0, 0.0);
+            for (int j = 0; j < totalSize; ++j)
+            {
+                FLOAT_TYPE phase = 0.0;
+                int kRemainder = k;
+                int jRemainder = j;
+                for (int i = 0; i < DIMENSIONS; ++i)
+                {
+                    phase -= 2.0 * PI * (kRemainder % sizes[i]) * (jRemainder % sizes[i]) / sizes[i];
+                    kRemainder /= sizes[i];
+                    jRemainder /= sizes[i];
+                }
+                expectedValue += values[j] * complex<FLOAT_TYPE>(cos(phase), sin(phase));
+            }
+            Assert::IsTrue(std::abs(actualValues[k] - expectedValue) < 1e-10 * totalSize, testName);
+        }
+    }
+
+    void FastFourierTransformTests::GetNextFastSize_ForSeveralSizes_SmallPrimeFactorsOnly()
+    {
+        string testName = "GetNextFastSize_ForSeveralSizes_SmallPrimeFactorsOnly";
+        printf("%s\n", testName.c_str());
+
+        Assert::AreEqual(FastFourierTransform::GetNextFastSize(0), 1, testName);
+        Assert::AreEqual(FastFourierTransform::GetNextFastSize(7), 8, testName);
+        Assert::AreEqual(FastFourierTransform::GetNextFastSize(11), 12, testName);
+        Assert::AreEqual(FastFourierTransform::GetNextFastSize(61), 64, testName);
+        Assert::AreEqual(FastFourierTransform::GetNextFastSize(97), 100, testName);
+    }
+
+    void FastFourierTransformTests::RunTests()
+    {
+        Transform_ForPowerOfTwo_SameAsNaive();
+        Transform_ForMixedRadix_SameAsNaive();
+        Transform_ForLargePrimeFactors_SameAsNaive();
+        Transform_Inverse_SameAsNaive();
+        TransformMultidimensional_ForMixedSizes_SameAsNaive();
+        GetNextFastSize_ForSeveralSizes_SmallPrimeFactorsOnly();
+    }
+}
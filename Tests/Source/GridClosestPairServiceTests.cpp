@@ -0,0 +1,146 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/GridClosestPairServiceTests.h"
+
+#include <stdio.h>
+#include "../Headers/Assert.h"
+#include "../Headers/PackingTestUtilities.h"
+#include "Core/Headers/Math.h"
+#include "Generation/PackingServices/DistanceServices/Headers/GridClosestPairService.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/Geometries/Headers/BulkGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+using namespace PackingServices;
+
+namespace Tests
+{
+    boost::shared_ptr<MathService> GridClosestPairServiceTests::mathService;
+    boost::shared_ptr<GeometryService> GridClosestPairServiceTests::geometryService;
+    boost::shared_ptr<GridClosestPairService> GridClosestPairServiceTests::closestPairService;
+
+    boost::shared_ptr<IGeometry> GridClosestPairServiceTests::geometry;
+    boost::shared_ptr<SystemConfig> GridClosestPairServiceTests::config;
+    boost::shared_ptr<ModellingContext> GridClosestPairServiceTests::context;
+    Packing GridClosestPairServiceTests::particles;
+
+    void GridClosestPairServiceTests::SetUp(int particlesCount, FLOAT_TYPE boxSize)
+    {
+        mathService.reset(new MathService());
+        geometryService.reset(new GeometryService(mathService.get()));
+        closestPairService.reset(new GridClosestPairService(mathService.get(), geometryService.get(), 3));
+
+        config.reset(new SystemConfig());
+        SpatialVector packingSize = REMOVE_LAST_DIMENSION_IF_NEEDED(boxSize, boxSize, boxSize);
+        config->packingSize = packingSize;
+        config->particlesCount = particlesCount;
+        config->boundariesMode = BoundariesMode::Bulk;
+
+        geometry.reset(new BulkGeometry(*config.get()));
+        context.reset(new ModellingContext(config.get(), geometry.get()));
+
+        mathService->SetContext(*context.get());
+        closestPairService->SetContext(*context.get());
+
+        particles.resize(config->particlesCount);
+    }
+
+    void GridClosestPairServiceTests::TearDown()
+    {
+    }
+
+    void GridClosestPairServiceTests::AssertSameAsNaive(string callerName)
+    {
+        ParticlePair expectedPair = geometryService->GetMinNormalizedDistanceNaive(particles);
+        ParticlePair actualPair = closestPairService->FindClosestPair(particles);
+
+        Assert::AreEqual(actualPair.firstParticleIndex, expectedPair.firstParticleIndex, callerName);
+        Assert::AreEqual(actualPair.secondParticleIndex, expectedPair.secondParticleIndex, callerName);
+        Assert::AreEqual(actualPair.normalizedDistanceSquare, expectedPair.normalizedDistanceSquare, callerName);
+    }
+
+    void GridClosestPairServiceTests::FindClosestPair_ForDensePolydispersePacking_SameAsNaive()
+    {
+        string testName = "FindClosestPair_ForDensePolydispersePacking_SameAsNaive";
+        printf("%s\n", testName.c_str());
+        SetUp(2000, 10.0);
+        PackingTestUtilities::FillRandomParticles(*config, 31, 0.2, 2.0, &particles);
+
+        AssertSameAsNaive(testName);
+
+        TearDown();
+    }
+
+    void GridClosestPairServiceTests::FindClosestPair_ForDilutePacking_SameAsNaive()
+    {
+        string testName = "FindClosestPair_ForDilutePacking_SameAsNaive";
+        printf("%s\n", testName.c_str());
+
+        // The closest pair is much farther than the max diameter, so the cell size is increased several times
+        SetUp(20, 10.0);
+        PackingTestUtilities::FillRandomParticles(*config, 31, 0.01, 0.05, &particles);
+
+        AssertSameAsNaive(testName);
+
+        TearDown();
+    }
+
+    void GridClosestPairServiceTests::FindClosestPair_ForCubicLatticeWithEqualDistances_SameAsNaive()
+    {
+        string testName = "FindClosestPair_ForCubicLatticeWithEqualDistances_SameAsNaive";
+        printf("%s\n", testName.c_str());
+
+        const int particlesPerSide = 6;
+        int particlesCount = 1;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            particlesCount *= particlesPerSide;
+        }
+        SetUp(particlesCount, particlesPerSide);
+
+        // All the nearest neighbors are exactly at the same distance, so the pair with the smallest indexes should be chosen.
+        // Indexes are shuffled, so that the spatial order differs from the index order.
+        vector<ParticleIndex> indexes(particlesCount);
+        for (ParticleIndex i = 0; i < particlesCount; ++i)
+        {
+            indexes[i] = i;
+        }
+        Math::SetSeed(37);
+        for (ParticleIndex i = particlesCount - 1; i > 0; --i)
+        {
+            ParticleIndex j = static_cast<ParticleIndex>(Math::GetNextRandom() * i);
+            std::swap(indexes[i], indexes[j]);
+        }
+
+        for (ParticleIndex latticeIndex = 0; latticeIndex < particlesCount; ++latticeIndex)
+        {
+            SpatialVector coordinates;
+            int remainder = latticeIndex;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                coordinates[i] = remainder % particlesPerSide + 0.5;
+                remainder /= particlesPerSide;
+            }
+            ParticleIndex particleIndex = indexes[latticeIndex];
+            particles[particleIndex] = DomainParticle(particleIndex, 1.0, coordinates);
+        }
+
+        AssertSameAsNaive(testName);
+
+        TearDown();
+    }
+
+    void GridClosestPairServiceTests::RunTests()
+    {
+        FindClosestPair_ForDensePolydispersePacking_SameAsNaive();
+        FindClosestPair_ForDilutePacking_SameAsNaive();
+        FindClosestPair_ForCubicLatticeWithEqualDistances_SameAsNaive();
+    }
+}
@@ -0,0 +1,218 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/GriddedStructureFactorServiceTests.h"
+
+#include <stdio.h>
+#include <cmath>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/Constants.h"
+#include "Generation/PackingServices/PostProcessing/Headers/GriddedStructureFactorService.h"
+#include "Generation/PackingServices/DistanceServices/Headers/DistanceService.h"
+#include "Generation/PackingServices/DistanceServices/Headers/CellListNeighborProvider.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/PackingServices/Headers/GeometryCollisionService.h"
+#include "Generation/Geometries/Headers/BulkGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+using namespace PackingServices;
+
+namespace Tests
+{
+    boost::shared_ptr<MathService> GriddedStructureFactorServiceTests::mathService;
+    boost::shared_ptr<GeometryService> GriddedStructureFactorServiceTests::geometryService;
+    boost::shared_ptr<GeometryCollisionService> GriddedStructureFactorServiceTests::geometryCollisionService;
+    boost::shared_ptr<CellListNeighborProvider> GriddedStructureFactorServiceTests::neighborProvider;
+    boost::shared_ptr<DistanceService> GriddedStructureFactorServiceTests::distanceService;
+    boost::shared_ptr<GriddedStructureFactorService> GriddedStructureFactorServiceTests::structureFactorService;
+
+    boost::shared_ptr<IGeometry> GriddedStructureFactorServiceTests::geometry;
+    boost::shared_ptr<SystemConfig> GriddedStructureFactorServiceTests::config;
+    boost::shared_ptr<ModellingContext> GriddedStructureFactorServiceTests::context;
+    Packing GriddedStructureFactorServiceTests::particles;
+
+    void GriddedStructureFactorServiceTests::SetUp(int particlesCount, FLOAT_TYPE boxSize)
+    {
+        mathService.reset(new MathService());
+        geometryService.reset(new GeometryService(mathService.get()));
+        geometryCollisionService.reset(new GeometryCollisionService());
+        neighborProvider.reset(new CellListNeighborProvider(geometryService.get(), geometryCollisionService.get()));
+        distanceService.reset(new DistanceService(mathService.get(), geometryService.get(), neighborProvider.get()));
+        structureFactorService.reset(new GriddedStructureFactorService());
+
+        config.reset(new SystemConfig());
+        SpatialVector packingSize = REMOVE_LAST_DIMENSION_IF_NEEDED(boxSize, boxSize, boxSize);
+        config->packingSize = packingSize;
+        config->particlesCount = particlesCount;
+        config->boundariesMode = BoundariesMode::Bulk;
+
+        geometry.reset(new BulkGeometry(*config.get()));
+        context.reset(new ModellingContext(config.get(), geometry.get()));
+
+        distanceService->SetContext(*context.get());
+        structureFactorService->SetContext(*context.get());
+
+        particles.resize(config->particlesCount);
+    }
+
+    void GriddedStructureFactorServiceTests::TearDown()
+    {
+    }
+
+    void GriddedStructureFactorServiceTests::FillRandomParticles()
+    {
+        Math::SetSeed(61);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                // Some particles lie slightly outside the box
+                coordinates[i] = config->packingSize[i] * (1.02 * Math::GetNextRandom() - 0.01);
+            }
+            particles[particleIndex] = DomainParticle(particleIndex, 1.0, coordinates);
+        }
+    }
+
+    void GriddedStructureFactorServiceTests::FillStructureFactor_ForRandomPacking_SameAsDirectSum()
+    {
+        string testName = "FillStructureFactor_ForRandomPacking_SameAsDirectSum";
+        printf("%s\n", testName.c_str());
+        SetUp(500, 8.0);
+        FillRandomParticles();
+
+        vector<SpatialVector> waveVectors;
+        vector<FLOAT_TYPE> actualValues;
+        structureFactorService->FillStructureFactor(particles, 8.0, &waveVectors, &actualValues);
+
+        vector<FLOAT_TYPE> expectedValues;
+        distanceService->FillStructureFactorForWaveVectors(*config, particles, waveVectors, &expectedValues);
+
+        // All the commensurate wave vectors with 0 < |k| <= 8, i.e. 0 < |m| <= 8 * 8 / (2 pi)
+        int expectedVectorsCount = 0;
+        FLOAT_TYPE maxIndexLength = 8.0 * 8.0 / (2.0 * PI);
+        int maxIndex = static_cast<int>(maxIndexLength);
+        for (int i = -maxIndex; i <= maxIndex; ++i)
+        {
+            for (int j = -maxIndex; j <= maxIndex; ++j)
+            {
+                for (int k = -maxIndex; k <= maxIndex; ++k)
+                {
+                    int indexLengthSquare = i * i + j * j + k * k;
+                    if (indexLengthSquare > 0 && indexLengthSquare <= maxIndexLength * maxIndexLength)
+                    {
+                        expectedVectorsCount++;
+                    }
+                }
+            }
+        }
+
+        Assert::AreEqual(static_cast<int>(waveVectors.size()), expectedVectorsCount, testName);
+        for (size_t i = 0; i < waveVectors.size(); ++i)
+        {
+            // The structure factor of a random packing is about one. The largest error is at the largest wave vectors
+            Assert::IsTrue(std::abs(actualValues[i] - expectedValues[i]) < 1e-3, testName);
+        }
+
+        TearDown();
+    }
+
+    void GriddedStructureFactorServiceTests::FillStructureFactor_ForCubicLattice_PeaksAtReciprocalLattice()
+    {
+        string testName = "FillStructureFactor_ForCubicLattice_PeaksAtReciprocalLattice";
+        printf("%s\n", testName.c_str());
+
+        const int particlesPerSide = 4;
+        SetUp(particlesPerSide * particlesPerSide * particlesPerSide, particlesPerSide * 1.5);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates;
+            int remainder = particleIndex;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                coordinates[i] = (remainder % particlesPerSide + 0.3) * 1.5;
+                remainder /= particlesPerSide;
+            }
+            particles[particleIndex] = DomainParticle(particleIndex, 1.0, coordinates);
+        }
+
+        vector<SpatialVector> waveVectors;
+        vector<FLOAT_TYPE> values;
+        structureFactorService->FillStructureFactor(particles, 10.0, &waveVectors, &values);
+
+        // S(k) = N for the reciprocal lattice vectors, i.e. when all the wave indexes are divisible by particlesPerSide, and zero otherwise
+        for (size_t i = 0; i < waveVectors.size(); ++i)
+        {
+            bool isReciprocalLatticeVector = true;
+            for (int j = 0; j < DIMENSIONS; ++j)
+            {
+                int waveIndex = Math::Round(waveVectors[i][j] * config->packingSize[j] / (2.0 * PI));
+                isReciprocalLatticeVector = isReciprocalLatticeVector && (waveIndex % particlesPerSide == 0);
+            }
+
+            FLOAT_TYPE expectedValue = isReciprocalLatticeVector ? config->particlesCount : 0.0;
+            Assert::IsTrue(std::abs(values[i] - expectedValue) < 1e-4 * config->particlesCount, testName);
+        }
+
+        TearDown();
+    }
+
+    void GriddedStructureFactorServiceTests::FillStructureFactor_ForWaveVectorsOfEqualLength_ValuesAveraged()
+    {
+        string testName = "FillStructureFactor_ForWaveVectorsOfEqualLength_ValuesAveraged";
+        printf("%s\n", testName.c_str());
+        SetUp(200, 6.0);
+        FillRandomParticles();
+
+        vector<SpatialVector> waveVectors;
+        vector<FLOAT_TYPE> values;
+        structureFactorService->FillStructureFactor(particles, 5.0, &waveVectors, &values);
+
+        StructureFactor structureFactor;
+        structureFactorService->FillStructureFactor(particles, 5.0, &structureFactor);
+
+        // The shortest wave vectors are 2 pi / L (m_i = +-1), the next ones are 2 pi sqrt(2) / L
+        FLOAT_TYPE shortestLength = 2.0 * PI / config->packingSize[Axis::X];
+        Assert::AreAlmostEqual(structureFactor.waveVectorLengths[0], shortestLength, testName, 1e-12);
+        Assert::AreAlmostEqual(structureFactor.waveVectorLengths[1], shortestLength * std::sqrt(2.0), testName, 1e-12);
+
+        FLOAT_TYPE shortestValuesSum = 0.0;
+        int shortestValuesCount = 0;
+        for (size_t i = 0; i < waveVectors.size(); ++i)
+        {
+            FLOAT_TYPE lengthSquare = 0.0;
+            for (int j = 0; j < DIMENSIONS; ++j)
+            {
+                lengthSquare += waveVectors[i][j] * waveVectors[i][j];
+            }
+            if (std::abs(std::sqrt(lengthSquare) - shortestLength) < 1e-10)
+            {
+                shortestValuesSum += values[i];
+                shortestValuesCount++;
+            }
+        }
+
+        Assert::AreEqual(shortestValuesCount, 2 * DIMENSIONS, testName);
+        Assert::AreAlmostEqual(structureFactor.structureFactorValues[0], shortestValuesSum / shortestValuesCount, testName, 1e-12);
+        for (size_t i = 1; i < structureFactor.waveVectorLengths.size(); ++i)
+        {
+            Assert::IsTrue(structureFactor.waveVectorLengths[i] > structureFactor.waveVectorLengths[i - 1] * (1.0 + 1e-12), testName);
+        }
+
+        TearDown();
+    }
+
+    void GriddedStructureFactorServiceTests::RunTests()
+    {
+        FillStructureFactor_ForRandomPacking_SameAsDirectSum();
+        FillStructureFactor_ForCubicLattice_PeaksAtReciprocalLattice();
+        FillStructureFactor_ForWaveVectorsOfEqualLength_ValuesAveraged();
+    }
+}
@@ -0,0 +1,211 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/HierarchicalCellListNeighborProviderTests.h"
+
+#include <stdio.h>
+#include <vector>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/ThreadPool.h"
+#include "Generation/PackingServices/DistanceServices/Headers/HierarchicalCellListNeighborProvider.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/PackingServices/Headers/GeometryCollisionService.h"
+#include "Generation/Geometries/Headers/BulkGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+using namespace PackingServices;
+
+namespace Tests
+{
+    boost::shared_ptr<MathService> HierarchicalCellListNeighborProviderTests::mathService;
+    boost::shared_ptr<GeometryService> HierarchicalCellListNeighborProviderTests::geometryService;
+    boost::shared_ptr<GeometryCollisionService> HierarchicalCellListNeighborProviderTests::geometryCollisionService;
+    boost::shared_ptr<HierarchicalCellListNeighborProvider> HierarchicalCellListNeighborProviderTests::neighborProvider;
+
+    boost::shared_ptr<IGeometry> HierarchicalCellListNeighborProviderTests::geometry;
+    boost::shared_ptr<SystemConfig> HierarchicalCellListNeighborProviderTests::config;
+    boost::shared_ptr<ModellingContext> HierarchicalCellListNeighborProviderTests::context;
+    Packing HierarchicalCellListNeighborProviderTests::particles;
+
+    void HierarchicalCellListNeighborProviderTests::SetUp(int largeParticlesCount, FLOAT_TYPE largeDiameter, int smallParticlesCount, FLOAT_TYPE smallDiameter)
+    {
+        mathService.reset(new MathService());
+        geometryService.reset(new GeometryService(mathService.get()));
+        geometryCollisionService.reset(new GeometryCollisionService());
+        neighborProvider.reset(new HierarchicalCellListNeighborProvider(geometryService.get(), geometryCollisionService.get()));
+
+        config.reset(new SystemConfig());
+        SpatialVector packingSize = REMOVE_LAST_DIMENSION_IF_NEEDED(10, 10, 10);
+        config->packingSize = packingSize;
+        config->particlesCount = largeParticlesCount + smallParticlesCount;
+        config->boundariesMode = BoundariesMode::Bulk;
+
+        geometry.reset(new BulkGeometry(*config.get()));
+        context.reset(new ModellingContext(config.get(), geometry.get()));
+
+        mathService->SetContext(*context.get());
+        geometryService->SetContext(*context.get());
+        neighborProvider->SetContext(*context.get());
+
+        // Random (overlapping) particles, so that there are many intersecting pairs of all kinds
+        Math::SetSeed(17);
+        particles.resize(config->particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                coordinates[i] = config->packingSize[i] * Math::GetNextRandom();
+            }
+            FLOAT_TYPE diameter = (particleIndex < largeParticlesCount) ? largeDiameter : smallDiameter;
+            particles[particleIndex] = DomainParticle(particleIndex, diameter, coordinates);
+        }
+
+        neighborProvider->SetParticles(particles);
+    }
+
+    void HierarchicalCellListNeighborProviderTests::TearDown()
+    {
+    }
+
+    void HierarchicalCellListNeighborProviderTests::AssertIntersectingNeighborsFound(string callerName)
+    {
+        vector<bool> isNeighbor(config->particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            isNeighbor.assign(config->particlesCount, false);
+
+            ParticleIndex neighborsCount;
+            const ParticleIndex* neighborIndexes = neighborProvider->GetNeighborIndexes(particleIndex, &neighborsCount);
+            for (ParticleIndex i = 0; i < neighborsCount; ++i)
+            {
+                ParticleIndex neighborIndex = neighborIndexes[i];
+                Assert::IsTrue(neighborIndex != particleIndex, callerName + ": the particle is its own neighbor");
+                Assert::IsTrue(!isNeighbor[neighborIndex], callerName + ": duplicate neighbor");
+                isNeighbor[neighborIndex] = true;
+            }
+
+            for (ParticleIndex neighborIndex = 0; neighborIndex < config->particlesCount; ++neighborIndex)
+            {
+                bool intersects = neighborIndex != particleIndex && mathService->GetNormalizedDistanceSquare(particleIndex, neighborIndex, particles) < 1.0;
+                if (intersects)
+                {
+                    Assert::IsTrue(isNeighbor[neighborIndex], callerName + ": intersecting neighbor not found");
+                }
+            }
+        }
+    }
+
+    void HierarchicalCellListNeighborProviderTests::GetNeighborIndexes_ForMonodispersePacking_SingleLevelAndIntersectingNeighborsFound()
+    {
+        string testName = "GetNeighborIndexes_ForMonodispersePacking_SingleLevelAndIntersectingNeighborsFound";
+        printf("%s\n", testName.c_str());
+        SetUp(500, 1.0, 0, 1.0);
+
+        Assert::AreEqual(neighborProvider->GetLevelsCount(), 1, testName);
+        AssertIntersectingNeighborsFound(testName);
+
+        TearDown();
+    }
+
+    void HierarchicalCellListNeighborProviderTests::GetNeighborIndexes_ForBimodalPacking_TwoLevelsAndIntersectingNeighborsFound()
+    {
+        string testName = "GetNeighborIndexes_ForBimodalPacking_TwoLevelsAndIntersectingNeighborsFound";
+        printf("%s\n", testName.c_str());
+        SetUp(50, 2.0, 1000, 0.3);
+
+        Assert::AreEqual(neighborProvider->GetLevelsCount(), 2, testName);
+        AssertIntersectingNeighborsFound(testName);
+
+        TearDown();
+    }
+
+    void HierarchicalCellListNeighborProviderTests::GetNeighborIndexes_ForBimodalPackingAfterMoves_IntersectingNeighborsFound()
+    {
+        string testName = "GetNeighborIndexes_ForBimodalPackingAfterMoves_IntersectingNeighborsFound";
+        printf("%s\n", testName.c_str());
+        SetUp(50, 2.0, 1000, 0.3);
+
+        // Many moves, so that some cells overflow and the particles are spread again
+        for (int move = 0; move < 5000; ++move)
+        {
+            ParticleIndex particleIndex = static_cast<ParticleIndex>(Math::GetNextRandom() * (config->particlesCount - 1));
+            neighborProvider->StartMove(particleIndex);
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                FLOAT_TYPE coordinate = particles[particleIndex].coordinates[i] + (Math::GetNextRandom() - 0.5);
+                particles[particleIndex].coordinates[i] = coordinate - config->packingSize[i] * std::floor(coordinate / config->packingSize[i]);
+            }
+            neighborProvider->EndMove();
+        }
+
+        AssertIntersectingNeighborsFound(testName);
+
+        TearDown();
+    }
+
+    void HierarchicalCellListNeighborProviderTests::PointQueryTask::Execute(int partIndex)
+    {
+        for (size_t pointIndex = partIndex; pointIndex < points->size(); pointIndex += partsCount)
+        {
+            ParticleIndex neighborsCount;
+            const ParticleIndex* neighborIndexes = neighborProvider->GetNeighborIndexes((*points)[pointIndex], &neighborsCount);
+            pointNeighborIndexes[pointIndex].assign(neighborIndexes, neighborIndexes + neighborsCount);
+        }
+    }
+
+    void HierarchicalCellListNeighborProviderTests::GetNeighborIndexes_ForPointsInSeveralThreads_SameAsInSingleThread()
+    {
+        string testName = "GetNeighborIndexes_ForPointsInSeveralThreads_SameAsInSingleThread";
+        printf("%s\n", testName.c_str());
+        SetUp(50, 2.0, 1000, 0.3);
+
+        vector<SpatialVector> points(2000);
+        for (size_t pointIndex = 0; pointIndex < points.size(); ++pointIndex)
+        {
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                points[pointIndex][i] = config->packingSize[i] * Math::GetNextRandom();
+            }
+        }
+
+        PointQueryTask expectedTask;
+        expectedTask.neighborProvider = neighborProvider.get();
+        expectedTask.points = &points;
+        expectedTask.pointNeighborIndexes.resize(points.size());
+        expectedTask.partsCount = 1;
+        expectedTask.Execute(0);
+
+        // The threads query the provider simultaneously, so they would overwrite the lists of each other if the provider had a single buffer
+        PointQueryTask task;
+        task.neighborProvider = neighborProvider.get();
+        task.points = &points;
+        task.pointNeighborIndexes.resize(points.size());
+        task.partsCount = 16;
+        ThreadPool threadPool(4);
+        threadPool.Execute(&task, task.partsCount);
+
+        for (size_t pointIndex = 0; pointIndex < points.size(); ++pointIndex)
+        {
+            Assert::AreEqual(task.pointNeighborIndexes[pointIndex].size(), expectedTask.pointNeighborIndexes[pointIndex].size(), testName);
+            Assert::AreVectorsEqual(task.pointNeighborIndexes[pointIndex], expectedTask.pointNeighborIndexes[pointIndex], testName);
+        }
+
+        TearDown();
+    }
+
+    void HierarchicalCellListNeighborProviderTests::RunTests()
+    {
+        GetNeighborIndexes_ForMonodispersePacking_SingleLevelAndIntersectingNeighborsFound();
+        GetNeighborIndexes_ForBimodalPacking_TwoLevelsAndIntersectingNeighborsFound();
+        GetNeighborIndexes_ForBimodalPackingAfterMoves_IntersectingNeighborsFound();
+        GetNeighborIndexes_ForPointsInSeveralThreads_SameAsInSingleThread();
+    }
+}
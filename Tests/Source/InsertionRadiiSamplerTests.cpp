@@ -0,0 +1,196 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/InsertionRadiiSamplerTests.h"
+
+#include <stdio.h>
+#include <string>
+#include <algorithm>
+#include "../Headers/Assert.h"
+#include "../Headers/PackingTestUtilities.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/Constants.h"
+#include "Generation/PackingServices/PostProcessing/Headers/InsertionRadiiSampler.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/Geometries/Headers/BulkGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+using namespace PackingServices;
+
+namespace Tests
+{
+    boost::shared_ptr<MathService> InsertionRadiiSamplerTests::mathService;
+
+    boost::shared_ptr<IGeometry> InsertionRadiiSamplerTests::geometry;
+    boost::shared_ptr<SystemConfig> InsertionRadiiSamplerTests::config;
+    boost::shared_ptr<ModellingContext> InsertionRadiiSamplerTests::context;
+    Packing InsertionRadiiSamplerTests::particles;
+
+    void InsertionRadiiSamplerTests::SetUp(int particlesCount, FLOAT_TYPE boxSize)
+    {
+        mathService.reset(new MathService());
+
+        config.reset(new SystemConfig());
+        SpatialVector packingSize = REMOVE_LAST_DIMENSION_IF_NEEDED(boxSize, boxSize, boxSize);
+        config->packingSize = packingSize;
+        config->particlesCount = particlesCount;
+        config->boundariesMode = BoundariesMode::Bulk;
+
+        geometry.reset(new BulkGeometry(*config.get()));
+        context.reset(new ModellingContext(config.get(), geometry.get()));
+
+        mathService->SetContext(*context.get());
+
+        particles.resize(config->particlesCount);
+    }
+
+    void InsertionRadiiSamplerTests::TearDown()
+    {
+    }
+
+    void InsertionRadiiSamplerTests::FillDistances(int threadsCount, int seed, long long firstSampleIndex, int samplesCount, vector<FLOAT_TYPE>* distances)
+    {
+        InsertionRadiiSampler sampler(mathService.get(), threadsCount);
+        sampler.SetContext(*context.get());
+        sampler.SetSeed(seed);
+        sampler.SetParticles(particles);
+
+        distances->resize(samplesCount);
+        sampler.FillDistancesToNearestSurfaces(firstSampleIndex, samplesCount, &distances->at(0));
+    }
+
+    void InsertionRadiiSamplerTests::AssertDistancesSameAsNaive(int seed, string testName)
+    {
+        InsertionRadiiSampler sampler(mathService.get(), 1);
+        sampler.SetContext(*context.get());
+        sampler.SetSeed(seed);
+        sampler.SetParticles(particles);
+
+        for (int sampleIndex = 0; sampleIndex < 500; ++sampleIndex)
+        {
+            SpatialVector point;
+            sampler.FillRandomPoint(sampleIndex, &point);
+
+            FLOAT_TYPE expectedDistance = MAX_FLOAT_VALUE;
+            for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+            {
+                FLOAT_TYPE distance = mathService->GetDistanceLength(point, particles[particleIndex].coordinates) - particles[particleIndex].diameter * 0.5;
+                expectedDistance = std::min(expectedDistance, distance);
+            }
+
+            Assert::AreEqual(sampler.GetDistanceToNearestSurface(point), expectedDistance, testName);
+        }
+    }
+
+    void InsertionRadiiSamplerTests::FillDistancesToNearestSurfaces_ForDifferentThreadsCounts_SameDistances()
+    {
+        string testName = "FillDistancesToNearestSurfaces_ForDifferentThreadsCounts_SameDistances";
+        printf("%s\n", testName.c_str());
+
+        SetUp(1000, 10.0);
+        PackingTestUtilities::FillRandomParticles(*config, 59, 0.8, 1.2, &particles);
+
+        vector<FLOAT_TYPE> expectedDistances;
+        FillDistances(1, 5, 0, 5000, &expectedDistances);
+
+        vector<FLOAT_TYPE> actualDistances;
+        FillDistances(3, 5, 0, 5000, &actualDistances);
+
+        for (size_t i = 0; i < expectedDistances.size(); ++i)
+        {
+            Assert::AreEqual(actualDistances[i], expectedDistances[i], testName);
+        }
+
+        TearDown();
+    }
+
+    void InsertionRadiiSamplerTests::FillDistancesToNearestSurfaces_ForDifferentBatches_SameDistances()
+    {
+        string testName = "FillDistancesToNearestSurfaces_ForDifferentBatches_SameDistances";
+        printf("%s\n", testName.c_str());
+
+        SetUp(1000, 10.0);
+        PackingTestUtilities::FillRandomParticles(*config, 61, 0.8, 1.2, &particles);
+
+        vector<FLOAT_TYPE> expectedDistances;
+        FillDistances(2, 7, 0, 3000, &expectedDistances);
+
+        vector<FLOAT_TYPE> actualDistances;
+        FillDistances(3, 7, 1234, 1766, &actualDistances);
+
+        for (size_t i = 0; i < actualDistances.size(); ++i)
+        {
+            Assert::AreEqual(actualDistances[i], expectedDistances[1234 + i], testName);
+        }
+
+        TearDown();
+    }
+
+    void InsertionRadiiSamplerTests::FillDistancesToNearestSurfaces_ForDifferentSeeds_DifferentDistances()
+    {
+        string testName = "FillDistancesToNearestSurfaces_ForDifferentSeeds_DifferentDistances";
+        printf("%s\n", testName.c_str());
+
+        SetUp(1000, 10.0);
+        PackingTestUtilities::FillRandomParticles(*config, 67, 0.8, 1.2, &particles);
+
+        vector<FLOAT_TYPE> firstDistances;
+        FillDistances(2, 11, 0, 100, &firstDistances);
+
+        vector<FLOAT_TYPE> secondDistances;
+        FillDistances(2, 13, 0, 100, &secondDistances);
+
+        int equalDistancesCount = 0;
+        for (size_t i = 0; i < firstDistances.size(); ++i)
+        {
+            if (firstDistances[i] == secondDistances[i])
+            {
+                equalDistancesCount++;
+            }
+        }
+        Assert::AreEqual(equalDistancesCount, 0, testName);
+
+        TearDown();
+    }
+
+    void InsertionRadiiSamplerTests::GetDistanceToNearestSurface_ForDensePacking_SameAsNaive()
+    {
+        string testName = "GetDistanceToNearestSurface_ForDensePacking_SameAsNaive";
+        printf("%s\n", testName.c_str());
+
+        SetUp(2000, 12.0);
+        PackingTestUtilities::FillRandomParticles(*config, 71, 0.5, 1.5, &particles);
+
+        AssertDistancesSameAsNaive(17, testName);
+
+        TearDown();
+    }
+
+    void InsertionRadiiSamplerTests::GetDistanceToNearestSurface_ForDilutePacking_SameAsNaive()
+    {
+        string testName = "GetDistanceToNearestSurface_ForDilutePacking_SameAsNaive";
+        printf("%s\n", testName.c_str());
+
+        // Most of the points are farther from the particles than the cell size, so the fallback to all the particles is checked
+        SetUp(30, 20.0);
+        PackingTestUtilities::FillRandomParticles(*config, 73, 0.5, 1.5, &particles);
+
+        AssertDistancesSameAsNaive(19, testName);
+
+        TearDown();
+    }
+
+    void InsertionRadiiSamplerTests::RunTests()
+    {
+        FillDistancesToNearestSurfaces_ForDifferentThreadsCounts_SameDistances();
+        FillDistancesToNearestSurfaces_ForDifferentBatches_SameDistances();
+        FillDistancesToNearestSurfaces_ForDifferentSeeds_DifferentDistances();
+        GetDistanceToNearestSurface_ForDensePacking_SameAsNaive();
+        GetDistanceToNearestSurface_ForDilutePacking_SameAsNaive();
+    }
+}
@@ -0,0 +1,148 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/KeyOrderedPriorityQueueTests.h"
+#include "../Headers/Assert.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/Constants.h"
+
+using namespace std;
+using namespace Core;
+
+namespace Tests
+{
+    KeyOrderedPriorityQueue<vector<double>, KeyOrderedPriorityQueueTests::DoubleComparer> KeyOrderedPriorityQueueTests::eventsQueue;
+    vector<double> KeyOrderedPriorityQueueTests::values;
+
+    void KeyOrderedPriorityQueueTests::SetUp()
+    {
+        double temp[6] = {3, 1, 2, 4, 0, 5};
+        values.clear();
+        values.insert(values.begin(), temp, temp + 6);
+
+        eventsQueue.Initialize(&values, DoubleComparer());
+    }
+
+    void KeyOrderedPriorityQueueTests::TearDown()
+    {
+
+    }
+
+    void KeyOrderedPriorityQueueTests::GetTop_ForOrdered_TopCorrect()
+    {
+        SetUp();
+
+        int topIndex = eventsQueue.GetTopIndex();
+
+        Assert::AreEqual(topIndex, 4, "GetTop_ForOrdered_TopCorrect");
+        TearDown();
+    }
+
+    void KeyOrderedPriorityQueueTests::UpdateValue_MakeEachMinimal_TopAlwaysCorrect()
+    {
+        SetUp();
+
+        int oldTopIndex = eventsQueue.GetTopIndex();
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            double oldValue = values[i];
+            values[i] = -1;
+
+            eventsQueue.HandleUpdate(i);
+            int topIndex = eventsQueue.GetTopIndex();
+            Assert::AreEqual(topIndex, static_cast<int>(i), "UpdateValue_MakeEachMinimal_TopCorrect");
+
+            values[i] = oldValue;
+            eventsQueue.HandleUpdate(i);
+            topIndex = eventsQueue.GetTopIndex();
+            Assert::AreEqual(topIndex, oldTopIndex, "UpdateValue_MakeEachMinimal_TopCorrect");
+        }
+
+        TearDown();
+    }
+
+    void KeyOrderedPriorityQueueTests::UpdateValue_MakeEachMaximal_TopAlwaysCorrect()
+    {
+        SetUp();
+
+        for (size_t i = 0; i < values.size() - 1; i++)
+        {
+            int topIndex = eventsQueue.GetTopIndex();
+            values[topIndex] = 100;
+            eventsQueue.HandleUpdate(topIndex);
+
+            topIndex = eventsQueue.GetTopIndex();
+            Assert::AreEqual(values[topIndex], static_cast<double>(i + 1), "UpdateValue_MakeEachMaximal_TopAlwaysCorrect");
+        }
+
+        TearDown();
+    }
+
+    void KeyOrderedPriorityQueueTests::UpdateValue_MakeInfinite_InfiniteValuesLast()
+    {
+        SetUp();
+
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            int topIndex = eventsQueue.GetTopIndex();
+            Assert::AreEqual(values[topIndex], static_cast<double>(i), "UpdateValue_MakeInfinite_InfiniteValuesLast");
+
+            values[topIndex] = MAX_FLOAT_VALUE;
+            eventsQueue.HandleUpdate(topIndex);
+        }
+
+        values[2] = 7;
+        eventsQueue.HandleUpdate(2);
+        Assert::AreEqual(eventsQueue.GetTopIndex(), 2, "UpdateValue_MakeInfinite_InfiniteValuesLast");
+
+        TearDown();
+    }
+
+    // Emulates event-driven molecular dynamics: the top value is always replaced with a larger one, some other values are changed as well.
+    // The time scale of the updates changes during the simulation.
+    void KeyOrderedPriorityQueueTests::UpdateValue_SimulateEvents_SameOrderAsSorting()
+    {
+        const int valuesCount = 1000;
+        const int updatesCount = 20000;
+        Math::SetSeed(17);
+
+        values.resize(valuesCount);
+        for (int i = 0; i < valuesCount; ++i)
+        {
+            values[i] = 0.0;
+        }
+        eventsQueue.Initialize(&values, DoubleComparer());
+
+        double currentTime = 0.0;
+        bool orderCorrect = true;
+        for (int i = 0; i < updatesCount; ++i)
+        {
+            int topIndex = eventsQueue.GetTopIndex();
+            double minValue = *min_element(values.begin(), values.end());
+            orderCorrect = orderCorrect && (values[topIndex] == minValue);
+            currentTime = values[topIndex];
+
+            // The time scale changes during the simulation
+            double timeScale = (i < updatesCount / 2) ? 1e-3 : 1e2;
+            values[topIndex] = currentTime + timeScale * Math::GetNextRandom();
+            eventsQueue.HandleUpdate(topIndex);
+
+            int neighborIndex = static_cast<int>(Math::GetNextRandom() * (valuesCount - 1));
+            values[neighborIndex] = currentTime + timeScale * Math::GetNextRandom();
+            eventsQueue.HandleUpdate(neighborIndex);
+        }
+
+        Assert::IsTrue(orderCorrect, "UpdateValue_SimulateEvents_SameOrderAsSorting");
+    }
+
+    void KeyOrderedPriorityQueueTests::RunTests()
+    {
+        GetTop_ForOrdered_TopCorrect();
+        UpdateValue_MakeEachMinimal_TopAlwaysCorrect();
+        UpdateValue_MakeEachMaximal_TopAlwaysCorrect();
+        UpdateValue_MakeInfinite_InfiniteValuesLast();
+        UpdateValue_SimulateEvents_SameOrderAsSorting();
+    }
+}
+
@@ -0,0 +1,331 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/LubachevsckyStillingerStepTests.h"
+
+#include <stdio.h>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/Path.h"
+#include "Generation/Constants.h"
+#include "Generation/Geometries/Headers/BulkGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+#include "Generation/PackingServices/DistanceServices/Headers/CellListNeighborProvider.h"
+#include "Generation/PackingServices/DistanceServices/Headers/DistanceService.h"
+
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/PackingServices/Headers/GeometryCollisionService.h"
+
+#include "Generation/PackingGenerators/LubachevsckyStillinger/Headers/CheckpointSerializer.h"
+#include "Generation/PackingGenerators/LubachevsckyStillinger/Headers/LubachevsckyStillingerStep.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+using namespace PackingServices;
+using namespace PackingGenerators;
+
+namespace Tests
+{
+    boost::shared_ptr<CheckpointSerializer> LubachevsckyStillingerStepTests::checkpointSerializer;
+
+    boost::shared_ptr<MathService> LubachevsckyStillingerStepTests::mathService;
+    boost::shared_ptr<GeometryService> LubachevsckyStillingerStepTests::geometryService;
+    boost::shared_ptr<GeometryCollisionService> LubachevsckyStillingerStepTests::geometryCollisionService;
+    boost::shared_ptr<INeighborProvider> LubachevsckyStillingerStepTests::neighborProvider;
+    boost::shared_ptr<DistanceService> LubachevsckyStillingerStepTests::distanceService;
+
+    boost::shared_ptr<IGeometry> LubachevsckyStillingerStepTests::geometry;
+    boost::shared_ptr<SystemConfig> LubachevsckyStillingerStepTests::config;
+    boost::shared_ptr<ModellingContext> LubachevsckyStillingerStepTests::context;
+    boost::shared_ptr<GenerationConfig> LubachevsckyStillingerStepTests::generationConfig;
+
+    const string LubachevsckyStillingerStepTests::checkpointFilePath = Generation::CHECKPOINT_FILE_NAME;
+    const int LubachevsckyStillingerStepTests::particlesPerSide = 8;
+
+    void LubachevsckyStillingerStepTests::SetUp()
+    {
+        checkpointSerializer.reset(new CheckpointSerializer());
+
+        mathService.reset(new MathService());
+        geometryService.reset(new GeometryService(mathService.get()));
+        geometryCollisionService.reset(new GeometryCollisionService());
+        neighborProvider.reset(new CellListNeighborProvider(geometryService.get(), geometryCollisionService.get()));
+        distanceService.reset(new DistanceService(mathService.get(), geometryService.get(), neighborProvider.get()));
+
+        int particlesCount = 1;
+        for (int i = 0; i < DIMENSIONS; ++i)
+        {
+            particlesCount *= particlesPerSide;
+        }
+
+        config.reset(new SystemConfig());
+        VectorUtilities::InitializeWith(&config->packingSize, particlesPerSide);
+        config->particlesCount = particlesCount;
+        config->boundariesMode = BoundariesMode::Bulk;
+
+        geometry.reset(new BulkGeometry(*config));
+        context.reset(new ModellingContext(config.get(), geometry.get()));
+
+        // The steps start from the checkpoint in the current folder, as the initial velocities are not rescaled to the temperature
+        generationConfig.reset(new GenerationConfig());
+        generationConfig->baseFolder = "";
+        generationConfig->stepsToWrite = 1;
+        generationConfig->generationAlgorithm = PackingGenerationAlgorithm::LubachevskyStillingerSimple;
+
+        mathService->SetContext(*context);
+        geometryService->SetContext(*context);
+        neighborProvider->SetContext(*context);
+        distanceService->SetContext(*context);
+
+        Path::DeleteFile(checkpointFilePath);
+    }
+
+    void LubachevsckyStillingerStepTests::TearDown()
+    {
+        Path::DeleteFile(checkpointFilePath);
+    }
+
+    boost::shared_ptr<LubachevsckyStillingerStep> LubachevsckyStillingerStepTests::CreateStep(bool updateEventsIncrementally)
+    {
+        boost::shared_ptr<LubachevsckyStillingerStep> step(new LubachevsckyStillingerStep(geometryService.get(), neighborProvider.get(), distanceService.get(), mathService.get(), NULL, NULL));
+        step->updateEventsIncrementally = updateEventsIncrementally;
+        step->writeCheckpoints = true;
+        step->SetContext(*context);
+        step->SetGenerationConfig(*generationConfig);
+        return step;
+    }
+
+    void LubachevsckyStillingerStepTests::FillJitteredLattice(Packing* particles)
+    {
+        Math::SetSeed(1);
+        particles->clear();
+        particles->resize(config->particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates;
+            int remainder = particleIndex;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                coordinates[i] = remainder % particlesPerSide + 0.5 + 0.2 * (Math::GetNextRandom() - 0.5);
+                remainder /= particlesPerSide;
+            }
+            (*particles)[particleIndex] = DomainParticle(particleIndex, 1.0, coordinates);
+        }
+    }
+
+    void LubachevsckyStillingerStepTests::FillRandomVelocities(vector<SpatialVector>* velocities)
+    {
+        // The kinetic energy differs from the expected one, so the velocities are rescaled by a factor far from one after the first block
+        Math::SetSeed(2);
+        velocities->resize(config->particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                (*velocities)[particleIndex][i] = 4.0 * (Math::GetNextRandom() - 0.5);
+            }
+        }
+    }
+
+    void LubachevsckyStillingerStepTests::FillRowVelocities(vector<SpatialVector>* velocities)
+    {
+        // The lattice rows along the first axis are at least 0.8 apart, and the inner diameters are 0.5, so the rows never interact.
+        // Each row moves as a whole, so there are no collisions at all, and the particles of the rows at rest never have events.
+        Math::SetSeed(2);
+        velocities->resize(config->particlesCount);
+        FLOAT_TYPE rowVelocity = 0.0;
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            int rowIndex = particleIndex / particlesPerSide;
+            if (particleIndex % particlesPerSide == 0)
+            {
+                rowVelocity = (rowIndex % 4 == 0) ? 0.0 : 4.0 * (Math::GetNextRandom() - 0.5);
+            }
+
+            SpatialVector& velocity = (*velocities)[particleIndex];
+            VectorUtilities::InitializeWith(&velocity, 0.0);
+            velocity[0] = rowVelocity;
+        }
+    }
+
+    void LubachevsckyStillingerStepTests::WriteCheckpoint(const Packing& particles, const vector<SpatialVector>& velocities)
+    {
+        LubachevsckyStillingerCheckpoint checkpoint;
+        checkpoint.generationAlgorithm = generationConfig->generationAlgorithm;
+        checkpoint.lockParticles = false;
+        checkpoint.initialInnerDiameterRatio = 0.5;
+        checkpoint.ratioGrowthRate = 0.0;
+        checkpoint.growthRateUpdatesCount = 0;
+        checkpoint.equilibrationsCount = 0;
+        checkpoint.shouldContinue = true;
+        checkpoint.particles = particles;
+
+        checkpoint.movingParticles.resize(config->particlesCount);
+        Particle::CopyPackingTo(particles, &checkpoint.movingParticles);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            MovingParticle& movingParticle = checkpoint.movingParticles[particleIndex];
+            movingParticle.lastEventTime = 0.0;
+            movingParticle.velocity = velocities[particleIndex];
+        }
+        Math::FillRandomState(&checkpoint.randomState);
+
+        checkpointSerializer->WriteCheckpoint(checkpointFilePath, checkpoint);
+    }
+
+    void LubachevsckyStillingerStepTests::FillFinalEvents(const vector<MovingParticle>& movingParticles, FLOAT_TYPE cutoffTime, vector<Event>* events)
+    {
+        events->clear();
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            const Event& event = movingParticles[particleIndex].nextAvailableEvent;
+            if (event.type != EventType::Move && event.type != EventType::InvalidEvent && event.time < cutoffTime)
+            {
+                events->push_back(event);
+            }
+        }
+    }
+
+    FLOAT_TYPE LubachevsckyStillingerStepTests::GetFirstMoveEventTime(const vector<MovingParticle>& movingParticles)
+    {
+        FLOAT_TYPE firstMoveEventTime = MAX_FLOAT_VALUE;
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            const Event& event = movingParticles[particleIndex].nextAvailableEvent;
+            if (event.type == EventType::Move)
+            {
+                firstMoveEventTime = std::min(firstMoveEventTime, event.time);
+            }
+        }
+        return firstMoveEventTime;
+    }
+
+    boost::shared_ptr<LubachevsckyStillingerStep> LubachevsckyStillingerStepTests::RunBlock(const vector<SpatialVector>& velocities, bool updateEventsIncrementally, Packing* particles)
+    {
+        FillJitteredLattice(particles);
+        WriteCheckpoint(*particles, velocities);
+        boost::shared_ptr<LubachevsckyStillingerStep> step = CreateStep(updateEventsIncrementally);
+        step->SetParticles(particles);
+        step->DisplaceParticles();
+        return step;
+    }
+
+    void LubachevsckyStillingerStepTests::AssertFinalEventsEqual(const vector<MovingParticle>& actualMovingParticles, const vector<MovingParticle>& expectedMovingParticles, string testName)
+    {
+        // The next events of individual particles may differ, as the rebuilt events depend on the order of their computation,
+        // and some events are postponed by Move events (the particle events are recomputed at the Move event time).
+        // The events earlier than any Move event are final, and they shall coincide.
+        FLOAT_TYPE cutoffTime = std::min(GetFirstMoveEventTime(expectedMovingParticles), GetFirstMoveEventTime(actualMovingParticles));
+
+        vector<Event> expectedEvents;
+        vector<Event> actualEvents;
+        FillFinalEvents(expectedMovingParticles, cutoffTime, &expectedEvents);
+        FillFinalEvents(actualMovingParticles, cutoffTime, &actualEvents);
+
+        Assert::IsTrue(expectedEvents.size() > 0, testName);
+        Assert::AreEqual(actualEvents.size(), expectedEvents.size(), testName);
+        for (size_t i = 0; i < expectedEvents.size(); ++i)
+        {
+            Assert::AreEqual(actualEvents[i].type, expectedEvents[i].type, testName);
+            Assert::AreEqual(actualEvents[i].particleIndex, expectedEvents[i].particleIndex, testName);
+            Assert::AreEqual(actualEvents[i].neighborIndex, expectedEvents[i].neighborIndex, testName);
+            Assert::AreEqual(actualEvents[i].wallIndex, expectedEvents[i].wallIndex, testName);
+            if (expectedEvents[i].type == EventType::NeighborTransfer)
+            {
+                // The transfer events, found right after the previous transfers, are shifted by 1e-10 (see NeighborTransferEventProvider), and the shift is rescaled too
+                Assert::IsTrue(std::abs(actualEvents[i].time - expectedEvents[i].time) < 1e-9, testName);
+            }
+            else
+            {
+                Assert::AreAlmostEqual(actualEvents[i].time, expectedEvents[i].time, testName, 1e-10);
+            }
+        }
+    }
+
+    void LubachevsckyStillingerStepTests::AssertNeverEventsKept(const vector<MovingParticle>& actualMovingParticles, const vector<MovingParticle>& expectedMovingParticles, string testName)
+    {
+        // The events that never happen are not shifted or rescaled
+        int neverEventsCount = CountNeverEvents(expectedMovingParticles);
+        Assert::IsTrue(neverEventsCount > 0, testName);
+        Assert::AreEqual(CountNeverEvents(actualMovingParticles), neverEventsCount, testName);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            if (expectedMovingParticles[particleIndex].nextAvailableEvent.time == MAX_FLOAT_VALUE)
+            {
+                Assert::IsTrue(actualMovingParticles[particleIndex].nextAvailableEvent.time == MAX_FLOAT_VALUE, testName);
+            }
+        }
+    }
+
+    int LubachevsckyStillingerStepTests::CountNeverEvents(const vector<MovingParticle>& movingParticles)
+    {
+        int neverEventsCount = 0;
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            if (movingParticles[particleIndex].nextAvailableEvent.time == MAX_FLOAT_VALUE)
+            {
+                neverEventsCount++;
+            }
+        }
+        return neverEventsCount;
+    }
+
+    void LubachevsckyStillingerStepTests::DisplaceParticles_ForRandomVelocities_IncrementalEventsEqualRebuiltEvents()
+    {
+        string testName = "DisplaceParticles_ForRandomVelocities_IncrementalEventsEqualRebuiltEvents";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        // Arrange
+        // Both steps start from the same checkpoint without growth and process the same first block of events.
+        // The steps share the neighbor provider, so each one is run right after setting its particles.
+        vector<SpatialVector> velocities;
+        FillRandomVelocities(&velocities);
+        Packing rebuiltParticles;
+        boost::shared_ptr<LubachevsckyStillingerStep> rebuildingStep = RunBlock(velocities, false, &rebuiltParticles);
+
+        // Act
+        Packing incrementalParticles;
+        boost::shared_ptr<LubachevsckyStillingerStep> incrementalStep = RunBlock(velocities, true, &incrementalParticles);
+
+        // Assert
+        AssertFinalEventsEqual(incrementalStep->GetMovingParticles(), rebuildingStep->GetMovingParticles(), testName);
+
+        TearDown();
+    }
+
+    void LubachevsckyStillingerStepTests::DisplaceParticles_ForParticlesAtRest_NeverEventsKept()
+    {
+        string testName = "DisplaceParticles_ForParticlesAtRest_NeverEventsKept";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        // Arrange
+        // The particles at rest are not hit by the other rows, so they have the events that never happen.
+        // The moving rows cross the walls and the cell boundaries simultaneously, so their events are not compared (the event types may differ).
+        vector<SpatialVector> velocities;
+        FillRowVelocities(&velocities);
+        Packing rebuiltParticles;
+        boost::shared_ptr<LubachevsckyStillingerStep> rebuildingStep = RunBlock(velocities, false, &rebuiltParticles);
+
+        // Act
+        Packing incrementalParticles;
+        boost::shared_ptr<LubachevsckyStillingerStep> incrementalStep = RunBlock(velocities, true, &incrementalParticles);
+
+        // Assert
+        AssertNeverEventsKept(incrementalStep->GetMovingParticles(), rebuildingStep->GetMovingParticles(), testName);
+
+        TearDown();
+    }
+
+    void LubachevsckyStillingerStepTests::RunTests()
+    {
+        DisplaceParticles_ForRandomVelocities_IncrementalEventsEqualRebuiltEvents();
+        DisplaceParticles_ForParticlesAtRest_NeverEventsKept();
+    }
+}
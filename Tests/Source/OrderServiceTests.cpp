@@ -0,0 +1,166 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/OrderServiceTests.h"
+
+#include <stdio.h>
+#include <string>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Math.h"
+#include "Generation/PackingServices/PostProcessing/Headers/OrderService.h"
+#include "Generation/PackingServices/DistanceServices/Headers/CellListNeighborProvider.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/PackingServices/Headers/GeometryCollisionService.h"
+#include "Generation/Geometries/Headers/BulkGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+using namespace PackingServices;
+
+namespace Tests
+{
+    boost::shared_ptr<MathService> OrderServiceTests::mathService;
+    boost::shared_ptr<GeometryService> OrderServiceTests::geometryService;
+    boost::shared_ptr<GeometryCollisionService> OrderServiceTests::geometryCollisionService;
+    boost::shared_ptr<CellListNeighborProvider> OrderServiceTests::neighborProvider;
+    boost::shared_ptr<OrderService> OrderServiceTests::orderService;
+
+    boost::shared_ptr<IGeometry> OrderServiceTests::geometry;
+    boost::shared_ptr<SystemConfig> OrderServiceTests::config;
+    boost::shared_ptr<ModellingContext> OrderServiceTests::context;
+    Packing OrderServiceTests::particles;
+
+    void OrderServiceTests::SetUp(int particlesCount, FLOAT_TYPE boxSize)
+    {
+        mathService.reset(new MathService());
+        geometryService.reset(new GeometryService(mathService.get()));
+        geometryCollisionService.reset(new GeometryCollisionService());
+        neighborProvider.reset(new CellListNeighborProvider(geometryService.get(), geometryCollisionService.get()));
+        orderService.reset(new OrderService(mathService.get(), neighborProvider.get()));
+
+        config.reset(new SystemConfig());
+        SpatialVector packingSize = REMOVE_LAST_DIMENSION_IF_NEEDED(boxSize, boxSize, boxSize);
+        config->packingSize = packingSize;
+        config->particlesCount = particlesCount;
+        config->boundariesMode = BoundariesMode::Bulk;
+
+        geometry.reset(new BulkGeometry(*config.get()));
+        context.reset(new ModellingContext(config.get(), geometry.get()));
+
+        orderService->SetContext(*context.get());
+
+        particles.resize(config->particlesCount);
+    }
+
+    void OrderServiceTests::TearDown()
+    {
+    }
+
+    void OrderServiceTests::FillBondOrders_ForFccLattice_KnownValues()
+    {
+        string testName = "FillBondOrders_ForFccLattice_KnownValues";
+        printf("%s\n", testName.c_str());
+
+        // Four particles per unit cell, the neighbors touch each other
+        const int cellsPerSide = 4;
+        const FLOAT_TYPE cellSize = 1.0;
+        SetUp(4 * cellsPerSide * cellsPerSide * cellsPerSide, cellsPerSide * cellSize);
+        const FLOAT_TYPE basis[4][3] = {{0.0, 0.0, 0.0}, {0.5, 0.5, 0.0}, {0.5, 0.0, 0.5}, {0.0, 0.5, 0.5}};
+        FLOAT_TYPE diameter = cellSize / sqrt(2.0);
+
+        ParticleIndex particleIndex = 0;
+        for (int x = 0; x < cellsPerSide; ++x)
+        {
+            for (int y = 0; y < cellsPerSide; ++y)
+            {
+                for (int z = 0; z < cellsPerSide; ++z)
+                {
+                    for (int basisIndex = 0; basisIndex < 4; ++basisIndex)
+                    {
+                        SpatialVector coordinates = {{(x + basis[basisIndex][0] + 0.25) * cellSize, (y + basis[basisIndex][1] + 0.25) * cellSize, (z + basis[basisIndex][2] + 0.25) * cellSize}};
+                        particles[particleIndex] = DomainParticle(particleIndex, diameter, coordinates);
+                        particleIndex++;
+                    }
+                }
+            }
+        }
+
+        orderService->SetParticles(particles);
+        vector<int> ls;
+        ls.push_back(4);
+        ls.push_back(6);
+        ls.push_back(8);
+        OrderService::BondOrders bondOrders;
+        orderService->FillBondOrders(ls, &bondOrders);
+
+        const FLOAT_TYPE expectedOrders[] = {0.19094, 0.57452, 0.40391};
+        for (size_t i = 0; i < ls.size(); ++i)
+        {
+            Assert::AreAlmostEqual(bondOrders.globalOrders[i], expectedOrders[i], testName, 1e-4);
+            Assert::AreAlmostEqual(bondOrders.localOrders[i], expectedOrders[i], testName, 1e-4);
+        }
+        Assert::AreAlmostEqual(bondOrders.globalWignerOrders[1], -0.01316, testName, 1e-3);
+        Assert::AreAlmostEqual(bondOrders.localWignerOrders[1], -0.01316, testName, 1e-3);
+
+        OrderService::Order order = orderService->GetOrder(6);
+        Assert::AreAlmostEqual(order.globalOrder, bondOrders.globalOrders[1], testName, 1e-12);
+        Assert::AreAlmostEqual(order.localOrder, bondOrders.localOrders[1], testName, 1e-12);
+
+        TearDown();
+    }
+
+    void OrderServiceTests::FillBondOrders_ForDifferentThreadsCounts_SameValues()
+    {
+        string testName = "FillBondOrders_ForDifferentThreadsCounts_SameValues";
+        printf("%s\n", testName.c_str());
+
+        SetUp(1000, 10.0);
+        Math::SetSeed(89);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates = {{10.0 * Math::GetNextRandom(), 10.0 * Math::GetNextRandom(), 10.0 * Math::GetNextRandom()}};
+            particles[particleIndex] = DomainParticle(particleIndex, 0.8 + 0.4 * Math::GetNextRandom(), coordinates);
+        }
+
+        vector<int> ls;
+        ls.push_back(6);
+        ls.push_back(10);
+
+        orderService->SetParticles(particles);
+        orderService->threadsCount = 1;
+        OrderService::BondOrders expectedBondOrders;
+        orderService->FillBondOrders(ls, &expectedBondOrders);
+
+        // The cell list reorders the neighbors of a cell on each query, and the sums of harmonics depend on the order of the neighbors.
+        // Therefore the services are recreated to traverse the neighbors in the same order.
+        Packing initialParticles = particles;
+        SetUp(1000, 10.0);
+        particles = initialParticles;
+
+        orderService->SetParticles(particles);
+        orderService->threadsCount = 3;
+        OrderService::BondOrders actualBondOrders;
+        orderService->FillBondOrders(ls, &actualBondOrders);
+
+        for (size_t i = 0; i < ls.size(); ++i)
+        {
+            Assert::AreEqual(actualBondOrders.globalOrders[i], expectedBondOrders.globalOrders[i], testName);
+            Assert::AreEqual(actualBondOrders.localOrders[i], expectedBondOrders.localOrders[i], testName);
+            Assert::AreEqual(actualBondOrders.globalWignerOrders[i], expectedBondOrders.globalWignerOrders[i], testName);
+            Assert::AreEqual(actualBondOrders.localWignerOrders[i], expectedBondOrders.localWignerOrders[i], testName);
+        }
+
+        TearDown();
+    }
+
+    void OrderServiceTests::RunTests()
+    {
+        FillBondOrders_ForFccLattice_KnownValues();
+        FillBondOrders_ForDifferentThreadsCounts_SameValues();
+    }
+}
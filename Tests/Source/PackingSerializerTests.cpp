@@ -6,6 +6,7 @@
 
 #include "Generation/PackingServices/Headers/PackingSerializer.h"
 #include "Core/Headers/MemoryUtility.h"
+#include "Core/Headers/Path.h"
 #include "../Headers/Assert.h"
 #include "../Headers/EndiannessProviderStub.h"
 
@@ -120,6 +121,46 @@ namespace Tests
         TearDown();
     }
 
+    void PackingSerializerTests::SavePacking_ForSeveralChunks_PackingIsCorrectWhenLoaded()
+    {
+        string testName = "SavePacking_ForSeveralChunks_PackingIsCorrectWhenLoaded";
+        SetUp();
+
+        // More particles than in a single read or write chunk
+        const int largeParticlesCount = 150000;
+        Packing largeParticles(largeParticlesCount);
+        for (int i = 0; i < largeParticlesCount; ++i)
+        {
+            SpatialVector coordinates;
+            for (int j = 0; j < DIMENSIONS; ++j)
+            {
+                coordinates[j] = i + 0.25 * j;
+            }
+            largeParticles[i] = DomainParticle(i, 1.0 + 1e-6 * i, coordinates);
+        }
+
+        endiannessProvider->isBigEndian = false;
+        packingSerializer->SerializePacking("file.txt", largeParticles);
+        packingSerializer->AppendPacking("file.txt", particles);
+
+        Assert::AreEqual(static_cast<long long>(Path::GetFileSize("file.txt")), static_cast<long long>((largeParticlesCount + particlesCount) * (DIMENSIONS + 1) * sizeof(FLOAT_TYPE)), testName);
+
+        Packing loadedParticles(largeParticlesCount + particlesCount);
+        packingSerializer->ReadPacking("file.txt", &loadedParticles);
+        for (int i = 0; i < largeParticlesCount + particlesCount; ++i)
+        {
+            const DomainParticle& expectedParticle = (i < largeParticlesCount) ? largeParticles[i] : particles[i - largeParticlesCount];
+            Assert::AreEqual(loadedParticles[i].index, i, testName);
+            Assert::AreEqual(loadedParticles[i].diameter, expectedParticle.diameter, testName);
+            for (int j = 0; j < DIMENSIONS; ++j)
+            {
+                Assert::AreEqual(loadedParticles[i].coordinates[j], expectedParticle.coordinates[j], testName);
+            }
+        }
+
+        TearDown();
+    }
+
     void PackingSerializerTests::SerializeInsertionRadii_InBigEndian_DataIsDifferentWhenLoadingInLittleEndian()
     {
         SetUp();
@@ -220,6 +261,7 @@ namespace Tests
         SavePacking_InBigEndian_PackingIsNotChanged();
         SavePacking_InBigEndian_PackingIsCorrectWhenLoadedInBigEndian();
         SavePacking_InLittleEndian_PackingIsCorrectWhenLoadedInLittleEndian();
+        SavePacking_ForSeveralChunks_PackingIsCorrectWhenLoaded();
 
         SerializeInsertionRadii_InBigEndian_DataIsDifferentWhenLoadingInLittleEndian();
         SerializeInsertionRadii_InLittleEndian_DataIsDifferentWhenLoadingInBigEndian();
@@ -0,0 +1,30 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/PackingTestUtilities.h"
+
+#include "Core/Headers/Math.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace Core;
+using namespace Model;
+
+namespace Tests
+{
+    void PackingTestUtilities::FillRandomParticles(const SystemConfig& config, int seed, FLOAT_TYPE minDiameter, FLOAT_TYPE maxDiameter, Packing* particles)
+    {
+        Packing& particlesRef = *particles;
+        Math::SetSeed(seed);
+        for (ParticleIndex particleIndex = 0; particleIndex < config.particlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                coordinates[i] = config.packingSize[i] * Math::GetNextRandom();
+            }
+            FLOAT_TYPE diameter = minDiameter + (maxDiameter - minDiameter) * Math::GetNextRandom();
+            particlesRef[particleIndex] = DomainParticle(particleIndex, diameter, coordinates);
+        }
+    }
+}
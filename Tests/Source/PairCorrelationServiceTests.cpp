@@ -0,0 +1,124 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/PairCorrelationServiceTests.h"
+
+#include <stdio.h>
+#include "../Headers/Assert.h"
+#include "../Headers/PackingTestUtilities.h"
+#include "Core/Headers/Math.h"
+#include "Generation/PackingServices/PostProcessing/Headers/PairCorrelationService.h"
+#include "Generation/PackingServices/DistanceServices/Headers/DistanceService.h"
+#include "Generation/PackingServices/DistanceServices/Headers/CellListNeighborProvider.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/PackingServices/Headers/GeometryCollisionService.h"
+#include "Generation/Geometries/Headers/BulkGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+using namespace PackingServices;
+
+namespace Tests
+{
+    boost::shared_ptr<MathService> PairCorrelationServiceTests::mathService;
+    boost::shared_ptr<GeometryService> PairCorrelationServiceTests::geometryService;
+    boost::shared_ptr<GeometryCollisionService> PairCorrelationServiceTests::geometryCollisionService;
+    boost::shared_ptr<CellListNeighborProvider> PairCorrelationServiceTests::neighborProvider;
+    boost::shared_ptr<DistanceService> PairCorrelationServiceTests::distanceService;
+    boost::shared_ptr<PairCorrelationService> PairCorrelationServiceTests::pairCorrelationService;
+
+    boost::shared_ptr<IGeometry> PairCorrelationServiceTests::geometry;
+    boost::shared_ptr<SystemConfig> PairCorrelationServiceTests::config;
+    boost::shared_ptr<ModellingContext> PairCorrelationServiceTests::context;
+    Packing PairCorrelationServiceTests::particles;
+
+    void PairCorrelationServiceTests::SetUp(int particlesCount, FLOAT_TYPE boxSize)
+    {
+        mathService.reset(new MathService());
+        geometryService.reset(new GeometryService(mathService.get()));
+        geometryCollisionService.reset(new GeometryCollisionService());
+        neighborProvider.reset(new CellListNeighborProvider(geometryService.get(), geometryCollisionService.get()));
+        distanceService.reset(new DistanceService(mathService.get(), geometryService.get(), neighborProvider.get()));
+        pairCorrelationService.reset(new PairCorrelationService(mathService.get(), geometryService.get(), 3));
+
+        config.reset(new SystemConfig());
+        SpatialVector packingSize = REMOVE_LAST_DIMENSION_IF_NEEDED(boxSize, boxSize, boxSize);
+        config->packingSize = packingSize;
+        config->particlesCount = particlesCount;
+        config->boundariesMode = BoundariesMode::Bulk;
+
+        geometry.reset(new BulkGeometry(*config.get()));
+        context.reset(new ModellingContext(config.get(), geometry.get()));
+
+        distanceService->SetContext(*context.get());
+        pairCorrelationService->SetContext(*context.get());
+
+        particles.resize(config->particlesCount);
+    }
+
+    void PairCorrelationServiceTests::TearDown()
+    {
+    }
+
+    void PairCorrelationServiceTests::FillNaivePairCorrelationFunction(PairCorrelationFunction* pairCorrelationFunction)
+    {
+        distanceService->SetParticles(particles);
+        distanceService->FillPairCorrelationFunction(pairCorrelationFunction);
+    }
+
+    void PairCorrelationServiceTests::AssertSameAsNaive(string callerName)
+    {
+        PairCorrelationFunction expectedFunction;
+        FillNaivePairCorrelationFunction(&expectedFunction);
+
+        PairCorrelationFunction actualFunction;
+        pairCorrelationService->FillPairCorrelationFunction(particles, &actualFunction);
+
+        Assert::AreEqual(actualFunction.binLeftEdges.size(), expectedFunction.binLeftEdges.size(), callerName);
+        for (size_t binIndex = 0; binIndex < expectedFunction.binLeftEdges.size(); ++binIndex)
+        {
+            Assert::AreEqual(actualFunction.binLeftEdges[binIndex], expectedFunction.binLeftEdges[binIndex], callerName);
+            Assert::AreEqual(actualFunction.binParticleCounts[binIndex], expectedFunction.binParticleCounts[binIndex], callerName);
+            Assert::AreEqual(actualFunction.pairCorrelationFunctionValues[binIndex], expectedFunction.pairCorrelationFunctionValues[binIndex], callerName);
+        }
+    }
+
+    void PairCorrelationServiceTests::FillPairCorrelationFunction_ForLargeBox_SameAsNaive()
+    {
+        string testName = "FillPairCorrelationFunction_ForLargeBox_SameAsNaive";
+        printf("%s\n", testName.c_str());
+
+        // The cutoff is about 3, so there are three cells per side
+        SetUp(2000, 10.0);
+        PackingTestUtilities::FillRandomParticles(*config, 41, 0.3, 0.7, &particles);
+
+        AssertSameAsNaive(testName);
+
+        TearDown();
+    }
+
+    void PairCorrelationServiceTests::FillPairCorrelationFunction_ForSmallBox_SameAsNaive()
+    {
+        string testName = "FillPairCorrelationFunction_ForSmallBox_SameAsNaive";
+        printf("%s\n", testName.c_str());
+
+        // The cutoff is larger than the box, so all the pairs are scanned
+        SetUp(200, 5.0);
+        PackingTestUtilities::FillRandomParticles(*config, 43, 0.5, 1.5, &particles);
+
+        AssertSameAsNaive(testName);
+
+        TearDown();
+    }
+
+    void PairCorrelationServiceTests::RunTests()
+    {
+        FillPairCorrelationFunction_ForLargeBox_SameAsNaive();
+        FillPairCorrelationFunction_ForSmallBox_SameAsNaive();
+    }
+}
@@ -0,0 +1,198 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/ScatteringSumsKernelTests.h"
+
+#include <stdio.h>
+#include <cmath>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/Constants.h"
+#include "Generation/PackingServices/DistanceServices/Headers/DistanceService.h"
+#include "Generation/PackingServices/DistanceServices/Headers/CellListNeighborProvider.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/PackingServices/Headers/GeometryCollisionService.h"
+#include "Generation/Geometries/Headers/BulkGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+using namespace PackingServices;
+
+namespace Tests
+{
+    boost::shared_ptr<MathService> ScatteringSumsKernelTests::mathService;
+    boost::shared_ptr<GeometryService> ScatteringSumsKernelTests::geometryService;
+    boost::shared_ptr<GeometryCollisionService> ScatteringSumsKernelTests::geometryCollisionService;
+    boost::shared_ptr<CellListNeighborProvider> ScatteringSumsKernelTests::neighborProvider;
+    boost::shared_ptr<DistanceService> ScatteringSumsKernelTests::distanceService;
+
+    boost::shared_ptr<IGeometry> ScatteringSumsKernelTests::geometry;
+    boost::shared_ptr<SystemConfig> ScatteringSumsKernelTests::config;
+    boost::shared_ptr<ModellingContext> ScatteringSumsKernelTests::context;
+    Packing ScatteringSumsKernelTests::firstParticles;
+    Packing ScatteringSumsKernelTests::secondParticles;
+
+    void ScatteringSumsKernelTests::SetUp()
+    {
+        mathService.reset(new MathService());
+        geometryService.reset(new GeometryService(mathService.get()));
+        geometryCollisionService.reset(new GeometryCollisionService());
+        neighborProvider.reset(new CellListNeighborProvider(geometryService.get(), geometryCollisionService.get()));
+        distanceService.reset(new DistanceService(mathService.get(), geometryService.get(), neighborProvider.get()));
+        distanceService->threadsCount = 3;
+
+        // Several blocks of particles, the last one is incomplete
+        config.reset(new SystemConfig());
+        SpatialVector packingSize = REMOVE_LAST_DIMENSION_IF_NEEDED(10.0, 11.0, 12.0);
+        config->packingSize = packingSize;
+        config->particlesCount = 1300;
+        config->boundariesMode = BoundariesMode::Bulk;
+
+        geometry.reset(new BulkGeometry(*config.get()));
+        context.reset(new ModellingContext(config.get(), geometry.get()));
+
+        distanceService->SetContext(*context.get());
+
+        Math::SetSeed(67);
+        FillRandomParticles(&firstParticles);
+        FillRandomParticles(&secondParticles);
+    }
+
+    void ScatteringSumsKernelTests::TearDown()
+    {
+    }
+
+    void ScatteringSumsKernelTests::FillRandomParticles(Packing* particles)
+    {
+        particles->resize(config->particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                // Some particles lie slightly outside the box
+                coordinates[i] = config->packingSize[i] * (1.02 * Math::GetNextRandom() - 0.01);
+            }
+            particles->at(particleIndex) = DomainParticle(particleIndex, 1.0, coordinates);
+        }
+    }
+
+    void ScatteringSumsKernelTests::AssertSameAsNaive(const Packing& firstPacking, const Packing& secondPacking, const vector<SpatialVector>& waveVectors, string callerName)
+    {
+        vector<FLOAT_TYPE> expectedValues;
+        vector<FLOAT_TYPE> expectedSelfPartValues;
+        distanceService->FillIntermediateScatteringFunctionForWaveVectorsNaive(*config, firstPacking, secondPacking, waveVectors, &expectedValues, &expectedSelfPartValues);
+
+        vector<FLOAT_TYPE> actualValues;
+        vector<FLOAT_TYPE> actualSelfPartValues;
+        distanceService->FillIntermediateScatteringFunctionForWaveVectors(*config, firstPacking, secondPacking, waveVectors, &actualValues, &actualSelfPartValues);
+
+        Assert::AreEqual(actualValues.size(), expectedValues.size(), callerName);
+        Assert::AreEqual(actualSelfPartValues.size(), expectedSelfPartValues.size(), callerName);
+        for (size_t i = 0; i < expectedValues.size(); ++i)
+        {
+            // The values are of the order of one, the sums of N terms may differ in the order of summation
+            Assert::IsTrue(std::abs(actualValues[i] - expectedValues[i]) < 1e-9, callerName);
+            Assert::IsTrue(std::abs(actualSelfPartValues[i] - expectedSelfPartValues[i]) < 1e-9, callerName);
+        }
+    }
+
+    void ScatteringSumsKernelTests::FillIntermediateScatteringFunction_ForSamePackings_SameAsNaive()
+    {
+        string testName = "FillIntermediateScatteringFunction_ForSamePackings_SameAsNaive";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        vector<SpatialVector> waveVectors;
+        vector<FLOAT_TYPE> waveVectorLengths;
+        distanceService->FillPeriodicWaveVectors(*config, 2.0 * PI, 0.3, &waveVectors, &waveVectorLengths);
+
+        AssertSameAsNaive(firstParticles, firstParticles, waveVectors, testName);
+
+        TearDown();
+    }
+
+    void ScatteringSumsKernelTests::FillIntermediateScatteringFunction_ForDifferentPackings_SameAsNaive()
+    {
+        string testName = "FillIntermediateScatteringFunction_ForDifferentPackings_SameAsNaive";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        // All the signs of the wave indexes
+        vector<SpatialVector> waveVectors;
+        for (int i = -3; i <= 3; ++i)
+        {
+            for (int j = -3; j <= 3; ++j)
+            {
+                for (int k = -3; k <= 3; ++k)
+                {
+                    SpatialVector waveVector = REMOVE_LAST_DIMENSION_IF_NEEDED(2.0 * PI * i / config->packingSize[Axis::X],
+                            2.0 * PI * j / config->packingSize[Axis::Y], 2.0 * PI * k / config->packingSize[Axis::Z]);
+                    waveVectors.push_back(waveVector);
+                }
+            }
+        }
+
+        AssertSameAsNaive(firstParticles, secondParticles, waveVectors, testName);
+
+        TearDown();
+    }
+
+    void ScatteringSumsKernelTests::FillIntermediateScatteringFunction_ForNotCommensurateWaveVectors_SameAsNaive()
+    {
+        string testName = "FillIntermediateScatteringFunction_ForNotCommensurateWaveVectors_SameAsNaive";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        vector<SpatialVector> waveVectors;
+        SpatialVector waveVector = REMOVE_LAST_DIMENSION_IF_NEEDED(1.0, 2.0, 3.0);
+        waveVectors.push_back(waveVector);
+
+        AssertSameAsNaive(firstParticles, secondParticles, waveVectors, testName);
+
+        TearDown();
+    }
+
+    void ScatteringSumsKernelTests::FillIntermediateScatteringFunction_ForDifferentThreadsCounts_SameValues()
+    {
+        string testName = "FillIntermediateScatteringFunction_ForDifferentThreadsCounts_SameValues";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        vector<SpatialVector> waveVectors;
+        vector<FLOAT_TYPE> waveVectorLengths;
+        distanceService->FillPeriodicWaveVectors(*config, 2.0 * PI, 0.3, &waveVectors, &waveVectorLengths);
+
+        vector<FLOAT_TYPE> expectedValues;
+        vector<FLOAT_TYPE> expectedSelfPartValues;
+        distanceService->FillIntermediateScatteringFunctionForWaveVectors(*config, firstParticles, secondParticles, waveVectors, &expectedValues, &expectedSelfPartValues);
+
+        // The particles are split into parts independently of the threads count, so the sums are the same bitwise
+        distanceService->threadsCount = 1;
+        vector<FLOAT_TYPE> actualValues;
+        vector<FLOAT_TYPE> actualSelfPartValues;
+        distanceService->FillIntermediateScatteringFunctionForWaveVectors(*config, firstParticles, secondParticles, waveVectors, &actualValues, &actualSelfPartValues);
+
+        Assert::AreEqual(actualValues.size(), expectedValues.size(), testName);
+        for (size_t i = 0; i < expectedValues.size(); ++i)
+        {
+            Assert::AreEqual(actualValues[i], expectedValues[i], testName);
+            Assert::AreEqual(actualSelfPartValues[i], expectedSelfPartValues[i], testName);
+        }
+
+        TearDown();
+    }
+
+    void ScatteringSumsKernelTests::RunTests()
+    {
+        FillIntermediateScatteringFunction_ForSamePackings_SameAsNaive();
+        FillIntermediateScatteringFunction_ForDifferentPackings_SameAsNaive();
+        FillIntermediateScatteringFunction_ForNotCommensurateWaveVectors_SameAsNaive();
+        FillIntermediateScatteringFunction_ForDifferentThreadsCounts_SameValues();
+    }
+}
@@ -0,0 +1,161 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/SphericalHarmonicsKernelTests.h"
+
+#include <stdio.h>
+#include <string>
+#include <cmath>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/Constants.h"
+#include "Core/Headers/VectorUtilities.h"
+#include "Core/Headers/SphericalHarmonicsKernel.h"
+#include "Core/Headers/SphericalHarmonicsComputer.h"
+
+using namespace std;
+using namespace Core;
+
+namespace Tests
+{
+    void SphericalHarmonicsKernelTests::FillFccNeighborDirections(vector<SpatialVector>* directions)
+    {
+        directions->clear();
+        for (int x = -1; x <= 1; ++x)
+        {
+            for (int y = -1; y <= 1; ++y)
+            {
+                for (int z = -1; z <= 1; ++z)
+                {
+                    int nonZeroCount = (x != 0) + (y != 0) + (z != 0);
+                    if (nonZeroCount == 2)
+                    {
+                        SpatialVector direction = {{x / sqrt(2.0), y / sqrt(2.0), z / sqrt(2.0)}};
+                        directions->push_back(direction);
+                    }
+                }
+            }
+        }
+    }
+
+    void SphericalHarmonicsKernelTests::AddSphericalHarmonicValues_ForLIsSix_SameAsAnalytical()
+    {
+        string testName = "AddSphericalHarmonicValues_ForLIsSix_SameAsAnalytical";
+        printf("%s\n", testName.c_str());
+
+        SphericalHarmonicsKernel kernel(8);
+        Math::SetSeed(79);
+        for (int directionIndex = 0; directionIndex < 100; ++directionIndex)
+        {
+            SpatialVector direction = {{Math::GetNextRandom() - 0.5, Math::GetNextRandom() - 0.5, Math::GetNextRandom() - 0.5}};
+            VectorUtilities::DivideByValue(direction, VectorUtilities::GetLength(direction), &direction);
+
+            vector<complex<FLOAT_TYPE> > values(kernel.GetValuesCount(), 0.0);
+            kernel.AddSphericalHarmonicValues(direction, &values[0]);
+
+            FLOAT_TYPE theta = acos(direction[2]);
+            FLOAT_TYPE phi = atan2(direction[1], direction[0]);
+            for (int m = 0; m <= 6; ++m)
+            {
+                complex<FLOAT_TYPE> expectedValue = SphericalHarmonicsComputer::GetAnalyticalSphericalHarmonicValue(theta, phi, 6, m);
+                complex<FLOAT_TYPE> actualValue = values[SphericalHarmonicsKernel::GetValueIndex(6, m)];
+                Assert::IsTrue(abs(actualValue - expectedValue) < 1e-12, testName);
+            }
+        }
+    }
+
+    void SphericalHarmonicsKernelTests::AddSphericalHarmonicValues_ForPoles_SameAsAnalytical()
+    {
+        string testName = "AddSphericalHarmonicValues_ForPoles_SameAsAnalytical";
+        printf("%s\n", testName.c_str());
+
+        // Only Y_l0 = sqrt((2 l + 1) / (4 pi)) * (+-1)^l are not zero at the poles
+        SphericalHarmonicsKernel kernel(8);
+        for (int sign = -1; sign <= 1; sign += 2)
+        {
+            SpatialVector direction = {{0.0, 0.0, static_cast<FLOAT_TYPE>(sign)}};
+            vector<complex<FLOAT_TYPE> > values(kernel.GetValuesCount(), 0.0);
+            kernel.AddSphericalHarmonicValues(direction, &values[0]);
+
+            for (int l = 0; l <= 8; ++l)
+            {
+                for (int m = 0; m <= l; ++m)
+                {
+                    FLOAT_TYPE expectedValue = (m == 0) ? sqrt((2.0 * l + 1.0) / (4.0 * PI)) * pow(static_cast<FLOAT_TYPE>(sign), l) : 0.0;
+                    Assert::IsTrue(abs(values[SphericalHarmonicsKernel::GetValueIndex(l, m)] - expectedValue) < 1e-12, testName);
+                }
+            }
+        }
+    }
+
+    void SphericalHarmonicsKernelTests::AddSphericalHarmonicValues_ForRandomDirection_SatisfiesAdditionTheorem()
+    {
+        string testName = "AddSphericalHarmonicValues_ForRandomDirection_SatisfiesAdditionTheorem";
+        printf("%s\n", testName.c_str());
+
+        // sum_m |Y_lm|^2 = (2 l + 1) / (4 pi) for any direction, which checks all the l, including the ones without analytical forms
+        const int maxL = 16;
+        SphericalHarmonicsKernel kernel(maxL);
+        Math::SetSeed(83);
+        for (int directionIndex = 0; directionIndex < 100; ++directionIndex)
+        {
+            SpatialVector direction = {{Math::GetNextRandom() - 0.5, Math::GetNextRandom() - 0.5, Math::GetNextRandom() - 0.5}};
+            VectorUtilities::DivideByValue(direction, VectorUtilities::GetLength(direction), &direction);
+
+            vector<complex<FLOAT_TYPE> > values(kernel.GetValuesCount(), 0.0);
+            kernel.AddSphericalHarmonicValues(direction, &values[0]);
+
+            for (int l = 0; l <= maxL; ++l)
+            {
+                FLOAT_TYPE expectedSquaresSum = (2.0 * l + 1.0) / (4.0 * PI);
+                Assert::AreAlmostEqual(SphericalHarmonicsKernel::GetSquaresSum(&values[0], l), expectedSquaresSum, testName, 1e-12);
+            }
+        }
+    }
+
+    void SphericalHarmonicsKernelTests::GetWignerSymbol_ForKnownSymbols_KnownValues()
+    {
+        string testName = "GetWignerSymbol_ForKnownSymbols_KnownValues";
+        printf("%s\n", testName.c_str());
+
+        // (1 1 1; 1 -1 0) = 1 / sqrt(6), (2 2 2; 0 0 0) = -sqrt(2 / 35), (2 2 2; 2 -2 0) = sqrt(2 / 35)
+        Assert::AreAlmostEqual(SphericalHarmonicsKernel::GetWignerSymbol(1, 1, -1), 1.0 / sqrt(6.0), testName, 1e-12);
+        Assert::AreAlmostEqual(SphericalHarmonicsKernel::GetWignerSymbol(2, 0, 0), -sqrt(2.0 / 35.0), testName, 1e-12);
+        Assert::AreAlmostEqual(SphericalHarmonicsKernel::GetWignerSymbol(2, 2, -2), sqrt(2.0 / 35.0), testName, 1e-12);
+        Assert::AreEqual(SphericalHarmonicsKernel::GetWignerSymbol(2, 2, 1), 0.0, testName);
+    }
+
+    void SphericalHarmonicsKernelTests::GetOrders_ForFccCluster_KnownValues()
+    {
+        string testName = "GetOrders_ForFccCluster_KnownValues";
+        printf("%s\n", testName.c_str());
+
+        vector<SpatialVector> directions;
+        FillFccNeighborDirections(&directions);
+
+        SphericalHarmonicsKernel kernel(8);
+        vector<complex<FLOAT_TYPE> > values(kernel.GetValuesCount(), 0.0);
+        for (size_t i = 0; i < directions.size(); ++i)
+        {
+            kernel.AddSphericalHarmonicValues(directions[i], &values[0]);
+        }
+
+        // See e.g. Mickel, Kapfer, Schroder-Turk, Mecke (2013) Shortcomings of the bond orientational order parameters for the analysis of disordered particulate matter
+        int count = directions.size();
+        Assert::AreAlmostEqual(SphericalHarmonicsKernel::GetOrder(&values[0], 4, count), 0.19094, testName, 1e-4);
+        Assert::AreAlmostEqual(SphericalHarmonicsKernel::GetOrder(&values[0], 6, count), 0.57452, testName, 1e-4);
+        Assert::AreAlmostEqual(SphericalHarmonicsKernel::GetOrder(&values[0], 8, count), 0.40391, testName, 1e-4);
+        Assert::AreAlmostEqual(kernel.GetWignerOrder(&values[0], 4), -0.15932, testName, 1e-4);
+        Assert::AreAlmostEqual(kernel.GetWignerOrder(&values[0], 6), -0.01316, testName, 1e-3);
+    }
+
+    void SphericalHarmonicsKernelTests::RunTests()
+    {
+        AddSphericalHarmonicValues_ForLIsSix_SameAsAnalytical();
+        AddSphericalHarmonicValues_ForPoles_SameAsAnalytical();
+        AddSphericalHarmonicValues_ForRandomDirection_SatisfiesAdditionTheorem();
+        GetWignerSymbol_ForKnownSymbols_KnownValues();
+        GetOrders_ForFccCluster_KnownValues();
+    }
+}
@@ -0,0 +1,127 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/TaskCostEstimatorTests.h"
+
+#include <stdio.h>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Path.h"
+#include "Core/Headers/ScopedFile.h"
+#include "Generation/Constants.h"
+#include "Generation/Model/Headers/Config.h"
+#include "Execution/Headers/TaskCostEstimator.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Generation;
+using namespace Execution;
+
+namespace Tests
+{
+    boost::shared_ptr<TaskCostEstimator> TaskCostEstimatorTests::costEstimator;
+    boost::shared_ptr<GenerationConfig> TaskCostEstimatorTests::generationConfig;
+    vector<string> TaskCostEstimatorTests::folders;
+
+    const string TaskCostEstimatorTests::baseFolder = "task_cost_estimator_tests";
+
+    void TaskCostEstimatorTests::SetUp()
+    {
+        costEstimator.reset(new TaskCostEstimator());
+        generationConfig.reset(new GenerationConfig());
+        generationConfig->executionMode = ExecutionMode::PackingGeneration;
+        generationConfig->generationAlgorithm = PackingGenerationAlgorithm::ForceBiasedAlgorithm;
+
+        folders.clear();
+        Path::EnsureClearDirectory(baseFolder);
+    }
+
+    void TaskCostEstimatorTests::TearDown()
+    {
+        Path::DeleteFolder(baseFolder);
+    }
+
+    void TaskCostEstimatorTests::CreateFolder(string folderName, int particlesCount)
+    {
+        string folder = Path::Append(baseFolder, folderName);
+        Path::EnsureDirectory(folder);
+        ScopedFile<ExceptionErrorHandler> configFile(Path::Append(folder, CONFIG_FILE_NAME), FileOpenMode::Write);
+        fprintf(configFile, "Particles count: %d\n", particlesCount);
+        folders.push_back(folder);
+    }
+
+    void TaskCostEstimatorTests::GetModelCost_ForMoreParticles_LargerCost()
+    {
+        string testName = "GetModelCost_ForMoreParticles_LargerCost";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        FLOAT_TYPE smallPackingCost = costEstimator->GetModelCost(*generationConfig, 1000);
+        FLOAT_TYPE largePackingCost = costEstimator->GetModelCost(*generationConfig, 1000000);
+        Assert::IsTrue(largePackingCost > 1000.0 * smallPackingCost, testName);
+
+        // Lubachevsky-Stillinger is slower than the force-biased algorithm
+        generationConfig->generationAlgorithm = PackingGenerationAlgorithm::LubachevskyStillingerSimple;
+        Assert::IsTrue(costEstimator->GetModelCost(*generationConfig, 1000) > smallPackingCost, testName);
+
+        TearDown();
+    }
+
+    void TaskCostEstimatorTests::FillCosts_ForRecordedTime_RecordedTimeUsedAndOtherCostsCalibrated()
+    {
+        string testName = "FillCosts_ForRecordedTime_RecordedTimeUsedAndOtherCostsCalibrated";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        CreateFolder("recorded", 1000);
+        CreateFolder("same", 1000);
+        CreateFolder("larger", 2000);
+
+        generationConfig->baseFolder = folders[0];
+        costEstimator->RecordExecutionTime(*generationConfig, 50.0);
+
+        // The records of other algorithms are ignored
+        generationConfig->generationAlgorithm = PackingGenerationAlgorithm::LubachevskyStillingerSimple;
+        costEstimator->RecordExecutionTime(*generationConfig, 1000.0);
+        generationConfig->generationAlgorithm = PackingGenerationAlgorithm::ForceBiasedAlgorithm;
+
+        vector<FLOAT_TYPE> costs;
+        costEstimator->FillCosts(*generationConfig, folders, &costs);
+
+        FLOAT_TYPE expectedLargerCost = 50.0 * costEstimator->GetModelCost(*generationConfig, 2000) / costEstimator->GetModelCost(*generationConfig, 1000);
+        Assert::AreEqual(static_cast<int>(costs.size()), 3, testName);
+        Assert::AreAlmostEqual(costs[0], 50.0, testName);
+        Assert::AreAlmostEqual(costs[1], 50.0, testName);
+        Assert::AreAlmostEqual(costs[2], expectedLargerCost, testName);
+
+        TearDown();
+    }
+
+    void TaskCostEstimatorTests::FillCosts_ForGeneratedPacking_ZeroCost()
+    {
+        string testName = "FillCosts_ForGeneratedPacking_ZeroCost";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        CreateFolder("generated", 1000);
+        CreateFolder("new", 1000);
+        ScopedFile<ExceptionErrorHandler> infoFile(Path::Append(folders[0], PACKING_FILE_NAME_NFO), FileOpenMode::Write);
+        infoFile.Close();
+
+        vector<FLOAT_TYPE> costs;
+        costEstimator->FillCosts(*generationConfig, folders, &costs);
+
+        Assert::AreEqual(costs[0], 0.0, testName);
+        Assert::IsTrue(costs[1] > 0.0, testName);
+
+        TearDown();
+    }
+
+    void TaskCostEstimatorTests::RunTests()
+    {
+        GetModelCost_ForMoreParticles_LargerCost();
+        FillCosts_ForRecordedTime_RecordedTimeUsedAndOtherCostsCalibrated();
+        FillCosts_ForGeneratedPacking_ZeroCost();
+    }
+}
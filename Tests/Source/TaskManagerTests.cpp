@@ -0,0 +1,162 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/TaskManagerTests.h"
+
+#include <stdio.h>
+#include <algorithm>
+#include "../Headers/Assert.h"
+#include "Core/Headers/TimeBudget.h"
+#include "Core/Headers/Utilities.h"
+#include "Parallelism/Headers/TaskManager.h"
+
+using namespace std;
+using namespace Core;
+using namespace Parallelism;
+
+namespace Tests
+{
+    vector<int> TaskManagerTests::startedTaskIds;
+    std::mutex TaskManagerTests::startedTaskIdsMutex;
+
+    TaskManagerTests::TaskStub::TaskStub(int id, FLOAT_TYPE weight)
+    {
+        this->id = id;
+        this->weight = weight;
+    }
+
+    int TaskManagerTests::TaskStub::GetId() const
+    {
+        return id;
+    }
+
+    FLOAT_TYPE TaskManagerTests::TaskStub::GetWeight() const
+    {
+        return weight;
+    }
+
+    void TaskManagerTests::TaskStub::Execute()
+    {
+        std::lock_guard<std::mutex> lock(startedTaskIdsMutex);
+        startedTaskIds.push_back(id);
+    }
+
+    void TaskManagerTests::TaskFactoryStub::FillTasks(vector<boost::shared_ptr<ITask> >* tasks)
+    {
+        for (size_t i = 0; i < weights.size(); ++i)
+        {
+            tasks->push_back(boost::shared_ptr<ITask>(new TaskStub(static_cast<int>(i), weights[i])));
+        }
+    }
+
+    void TaskManagerTests::SetUp()
+    {
+        startedTaskIds.clear();
+    }
+
+    void TaskManagerTests::TearDown()
+    {
+        TimeBudget::GetInstance()->Start(0.0);
+    }
+
+    void TaskManagerTests::SubmitTasks_ForDifferentWeights_HeaviestTasksStartFirst()
+    {
+        string testName = "SubmitTasks_ForDifferentWeights_HeaviestTasksStartFirst";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        TaskFactoryStub taskFactory;
+        FLOAT_TYPE weights[] = {1.0, 30.0, 0.0, 200.0, 5.0};
+        taskFactory.weights.assign(weights, weights + 5);
+
+        TaskManager taskManager(&taskFactory);
+        taskManager.SubmitTasks();
+
+        int expectedTaskIds[] = {3, 1, 4, 0, 2};
+        Assert::AreEqual(static_cast<int>(startedTaskIds.size()), 5, testName);
+        for (int i = 0; i < 5; ++i)
+        {
+            Assert::AreEqual(startedTaskIds[i], expectedTaskIds[i], testName);
+        }
+
+        TearDown();
+    }
+
+    void TaskManagerTests::SubmitTasks_ForEqualWeights_TasksStartInOriginalOrder()
+    {
+        string testName = "SubmitTasks_ForEqualWeights_TasksStartInOriginalOrder";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        TaskFactoryStub taskFactory;
+        taskFactory.weights.assign(6, 1.0);
+
+        TaskManager taskManager(&taskFactory);
+        taskManager.SubmitTasks();
+
+        Assert::AreEqual(static_cast<int>(startedTaskIds.size()), 6, testName);
+        for (int i = 0; i < 6; ++i)
+        {
+            Assert::AreEqual(startedTaskIds[i], i, testName);
+        }
+
+        TearDown();
+    }
+
+    void TaskManagerTests::SubmitTasks_ForSeveralThreads_AllTasksExecutedOnce()
+    {
+        string testName = "SubmitTasks_ForSeveralThreads_AllTasksExecutedOnce";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        const int tasksCount = 20;
+        TaskFactoryStub taskFactory;
+        for (int i = 0; i < tasksCount; ++i)
+        {
+            taskFactory.weights.push_back(i % 7);
+        }
+
+        TaskManager taskManager(&taskFactory);
+        taskManager.concurrentTasksCount = 3;
+        taskManager.SubmitTasks();
+
+        // The start order depends on the thread scheduling
+        Assert::AreEqual(static_cast<int>(startedTaskIds.size()), tasksCount, testName);
+        std::sort(startedTaskIds.begin(), startedTaskIds.end());
+        for (int i = 0; i < tasksCount; ++i)
+        {
+            Assert::AreEqual(startedTaskIds[i], i, testName);
+        }
+
+        TearDown();
+    }
+
+    void TaskManagerTests::SubmitTasks_ForExpiredTimeBudget_NoTasksStarted()
+    {
+        string testName = "SubmitTasks_ForExpiredTimeBudget_NoTasksStarted";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        TaskFactoryStub taskFactory;
+        taskFactory.weights.assign(4, 1.0);
+
+        TimeBudget::GetInstance()->Start(1e-3);
+        Utilities::Sleep(10);
+
+        TaskManager taskManager(&taskFactory);
+        taskManager.SubmitTasks();
+
+        Assert::AreEqual(static_cast<int>(startedTaskIds.size()), 0, testName);
+
+        TearDown();
+    }
+
+    void TaskManagerTests::RunTests()
+    {
+        SubmitTasks_ForDifferentWeights_HeaviestTasksStartFirst();
+        SubmitTasks_ForEqualWeights_TasksStartInOriginalOrder();
+        SubmitTasks_ForSeveralThreads_AllTasksExecutedOnce();
+        SubmitTasks_ForExpiredTimeBudget_NoTasksStarted();
+    }
+}
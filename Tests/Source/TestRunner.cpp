@@ -13,10 +13,34 @@
 #include "../Headers/ByteUtilityTests.h"
 #include "../Headers/PackingSerializerTests.h"
 #include "../Headers/OrderedPriorityQueueTests.h"
+#include "../Headers/CalendarOrderedPriorityQueueTests.h"
+#include "../Headers/KeyOrderedPriorityQueueTests.h"
 #include "../Headers/ParticleCollisionServiceTests.h"
 #include "../Headers/VelocityServiceTests.h"
 #include "../Headers/GeometryCollisionServiceTests.h"
 #include "../Headers/ClosestJammingStepTests.h"
+#include "../Headers/CellListNeighborProviderTests.h"
+#include "../Headers/HierarchicalCellListNeighborProviderTests.h"
+#include "../Headers/VerletSkinTunerTests.h"
+#include "../Headers/VerletListNeighborProviderTests.h"
+#include "../Headers/GridClosestPairServiceTests.h"
+#include "../Headers/EnergyServiceTests.h"
+#include "../Headers/PairCorrelationServiceTests.h"
+#include "../Headers/FastFourierTransformTests.h"
+#include "../Headers/GriddedStructureFactorServiceTests.h"
+#include "../Headers/ScatteringSumsKernelTests.h"
+#include "../Headers/CounterBasedRandomTests.h"
+#include "../Headers/InsertionRadiiSamplerTests.h"
+#include "../Headers/SphericalHarmonicsKernelTests.h"
+#include "../Headers/OrderServiceTests.h"
+#include "../Headers/VoronoiTesselationBuilderTests.h"
+#include "../Headers/AsyncPackingWriterTests.h"
+#include "../Headers/CheckpointSerializerTests.h"
+#include "../Headers/LubachevsckyStillingerStepTests.h"
+#include "../Headers/TaskManagerTests.h"
+#include "../Headers/TaskCostEstimatorTests.h"
+#include "../Headers/TimeBudgetTests.h"
+#include "../Headers/WorkingFolderIndexTests.h"
 
 namespace Tests
 {
@@ -25,10 +49,34 @@ namespace Tests
 //        ClosestJammingStepTests::RunTests(); TODO: fix
         HcpGeneratorTests::RunTests();
         ClosestPairProviderTests::RunTests();
+        GridClosestPairServiceTests::RunTests();
+        EnergyServiceTests::RunTests();
+        PairCorrelationServiceTests::RunTests();
+        FastFourierTransformTests::RunTests();
+        GriddedStructureFactorServiceTests::RunTests();
+        ScatteringSumsKernelTests::RunTests();
+        CounterBasedRandomTests::RunTests();
+        InsertionRadiiSamplerTests::RunTests();
+        SphericalHarmonicsKernelTests::RunTests();
+        OrderServiceTests::RunTests();
+        VoronoiTesselationBuilderTests::RunTests();
+        CellListNeighborProviderTests::RunTests();
+        HierarchicalCellListNeighborProviderTests::RunTests();
+        VerletListNeighborProviderTests::RunTests();
+        VerletSkinTunerTests::RunTests();
         ColumnMajorIndexingProviderTests::RunTests();
         ByteUtilityTests::RunTests();
         PackingSerializerTests::RunTests();
+        AsyncPackingWriterTests::RunTests();
+        CheckpointSerializerTests::RunTests();
+        LubachevsckyStillingerStepTests::RunTests();
+        TaskManagerTests::RunTests();
+        TaskCostEstimatorTests::RunTests();
+        TimeBudgetTests::RunTests();
+        WorkingFolderIndexTests::RunTests();
         OrderedPriorityQueueTests::RunTests();
+        CalendarOrderedPriorityQueueTests::RunTests();
+        KeyOrderedPriorityQueueTests::RunTests();
         ParticleCollisionServiceTests::RunTests();
         GeometryCollisionServiceTests::RunTests();
         VelocityServiceTests::RunTests();
@@ -0,0 +1,86 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/TimeBudgetTests.h"
+
+#include <stdio.h>
+#include <string>
+#include "../Headers/Assert.h"
+#include "Core/Headers/TimeBudget.h"
+#include "Core/Headers/Utilities.h"
+
+using namespace std;
+using namespace Core;
+
+namespace Tests
+{
+    void TimeBudgetTests::TearDown()
+    {
+        TimeBudget::GetInstance()->Start(0.0);
+    }
+
+    void TimeBudgetTests::IsExpired_ForNotPositiveBudget_False()
+    {
+        string testName = "IsExpired_ForNotPositiveBudget_False";
+        printf("%s\n", testName.c_str());
+
+        TimeBudget* timeBudget = TimeBudget::GetInstance();
+        timeBudget->Start(0.0);
+        Assert::IsTrue(!timeBudget->IsLimited(), testName);
+        Assert::IsTrue(!timeBudget->IsExpired(), testName);
+
+        timeBudget->Start(-1.0);
+        Assert::IsTrue(!timeBudget->IsLimited(), testName);
+        Assert::IsTrue(!timeBudget->IsExpired(), testName);
+
+        TearDown();
+    }
+
+    void TimeBudgetTests::IsExpired_ForElapsedBudget_True()
+    {
+        string testName = "IsExpired_ForElapsedBudget_True";
+        printf("%s\n", testName.c_str());
+
+        TimeBudget* timeBudget = TimeBudget::GetInstance();
+        timeBudget->Start(3600.0);
+        Assert::IsTrue(timeBudget->IsLimited(), testName);
+        Assert::IsTrue(!timeBudget->IsExpired(), testName);
+
+        timeBudget->Start(1e-3);
+        Utilities::Sleep(10);
+        Assert::IsTrue(timeBudget->IsExpired(), testName);
+
+        TearDown();
+    }
+
+    void TimeBudgetTests::ThrowIfExpired_ForElapsedBudget_Throws()
+    {
+        string testName = "ThrowIfExpired_ForElapsedBudget_Throws";
+        printf("%s\n", testName.c_str());
+
+        TimeBudget* timeBudget = TimeBudget::GetInstance();
+        timeBudget->Start(1e-3);
+        Utilities::Sleep(10);
+
+        bool exceptionThrown = false;
+        try
+        {
+            timeBudget->ThrowIfExpired();
+        }
+        catch (TimeBudgetExpiredException&)
+        {
+            exceptionThrown = true;
+        }
+        Assert::IsTrue(exceptionThrown, testName);
+
+        TearDown();
+    }
+
+    void TimeBudgetTests::RunTests()
+    {
+        IsExpired_ForNotPositiveBudget_False();
+        IsExpired_ForElapsedBudget_True();
+        ThrowIfExpired_ForElapsedBudget_Throws();
+    }
+}
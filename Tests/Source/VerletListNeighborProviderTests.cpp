@@ -0,0 +1,163 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/VerletListNeighborProviderTests.h"
+
+#include <stdio.h>
+#include <vector>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Math.h"
+#include "Generation/PackingServices/DistanceServices/Headers/CellListNeighborProvider.h"
+#include "Generation/PackingServices/DistanceServices/Headers/VerletListNeighborProvider.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/PackingServices/Headers/GeometryService.h"
+#include "Generation/PackingServices/Headers/GeometryCollisionService.h"
+#include "Generation/Geometries/Headers/BulkGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+using namespace PackingServices;
+
+namespace Tests
+{
+    boost::shared_ptr<MathService> VerletListNeighborProviderTests::mathService;
+    boost::shared_ptr<GeometryService> VerletListNeighborProviderTests::geometryService;
+    boost::shared_ptr<GeometryCollisionService> VerletListNeighborProviderTests::geometryCollisionService;
+    boost::shared_ptr<CellListNeighborProvider> VerletListNeighborProviderTests::baseNeighborProvider;
+    boost::shared_ptr<VerletListNeighborProvider> VerletListNeighborProviderTests::neighborProvider;
+
+    boost::shared_ptr<IGeometry> VerletListNeighborProviderTests::geometry;
+    boost::shared_ptr<SystemConfig> VerletListNeighborProviderTests::config;
+    boost::shared_ptr<ModellingContext> VerletListNeighborProviderTests::context;
+    Packing VerletListNeighborProviderTests::particles;
+
+    void VerletListNeighborProviderTests::SetUp()
+    {
+        mathService.reset(new MathService());
+        geometryService.reset(new GeometryService(mathService.get()));
+        geometryCollisionService.reset(new GeometryCollisionService());
+        baseNeighborProvider.reset(new CellListNeighborProvider(geometryService.get(), geometryCollisionService.get()));
+        neighborProvider.reset(new VerletListNeighborProvider(geometryService.get(), mathService.get(), baseNeighborProvider.get(), geometryCollisionService.get()));
+
+        config.reset(new SystemConfig());
+        SpatialVector packingSize = REMOVE_LAST_DIMENSION_IF_NEEDED(10, 10, 10);
+        config->packingSize = packingSize;
+        config->particlesCount = 1000;
+        config->boundariesMode = BoundariesMode::Bulk;
+
+        geometry.reset(new BulkGeometry(*config.get()));
+        context.reset(new ModellingContext(config.get(), geometry.get()));
+
+        mathService->SetContext(*context.get());
+        geometryService->SetContext(*context.get());
+        neighborProvider->SetContext(*context.get());
+
+        // Random (overlapping) particles, so that there are many intersecting pairs
+        Math::SetSeed(23);
+        particles.resize(config->particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                coordinates[i] = config->packingSize[i] * Math::GetNextRandom();
+            }
+            particles[particleIndex] = DomainParticle(particleIndex, 0.5 + Math::GetNextRandom(), coordinates);
+        }
+
+        neighborProvider->SetParticles(particles);
+    }
+
+    void VerletListNeighborProviderTests::TearDown()
+    {
+    }
+
+    void VerletListNeighborProviderTests::MoveParticlesRandomly(int movesCount)
+    {
+        for (int move = 0; move < movesCount; ++move)
+        {
+            ParticleIndex particleIndex = static_cast<ParticleIndex>(Math::GetNextRandom() * (config->particlesCount - 1));
+
+            // Both small shifts (inside the half-cutoff sphere) and large jumps
+            FLOAT_TYPE maxShift = (move % 10 == 0) ? 5.0 : 0.5;
+            neighborProvider->StartMove(particleIndex);
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                FLOAT_TYPE coordinate = particles[particleIndex].coordinates[i] + maxShift * (2.0 * Math::GetNextRandom() - 1.0);
+                particles[particleIndex].coordinates[i] = coordinate - config->packingSize[i] * std::floor(coordinate / config->packingSize[i]);
+            }
+            neighborProvider->EndMove();
+        }
+    }
+
+    void VerletListNeighborProviderTests::AssertListsCorrect(string callerName)
+    {
+        vector<vector<bool> > isNeighbor(config->particlesCount, vector<bool>(config->particlesCount, false));
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            ParticleIndex neighborsCount;
+            const ParticleIndex* neighborIndexes = neighborProvider->GetNeighborIndexes(particleIndex, &neighborsCount);
+            for (ParticleIndex i = 0; i < neighborsCount; ++i)
+            {
+                ParticleIndex neighborIndex = neighborIndexes[i];
+                Assert::IsTrue(neighborIndex != particleIndex, callerName + ": the particle is its own neighbor");
+                Assert::IsTrue(!isNeighbor[particleIndex][neighborIndex], callerName + ": duplicate neighbor");
+                isNeighbor[particleIndex][neighborIndex] = true;
+            }
+        }
+
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            for (ParticleIndex neighborIndex = 0; neighborIndex < config->particlesCount; ++neighborIndex)
+            {
+                Assert::IsTrue(isNeighbor[particleIndex][neighborIndex] == isNeighbor[neighborIndex][particleIndex], callerName + ": lists are not symmetric");
+
+                bool intersects = neighborIndex != particleIndex && mathService->GetNormalizedDistanceSquare(particleIndex, neighborIndex, particles) < 1.0;
+                if (intersects)
+                {
+                    Assert::IsTrue(isNeighbor[particleIndex][neighborIndex], callerName + ": intersecting neighbor not found");
+                }
+            }
+        }
+    }
+
+    void VerletListNeighborProviderTests::GetNeighborIndexes_AfterSetParticles_ListsCorrect()
+    {
+        string testName = "GetNeighborIndexes_AfterSetParticles_ListsCorrect";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        AssertListsCorrect(testName);
+
+        TearDown();
+    }
+
+    void VerletListNeighborProviderTests::GetNeighborIndexes_AfterMovesAndRebuild_ListsCorrect()
+    {
+        string testName = "GetNeighborIndexes_AfterMovesAndRebuild_ListsCorrect";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        // Many moves, so that some lists overflow, are moved and the storage is compacted
+        MoveParticlesRandomly(5000);
+        AssertListsCorrect(testName);
+
+        // Rebuild in the same storage with a larger cutoff distance
+        neighborProvider->SetCutoffDistance(1.5);
+        neighborProvider->SetParticles(particles);
+        MoveParticlesRandomly(5000);
+        AssertListsCorrect(testName);
+
+        TearDown();
+    }
+
+    void VerletListNeighborProviderTests::RunTests()
+    {
+        GetNeighborIndexes_AfterSetParticles_ListsCorrect();
+        GetNeighborIndexes_AfterMovesAndRebuild_ListsCorrect();
+    }
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/VerletSkinTunerTests.h"
+
+#include <cmath>
+#include "Generation/PackingServices/DistanceServices/Headers/VerletSkinTuner.h"
+#include "../Headers/Assert.h"
+
+using namespace std;
+using namespace Core;
+using namespace PackingServices;
+
+namespace Tests
+{
+    boost::shared_ptr<VerletSkinTuner> VerletSkinTunerTests::verletSkinTuner;
+
+    void VerletSkinTunerTests::SetUp()
+    {
+        verletSkinTuner.reset(new VerletSkinTuner());
+        verletSkinTuner->Initialize(1.0, 0.05, 2.0);
+    }
+
+    void VerletSkinTunerTests::TearDown()
+    {
+    }
+
+    FLOAT_TYPE VerletSkinTunerTests::Tune(FLOAT_TYPE listUpdatesCostFactor, FLOAT_TYPE listLengthCostFactor)
+    {
+        FLOAT_TYPE cutoffDistance = verletSkinTuner->GetCutoffDistance();
+        for (int i = 0; i < 200; ++i)
+        {
+            FLOAT_TYPE cost = listUpdatesCostFactor / cutoffDistance + listLengthCostFactor * cutoffDistance;
+            cutoffDistance = verletSkinTuner->GetNextCutoffDistance(cost);
+        }
+        return cutoffDistance;
+    }
+
+    void VerletSkinTunerTests::GetNextCutoffDistance_ForConvexCost_ConvergesToOptimum()
+    {
+        SetUp();
+
+        // The optimum is sqrt(1 / 16) = 0.25
+        FLOAT_TYPE cutoffDistance = Tune(1.0, 16.0);
+
+        Assert::IsTrue(std::abs(log(cutoffDistance / 0.25)) < log(1.25), "GetNextCutoffDistance_ForConvexCost_ConvergesToOptimum");
+        TearDown();
+    }
+
+    void VerletSkinTunerTests::GetNextCutoffDistance_ForOptimumBeyondMaxCutoff_StaysNearMaxCutoff()
+    {
+        SetUp();
+
+        // The optimum is sqrt(16) = 4, while the max cutoff is 2
+        FLOAT_TYPE cutoffDistance = Tune(16.0, 1.0);
+
+        Assert::IsTrue(cutoffDistance <= 2.0 && cutoffDistance > 2.0 / 1.25 - 1e-10, "GetNextCutoffDistance_ForOptimumBeyondMaxCutoff_StaysNearMaxCutoff");
+        TearDown();
+    }
+
+    void VerletSkinTunerTests::RunTests()
+    {
+        GetNextCutoffDistance_ForConvexCost_ConvergesToOptimum();
+        GetNextCutoffDistance_ForOptimumBeyondMaxCutoff_StaysNearMaxCutoff();
+    }
+}
@@ -0,0 +1,233 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/VoronoiTesselationBuilderTests.h"
+
+#include <stdio.h>
+#include <cmath>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Math.h"
+#include "Core/Headers/Constants.h"
+#include "Core/Headers/VectorUtilities.h"
+#include "Generation/PackingGenerators/LubachevsckyStillinger/Headers/VoronoiTesselationBuilder.h"
+#include "Generation/PackingServices/Headers/MathService.h"
+#include "Generation/Geometries/Headers/BulkGeometry.h"
+#include "Generation/Model/Headers/Config.h"
+
+using namespace std;
+using namespace Core;
+using namespace Model;
+using namespace Geometries;
+using namespace PackingServices;
+using namespace PackingGenerators;
+
+namespace Tests
+{
+    boost::shared_ptr<MathService> VoronoiTesselationBuilderTests::mathService;
+    boost::shared_ptr<VoronoiTesselationBuilder> VoronoiTesselationBuilderTests::tesselationBuilder;
+
+    boost::shared_ptr<IGeometry> VoronoiTesselationBuilderTests::geometry;
+    boost::shared_ptr<SystemConfig> VoronoiTesselationBuilderTests::config;
+    boost::shared_ptr<ModellingContext> VoronoiTesselationBuilderTests::context;
+    Packing VoronoiTesselationBuilderTests::particles;
+
+    void VoronoiTesselationBuilderTests::SetUp(int particlesCount, FLOAT_TYPE boxSize)
+    {
+        mathService.reset(new MathService());
+        tesselationBuilder.reset(new VoronoiTesselationBuilder(mathService.get(), 3));
+
+        config.reset(new SystemConfig());
+        SpatialVector packingSize = REMOVE_LAST_DIMENSION_IF_NEEDED(boxSize, boxSize, boxSize);
+        config->packingSize = packingSize;
+        config->particlesCount = particlesCount;
+        config->boundariesMode = BoundariesMode::Bulk;
+
+        geometry.reset(new BulkGeometry(*config.get()));
+        context.reset(new ModellingContext(config.get(), geometry.get()));
+
+        mathService->SetContext(*context.get());
+
+        particles.resize(config->particlesCount);
+    }
+
+    void VoronoiTesselationBuilderTests::TearDown()
+    {
+    }
+
+    FLOAT_TYPE VoronoiTesselationBuilderTests::GetSignedDistance(const SpatialVector& point, const VoronoiPlane& plane)
+    {
+        return VectorUtilities::GetDotProduct(point, plane.normal) + plane.displacement;
+    }
+
+    void VoronoiTesselationBuilderTests::FillOwnPlanes(ParticleIndex particleIndex, const vector<VoronoiPlane>& planes, vector<VoronoiPlane>* ownPlanes)
+    {
+        ownPlanes->clear();
+        const SpatialVector& center = particles[particleIndex].coordinates;
+        for (vector<VoronoiPlane>::const_iterator it = planes.begin(); it != planes.end(); ++it)
+        {
+            FLOAT_TYPE neighborDistance = mathService->GetDistanceLength(particles[it->neighborIndex].coordinates, center);
+            if (std::abs(std::abs(GetSignedDistance(center, *it)) - 0.5 * neighborDistance) < 1e-9)
+            {
+                ownPlanes->push_back(*it);
+            }
+        }
+    }
+
+    bool VoronoiTesselationBuilderTests::IsInsideOwnPlanes(const SpatialVector& point, ParticleIndex particleIndex, const vector<VoronoiPlane>& ownPlanes)
+    {
+        // The point is taken in the periodic image closest to the particle
+        const SpatialVector& center = particles[particleIndex].coordinates;
+        SpatialVector periodicPoint;
+        mathService->FillClosestPeriodicImagePosition(center, point, &periodicPoint);
+
+        for (vector<VoronoiPlane>::const_iterator it = ownPlanes.begin(); it != ownPlanes.end(); ++it)
+        {
+            bool sameSideAsCenter = GetSignedDistance(periodicPoint, *it) * GetSignedDistance(center, *it) > 0.0;
+            if (!sameSideAsCenter)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void VoronoiTesselationBuilderTests::FillVoronoiPlanes_ForCubicLattice_SixPlanesAtHalfSpacing()
+    {
+        string testName = "FillVoronoiPlanes_ForCubicLattice_SixPlanesAtHalfSpacing";
+        printf("%s\n", testName.c_str());
+
+        const int particlesPerSide = 4;
+        SetUp(particlesPerSide * particlesPerSide * particlesPerSide, particlesPerSide);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            int remainder = particleIndex;
+            SpatialVector coordinates;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                coordinates[i] = remainder % particlesPerSide + 0.5;
+                remainder /= particlesPerSide;
+            }
+            particles[particleIndex] = DomainParticle(particleIndex, 1.0, coordinates);
+        }
+
+        vector<vector<VoronoiPlane> > voronoiPlanesPerParticle;
+        tesselationBuilder->FillVoronoiPlanes(*config, particles, &voronoiPlanesPerParticle);
+
+        // The cells touch the box boundaries, but do not cross them, so there are no planes of the periodic images
+        Assert::AreEqual(static_cast<int>(voronoiPlanesPerParticle.size()), config->particlesCount, testName);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            const vector<VoronoiPlane>& planes = voronoiPlanesPerParticle[particleIndex];
+            Assert::AreEqual(static_cast<int>(planes.size()), 6, testName);
+            for (vector<VoronoiPlane>::const_iterator it = planes.begin(); it != planes.end(); ++it)
+            {
+                Assert::AreAlmostEqual(std::abs(GetSignedDistance(particles[particleIndex].coordinates, *it)), 0.5, testName);
+                Assert::AreAlmostEqual(mathService->GetDistanceLength(particles[it->neighborIndex].coordinates, particles[particleIndex].coordinates), 1.0, testName);
+            }
+        }
+
+        TearDown();
+    }
+
+    void VoronoiTesselationBuilderTests::FillVoronoiPlanes_ForRandomPacking_CellsContainClosestPoints()
+    {
+        string testName = "FillVoronoiPlanes_ForRandomPacking_CellsContainClosestPoints";
+        printf("%s\n", testName.c_str());
+
+        SetUp(300, 7.0);
+        Math::SetSeed(41);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            SpatialVector coordinates;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                coordinates[i] = config->packingSize[i] * Math::GetNextRandom();
+            }
+            particles[particleIndex] = DomainParticle(particleIndex, 1.0, coordinates);
+        }
+
+        vector<vector<VoronoiPlane> > voronoiPlanesPerParticle;
+        tesselationBuilder->FillVoronoiPlanes(*config, particles, &voronoiPlanesPerParticle);
+
+        vector<vector<VoronoiPlane> > ownPlanesPerParticle(config->particlesCount);
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            FillOwnPlanes(particleIndex, voronoiPlanesPerParticle[particleIndex], &ownPlanesPerParticle[particleIndex]);
+        }
+
+        // A point is inside the cell of the closest particle and outside the other cells, so no planes are missing or extra
+        const int pointsCount = 300;
+        for (int pointIndex = 0; pointIndex < pointsCount; ++pointIndex)
+        {
+            SpatialVector point;
+            for (int i = 0; i < DIMENSIONS; ++i)
+            {
+                point[i] = config->packingSize[i] * Math::GetNextRandom();
+            }
+
+            ParticleIndex closestParticleIndex = 0;
+            FLOAT_TYPE minDistanceSquare = MAX_FLOAT_VALUE;
+            for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+            {
+                FLOAT_TYPE distanceSquare = mathService->GetDistanceSquare(point, particles[particleIndex].coordinates);
+                if (distanceSquare < minDistanceSquare)
+                {
+                    minDistanceSquare = distanceSquare;
+                    closestParticleIndex = particleIndex;
+                }
+            }
+
+            for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+            {
+                bool pointInsideCell = IsInsideOwnPlanes(point, particleIndex, ownPlanesPerParticle[particleIndex]);
+                Assert::AreEqual(pointInsideCell, particleIndex == closestParticleIndex, testName);
+            }
+        }
+
+        TearDown();
+    }
+
+    void VoronoiTesselationBuilderTests::FillVoronoiPlanes_ForTwoParticlesInBox_TruncatedOctahedra()
+    {
+        string testName = "FillVoronoiPlanes_ForTwoParticlesInBox_TruncatedOctahedra";
+        printf("%s\n", testName.c_str());
+
+        // A body-centered cubic lattice. The cells are larger than half of the box, so the periodic images of the particles themselves are neighbors.
+        SetUp(2, 2.0);
+        SpatialVector firstCoordinates = REMOVE_LAST_DIMENSION_IF_NEEDED(0.5, 0.5, 0.5);
+        SpatialVector secondCoordinates = REMOVE_LAST_DIMENSION_IF_NEEDED(1.5, 1.5, 1.5);
+        particles[0] = DomainParticle(0, 1.0, firstCoordinates);
+        particles[1] = DomainParticle(1, 1.0, secondCoordinates);
+
+        vector<vector<VoronoiPlane> > voronoiPlanesPerParticle;
+        tesselationBuilder->FillVoronoiPlanes(*config, particles, &voronoiPlanesPerParticle);
+
+        // The planes of the cell itself go first: eight hexagons to the other particle and six squares to the own periodic images
+        for (ParticleIndex particleIndex = 0; particleIndex < config->particlesCount; ++particleIndex)
+        {
+            const vector<VoronoiPlane>& planes = voronoiPlanesPerParticle[particleIndex];
+            Assert::IsTrue(planes.size() >= 14, testName);
+
+            int hexagonsCount = 0;
+            int squaresCount = 0;
+            for (int planeIndex = 0; planeIndex < 14; ++planeIndex)
+            {
+                FLOAT_TYPE distance = std::abs(GetSignedDistance(particles[particleIndex].coordinates, planes[planeIndex]));
+                hexagonsCount += (std::abs(distance - 0.5 * sqrt(3.0)) < 1e-9 && planes[planeIndex].neighborIndex != particleIndex) ? 1 : 0;
+                squaresCount += (std::abs(distance - 1.0) < 1e-9 && planes[planeIndex].neighborIndex == particleIndex) ? 1 : 0;
+            }
+            Assert::AreEqual(hexagonsCount, 8, testName);
+            Assert::AreEqual(squaresCount, 6, testName);
+        }
+
+        TearDown();
+    }
+
+    void VoronoiTesselationBuilderTests::RunTests()
+    {
+        FillVoronoiPlanes_ForCubicLattice_SixPlanesAtHalfSpacing();
+        FillVoronoiPlanes_ForRandomPacking_CellsContainClosestPoints();
+        FillVoronoiPlanes_ForTwoParticlesInBox_TruncatedOctahedra();
+    }
+}
@@ -0,0 +1,138 @@
+// Copyright (c) 2013 Vasili Baranau
+// Distributed under the MIT software license
+// See the accompanying file License.txt or http://opensource.org/licenses/MIT
+
+#include "../Headers/WorkingFolderIndexTests.h"
+
+#include <stdio.h>
+#include <vector>
+#include "../Headers/Assert.h"
+#include "Core/Headers/Path.h"
+#include "Core/Headers/ScopedFile.h"
+#include "Core/Headers/Utilities.h"
+#include "Generation/Constants.h"
+#include "Execution/Headers/WorkingFolderIndex.h"
+
+using namespace std;
+using namespace Core;
+using namespace Generation;
+using namespace Execution;
+
+namespace Tests
+{
+    const string WorkingFolderIndexTests::baseFolder = "working_folder_index_tests";
+
+    void WorkingFolderIndexTests::SetUp()
+    {
+        Path::EnsureClearDirectory(baseFolder);
+
+        CreateFolder("a", "", "");
+        CreateFolder(Path::Append("a", "p2"), CONFIG_FILE_NAME, PACKING_FILE_NAME_NFO);
+        CreateFolder(Path::Append("a", "p1"), CONFIG_FILE_NAME, "");
+        CreateFolder("b", CONFIG_FILE_NAME, "packing.xyzd");
+        CreateFolder("c", "", "");
+        CreateFolder(Path::Append("c", "d"), "", "");
+        CreateFolder(Path::Append(Path::Append("c", "d"), "e"), PACKING_FILE_NAME_NFO, "");
+    }
+
+    void WorkingFolderIndexTests::TearDown()
+    {
+        Path::DeleteFolder(baseFolder);
+    }
+
+    void WorkingFolderIndexTests::CreateFolder(string folderName, string firstFileName, string secondFileName)
+    {
+        string folder = Path::Append(baseFolder, folderName);
+        Path::EnsureDirectory(folder);
+        if (!firstFileName.empty())
+        {
+            ScopedFile<ExceptionErrorHandler> file(Path::Append(folder, firstFileName), FileOpenMode::Write);
+        }
+        if (!secondFileName.empty())
+        {
+            ScopedFile<ExceptionErrorHandler> file(Path::Append(folder, secondFileName), FileOpenMode::Write);
+        }
+    }
+
+    void WorkingFolderIndexTests::AssertIndexCorrect(string testName)
+    {
+        WorkingFolderIndex folderIndex(baseFolder);
+        folderIndex.threadsCount = 3;
+        folderIndex.Update();
+        Assert::IsTrue(Path::Exists(Path::Append(baseFolder, FOLDER_INDEX_FILE_NAME)), testName);
+
+        vector<string> expectedFolders;
+        vector<string> actualFolders;
+        Path::FillFoldersRecursively(baseFolder, CONFIG_FILE_NAME, &expectedFolders);
+        folderIndex.FillConfigFolders(&actualFolders);
+        Assert::AreEqual(actualFolders.size(), expectedFolders.size(), testName);
+        Assert::AreVectorsEqual(actualFolders, expectedFolders, testName);
+
+        Path::FillFoldersRecursively(baseFolder, PACKING_FILE_NAME_NFO, &expectedFolders);
+        folderIndex.FillFinishedFolders(&actualFolders);
+        Assert::AreEqual(actualFolders.size(), expectedFolders.size(), testName);
+        Assert::AreVectorsEqual(actualFolders, expectedFolders, testName);
+    }
+
+    void WorkingFolderIndexTests::Update_ForFolderTree_SameFoldersAsRecursiveSearch()
+    {
+        string testName = "Update_ForFolderTree_SameFoldersAsRecursiveSearch";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        AssertIndexCorrect(testName);
+
+        // The folders are sorted by names, as in the recursive search
+        WorkingFolderIndex folderIndex(baseFolder);
+        folderIndex.Update();
+        vector<string> configFolders;
+        folderIndex.FillConfigFolders(&configFolders);
+        Assert::AreEqual(static_cast<int>(configFolders.size()), 3, testName);
+        Assert::AreEqual(configFolders[0], Path::Append(baseFolder, Path::Append("a", "p1")), testName);
+        Assert::AreEqual(configFolders[1], Path::Append(baseFolder, Path::Append("a", "p2")), testName);
+        Assert::AreEqual(configFolders[2], Path::Append(baseFolder, "b"), testName);
+
+        TearDown();
+    }
+
+    void WorkingFolderIndexTests::Update_ForChangedFoldersAfterPreviousIndex_ChangesFound()
+    {
+        string testName = "Update_ForChangedFoldersAfterPreviousIndex_ChangesFound";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        // The folders modified shortly before the scan are always listed, so the test waits to reuse the previous index
+        Utilities::Sleep(2500);
+        AssertIndexCorrect(testName);
+        AssertIndexCorrect(testName);
+
+        CreateFolder("b", PACKING_FILE_NAME_NFO, "");
+        CreateFolder(Path::Append("c", "f"), CONFIG_FILE_NAME, "");
+        Path::DeleteFolder(Path::Append(baseFolder, Path::Append("a", "p1")));
+        AssertIndexCorrect(testName);
+
+        TearDown();
+    }
+
+    void WorkingFolderIndexTests::Update_ForInvalidIndexFile_AllFoldersFound()
+    {
+        string testName = "Update_ForInvalidIndexFile_AllFoldersFound";
+        printf("%s\n", testName.c_str());
+        SetUp();
+
+        {
+            ScopedFile<ExceptionErrorHandler> file(Path::Append(baseFolder, FOLDER_INDEX_FILE_NAME), FileOpenMode::Write);
+            fprintf(file, "not an index");
+        }
+        AssertIndexCorrect(testName);
+
+        TearDown();
+    }
+
+    void WorkingFolderIndexTests::RunTests()
+    {
+        Update_ForFolderTree_SameFoldersAsRecursiveSearch();
+        Update_ForChangedFoldersAfterPreviousIndex_ChangesFound();
+        Update_ForInvalidIndexFile_AllFoldersFound();
+    }
+}
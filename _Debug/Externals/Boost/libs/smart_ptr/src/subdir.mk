@@ -20,7 +20,7 @@ CPP_DEPS += \
 Externals/Boost/libs/smart_ptr/src/%.o: ../Externals/Boost/libs/smart_ptr/src/%.cpp
 	@echo 'Building file: $<'
 	@echo 'Invoking: Cygwin C++ Compiler'
-	g++ -DDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	g++ -DDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O0 -g3 -Wall -std=c++11 -pthread -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
@@ -6,6 +6,7 @@
 CPP_SRCS += \
 ../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/BaseEventProcessor.cpp \
 ../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/BaseEventProvider.cpp \
+../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/CheckpointSerializer.cpp \
 ../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/CollisionEventProcessor.cpp \
 ../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/CollisionEventProvider.cpp \
 ../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/CompositeEventProcessor.cpp \
@@ -17,6 +18,7 @@ CPP_SRCS += \
 ../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/ParticleCollisionService.cpp \
 ../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/Types.cpp \
 ../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VelocityService.cpp \
+../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VoronoiTesselationBuilder.cpp \
 ../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VoronoiTesselationProvider.cpp \
 ../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VoronoiTransferEventProcessor.cpp \
 ../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VoronoiTransferEventProvider.cpp \
@@ -26,6 +28,7 @@ CPP_SRCS += \
 OBJS += \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/BaseEventProcessor.o \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/BaseEventProvider.o \
+./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/CheckpointSerializer.o \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/CollisionEventProcessor.o \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/CollisionEventProvider.o \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/CompositeEventProcessor.o \
@@ -37,6 +40,7 @@ OBJS += \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/ParticleCollisionService.o \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/Types.o \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VelocityService.o \
+./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VoronoiTesselationBuilder.o \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VoronoiTesselationProvider.o \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VoronoiTransferEventProcessor.o \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VoronoiTransferEventProvider.o \
@@ -46,6 +50,7 @@ OBJS += \
 CPP_DEPS += \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/BaseEventProcessor.d \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/BaseEventProvider.d \
+./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/CheckpointSerializer.d \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/CollisionEventProcessor.d \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/CollisionEventProvider.d \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/CompositeEventProcessor.d \
@@ -57,6 +62,7 @@ CPP_DEPS += \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/ParticleCollisionService.d \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/Types.d \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VelocityService.d \
+./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VoronoiTesselationBuilder.d \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VoronoiTesselationProvider.d \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VoronoiTransferEventProcessor.d \
 ./PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/VoronoiTransferEventProvider.d \
@@ -68,7 +74,7 @@ CPP_DEPS += \
 PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/%.o: ../PackingGeneration/Generation/PackingGenerators/LubachevsckyStillinger/Source/%.cpp
 	@echo 'Building file: $<'
 	@echo 'Invoking: Cygwin C++ Compiler'
-	g++ -DDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	g++ -DDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O0 -g3 -Wall -std=c++11 -pthread -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
@@ -6,12 +6,15 @@
 CPP_SRCS += \
 ../PackingGeneration/Generation/PackingServices/PostProcessing/Source/EquilibrationPressureProcessor.cpp \
 ../PackingGeneration/Generation/PackingServices/PostProcessing/Source/ErrorRateProcessor.cpp \
+../PackingGeneration/Generation/PackingServices/PostProcessing/Source/GriddedStructureFactorService.cpp \
 ../PackingGeneration/Generation/PackingServices/PostProcessing/Source/HessianService.cpp \
 ../PackingGeneration/Generation/PackingServices/PostProcessing/Source/InsertionRadiiGenerator.cpp \
+../PackingGeneration/Generation/PackingServices/PostProcessing/Source/InsertionRadiiSampler.cpp \
 ../PackingGeneration/Generation/PackingServices/PostProcessing/Source/IntermediateScatteringFunctionProcessor.cpp \
 ../PackingGeneration/Generation/PackingServices/PostProcessing/Source/MinIterationsProcessor.cpp \
 ../PackingGeneration/Generation/PackingServices/PostProcessing/Source/MolecularDynamicsService.cpp \
 ../PackingGeneration/Generation/PackingServices/PostProcessing/Source/OrderService.cpp \
+../PackingGeneration/Generation/PackingServices/PostProcessing/Source/PairCorrelationService.cpp \
 ../PackingGeneration/Generation/PackingServices/PostProcessing/Source/PressureService.cpp \
 ../PackingGeneration/Generation/PackingServices/PostProcessing/Source/RattlerRemovalService.cpp \
 ../PackingGeneration/Generation/PackingServices/PostProcessing/Source/ScatterAndDiffusionProcessor.cpp \
@@ -20,12 +23,15 @@ CPP_SRCS += \
 OBJS += \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/EquilibrationPressureProcessor.o \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/ErrorRateProcessor.o \
+./PackingGeneration/Generation/PackingServices/PostProcessing/Source/GriddedStructureFactorService.o \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/HessianService.o \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/InsertionRadiiGenerator.o \
+./PackingGeneration/Generation/PackingServices/PostProcessing/Source/InsertionRadiiSampler.o \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/IntermediateScatteringFunctionProcessor.o \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/MinIterationsProcessor.o \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/MolecularDynamicsService.o \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/OrderService.o \
+./PackingGeneration/Generation/PackingServices/PostProcessing/Source/PairCorrelationService.o \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/PressureService.o \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/RattlerRemovalService.o \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/ScatterAndDiffusionProcessor.o \
@@ -34,12 +40,15 @@ OBJS += \
 CPP_DEPS += \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/EquilibrationPressureProcessor.d \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/ErrorRateProcessor.d \
+./PackingGeneration/Generation/PackingServices/PostProcessing/Source/GriddedStructureFactorService.d \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/HessianService.d \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/InsertionRadiiGenerator.d \
+./PackingGeneration/Generation/PackingServices/PostProcessing/Source/InsertionRadiiSampler.d \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/IntermediateScatteringFunctionProcessor.d \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/MinIterationsProcessor.d \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/MolecularDynamicsService.d \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/OrderService.d \
+./PackingGeneration/Generation/PackingServices/PostProcessing/Source/PairCorrelationService.d \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/PressureService.d \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/RattlerRemovalService.d \
 ./PackingGeneration/Generation/PackingServices/PostProcessing/Source/ScatterAndDiffusionProcessor.d \
@@ -50,7 +59,7 @@ CPP_DEPS += \
 PackingGeneration/Generation/PackingServices/PostProcessing/Source/%.o: ../PackingGeneration/Generation/PackingServices/PostProcessing/Source/%.cpp
 	@echo 'Building file: $<'
 	@echo 'Invoking: Cygwin C++ Compiler'
-	g++ -DDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	g++ -DDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O0 -g3 -Wall -std=c++11 -pthread -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
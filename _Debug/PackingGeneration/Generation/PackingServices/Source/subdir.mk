@@ -4,6 +4,7 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../PackingGeneration/Generation/PackingServices/Source/AsyncPackingWriter.cpp \
 ../PackingGeneration/Generation/PackingServices/Source/ClosestJammingVelocityProvider.cpp \
 ../PackingGeneration/Generation/PackingServices/Source/GeometryCollisionService.cpp \
 ../PackingGeneration/Generation/PackingServices/Source/GeometryService.cpp \
@@ -12,6 +13,7 @@ CPP_SRCS += \
 ../PackingGeneration/Generation/PackingServices/Source/PackingSerializer.cpp 
 
 OBJS += \
+./PackingGeneration/Generation/PackingServices/Source/AsyncPackingWriter.o \
 ./PackingGeneration/Generation/PackingServices/Source/ClosestJammingVelocityProvider.o \
 ./PackingGeneration/Generation/PackingServices/Source/GeometryCollisionService.o \
 ./PackingGeneration/Generation/PackingServices/Source/GeometryService.o \
@@ -20,6 +22,7 @@ OBJS += \
 ./PackingGeneration/Generation/PackingServices/Source/PackingSerializer.o 
 
 CPP_DEPS += \
+./PackingGeneration/Generation/PackingServices/Source/AsyncPackingWriter.d \
 ./PackingGeneration/Generation/PackingServices/Source/ClosestJammingVelocityProvider.d \
 ./PackingGeneration/Generation/PackingServices/Source/GeometryCollisionService.d \
 ./PackingGeneration/Generation/PackingServices/Source/GeometryService.d \
@@ -32,7 +35,7 @@ CPP_DEPS += \
 PackingGeneration/Generation/PackingServices/Source/%.o: ../PackingGeneration/Generation/PackingServices/Source/%.cpp
 	@echo 'Building file: $<'
 	@echo 'Invoking: Cygwin C++ Compiler'
-	g++ -DDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	g++ -DDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O0 -g3 -Wall -std=c++11 -pthread -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
@@ -4,29 +4,44 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
+../PackingGeneration/Core/Source/CounterBasedRandom.cpp \
 ../PackingGeneration/Core/Source/EndiannessProvider.cpp \
 ../PackingGeneration/Core/Source/Exceptions.cpp \
+../PackingGeneration/Core/Source/FastFourierTransform.cpp \
 ../PackingGeneration/Core/Source/Math.cpp \
 ../PackingGeneration/Core/Source/MpiManager.cpp \
 ../PackingGeneration/Core/Source/Path.cpp \
+../PackingGeneration/Core/Source/SphericalHarmonicsKernel.cpp \
+../PackingGeneration/Core/Source/ThreadPool.cpp \
+../PackingGeneration/Core/Source/TimeBudget.cpp \
 ../PackingGeneration/Core/Source/Utilities.cpp \
 ../PackingGeneration/Core/Source/VectorUtilities.cpp 
 
 OBJS += \
+./PackingGeneration/Core/Source/CounterBasedRandom.o \
 ./PackingGeneration/Core/Source/EndiannessProvider.o \
 ./PackingGeneration/Core/Source/Exceptions.o \
+./PackingGeneration/Core/Source/FastFourierTransform.o \
 ./PackingGeneration/Core/Source/Math.o \
 ./PackingGeneration/Core/Source/MpiManager.o \
 ./PackingGeneration/Core/Source/Path.o \
+./PackingGeneration/Core/Source/SphericalHarmonicsKernel.o \
+./PackingGeneration/Core/Source/ThreadPool.o \
+./PackingGeneration/Core/Source/TimeBudget.o \
 ./PackingGeneration/Core/Source/Utilities.o \
 ./PackingGeneration/Core/Source/VectorUtilities.o 
 
 CPP_DEPS += \
+./PackingGeneration/Core/Source/CounterBasedRandom.d \
 ./PackingGeneration/Core/Source/EndiannessProvider.d \
 ./PackingGeneration/Core/Source/Exceptions.d \
+./PackingGeneration/Core/Source/FastFourierTransform.d \
 ./PackingGeneration/Core/Source/Math.d \
 ./PackingGeneration/Core/Source/MpiManager.d \
 ./PackingGeneration/Core/Source/Path.d \
+./PackingGeneration/Core/Source/SphericalHarmonicsKernel.d \
+./PackingGeneration/Core/Source/ThreadPool.d \
+./PackingGeneration/Core/Source/TimeBudget.d \
 ./PackingGeneration/Core/Source/Utilities.d \
 ./PackingGeneration/Core/Source/VectorUtilities.d 
 
@@ -35,7 +50,7 @@ CPP_DEPS += \
 PackingGeneration/Core/Source/%.o: ../PackingGeneration/Core/Source/%.cpp
 	@echo 'Building file: $<'
 	@echo 'Invoking: Cygwin C++ Compiler'
-	g++ -DDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	g++ -DDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O0 -g3 -Wall -std=c++11 -pthread -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
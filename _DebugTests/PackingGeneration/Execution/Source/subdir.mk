@@ -5,22 +5,28 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../PackingGeneration/Execution/Source/PackingGenerationTask.cpp \
-../PackingGeneration/Execution/Source/PackingTaskFactory.cpp 
+../PackingGeneration/Execution/Source/PackingTaskFactory.cpp \
+../PackingGeneration/Execution/Source/TaskCostEstimator.cpp \
+../PackingGeneration/Execution/Source/WorkingFolderIndex.cpp 
 
 OBJS += \
 ./PackingGeneration/Execution/Source/PackingGenerationTask.o \
-./PackingGeneration/Execution/Source/PackingTaskFactory.o 
+./PackingGeneration/Execution/Source/PackingTaskFactory.o \
+./PackingGeneration/Execution/Source/TaskCostEstimator.o \
+./PackingGeneration/Execution/Source/WorkingFolderIndex.o 
 
 CPP_DEPS += \
 ./PackingGeneration/Execution/Source/PackingGenerationTask.d \
-./PackingGeneration/Execution/Source/PackingTaskFactory.d 
+./PackingGeneration/Execution/Source/PackingTaskFactory.d \
+./PackingGeneration/Execution/Source/TaskCostEstimator.d \
+./PackingGeneration/Execution/Source/WorkingFolderIndex.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
 PackingGeneration/Execution/Source/%.o: ../PackingGeneration/Execution/Source/%.cpp
 	@echo 'Building file: $<'
 	@echo 'Invoking: Cygwin C++ Compiler'
-	g++ -DDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O0 -g3 -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	g++ -DDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O0 -g3 -Wall -std=c++11 -pthread -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
@@ -5,64 +5,139 @@
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
 ../Tests/Source/Assert.cpp \
+../Tests/Source/AsyncPackingWriterTests.cpp \
 ../Tests/Source/ByteUtilityTests.cpp \
+../Tests/Source/CalendarOrderedPriorityQueueTests.cpp \
+../Tests/Source/CellListNeighborProviderTests.cpp \
+../Tests/Source/CheckpointSerializerTests.cpp \
 ../Tests/Source/ClosestJammingStepTests.cpp \
 ../Tests/Source/ClosestPairProviderTests.cpp \
 ../Tests/Source/ColumnMajorIndexingProviderTests.cpp \
+../Tests/Source/CounterBasedRandomTests.cpp \
 ../Tests/Source/EndiannessProviderStub.cpp \
+../Tests/Source/EnergyServiceTests.cpp \
+../Tests/Source/FastFourierTransformTests.cpp \
 ../Tests/Source/GeometryCollisionServiceTests.cpp \
+../Tests/Source/GridClosestPairServiceTests.cpp \
+../Tests/Source/GriddedStructureFactorServiceTests.cpp \
 ../Tests/Source/HcpGeneratorTests.cpp \
 ../Tests/Source/HessianServiceTests.cpp \
+../Tests/Source/HierarchicalCellListNeighborProviderTests.cpp \
+../Tests/Source/InsertionRadiiSamplerTests.cpp \
+../Tests/Source/KeyOrderedPriorityQueueTests.cpp \
+../Tests/Source/LubachevsckyStillingerStepTests.cpp \
 ../Tests/Source/OrderedPriorityQueueTests.cpp \
+../Tests/Source/OrderServiceTests.cpp \
 ../Tests/Source/PackingSerializerTests.cpp \
+../Tests/Source/PackingTestUtilities.cpp \
+../Tests/Source/PairCorrelationServiceTests.cpp \
 ../Tests/Source/ParticleCollisionServiceTests.cpp \
 ../Tests/Source/RattlerRemovalServiceTests.cpp \
+../Tests/Source/ScatteringSumsKernelTests.cpp \
 ../Tests/Source/SphericalHarmonicsComputerTests.cpp \
+../Tests/Source/SphericalHarmonicsKernelTests.cpp \
+../Tests/Source/TaskCostEstimatorTests.cpp \
+../Tests/Source/TaskManagerTests.cpp \
 ../Tests/Source/TestRunner.cpp \
-../Tests/Source/VelocityServiceTests.cpp 
+../Tests/Source/TimeBudgetTests.cpp \
+../Tests/Source/VelocityServiceTests.cpp \
+../Tests/Source/VerletListNeighborProviderTests.cpp \
+../Tests/Source/VerletSkinTunerTests.cpp \
+../Tests/Source/VoronoiTesselationBuilderTests.cpp \
+../Tests/Source/WorkingFolderIndexTests.cpp 
 
 OBJS += \
 ./Tests/Source/Assert.o \
+./Tests/Source/AsyncPackingWriterTests.o \
 ./Tests/Source/ByteUtilityTests.o \
+./Tests/Source/CalendarOrderedPriorityQueueTests.o \
+./Tests/Source/CellListNeighborProviderTests.o \
+./Tests/Source/CheckpointSerializerTests.o \
 ./Tests/Source/ClosestJammingStepTests.o \
 ./Tests/Source/ClosestPairProviderTests.o \
 ./Tests/Source/ColumnMajorIndexingProviderTests.o \
+./Tests/Source/CounterBasedRandomTests.o \
 ./Tests/Source/EndiannessProviderStub.o \
+./Tests/Source/EnergyServiceTests.o \
+./Tests/Source/FastFourierTransformTests.o \
 ./Tests/Source/GeometryCollisionServiceTests.o \
+./Tests/Source/GridClosestPairServiceTests.o \
+./Tests/Source/GriddedStructureFactorServiceTests.o \
 ./Tests/Source/HcpGeneratorTests.o \
 ./Tests/Source/HessianServiceTests.o \
+./Tests/Source/HierarchicalCellListNeighborProviderTests.o \
+./Tests/Source/InsertionRadiiSamplerTests.o \
+./Tests/Source/KeyOrderedPriorityQueueTests.o \
+./Tests/Source/LubachevsckyStillingerStepTests.o \
 ./Tests/Source/OrderedPriorityQueueTests.o \
+./Tests/Source/OrderServiceTests.o \
 ./Tests/Source/PackingSerializerTests.o \
+./Tests/Source/PackingTestUtilities.o \
+./Tests/Source/PairCorrelationServiceTests.o \
 ./Tests/Source/ParticleCollisionServiceTests.o \
 ./Tests/Source/RattlerRemovalServiceTests.o \
+./Tests/Source/ScatteringSumsKernelTests.o \
 ./Tests/Source/SphericalHarmonicsComputerTests.o \
+./Tests/Source/SphericalHarmonicsKernelTests.o \
+./Tests/Source/TaskCostEstimatorTests.o \
+./Tests/Source/TaskManagerTests.o \
 ./Tests/Source/TestRunner.o \
-./Tests/Source/VelocityServiceTests.o 
+./Tests/Source/TimeBudgetTests.o \
+./Tests/Source/VelocityServiceTests.o \
+./Tests/Source/VerletListNeighborProviderTests.o \
+./Tests/Source/VerletSkinTunerTests.o \
+./Tests/Source/VoronoiTesselationBuilderTests.o \
+./Tests/Source/WorkingFolderIndexTests.o 
 
 CPP_DEPS += \
 ./Tests/Source/Assert.d \
+./Tests/Source/AsyncPackingWriterTests.d \
 ./Tests/Source/ByteUtilityTests.d \
+./Tests/Source/CalendarOrderedPriorityQueueTests.d \
+./Tests/Source/CellListNeighborProviderTests.d \
+./Tests/Source/CheckpointSerializerTests.d \
 ./Tests/Source/ClosestJammingStepTests.d \
 ./Tests/Source/ClosestPairProviderTests.d \
 ./Tests/Source/ColumnMajorIndexingProviderTests.d \
+./Tests/Source/CounterBasedRandomTests.d \
 ./Tests/Source/EndiannessProviderStub.d \
+./Tests/Source/EnergyServiceTests.d \
+./Tests/Source/FastFourierTransformTests.d \
 ./Tests/Source/GeometryCollisionServiceTests.d \
+./Tests/Source/GridClosestPairServiceTests.d \
+./Tests/Source/GriddedStructureFactorServiceTests.d \
 ./Tests/Source/HcpGeneratorTests.d \
 ./Tests/Source/HessianServiceTests.d \
+./Tests/Source/HierarchicalCellListNeighborProviderTests.d \
+./Tests/Source/InsertionRadiiSamplerTests.d \
+./Tests/Source/KeyOrderedPriorityQueueTests.d \
+./Tests/Source/LubachevsckyStillingerStepTests.d \
 ./Tests/Source/OrderedPriorityQueueTests.d \
+./Tests/Source/OrderServiceTests.d \
 ./Tests/Source/PackingSerializerTests.d \
+./Tests/Source/PackingTestUtilities.d \
+./Tests/Source/PairCorrelationServiceTests.d \
 ./Tests/Source/ParticleCollisionServiceTests.d \
 ./Tests/Source/RattlerRemovalServiceTests.d \
+./Tests/Source/ScatteringSumsKernelTests.d \
 ./Tests/Source/SphericalHarmonicsComputerTests.d \
+./Tests/Source/SphericalHarmonicsKernelTests.d \
+./Tests/Source/TaskCostEstimatorTests.d \
+./Tests/Source/TaskManagerTests.d \
 ./Tests/Source/TestRunner.d \
-./Tests/Source/VelocityServiceTests.d 
+./Tests/Source/TimeBudgetTests.d \
+./Tests/Source/VelocityServiceTests.d \
+./Tests/Source/VerletListNeighborProviderTests.d \
+./Tests/Source/VerletSkinTunerTests.d \
+./Tests/Source/VoronoiTesselationBuilderTests.d \
+./Tests/Source/WorkingFolderIndexTests.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
 Tests/Source/%.o: ../Tests/Source/%.cpp
 	@echo 'Building file: $<'
 	@echo 'Invoking: Cygwin C++ Compiler'
-	g++ -DBOOST_DISABLE_ASSERTS -DNDEBUG -I../Externals/Eigen -I../Externals/Boost -I../PackingGeneration -O3 -funroll-loops -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	g++ -DBOOST_DISABLE_ASSERTS -DNDEBUG -I../Externals/Eigen -I../Externals/Boost -I../PackingGeneration -O3 -funroll-loops -Wall -std=c++11 -pthread -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 
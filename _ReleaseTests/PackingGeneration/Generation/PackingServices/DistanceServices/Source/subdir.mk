@@ -6,36 +6,51 @@
 CPP_SRCS += \
 ../PackingGeneration/Generation/PackingServices/DistanceServices/Source/BaseDistanceService.cpp \
 ../PackingGeneration/Generation/PackingServices/DistanceServices/Source/BondsProvider.cpp \
+../PackingGeneration/Generation/PackingServices/DistanceServices/Source/CellGrid.cpp \
 ../PackingGeneration/Generation/PackingServices/DistanceServices/Source/CellListNeighborProvider.cpp \
 ../PackingGeneration/Generation/PackingServices/DistanceServices/Source/ClosestPairProvider.cpp \
 ../PackingGeneration/Generation/PackingServices/DistanceServices/Source/DistanceService.cpp \
+../PackingGeneration/Generation/PackingServices/DistanceServices/Source/GridClosestPairService.cpp \
+../PackingGeneration/Generation/PackingServices/DistanceServices/Source/HierarchicalCellListNeighborProvider.cpp \
 ../PackingGeneration/Generation/PackingServices/DistanceServices/Source/NaiveNeighborProvider.cpp \
-../PackingGeneration/Generation/PackingServices/DistanceServices/Source/VerletListNeighborProvider.cpp 
+../PackingGeneration/Generation/PackingServices/DistanceServices/Source/ScatteringSumsKernel.cpp \
+../PackingGeneration/Generation/PackingServices/DistanceServices/Source/VerletListNeighborProvider.cpp \
+../PackingGeneration/Generation/PackingServices/DistanceServices/Source/VerletSkinTuner.cpp 
 
 OBJS += \
 ./PackingGeneration/Generation/PackingServices/DistanceServices/Source/BaseDistanceService.o \
 ./PackingGeneration/Generation/PackingServices/DistanceServices/Source/BondsProvider.o \
+./PackingGeneration/Generation/PackingServices/DistanceServices/Source/CellGrid.o \
 ./PackingGeneration/Generation/PackingServices/DistanceServices/Source/CellListNeighborProvider.o \
 ./PackingGeneration/Generation/PackingServices/DistanceServices/Source/ClosestPairProvider.o \
 ./PackingGeneration/Generation/PackingServices/DistanceServices/Source/DistanceService.o \
+./PackingGeneration/Generation/PackingServices/DistanceServices/Source/GridClosestPairService.o \
+./PackingGeneration/Generation/PackingServices/DistanceServices/Source/HierarchicalCellListNeighborProvider.o \
 ./PackingGeneration/Generation/PackingServices/DistanceServices/Source/NaiveNeighborProvider.o \
-./PackingGeneration/Generation/PackingServices/DistanceServices/Source/VerletListNeighborProvider.o 
+./PackingGeneration/Generation/PackingServices/DistanceServices/Source/ScatteringSumsKernel.o \
+./PackingGeneration/Generation/PackingServices/DistanceServices/Source/VerletListNeighborProvider.o \
+./PackingGeneration/Generation/PackingServices/DistanceServices/Source/VerletSkinTuner.o 
 
 CPP_DEPS += \
 ./PackingGeneration/Generation/PackingServices/DistanceServices/Source/BaseDistanceService.d \
 ./PackingGeneration/Generation/PackingServices/DistanceServices/Source/BondsProvider.d \
+./PackingGeneration/Generation/PackingServices/DistanceServices/Source/CellGrid.d \
 ./PackingGeneration/Generation/PackingServices/DistanceServices/Source/CellListNeighborProvider.d \
 ./PackingGeneration/Generation/PackingServices/DistanceServices/Source/ClosestPairProvider.d \
 ./PackingGeneration/Generation/PackingServices/DistanceServices/Source/DistanceService.d \
+./PackingGeneration/Generation/PackingServices/DistanceServices/Source/GridClosestPairService.d \
+./PackingGeneration/Generation/PackingServices/DistanceServices/Source/HierarchicalCellListNeighborProvider.d \
 ./PackingGeneration/Generation/PackingServices/DistanceServices/Source/NaiveNeighborProvider.d \
-./PackingGeneration/Generation/PackingServices/DistanceServices/Source/VerletListNeighborProvider.d 
+./PackingGeneration/Generation/PackingServices/DistanceServices/Source/ScatteringSumsKernel.d \
+./PackingGeneration/Generation/PackingServices/DistanceServices/Source/VerletListNeighborProvider.d \
+./PackingGeneration/Generation/PackingServices/DistanceServices/Source/VerletSkinTuner.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
 PackingGeneration/Generation/PackingServices/DistanceServices/Source/%.o: ../PackingGeneration/Generation/PackingServices/DistanceServices/Source/%.cpp
 	@echo 'Building file: $<'
 	@echo 'Invoking: Cygwin C++ Compiler'
-	g++ -DBOOST_DISABLE_ASSERTS -DNDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O3 -funroll-loops -Wall -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
+	g++ -DBOOST_DISABLE_ASSERTS -DNDEBUG -I../Externals/Boost -I../Externals/Eigen -I../PackingGeneration -O3 -funroll-loops -Wall -std=c++11 -pthread -c -fmessage-length=0 -MMD -MP -MF"$(@:%.o=%.d)" -MT"$(@:%.o=%.d)" -o "$@" "$<"
 	@echo 'Finished building: $<'
 	@echo ' '
 